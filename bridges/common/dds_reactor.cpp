@@ -0,0 +1,132 @@
+// Copyright 2025 Vehicle Edge Platform Contributors
+// SPDX-License-Identifier: Apache-2.0
+
+#include "dds_reactor.hpp"
+
+#include <chrono>
+
+namespace bridge {
+
+namespace {
+
+/// Attach argument of the stop guard condition; readers use their index
+constexpr dds_attach_t kStopGuard = -1;
+
+}  // namespace
+
+DdsReactor::DdsReactor(std::string name) : name_(std::move(name)) {
+    waitset_ = dds_create_waitset(DDS_CYCLONEDDS_HANDLE);
+    if (waitset_ < 0) {
+        LOG(ERROR) << "DdsReactor: " << name_ << ": Failed to create waitset: "
+                   << dds_strretcode(waitset_);
+        return;
+    }
+    guard_ = dds_create_guardcondition(DDS_CYCLONEDDS_HANDLE);
+    if (guard_ < 0) {
+        LOG(ERROR) << "DdsReactor: " << name_ << ": Failed to create guard condition: "
+                   << dds_strretcode(guard_);
+        return;
+    }
+    dds_return_t rc = dds_waitset_attach(waitset_, guard_, kStopGuard);
+    if (rc < 0) {
+        LOG(ERROR) << "DdsReactor: " << name_ << ": Failed to attach guard condition: "
+                   << dds_strretcode(rc);
+        dds_delete(guard_);
+        guard_ = rc;
+    }
+}
+
+DdsReactor::~DdsReactor() {
+    stop();
+    for (const auto& handler : handlers_) {
+        dds_delete(handler.condition);
+    }
+    if (guard_ > 0) {
+        dds_delete(guard_);
+    }
+    if (waitset_ > 0) {
+        dds_delete(waitset_);
+    }
+}
+
+bool DdsReactor::attach(const std::string& name, dds::Reader& reader,
+                        std::function<void()> take) {
+    if (running_) {
+        LOG(ERROR) << "DdsReactor: " << name_ << ": reader " << name << " added while running";
+        return false;
+    }
+    if (waitset_ <= 0) {
+        return false;
+    }
+
+    // Triggered while the reader holds any sample, read or not
+    dds_entity_t condition = dds_create_readcondition(reader.get(), DDS_ANY_STATE);
+    if (condition < 0) {
+        LOG(ERROR) << "DdsReactor: " << name_ << ": Failed to create read condition for "
+                   << name << ": " << dds_strretcode(condition);
+        return false;
+    }
+    dds_return_t rc = dds_waitset_attach(waitset_, condition,
+                                         static_cast<dds_attach_t>(handlers_.size()));
+    if (rc < 0) {
+        LOG(ERROR) << "DdsReactor: " << name_ << ": Failed to attach " << name << ": "
+                   << dds_strretcode(rc);
+        dds_delete(condition);
+        return false;
+    }
+    handlers_.push_back({name, condition, std::move(take)});
+    return true;
+}
+
+bool DdsReactor::start() {
+    if (waitset_ <= 0 || guard_ <= 0) {
+        LOG(ERROR) << "DdsReactor: " << name_ << ": Not started, no waitset";
+        return false;
+    }
+    if (running_.exchange(true)) {
+        return true;
+    }
+    dds_set_guardcondition(guard_, false);
+    thread_ = std::thread(&DdsReactor::run, this);
+
+    std::string names;
+    for (const auto& handler : handlers_) {
+        names += (names.empty() ? "" : ", ") + handler.name;
+    }
+    LOG(INFO) << "DdsReactor: " << name_ << ": Waiting on " << handlers_.size()
+              << " readers (" << names << ")";
+    return true;
+}
+
+void DdsReactor::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    dds_set_guardcondition(guard_, true);
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void DdsReactor::run() {
+    std::vector<dds_attach_t> triggered(handlers_.size() + 1);
+
+    while (running_) {
+        dds_return_t count = dds_waitset_wait(waitset_, triggered.data(), triggered.size(),
+                                              DDS_INFINITY);
+        if (count < 0) {
+            LOG_EVERY_N(ERROR, 100) << "DdsReactor: " << name_ << ": Waitset wait failed: "
+                                    << dds_strretcode(count);
+            // Do not spin on a persistent error
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            continue;
+        }
+        for (dds_return_t i = 0; i < count && running_; ++i) {
+            if (triggered[i] != kStopGuard) {
+                handlers_[static_cast<size_t>(triggered[i])].take();
+            }
+        }
+    }
+}
+
+}  // namespace bridge
@@ -0,0 +1,175 @@
+// Copyright 2025 Vehicle Edge Platform Contributors
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+/// @file dds_reactor.hpp
+/// @brief Event-driven dispatch for DDS readers
+///
+/// One thread blocks on a CycloneDDS waitset holding a read condition per
+/// reader, so samples are handled as soon as they arrive instead of on the
+/// next tick of a sleep-based poll loop, and an idle process does not wake
+/// up at all:
+///
+///   reader A ─ read condition ─┐
+///   reader B ─ read condition ─┼→ waitset → reactor thread → callback A/B
+///   stop()   ─ guard condition ┘
+///
+/// Each wakeup takes at most max_samples from every triggered reader. A
+/// reader with more pending keeps its condition triggered, so the next
+/// wait returns immediately and a busy topic cannot starve the others.
+
+#include "common/dds_wrapper.hpp"
+
+#include <dds/dds.h>
+#include <glog/logging.h>
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace bridge {
+
+/// Dispatches samples of several DDS readers on one thread
+///
+/// Readers are added before start() and must outlive the reactor.
+/// Callbacks run on the reactor thread, one at a time.
+///
+/// Example:
+/// @code
+///   DdsReactor reactor("exporter");
+///   reactor.add_reader<vep_VssSignal>("signals", *reader,
+///       [](const vep_VssSignal& signal) { ... });
+///   reactor.start();
+///   ...
+///   reactor.stop();
+/// @endcode
+class DdsReactor {
+public:
+    /// @param name Component name in logs
+    explicit DdsReactor(std::string name);
+    ~DdsReactor();
+
+    DdsReactor(const DdsReactor&) = delete;
+    DdsReactor& operator=(const DdsReactor&) = delete;
+
+    /// Call callback for each sample of type T taken from reader
+    /// @param name Topic name in logs
+    /// @param max_samples Samples taken per wakeup
+    /// @return false if the read condition could not be attached, or the
+    ///         reactor is running
+    template<typename T, typename Callback>
+    bool add_reader(const std::string& name, dds::Reader& reader, Callback callback,
+                    int max_samples = 100) {
+        return attach(name, reader, [this, name, &reader, callback = std::move(callback),
+                                     max_samples]() {
+            try {
+                reader.take_each<T>(callback, max_samples);
+            } catch (const dds::Error& e) {
+                LOG(ERROR) << "DdsReactor: " << name_ << ": Error reading " << name << ": "
+                           << e.what();
+            }
+        });
+    }
+
+    /// Call callback(const T* samples, size_t count) for each run of valid
+    /// samples taken from reader, in order
+    ///
+    /// Samples are loaned from DDS, not copied, and the loan is one
+    /// contiguous array; callback is called directly (no std::function per
+    /// sample) and must not keep the pointer.
+    /// @param name Topic name in logs
+    /// @param max_samples Samples taken per wakeup
+    /// @return false if the read condition could not be attached, or the
+    ///         reactor is running
+    template<typename T, typename Callback>
+    bool add_batch_reader(const std::string& name, dds::Reader& reader, Callback callback,
+                          int max_samples = 100) {
+        dds_entity_t entity = reader.get();
+        return attach(name, reader, [this, name, entity, callback = std::move(callback),
+                                     max_samples,
+                                     samples = std::vector<void*>(max_samples),
+                                     infos = std::vector<dds_sample_info_t>(max_samples)]()
+                                     mutable {
+            samples[0] = nullptr;  // Loan: DDS supplies the sample array
+            dds_return_t taken = dds_take(entity, samples.data(), infos.data(),
+                                          samples.size(), static_cast<uint32_t>(max_samples));
+            if (taken < 0) {
+                LOG(ERROR) << "DdsReactor: " << name_ << ": Error reading " << name << ": "
+                           << dds_strretcode(taken);
+                return;
+            }
+            // Returned however the callbacks exit
+            LoanGuard loan(entity, samples.data(), taken);
+            try {
+                const T* base = static_cast<const T*>(samples[0]);
+                dds_return_t start = 0;
+                for (dds_return_t i = 0; i <= taken; ++i) {
+                    // Invalid samples (disposal, unregistration) end a run
+                    if (i == taken || !infos[i].valid_data) {
+                        if (i > start) {
+                            callback(base + start, static_cast<size_t>(i - start));
+                        }
+                        start = i + 1;
+                    }
+                }
+            } catch (const dds::Error& e) {
+                LOG(ERROR) << "DdsReactor: " << name_ << ": Error reading " << name << ": "
+                           << e.what();
+            }
+        });
+    }
+
+    /// Start the reactor thread
+    /// @return false if the waitset could not be created
+    bool start();
+
+    /// Wake the reactor thread and join it; samples still queued in the
+    /// readers stay there
+    void stop();
+
+    /// True between start() and stop()
+    bool running() const { return running_; }
+
+    /// Number of readers added
+    size_t readers() const { return handlers_.size(); }
+
+private:
+    /// Returns a dds_take() loan when it goes out of scope
+    struct LoanGuard {
+        dds_entity_t reader;
+        void** samples;
+        dds_return_t count;
+
+        LoanGuard(dds_entity_t entity, void** loaned, dds_return_t taken)
+            : reader(entity), samples(loaned), count(taken) {}
+        LoanGuard(const LoanGuard&) = delete;
+        LoanGuard& operator=(const LoanGuard&) = delete;
+        ~LoanGuard() {
+            if (count > 0) {
+                dds_return_loan(reader, samples, count);
+            }
+        }
+    };
+
+    struct Handler {
+        std::string name;
+        dds_entity_t condition;
+        std::function<void()> take;
+    };
+
+    bool attach(const std::string& name, dds::Reader& reader, std::function<void()> take);
+    void run();
+
+    std::string name_;
+    dds_entity_t waitset_ = 0;
+    dds_entity_t guard_ = 0;
+    std::vector<Handler> handlers_;
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+};
+
+}  // namespace bridge
@@ -0,0 +1,194 @@
+// Copyright 2025 Vehicle Edge Platform Contributors
+// SPDX-License-Identifier: Apache-2.0
+
+/// @file batch_builder_bench.cpp
+/// @brief UnifiedBatchBuilder throughput and allocations per item
+///
+/// Compares the heap-staged builder with arena, direct and signal block
+/// modes. Each iteration adds one batch worth of items and serializes it
+/// into a reused buffer, so allocs/item reflects the steady-state cost of
+/// the exporter hot path.
+/// The Candump benchmarks replay the recorded CAN workload instead of five
+/// synthetic paths. The ConcurrentAdd benchmarks measure ingest with several
+/// producer threads while thread 0 also drains batches, like the flush thread;
+/// the Span variants add kItemsPerBatch items per call, as one DDS take does.
+
+#include "batch_builder.hpp"
+#include "bench_support.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+namespace vep::exporter::bench {
+
+namespace {
+
+/// Add kItemsPerBatch signals and serialize them, per iteration; signals
+/// are taken in order, wrapping around
+void run_builder(benchmark::State& state, const BatchBuilderConfig& config,
+                 const std::vector<vep_VssSignal>& signals) {
+    UnifiedBatchBuilder builder("bench", kItemsPerBatch, config);
+    std::vector<uint8_t> buffer;
+    size_t next = 0;
+    auto add_batch = [&] {
+        for (int i = 0; i < kItemsPerBatch; ++i) {
+            builder.add(signals[next]);
+            next = next + 1 < signals.size() ? next + 1 : 0;
+        }
+        return builder.build_into(buffer);
+    };
+
+    // Warm up buffer capacity (and the path dictionary, if interning)
+    for (size_t i = 0; i < signals.size(); i += kItemsPerBatch) {
+        add_batch();
+    }
+    next = 0;
+
+    size_t bytes = 0;
+    ItemCounters counters;
+    for (auto _ : state) {
+        size_t size = add_batch();
+        benchmark::DoNotOptimize(size);
+        bytes += size;
+    }
+    size_t iterations = static_cast<size_t>(state.iterations());
+    counters.report(state, kItemsPerBatch, iterations > 0 ? bytes / iterations : 0);
+}
+
+void run_builder(benchmark::State& state, const BatchBuilderConfig& config) {
+    std::vector<vep_VssSignal> signals;
+    for (int i = 0; i < kItemsPerBatch; ++i) {
+        signals.push_back(make_signal(i));
+    }
+    run_builder(state, config, signals);
+}
+
+void run_builder_candump(benchmark::State& state, const BatchBuilderConfig& config) {
+    const auto& workload = can_workload();
+    if (workload.signals.empty()) {
+        state.SkipWithError(workload.error.c_str());
+        return;
+    }
+    run_builder(state, config, workload.signals);
+}
+
+void run_concurrent_add(benchmark::State& state, UnifiedBatchBuilder& builder) {
+    auto signal = make_signal(state.thread_index());
+    std::vector<uint8_t> buffer;
+
+    ItemCounters counters;
+    for (auto _ : state) {
+        builder.add(signal);
+        if (state.thread_index() == 0 && builder.full()) {
+            builder.build_into(buffer);
+        }
+    }
+    counters.report(state, 1, 0);
+}
+
+void run_concurrent_add_span(benchmark::State& state, UnifiedBatchBuilder& builder) {
+    std::vector<vep_VssSignal> signals(kItemsPerBatch, make_signal(state.thread_index()));
+    std::vector<uint8_t> buffer;
+
+    ItemCounters counters;
+    for (auto _ : state) {
+        builder.add(signals.data(), signals.size());
+        if (state.thread_index() == 0 && builder.full()) {
+            builder.build_into(buffer);
+        }
+    }
+    counters.report(state, kItemsPerBatch, 0);
+}
+
+}  // namespace
+
+static void BM_BuildBatch_Heap(benchmark::State& state) {
+    run_builder(state, BatchBuilderConfig{});
+}
+BENCHMARK(BM_BuildBatch_Heap);
+
+static void BM_BuildBatch_Arena(benchmark::State& state) {
+    BatchBuilderConfig config;
+    config.use_arena = true;
+    run_builder(state, config);
+}
+BENCHMARK(BM_BuildBatch_Arena);
+
+static void BM_BuildBatch_Direct(benchmark::State& state) {
+    BatchBuilderConfig config;
+    config.direct_encoding = true;
+    run_builder(state, config);
+}
+BENCHMARK(BM_BuildBatch_Direct);
+
+static void BM_BuildBatch_SignalBlocks(benchmark::State& state) {
+    BatchBuilderConfig config;
+    config.signal_blocks = true;
+    run_builder(state, config);
+}
+BENCHMARK(BM_BuildBatch_SignalBlocks);
+
+static void BM_BuildBatch_DirectSignalBlocks(benchmark::State& state) {
+    BatchBuilderConfig config;
+    config.direct_encoding = true;
+    config.signal_blocks = true;
+    run_builder(state, config);
+}
+BENCHMARK(BM_BuildBatch_DirectSignalBlocks);
+
+static void BM_BuildBatch_Candump_Heap(benchmark::State& state) {
+    run_builder_candump(state, BatchBuilderConfig{});
+}
+BENCHMARK(BM_BuildBatch_Candump_Heap);
+
+static void BM_BuildBatch_Candump_Direct(benchmark::State& state) {
+    BatchBuilderConfig config;
+    config.direct_encoding = true;
+    config.intern_paths = true;
+    run_builder_candump(state, config);
+}
+BENCHMARK(BM_BuildBatch_Candump_Direct);
+
+static void BM_BuildBatch_Candump_DirectSignalBlocks(benchmark::State& state) {
+    BatchBuilderConfig config;
+    config.direct_encoding = true;
+    config.intern_paths = true;
+    config.signal_blocks = true;
+    run_builder_candump(state, config);
+}
+BENCHMARK(BM_BuildBatch_Candump_DirectSignalBlocks);
+
+static void BM_ConcurrentAdd_Staged(benchmark::State& state) {
+    static UnifiedBatchBuilder builder("bench", kItemsPerBatch);
+    run_concurrent_add(state, builder);
+}
+BENCHMARK(BM_ConcurrentAdd_Staged)->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_ConcurrentAdd_Direct(benchmark::State& state) {
+    static UnifiedBatchBuilder builder("bench", kItemsPerBatch, [] {
+        BatchBuilderConfig config;
+        config.direct_encoding = true;
+        return config;
+    }());
+    run_concurrent_add(state, builder);
+}
+BENCHMARK(BM_ConcurrentAdd_Direct)->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_ConcurrentAddSpan_Staged(benchmark::State& state) {
+    static UnifiedBatchBuilder builder("bench", kItemsPerBatch);
+    run_concurrent_add_span(state, builder);
+}
+BENCHMARK(BM_ConcurrentAddSpan_Staged)->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_ConcurrentAddSpan_Direct(benchmark::State& state) {
+    static UnifiedBatchBuilder builder("bench", kItemsPerBatch, [] {
+        BatchBuilderConfig config;
+        config.direct_encoding = true;
+        return config;
+    }());
+    run_concurrent_add_span(state, builder);
+}
+BENCHMARK(BM_ConcurrentAddSpan_Direct)->ThreadRange(1, 8)->UseRealTime();
+
+}  // namespace vep::exporter::bench
@@ -0,0 +1,218 @@
+// Copyright 2025 Vehicle Edge Platform Contributors
+// SPDX-License-Identifier: Apache-2.0
+
+/// @file bench_support.cpp
+/// @brief Allocation counting, shared workloads and main for vep_exporter_bench
+
+#include "bench_support.hpp"
+
+#include <yaml-cpp/yaml.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <new>
+#include <sstream>
+
+#ifndef VEP_CONFIG_DIR
+#define VEP_CONFIG_DIR "config"
+#endif
+
+// =============================================================================
+// Allocation counting
+// =============================================================================
+
+namespace {
+std::atomic<uint64_t> g_allocations{0};
+}  // namespace
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace vep::exporter::bench {
+
+namespace {
+
+constexpr size_t kMaxCanFrames = 50000;
+
+const char* const kPaths[] = {
+    "Vehicle.Speed",
+    "Vehicle.Chassis.SteeringWheel.Angle",
+    "Vehicle.Powertrain.TractionBattery.CurrentCurrent",
+    "Vehicle.Chassis.Axle.Row1.Wheel.Left.Speed",
+    "Vehicle.Chassis.Axle.Row1.Wheel.Right.Speed",
+};
+
+struct CanMapping {
+    const std::string* path;
+    vep_VssValueType type;
+    size_t byte_offset;  // Two bytes of the frame, little endian
+};
+
+vep_VssValueType value_type(const std::string& datatype) {
+    if (datatype == "boolean") return vep_VSS_VALUE_TYPE_BOOL;
+    if (datatype == "int8") return vep_VSS_VALUE_TYPE_INT8;
+    if (datatype == "int16") return vep_VSS_VALUE_TYPE_INT16;
+    if (datatype == "int32") return vep_VSS_VALUE_TYPE_INT32;
+    if (datatype == "uint8") return vep_VSS_VALUE_TYPE_UINT8;
+    if (datatype == "uint16") return vep_VSS_VALUE_TYPE_UINT16;
+    if (datatype == "uint32") return vep_VSS_VALUE_TYPE_UINT32;
+    if (datatype == "double") return vep_VSS_VALUE_TYPE_DOUBLE;
+    return vep_VSS_VALUE_TYPE_FLOAT;
+}
+
+void set_value(vep_VssValue& value, uint16_t raw) {
+    switch (value.type) {
+        case vep_VSS_VALUE_TYPE_BOOL: value.bool_value = raw & 1; break;
+        case vep_VSS_VALUE_TYPE_INT8: value.int8_value = static_cast<uint8_t>(raw); break;
+        case vep_VSS_VALUE_TYPE_INT16: value.int16_value = static_cast<int16_t>(raw); break;
+        case vep_VSS_VALUE_TYPE_INT32: value.int32_value = static_cast<int16_t>(raw); break;
+        case vep_VSS_VALUE_TYPE_UINT8: value.uint8_value = static_cast<uint8_t>(raw); break;
+        case vep_VSS_VALUE_TYPE_UINT16: value.uint16_value = raw; break;
+        case vep_VSS_VALUE_TYPE_UINT32: value.uint32_value = raw; break;
+        case vep_VSS_VALUE_TYPE_DOUBLE: value.double_value = raw * 0.01; break;
+        default: value.float_value = static_cast<float>(raw) * 0.01f; break;
+    }
+}
+
+/// Mapped signals per CAN id, from "ID<hex id><message>.<signal>" names
+std::map<uint32_t, std::vector<CanMapping>> load_mappings(const std::string& file,
+                                                          CanWorkload& workload) {
+    std::map<uint32_t, std::vector<CanMapping>> frames;
+    YAML::Node root = YAML::LoadFile(file);
+    for (const auto& mapping : root["mappings"]) {
+        const auto& source = mapping["source"];
+        if (!source || source["type"].as<std::string>("") != "dbc") {
+            continue;
+        }
+        std::string name = source["name"].as<std::string>("");
+        if (name.size() < 5 || name.compare(0, 2, "ID") != 0) {
+            continue;
+        }
+        // Standard 11-bit ids: three hex digits
+        uint32_t can_id = static_cast<uint32_t>(std::stoul(name.substr(2, 3), nullptr, 16));
+        auto& signals = frames[can_id];
+        workload.paths.push_back(mapping["signal"].as<std::string>());
+        signals.push_back({&workload.paths.back(),
+                           value_type(mapping["datatype"].as<std::string>("float")),
+                           (signals.size() * 2) % 7});
+    }
+    return frames;
+}
+
+CanWorkload load_can_workload() {
+    CanWorkload workload;
+    std::string dir = VEP_CONFIG_DIR;
+    std::map<uint32_t, std::vector<CanMapping>> frames;
+    try {
+        frames = load_mappings(dir + "/model3_mappings_dag.yaml", workload);
+    } catch (const std::exception& e) {
+        workload.error = dir + "/model3_mappings_dag.yaml: " + e.what();
+        return workload;
+    }
+
+    std::ifstream log(dir + "/candump.log");
+    if (!log) {
+        workload.error = "Cannot open " + dir + "/candump.log";
+        return workload;
+    }
+    // "(1597242902.648455) elmcan 266#0000012000009401"
+    std::string line;
+    for (size_t count = 0; count < kMaxCanFrames && std::getline(log, line); ++count) {
+        std::istringstream in(line);
+        std::string time, interface, frame;
+        if (!(in >> time >> interface >> frame) || time.size() < 3) {
+            continue;
+        }
+        size_t hash = frame.find('#');
+        if (hash == std::string::npos) {
+            continue;
+        }
+        auto it = frames.find(static_cast<uint32_t>(std::stoul(frame.substr(0, hash), nullptr, 16)));
+        if (it == frames.end()) {
+            continue;
+        }
+        uint8_t data[8] = {};
+        std::string hex = frame.substr(hash + 1);
+        for (size_t i = 0; i < 8 && 2 * i + 1 < hex.size(); ++i) {
+            data[i] = static_cast<uint8_t>(std::stoul(hex.substr(2 * i, 2), nullptr, 16));
+        }
+        int64_t timestamp_ns = static_cast<int64_t>(
+            std::stod(time.substr(1, time.size() - 2)) * 1e9);
+
+        for (const auto& mapping : it->second) {
+            vep_VssSignal signal = {};
+            signal.path = const_cast<char*>(mapping.path->c_str());
+            signal.header.source_id = const_cast<char*>("vep_can_simulator");
+            signal.header.timestamp_ns = timestamp_ns;
+            signal.header.correlation_id = const_cast<char*>("");
+            signal.quality = vep_VSS_QUALITY_VALID;
+            signal.value.type = mapping.type;
+            set_value(signal.value, static_cast<uint16_t>(
+                data[mapping.byte_offset] | data[mapping.byte_offset + 1] << 8));
+            workload.signals.push_back(signal);
+        }
+    }
+    if (workload.signals.empty()) {
+        workload.error = "No mapped frames in " + dir + "/candump.log";
+    }
+    return workload;
+}
+
+}  // namespace
+
+ItemCounters::ItemCounters()
+    : allocations_(g_allocations.load(std::memory_order_relaxed)),
+      start_(std::chrono::steady_clock::now()) {}
+
+void ItemCounters::report(benchmark::State& state, int64_t items_per_iteration,
+                          size_t bytes_per_iteration) const {
+    auto elapsed = std::chrono::steady_clock::now() - start_;
+    uint64_t allocs = g_allocations.load(std::memory_order_relaxed) - allocations_;
+    int64_t items = state.iterations() * items_per_iteration;
+    state.SetItemsProcessed(items);
+    if (items == 0) {
+        return;
+    }
+
+    // Every thread sees the items and allocations of all threads
+    double n = static_cast<double>(items) * state.threads();
+    double ns = static_cast<double>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    state.counters["ns/item"] = benchmark::Counter(ns / n, benchmark::Counter::kAvgThreads);
+    state.counters["bytes/item"] = benchmark::Counter(
+        static_cast<double>(bytes_per_iteration) / static_cast<double>(items_per_iteration),
+        benchmark::Counter::kAvgThreads);
+    state.counters["allocs/item"] = benchmark::Counter(
+        static_cast<double>(allocs) / n, benchmark::Counter::kAvgThreads);
+}
+
+vep_VssSignal make_signal(int i) {
+    vep_VssSignal signal = {};
+    signal.path = const_cast<char*>(kPaths[i % 5]);
+    signal.header.source_id = const_cast<char*>("bench");
+    signal.header.timestamp_ns = 1700000000000000000LL + i * 10000000LL;
+    signal.header.correlation_id = const_cast<char*>("");
+    signal.quality = vep_VSS_QUALITY_VALID;
+    signal.value.type = vep_VSS_VALUE_TYPE_DOUBLE;
+    signal.value.double_value = 12.5 + i;
+    return signal;
+}
+
+const CanWorkload& can_workload() {
+    static const CanWorkload workload = load_can_workload();
+    return workload;
+}
+
+}  // namespace vep::exporter::bench
+
+BENCHMARK_MAIN();
@@ -0,0 +1,71 @@
+// Copyright 2025 Vehicle Edge Platform Contributors
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+/// @file bench_support.hpp
+/// @brief Shared workloads and counters for vep_exporter_bench
+///
+/// Every benchmark reports the same per-item counters so runs can be
+/// compared across components:
+///   items/s      - throughput (google-benchmark items_per_second)
+///   ns/item      - wall time per item
+///   bytes/item   - encoded (or compressed) output per item
+///   allocs/item  - operator new calls per item, counted process-wide
+///
+/// Workloads are synthetic signals plus a replay of config/candump.log
+/// through the CAN frames that config/model3_mappings_dag.yaml maps.
+
+#include "vss-signal.h"
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace vep::exporter::bench {
+
+/// Items added per batch by the builder benchmarks
+constexpr int kItemsPerBatch = 100;
+
+/// Allocations and wall time of a benchmark loop, reported per item
+///
+/// Construct right before the loop. Allocations are counted process-wide;
+/// in multi-threaded benchmarks the counters cover all threads' items.
+class ItemCounters {
+public:
+    ItemCounters();
+
+    /// Set items/s, ns/item, bytes/item and allocs/item
+    /// @param items_per_iteration Items handled by one benchmark iteration
+    /// @param bytes_per_iteration Output bytes of one iteration
+    void report(benchmark::State& state, int64_t items_per_iteration,
+                size_t bytes_per_iteration) const;
+
+private:
+    uint64_t allocations_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+/// Synthetic double signal on one of five paths
+vep_VssSignal make_signal(int i);
+
+/// VSS signals replayed from a CAN recording
+struct CanWorkload {
+    std::vector<vep_VssSignal> signals;
+    std::deque<std::string> paths;  // Storage for signal paths
+    std::string error;              // Why signals is empty
+};
+
+/// Signals for the candump.log frames with a mapping, loaded once
+///
+/// No DBC decoding: each mapped signal takes its value from two bytes of
+/// its frame, so values change with the recording but are not physical.
+/// The recording is capped at 50000 frames.
+const CanWorkload& can_workload();
+
+}  // namespace vep::exporter::bench
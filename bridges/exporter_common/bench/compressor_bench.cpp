@@ -0,0 +1,92 @@
+// Copyright 2025 Vehicle Edge Platform Contributors
+// SPDX-License-Identifier: Apache-2.0
+
+/// @file compressor_bench.cpp
+/// @brief ZstdCompressor cost per item across levels
+///
+/// Compresses batches of recorded CAN signals (plain and column-blocked)
+/// into a reused buffer. bytes/item is the compressed size, so the level
+/// trade-off reads directly as ns/item against bytes/item.
+
+#include "batch_builder.hpp"
+#include "bench_support.hpp"
+#include "compressor.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+namespace vep::exporter::bench {
+
+namespace {
+
+constexpr size_t kBatches = 20;
+
+/// kBatches batches of kItemsPerBatch recorded signals
+std::vector<std::vector<uint8_t>> build_candump_batches(bool signal_blocks) {
+    std::vector<std::vector<uint8_t>> batches;
+    BatchBuilderConfig config;
+    config.direct_encoding = true;
+    config.intern_paths = signal_blocks;
+    config.signal_blocks = signal_blocks;
+    UnifiedBatchBuilder builder("bench", kItemsPerBatch, config);
+    for (const auto& signal : can_workload().signals) {
+        builder.add(signal);
+        if (builder.full()) {
+            batches.push_back(builder.build());
+            if (batches.size() == kBatches) {
+                break;
+            }
+        }
+    }
+    return batches;
+}
+
+const std::vector<std::vector<uint8_t>>& candump_batches(bool signal_blocks) {
+    static const auto plain = build_candump_batches(false);
+    static const auto blocks = build_candump_batches(true);
+    return signal_blocks ? blocks : plain;
+}
+
+void run_zstd(benchmark::State& state, bool signal_blocks) {
+    if (can_workload().signals.empty()) {
+        state.SkipWithError(can_workload().error.c_str());
+        return;
+    }
+    const auto& batches = candump_batches(signal_blocks);
+    ZstdCompressor compressor(static_cast<int>(state.range(0)));
+    if (!compressor.init()) {
+        state.SkipWithError("Zstd init failed");
+        return;
+    }
+
+    std::vector<uint8_t> out;
+    size_t bytes = 0;
+    for (const auto& batch : batches) {
+        compressor.compress_into(batch, out);
+        bytes += out.size();
+    }
+
+    ItemCounters counters;
+    for (auto _ : state) {
+        for (const auto& batch : batches) {
+            compressor.compress_into(batch, out);
+            benchmark::DoNotOptimize(out.data());
+        }
+    }
+    counters.report(state, static_cast<int64_t>(batches.size()) * kItemsPerBatch, bytes);
+}
+
+}  // namespace
+
+static void BM_Zstd_Candump(benchmark::State& state) {
+    run_zstd(state, false);
+}
+BENCHMARK(BM_Zstd_Candump)->Arg(-5)->Arg(1)->Arg(3)->Arg(9)->Arg(19);
+
+static void BM_Zstd_CandumpSignalBlocks(benchmark::State& state) {
+    run_zstd(state, true);
+}
+BENCHMARK(BM_Zstd_CandumpSignalBlocks)->Arg(-5)->Arg(1)->Arg(3)->Arg(9)->Arg(19);
+
+}  // namespace vep::exporter::bench
@@ -0,0 +1,162 @@
+// Copyright 2025 Vehicle Edge Platform Contributors
+// SPDX-License-Identifier: Apache-2.0
+
+/// @file wire_codec_bench.cpp
+/// @brief Signal encoding and TransferBatch decoding per item
+///
+/// EncodeSignal converts one DDS signal into a reused protobuf Signal, the
+/// per-item step of the heap-staged builder. DecodeBatch measures the
+/// receiver side on whole batches: synthetic and recorded CAN signals, as
+/// plain and as interned, column-blocked batches.
+
+#include "batch_builder.hpp"
+#include "bench_support.hpp"
+#include "wire_decoder.hpp"
+#include "wire_encoder.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+namespace vep::exporter::bench {
+
+namespace {
+
+template<typename Seq>
+void set_sequence(Seq& seq, decltype(Seq::_buffer) buffer, uint32_t length) {
+    seq._maximum = length;
+    seq._length = length;
+    seq._buffer = buffer;
+    seq._release = false;
+}
+
+void run_encode(benchmark::State& state, const vep_VssSignal& signal) {
+    vep::transfer::Signal pb_signal;
+    encode_vss_signal(signal, &pb_signal, 1700000000000);
+
+    ItemCounters counters;
+    for (auto _ : state) {
+        pb_signal.Clear();
+        encode_vss_signal(signal, &pb_signal, 1700000000000);
+        benchmark::DoNotOptimize(pb_signal);
+    }
+    counters.report(state, 1, pb_signal.ByteSizeLong());
+}
+
+/// Decode each batch once per iteration
+void run_decode(benchmark::State& state, const std::vector<std::vector<uint8_t>>& batches) {
+    int64_t items = 0;
+    size_t bytes = 0;
+    for (const auto& data : batches) {
+        auto decoded = decode_transfer_batch(data);
+        if (!decoded) {
+            state.SkipWithError("Batch does not decode");
+            return;
+        }
+        items += static_cast<int64_t>(decoded->items.size());
+        bytes += data.size();
+    }
+
+    ItemCounters counters;
+    for (auto _ : state) {
+        PathDictionaryCache paths;
+        for (const auto& data : batches) {
+            benchmark::DoNotOptimize(decode_transfer_batch(data, paths));
+        }
+    }
+    counters.report(state, items, bytes);
+}
+
+/// Batches of kItemsPerBatch signals
+std::vector<std::vector<uint8_t>> build_batches(const std::vector<vep_VssSignal>& signals,
+                                                const BatchBuilderConfig& config,
+                                                size_t max_batches) {
+    UnifiedBatchBuilder builder("bench", kItemsPerBatch, config);
+    std::vector<std::vector<uint8_t>> batches;
+    for (const auto& signal : signals) {
+        builder.add(signal);
+        if (builder.full()) {
+            batches.push_back(builder.build());
+            if (batches.size() == max_batches) {
+                break;
+            }
+        }
+    }
+    return batches;
+}
+
+BatchBuilderConfig compact_config() {
+    BatchBuilderConfig config;
+    config.direct_encoding = true;
+    config.intern_paths = true;
+    config.signal_blocks = true;
+    return config;
+}
+
+}  // namespace
+
+static void BM_EncodeSignal_Scalar(benchmark::State& state) {
+    run_encode(state, make_signal(0));
+}
+BENCHMARK(BM_EncodeSignal_Scalar);
+
+static void BM_EncodeSignal_Array(benchmark::State& state) {
+    double values[16];
+    for (int i = 0; i < 16; ++i) {
+        values[i] = 3.2 + 0.01 * i;  // Cell voltages
+    }
+    auto signal = make_signal(0);
+    signal.path = const_cast<char*>("Vehicle.Powertrain.TractionBattery.CellVoltage");
+    signal.value.type = vep_VSS_VALUE_TYPE_DOUBLE_ARRAY;
+    set_sequence(signal.value.double_array, values, 16);
+    run_encode(state, signal);
+}
+BENCHMARK(BM_EncodeSignal_Array);
+
+static void BM_EncodeSignal_Struct(benchmark::State& state) {
+    vep_VssStructField fields[4] = {};
+    const char* names[] = {"latitude", "longitude", "altitude", "heading"};
+    for (int i = 0; i < 4; ++i) {
+        fields[i].name = const_cast<char*>(names[i]);
+        fields[i].type = vep_VSS_VALUE_TYPE_DOUBLE;
+        fields[i].double_value = 48.1374 + i;
+    }
+    auto signal = make_signal(0);
+    signal.path = const_cast<char*>("Vehicle.CurrentLocation");
+    signal.value.type = vep_VSS_VALUE_TYPE_STRUCT;
+    signal.value.struct_value.type_name = const_cast<char*>("Types.Location");
+    set_sequence(signal.value.struct_value.fields, fields, 4);
+    run_encode(state, signal);
+}
+BENCHMARK(BM_EncodeSignal_Struct);
+
+static void BM_DecodeBatch_Synthetic(benchmark::State& state) {
+    std::vector<vep_VssSignal> signals;
+    for (int i = 0; i < kItemsPerBatch; ++i) {
+        signals.push_back(make_signal(i));
+    }
+    run_decode(state, build_batches(signals, BatchBuilderConfig{}, 1));
+}
+BENCHMARK(BM_DecodeBatch_Synthetic);
+
+static void BM_DecodeBatch_Candump(benchmark::State& state) {
+    const auto& workload = can_workload();
+    if (workload.signals.empty()) {
+        state.SkipWithError(workload.error.c_str());
+        return;
+    }
+    run_decode(state, build_batches(workload.signals, BatchBuilderConfig{}, 100));
+}
+BENCHMARK(BM_DecodeBatch_Candump);
+
+static void BM_DecodeBatch_CandumpCompact(benchmark::State& state) {
+    const auto& workload = can_workload();
+    if (workload.signals.empty()) {
+        state.SkipWithError(workload.error.c_str());
+        return;
+    }
+    run_decode(state, build_batches(workload.signals, compact_config(), 100));
+}
+BENCHMARK(BM_DecodeBatch_CandumpCompact);
+
+}  // namespace vep::exporter::bench
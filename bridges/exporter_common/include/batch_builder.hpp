@@ -10,14 +10,39 @@
 /// - Delta timestamps (base + per-message offset)
 /// - Sequence numbers for ordering
 /// - Pre-conversion of values to avoid DDS pointer issues
+/// - Optional path interning with in-band dictionary deltas
+/// - Optional log templates: constant message text interned like paths,
+///   variable tokens sent as parameters (log_template.hpp)
+/// - Optional per-batch string table for metric names, labels and log
+///   components/attributes (string_table.hpp)
+/// - Optional metric series: metrics sent as MetricSample items of an
+///   interned series, counters and histogram counts as changes
+/// - Optional arena mode: items built once, in place, on a protobuf Arena
+/// - Optional direct mode: items serialized straight from DDS structs
+/// - Optional signal blocks: samples of one path grouped into a columnar
+///   SignalBlock item (signal_block.hpp)
+/// - Double-buffered: producers fill one batch while the previous one is
+///   serialized; item storage and buffers are recycled, not reallocated
+/// - Optional hard size limit: output is split into several batches with
+///   consecutive sequence numbers, none larger than max_batch_bytes
 
+#include "lockfree_queue.hpp"
+#include "log_template.hpp"
+#include "signal_block.hpp"
+#include "string_table.hpp"
 #include "wire_encoder.hpp"
 #include "transfer.pb.h"
 
+#include <google/protobuf/arena.h>
+
 #include <atomic>
 #include <cstdint>
+#include <deque>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 namespace vep::exporter {
@@ -30,11 +55,114 @@ enum class ItemType {
     Log
 };
 
+/// Type and sample time of one batched item (latency tracking)
+struct ItemTime {
+    ItemType type;
+    int64_t timestamp_ms;  // From the DDS header
+};
+
+/// Optional encoding features for UnifiedBatchBuilder
+struct BatchBuilderConfig {
+    /// Replace Signal.path with a stable Signal.path_id and send new
+    /// dictionary entries in-band (TransferBatch.path_dictionary)
+    bool intern_paths = false;
+
+    /// Send a full dictionary snapshot every N batches so receivers that
+    /// missed a delta (or joined late) can recover. 0 = never.
+    uint32_t path_dictionary_refresh_batches = 100;
+
+    /// Maximum interned paths; further new paths are sent as strings
+    size_t path_dictionary_max_entries = 4096;
+
+    /// Send log messages as a learned template (LogEntry.template_id) plus
+    /// parameters. Templates are entries of the path dictionary, sent
+    /// in-band and refreshed with it; works with or without intern_paths.
+    bool log_templates = false;
+
+    /// Maximum learned templates (counted within path_dictionary_max_entries);
+    /// messages with further new templates are sent as strings
+    size_t log_template_max_entries = 512;
+
+    /// Send each distinct metric name, label key/value, log component and
+    /// log attribute key/value once per batch (TransferBatch.strings) and
+    /// reference it from the items. Unlike the path dictionary this needs
+    /// no receiver state. With max_batch_bytes set the table is limited to
+    /// a quarter of it; further strings are sent inline.
+    bool string_table = false;
+
+    /// Send metrics as MetricSample items of an interned series: name and
+    /// labels, and histogram bucket bounds, become path dictionary entries;
+    /// integral counters and histogram counts are sent as the change since
+    /// the series' previous sample. Works with or without intern_paths.
+    bool metric_series = false;
+
+    /// Maximum interned series and bucket schemas (counted within
+    /// path_dictionary_max_entries); further metrics are sent as Metric
+    size_t metric_series_max_entries = 1024;
+
+    /// Send absolute values every N samples of a series so receivers that
+    /// missed a batch recover (0 = only the first sample). Absolute values
+    /// are also sent after resend_path_dictionary().
+    uint32_t metric_keyframe_samples = 60;
+
+    /// Build items directly inside an arena-allocated TransferBatch instead
+    /// of staging heap-allocated items and copying them at build() time.
+    /// Item construction then happens under the builder lock.
+    bool use_arena = false;
+
+    /// Initial block owned by each of the two arena buffers; a batch that
+    /// fits is built without any arena allocations
+    size_t arena_block_bytes = 64 * 1024;
+
+    /// Serialize each item to wire bytes as it is added (direct_encoder.hpp),
+    /// skipping generated message objects entirely. Batches are the same
+    /// bytes in every mode. Takes precedence over use_arena.
+    bool direct_encoding = false;
+
+    /// Group scalar numeric/bool signals of the same path into one
+    /// SignalBlock item per batch (delta-of-delta timestamps, XOR floats).
+    /// Staged and arena modes place each block where its first sample was;
+    /// direct mode collects samples at add() and appends blocks after the
+    /// other items. Decoders expand blocks back into signals.
+    bool signal_blocks = false;
+
+    /// Paths with fewer samples in a batch are sent as Signal items
+    size_t signal_block_min_samples = 4;
+
+    /// Hard limit on a serialized batch (0 = unlimited). build() splits
+    /// larger output into several batches with consecutive sequence
+    /// numbers; a path dictionary too large for one batch is spread over
+    /// leading batches. Items that cannot fit even alone are dropped and
+    /// counted in oversized_items(). Paths longer than a quarter of the
+    /// limit are not interned.
+    size_t max_batch_bytes = 0;
+
+    /// Record the type and timestamp of every item built into a batch,
+    /// read with item_times() after each build()
+    bool track_item_times = false;
+
+    /// Written to every batch (TransferBatch.session, 0 = none) so that
+    /// receivers can tell a new run of the sender, whose ids, versions and
+    /// sequence numbers start over. UnifiedExporterPipeline picks a random
+    /// one unless set.
+    uint64_t session = 0;
+};
+
 /// Builds unified TransferBatch with interleaved items
 ///
 /// Collects all data types (signals, events, metrics, logs)
 /// in arrival order. Used for both MQTT and SOME/IP transport.
 ///
+/// In the default staged mode add() is lock-free: items are converted by
+/// the calling thread and pushed onto an MPSC list that build() drains.
+/// ready(), size(), full() and estimated_size() never lock in any mode.
+/// build() must be called from one thread at a time; producers keep adding
+/// to the next batch while it serializes.
+///
+/// With max_batch_bytes set, one build() may produce several batches: the
+/// first is returned and the rest are queued (pending_batches()) and
+/// returned by the following build() calls, before any newer items.
+///
 /// Example:
 /// @code
 ///   UnifiedBatchBuilder builder("vep_exporter", 100);
@@ -47,7 +175,13 @@ class UnifiedBatchBuilder {
 public:
     /// Create builder with source ID and max items per batch
     explicit UnifiedBatchBuilder(const std::string& source_id = "vep_exporter",
-                                  size_t max_items = 100);
+                                  size_t max_items = 100,
+                                  const BatchBuilderConfig& config = {});
+
+    ~UnifiedBatchBuilder();
+
+    UnifiedBatchBuilder(const UnifiedBatchBuilder&) = delete;
+    UnifiedBatchBuilder& operator=(const UnifiedBatchBuilder&) = delete;
 
     /// @name Add items (all types accepted)
     /// Items are stored in arrival order
@@ -60,7 +194,22 @@ public:
     void add(const vep_OtelLogEntry& msg);
     /// @}
 
-    /// Check if batch has any items
+    /// Add a log entry standing for repeat.count identical occurrences
+    void add(const vep_OtelLogEntry& msg, const LogRepeat& repeat);
+
+    /// @name Add count items of one type
+    /// Same result as add() for each, but arena and direct modes take the
+    /// lock once and staged mode publishes the items with one push
+    /// @{
+    void add(const vep_VssSignal* msgs, size_t count);
+    void add(const vep_Event* msgs, size_t count);
+    void add(const vep_OtelGauge* msgs, size_t count);
+    void add(const vep_OtelCounter* msgs, size_t count);
+    void add(const vep_OtelHistogram* msgs, size_t count);
+    void add(const vep_OtelLogEntry* msgs, size_t count);
+    /// @}
+
+    /// Check if batch has any items, or split batches are queued
     bool ready() const;
 
     /// Get current item count
@@ -73,27 +222,332 @@ public:
     /// @return Serialized TransferBatch protobuf
     std::vector<uint8_t> build();
 
-    /// Reset the builder for next batch
+    /// Build the batch and serialize into a caller-supplied buffer
+    /// @param out Resized to the serialized size; capacity is reused
+    /// @return Number of bytes written (0 if there was nothing to build)
+    size_t build_into(std::vector<uint8_t>& out);
+
+    /// Split batches waiting to be returned by build()
+    size_t pending_batches() const;
+
+    /// Items of the last build() (track_item_times), signal block samples
+    /// one by one. Items of a split batch are all listed with its first
+    /// part; build() calls returning a later part leave this empty.
+    /// build() thread only.
+    const std::vector<ItemTime>& item_times() const { return item_times_; }
+
+    /// Reset the builder for next batch (also drops queued split batches)
     void reset();
 
-    /// Get approximate serialized size (for size-based flushing)
+    /// Serialized size of the current batch's items, for size-based
+    /// flushing. Exact including framing, except that staged mode sizes
+    /// timestamp deltas against the first item added and signal block
+    /// samples count as uncompressed, log messages as untemplated, strings
+    /// as inline and series samples as full metrics. Header and dictionary
+    /// not included; the string table is in direct mode.
     size_t estimated_size() const;
 
+    /// Items dropped because they exceed max_batch_bytes on their own
+    uint64_t oversized_items() const;
+
+    /// Force the next batch to carry a full path dictionary snapshot and
+    /// absolute metric series values (e.g. after a publish failure may have
+    /// lost a delta)
+    void resend_path_dictionary();
+
+    /// Append the path dictionary entries with ids first to last (inclusive,
+    /// up to the entries assigned so far) to dict
+    void path_dictionary_entries(uint32_t first, uint32_t last,
+                                 vep::transfer::PathDictionary* dict) const;
+
+    /// Number of path dictionary entries (paths, log templates, metric
+    /// series and bucket schemas)
+    size_t path_dictionary_size() const;
+
+    /// Number of learned log templates
+    size_t log_template_count() const;
+
+    /// Number of interned metric series and bucket schemas
+    size_t metric_series_count() const;
+
 private:
+    struct AddContext;
+
+    /// Add msg within ctx (published by commit(ctx))
+    void add_to(AddContext& ctx, const vep_VssSignal& msg);
+    void add_to(AddContext& ctx, const vep_Event& msg);
+    void add_to(AddContext& ctx, const vep_OtelGauge& msg);
+    void add_to(AddContext& ctx, const vep_OtelCounter& msg);
+    void add_to(AddContext& ctx, const vep_OtelHistogram& msg);
+    void add_to(AddContext& ctx, const vep_OtelLogEntry& msg, const LogRepeat& repeat = {});
+
+    /// add_to() for each of count items, then commit()
+    template<typename T>
+    void add_span(const T* msgs, size_t count);
+
+    /// Publish the staged items of ctx and release its lock
+    void commit(AddContext& ctx);
+
+    /// Add one item; fill() populates the TransferItem payload
+    template<typename Fill>
+    void add_item(AddContext& ctx, int64_t timestamp_ms, ItemType type, Fill&& fill);
+
+    /// Add one item in direct mode; encode(out, delta) appends its bytes
+    template<typename Encode>
+    void add_direct(AddContext& ctx, int64_t timestamp_ms, ItemType type, Encode&& encode);
+
+    /// Direct mode: append the metric fill() builds as a series sample
+    /// @return false if the metric must be encoded as a Metric instead
+    template<typename Fill>
+    bool add_direct_series(std::vector<uint8_t>& out, uint32_t timestamp_delta_ms, Fill&& fill);
+
+    /// Direct mode: append a signal to its path's column
+    /// @return false if the signal must be encoded as an item instead
+    bool add_direct_sample(AddContext& ctx, int64_t timestamp_ms, const vep_VssSignal& msg);
+
+    /// Staged mode build: serialize pending items straight into out
+    size_t build_staged_into(std::vector<uint8_t>& out);
+
+    /// Arena mode build: swap arena buffers and finish the filled one
+    size_t build_arena_into(std::vector<uint8_t>& out);
+
+    /// Direct mode build: header, string table, dictionary, pre-encoded items
+    size_t build_direct_into(std::vector<uint8_t>& out);
+
+    /// Staged/arena mode: group signals into blocks, intern paths and
+    /// serialize header, string table, dictionary and items into out
+    /// @param items Items in arrival order, deltas set; replaced by the
+    ///        items actually written
+    size_t write_batch(std::vector<vep::transfer::TransferItem*>& items, int64_t base_ts,
+                       std::vector<uint8_t>& out);
+
+    /// Replace items whose column reaches signal_block_min_samples by one
+    /// SignalBlock item at the position of the column's first sample
+    void group_signal_blocks(std::vector<vep::transfer::TransferItem*>& items, int64_t base_ts);
+
+    /// Block item for column (reused storage, indexed by column position)
+    vep::transfer::TransferItem* block_item(const SignalColumn& column, int64_t base_ts);
+
+    /// Path dictionary in use (path interning, log templates or series)
+    bool interning() const {
+        return config_.intern_paths || config_.log_templates || config_.metric_series;
+    }
+
+    /// Replace the item's signal or block path with its interned id, its
+    /// log message with a template, and its metric with a series sample,
+    /// if any
+    void intern_item(vep::transfer::TransferItem& item);
+
+    /// Replace the item's metric with a sample of its series
+    /// @return false if the series cannot be interned
+    bool series_sample(vep::transfer::TransferItem& item);
+
+    /// @name Output batches (build() thread only)
+    /// @{
+
+    /// Start a batch in out: header with the next sequence number, then
+    /// the string table (write_strings_) if any
+    void begin_batch(std::vector<uint8_t>& out, int64_t base_ts);
+
+    /// Start a queued split batch and make it the current output
+    std::vector<uint8_t>& split_batch();
+
+    /// Header and string table size of the next batch
+    size_t next_header_size();
+
+    /// Enforce max_batch_bytes after an item was appended at item_start:
+    /// move it to a new batch, or drop it if it cannot fit at all
+    void finish_item(size_t item_start);
+
+    /// Append pre-framed items, splitting between them as needed
+    void append_items(const uint8_t* items, size_t size);
+
+    /// Write dict, spread over several batches if it does not fit in one
+    void write_path_dictionary(const vep::transfer::PathDictionary& dict);
+
+    /// Return a queued split batch in out
+    bool take_split_batch(std::vector<uint8_t>& out);
+    /// @}
+
+    /// Id for path, interning it if there is room (0 = send as string)
+    uint32_t intern_path(std::string_view path);
+
+    /// Template id for message with its parameters in template_params_
+    /// (0 = send the message)
+    uint32_t template_message(std::string_view message);
+
+    /// Kinds of path dictionary entries
+    enum class EntryKind { Path, LogTemplate, MetricSeries };
+
+    /// Shared by intern_path, template_message and series_sample; log
+    /// templates and series count against their own limits too
+    uint32_t intern_string(std::string_view text, EntryKind kind);
+
+    /// Dictionary delta/snapshot for a batch referencing ids up to `end`
+    /// @return false if the batch needs no dictionary
+    bool path_dictionary_update(size_t end, vep::transfer::PathDictionary* dict);
+
+    /// Append entries [from, end) of paths_ to dict; dict_mutex_ held
+    void add_dictionary_entries(size_t from, size_t end,
+                                vep::transfer::PathDictionary* dict) const;
+
     /// Pending item - stores pre-converted protobuf and timestamp
     struct PendingItem {
         int64_t timestamp_ms;
         ItemType type;
+        size_t byte_size;
         vep::transfer::TransferItem proto_item;  // Pre-built
+        PendingItem* next = nullptr;
+    };
+
+    /// Items of one add() call: arena and direct modes hold mutex_ from
+    /// the first item to commit(), staged mode links its items here and
+    /// pushes the chain onto the pending list at once
+    struct AddContext {
+        std::unique_lock<std::mutex> lock;
+        PendingItem* newest = nullptr;
+        PendingItem* oldest = nullptr;
+    };
+
+    /// Staged mode: detach the pending list, oldest item first
+    PendingItem* take_pending();
+
+    /// Staged mode item storage: recycled node, or new if the pool is dry
+    PendingItem* acquire_item();
+    void release_item(PendingItem* item);
+
+    /// Arena mode buffer: arena with an owned initial block plus the batch
+    /// being built on it. Reset (not freed) after each build.
+    struct ArenaBuffer {
+        std::unique_ptr<char[]> initial_block;
+        std::unique_ptr<google::protobuf::Arena> arena;
+        vep::transfer::TransferBatch* batch = nullptr;
     };
+    void init_arena_buffer(ArenaBuffer& buffer);
 
     std::string source_id_;
     size_t max_items_;
     std::atomic<uint32_t> sequence_{0};
-    mutable std::mutex mutex_;
-    std::vector<PendingItem> pending_;
+    BatchBuilderConfig config_;
+
+    // Staged mode: lock-free MPSC list, newest item first
+    std::atomic<PendingItem*> pending_head_{nullptr};
+
+    // Staged mode: cleared items returned by build(), reused by add()
+    BoundedMpmcQueue<PendingItem*> item_pool_;
+
+    // Item count and byte estimate for the current batch (all modes).
+    // Staged mode adds before publishing an item, so build() can subtract
+    // what it drained without going negative.
+    std::atomic<size_t> item_count_{0};
+    std::atomic<size_t> estimated_bytes_{0};
+
+    // Staged mode: timestamp of the item that started the batch, for sizing
+    // timestamp deltas before build() knows the base
+    std::atomic<int64_t> size_base_ms_{0};
+
+    // Arena and direct modes write into shared batch storage under mutex_
+    std::mutex mutex_;
     int64_t base_timestamp_ms_ = 0;
-    size_t estimated_bytes_ = 0;
+
+    // Arena mode: producers fill arena_active_ while build() finishes the other
+    ArenaBuffer arena_buffers_[2];
+    ArenaBuffer* arena_active_ = nullptr;
+
+    // Direct mode: items already framed as TransferBatch.items entries.
+    // Buffers are swapped at build() so their capacity is reused.
+    std::vector<uint8_t> direct_items_;
+    std::vector<uint8_t> direct_building_;
+
+    // Item times (track_item_times). Arena and direct modes append to
+    // times_active_ under mutex_ and build() swaps it with item_times_;
+    // staged mode fills item_times_ at build() time.
+    std::vector<ItemTime> times_active_;
+    std::vector<ItemTime> item_times_;
+
+    // String tables. Direct mode: items reference table_active_ at add()
+    // under mutex_ and build() swaps it like direct_items_. Staged and
+    // arena modes fill tables_[0] at build() time.
+    StringTable tables_[2];
+    StringTable* table_active_ = &tables_[0];
+
+    // Signal blocks. Direct mode: producers fill columns_active_ under
+    // mutex_ and build() swaps it like direct_items_. Staged and arena
+    // modes group at build() time in columns_[0].
+    SignalColumnSet columns_[2];
+    SignalColumnSet* columns_active_ = &columns_[0];
+    std::vector<vep::transfer::TransferItem> block_items_;
+    struct ColumnRef {
+        SignalColumn* column = nullptr;
+        bool first = false;  // Column's first sample: its block goes here
+    };
+    std::vector<ColumnRef> item_columns_;
+    std::vector<vep::transfer::TransferItem*> build_items_;
+    std::vector<uint8_t> column_bytes_;
+    // Direct mode: each column sample in arrival order, with the size of
+    // direct_items_ when it arrived; build() encodes blocks and rows at
+    // those points, in the order group_signal_blocks() gives them
+    struct ColumnSample {
+        const SignalColumn* column;
+        size_t index;   // In the column
+        size_t offset;  // Pre-encoded item bytes before it
+    };
+    std::vector<ColumnSample> samples_active_;
+    std::vector<ColumnSample> samples_building_;
+    struct ColumnPiece {
+        size_t offset;      // Splice point in direct_building_
+        size_t begin, end;  // Encoded bytes in column_bytes_
+    };
+    std::vector<ColumnPiece> column_pieces_;
+
+    // Output being written by build(): the caller's buffer first, then
+    // split batches queued for later build() calls
+    std::vector<uint8_t>* write_out_ = nullptr;
+    size_t write_header_end_ = 0;
+    int64_t write_base_ts_ = 0;
+    const StringTable* write_strings_ = nullptr;  // Repeated by every split batch
+    std::deque<std::vector<uint8_t>> split_batches_;  // Stable references
+    std::vector<std::vector<uint8_t>> spare_batches_;  // Recycled capacity
+    std::vector<uint8_t> header_scratch_;
+    std::atomic<size_t> split_pending_{0};
+    std::atomic<uint64_t> oversized_items_{0};
+
+    // Path interning state (build(), or add() in direct mode)
+    mutable std::mutex dict_mutex_;
+    std::deque<std::string> paths_;  // index = id - 1; stable for path_ids_ keys
+    std::unordered_map<std::string_view, uint32_t> path_ids_;
+    size_t log_templates_ = 0;
+    size_t metric_series_ = 0;
+    size_t paths_sent_ = 0;          // Entries covered by previous dictionaries
+    uint32_t dict_version_ = 0;
+    uint32_t batches_since_snapshot_ = 0;
+    bool snapshot_pending_ = true;
+
+    // template_message() scratch: used at add() under mutex_ in direct
+    // mode, by the build() thread otherwise
+    std::string template_;
+    std::vector<std::string> template_params_;
+
+    /// Sender side of a metric series: what its last sample's changes were
+    /// taken against
+    struct SeriesState {
+        uint32_t epoch = 0;       // keyframe_epoch_ the state belongs to
+        uint32_t samples = 0;     // Since the last keyframe
+        bool has_counter = false;
+        double counter = 0.0;
+        bool has_histogram = false;
+        uint32_t schema_id = 0;
+        uint64_t sample_count = 0;
+        std::vector<uint64_t> bucket_counts;
+    };
+
+    // Metric series state: used at add() under mutex_ in direct mode, by
+    // the build() thread otherwise
+    std::unordered_map<uint32_t, SeriesState> series_state_;
+    std::atomic<uint32_t> keyframe_epoch_{0};  // Bumped by resend_path_dictionary()
+    std::string series_key_;
+    vep::transfer::Metric series_metric_;
+    vep::transfer::TransferItem series_item_;  // Direct mode
 };
 
 }  // namespace vep::exporter
@@ -0,0 +1,111 @@
+// Copyright 2025 Vehicle Edge Platform Contributors
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+/// @file batch_controller.hpp
+/// @brief Adaptive batch limits for the exporter pipeline
+///
+/// Fixed batch limits fit one ingest rate: at low rates they send small
+/// batches that compress poorly, at high rates they flush far more often
+/// than needed. BatchSizeController re-derives the item limit, byte limit
+/// and flush timeout after every flush from the observed ingest rate,
+/// item size, compression ratio and flush cost.
+///
+/// Targets:
+/// - target_latency_ms: the timeout is the latency budget minus the flush
+///   cost, so batches are as large as the budget allows
+/// - target_bytes_per_sec: the timeout grows while compressed output
+///   exceeds the uplink budget (larger batches compress better and carry
+///   less per-batch overhead) and shrinks back to the configured timeout
+///   once output is well below it
+/// With both set, the latency target caps the timeout. The item and byte
+/// limits follow the timeout: about twice the items expected per
+/// interval, so they only cut batches short during bursts.
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace vep::exporter {
+
+/// Configuration for adaptive batch sizing
+struct AdaptiveBatchingConfig {
+    bool enabled = false;
+
+    /// End-to-end target: oldest item's wait plus flush cost (0 = none)
+    uint32_t target_latency_ms = 0;
+
+    /// Compressed uplink budget (0 = none)
+    uint64_t target_bytes_per_sec = 0;
+
+    /// Bounds for the item limit
+    size_t min_items = 10;
+    size_t max_items = 10000;
+
+    /// Bounds for the flush timeout
+    std::chrono::milliseconds min_timeout{50};
+    std::chrono::milliseconds max_timeout{10000};
+
+    /// Weight of the newest flush in the moving averages (0..1]
+    double smoothing = 0.25;
+};
+
+/// Batch limits in effect
+struct BatchLimits {
+    size_t max_items = 100;
+    size_t max_bytes = 64 * 1024;
+    std::chrono::milliseconds timeout{1000};
+};
+
+/// What one flush produced
+struct BatchObservation {
+    size_t items = 0;
+    size_t bytes = 0;             ///< Serialized, before compression
+    size_t compressed_bytes = 0;
+    std::chrono::microseconds interval{0};    ///< Since the previous flush
+    std::chrono::microseconds flush_time{0};  ///< Serialize, compress, publish
+};
+
+/// Derives batch limits from observed flushes
+///
+/// Not thread-safe: owned by the pipeline's flush thread.
+class BatchSizeController {
+public:
+    /// @param config Targets and bounds
+    /// @param initial Limits before the first observation. initial.timeout
+    ///        is also the floor for the byte-rate target, initial.max_bytes
+    ///        the ceiling for the byte limit (the hard batch size limit).
+    BatchSizeController(const AdaptiveBatchingConfig& config, const BatchLimits& initial);
+
+    /// Fold in a flush and recompute the limits
+    /// @return New limits
+    const BatchLimits& update(const BatchObservation& observation);
+
+    const BatchLimits& limits() const { return limits_; }
+
+    /// Smoothed ingest rate in items per second
+    double ingest_rate() const { return ingest_rate_; }
+
+    /// Smoothed compressed/uncompressed ratio
+    double compression_ratio() const { return compression_ratio_; }
+
+private:
+    /// Timeout that meets the configured targets
+    double target_timeout_ms() const;
+
+    double smooth(double average, double sample) const;
+
+    AdaptiveBatchingConfig config_;
+    BatchLimits base_;
+    BatchLimits limits_;
+    bool observed_ = false;
+
+    // Moving averages
+    double ingest_rate_ = 0.0;        // items/s
+    double item_bytes_ = 0.0;         // uncompressed bytes/item
+    double compression_ratio_ = 1.0;  // compressed/uncompressed
+    double flush_ms_ = 0.0;
+};
+
+}  // namespace vep::exporter
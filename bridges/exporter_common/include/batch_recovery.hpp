@@ -0,0 +1,145 @@
+// Copyright 2025 Vehicle Edge Platform Contributors
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+/// @file batch_recovery.hpp
+/// @brief Keeps batches decodable after a lost one
+///
+/// A path dictionary delta carries only the entries first used since the
+/// batch before. The flush stages hold up to queue_depth batches between
+/// build and publish, so by the time a batch is dropped or fails to
+/// publish, the batches behind it are already built on it: a dictionary
+/// resent by the builder only reaches batches built afterwards.
+///
+/// BatchRecovery notes what each batch adds to the dictionary as it is
+/// submitted, and what the receiver was sent as batches are published.
+/// The first batch published after a loss is rewritten in its turn to
+/// carry every entry the receiver is missing:
+///
+///   submitted:  B1 {1}   B2 {2}   B3 {3}     B4
+///   published:  B1 {1}   lost     B3 {2, 3}  B4
+///
+/// Metric series samples are the same: counters and histogram counts are
+/// sent as changes since the previous sample, and a receiver drops all
+/// series values at a sequence gap. BatchRecovery keeps each series' values
+/// as batches are submitted, and after a loss the first sample of a series
+/// published is rewritten to absolute values:
+///
+///   submitted:  B1 c=10  B2 +5    B3 +2      B4 +1
+///   published:  B1 c=10  lost     B3 c=17    B4 +1
+///
+/// A spooled batch is replayed after later batches, possibly by another
+/// run of the sender, so it is rewritten to decode on its own instead
+/// (TransferBatch.replayed).
+
+#include "batch_builder.hpp"
+#include "transfer.pb.h"
+#include "wire_decoder.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace vep::exporter {
+
+/// Rewrites batches published after a lost one (see file comment)
+///
+/// observe() is called from the flush thread; rewrite(), published() and
+/// lost() from the publisher thread, once per observed batch, in order.
+class BatchRecovery {
+public:
+    /// @param builder Builder of the batches; must outlive this object
+    /// @param config The builder's config. A batch that would grow larger
+    ///        than max_batch_bytes is published as it is, and the builder
+    ///        resends its dictionary instead. Series samples are only
+    ///        tracked with metric_series.
+    BatchRecovery(UnifiedBatchBuilder& builder, const BatchBuilderConfig& config);
+
+    /// Note a serialized batch before it is submitted
+    void observe(const std::vector<uint8_t>& batch);
+
+    /// Rewrite the next batch before it is published, if the receiver
+    /// missed dictionary entries or series values it needs
+    /// @return true if batch was changed
+    bool rewrite(std::vector<uint8_t>& batch);
+
+    /// Rewrite the next batch to decode on its own before it is spooled:
+    /// flagged replayed, with a dictionary snapshot of the entries its
+    /// items use and absolute series values. Call before lost().
+    /// @return true if batch was changed
+    bool make_self_contained(std::vector<uint8_t>& batch);
+
+    /// The next batch was published
+    void published();
+
+    /// The next batch was dropped or could not be published
+    void lost();
+
+    /// Batches rewritten so far
+    uint64_t batches_rewritten() const {
+        return batches_rewritten_.load(std::memory_order_relaxed);
+    }
+
+private:
+    using SeriesValues = PathDictionaryCache::SeriesValues;
+
+    /// Path dictionary and series of one batch
+    struct Record {
+        uint32_t base_version = 0;  // Version it applies to (0 = snapshot)
+        uint32_t version = 0;       // Version after it
+        uint32_t end = 0;           // Highest entry id defined up to it
+        std::vector<uint32_t> series;  // Series sampled in it
+        // Values before it of the series whose first sample holds changes
+        std::vector<std::pair<uint32_t, SeriesValues>> before;
+        size_t series_known = 0;  // Series sampled up to it
+    };
+
+    /// Note the metric sample of an item, if it has one
+    void observe_item(const uint8_t* data, size_t size, Record& record);
+
+    /// Append the item with its sample made absolute, if it is the first
+    /// sample of a series in pending_
+    /// @return false if the item is to be copied as it is
+    bool rewrite_item(const uint8_t* data, size_t size);
+
+    /// The next batch's record; only popped by the publisher thread
+    const Record* front() const;
+
+    /// Take the next batch's record
+    Record pop();
+
+    UnifiedBatchBuilder& builder_;
+    size_t max_batch_bytes_;
+    bool metric_series_;
+
+    mutable std::mutex mutex_;
+    std::deque<Record> records_;  // Observed, not yet published or lost
+
+    // Flush thread: the dictionary as of the last observed batch
+    uint32_t version_ = 0;
+    uint32_t end_ = 0;
+    vep::transfer::PathDictionary dict_;
+    std::unordered_map<uint32_t, SeriesValues> series_;
+    std::unordered_set<uint32_t> batch_series_;
+    vep::transfer::MetricSample sample_;
+
+    // Publisher thread: what the receiver was sent
+    uint32_t sent_version_ = 0;
+    uint32_t sent_end_ = 0;
+    bool behind_ = false;  // A batch was lost since the last publish
+    bool series_behind_ = false;  // Some series were not sent since a loss
+    std::unordered_set<uint32_t> synced_;  // Series sent since the last loss
+    std::unordered_map<uint32_t, const SeriesValues*> pending_;
+    std::vector<uint8_t> rewritten_;
+
+    std::atomic<uint64_t> batches_rewritten_{0};
+};
+
+}  // namespace vep::exporter
@@ -0,0 +1,160 @@
+// Copyright 2025 Vehicle Edge Platform Contributors
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+/// @file batch_spool.hpp
+/// @brief Durable store-and-forward spool for compressed batches
+///
+/// While the backend is unreachable (tunnels, garages) the pipeline appends
+/// compressed batches to the spool instead of dropping them, and replays
+/// them oldest-first once the transport reports it is connected again.
+///
+/// On disk the spool is a ring of fixed-size, memory-mapped segment files
+/// in one directory, so its footprint is bounded (segments × segment_bytes).
+/// When the ring is full the oldest segment is overwritten and its batches
+/// are counted as dropped.
+///
+/// Segment layout:
+///   header (64 bytes): magic, version, generation, read offset
+///   records: size, CRC32, generation, payload (padded to 8 bytes)
+///
+/// Records are validated by CRC and by the generation of their segment, so
+/// after a restart or power loss the recovery scan stops at the first torn
+/// or stale record. The scan starts at each segment's persisted read offset
+/// and touches only unreplayed bytes: it is bounded by the spool size.
+///
+/// Durability: a crash of the process loses nothing that append() accepted
+/// (the mapping is shared with the page cache). A power loss loses less
+/// than SpoolConfig::sync_bytes of the last appended batches, none with the
+/// default of 0, which writes every append to disk before returning.
+/// Replay progress is written lazily, so batches replayed shortly before
+/// a power loss may be replayed again.
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace vep::exporter {
+
+/// Configuration for the store-and-forward spool
+struct SpoolConfig {
+    bool enabled = false;
+
+    /// Directory holding the segment files (created if missing)
+    std::string directory = "/var/lib/vep/spool";
+
+    /// Size of each segment file; also the largest batch that can be spooled
+    size_t segment_bytes = 4 * 1024 * 1024;
+
+    /// Segment files in the ring (minimum 2)
+    size_t segments = 8;
+
+    /// Replay rate limit, so the backlog does not saturate the link
+    uint64_t replay_bytes_per_sec = 64 * 1024;
+
+    /// Wait after a failed replay before trying again
+    std::chrono::milliseconds retry_interval{1000};
+
+    /// Appended bytes that may wait in the page cache before the segments
+    /// are written to disk (0 = every append)
+    size_t sync_bytes = 0;
+};
+
+/// Spool statistics
+struct SpoolStats {
+    uint64_t batches_spooled = 0;    ///< Appended since open
+    uint64_t batches_replayed = 0;   ///< Consumed (pop) since open
+    uint64_t batches_dropped = 0;    ///< Overwritten before replay, or unreadable
+    uint64_t batches_recovered = 0;  ///< Unreplayed batches found by open()
+    uint64_t batches_pending = 0;    ///< Waiting for replay
+    uint64_t bytes_pending = 0;
+};
+
+/// Segment-based ring file of batches, oldest first
+///
+/// Thread-safe: appends (publisher thread) and replay (replay thread) may
+/// run concurrently.
+class BatchSpool {
+public:
+    /// Where peek() found a batch: a segment, its generation and the
+    /// record offset
+    struct Position {
+        size_t segment = 0;
+        uint64_t generation = 0;
+        size_t offset = 0;
+    };
+
+    /// Open or create the spool in config.directory and recover unreplayed
+    /// batches
+    /// @return Spool, or nullptr if the directory or segment files cannot
+    ///         be created or mapped (logged)
+    static std::unique_ptr<BatchSpool> open(const SpoolConfig& config);
+
+    /// Smallest SpoolConfig::segment_bytes that holds a batch of batch_bytes
+    static size_t segment_bytes_for(size_t batch_bytes);
+
+    ~BatchSpool();
+
+    BatchSpool(const BatchSpool&) = delete;
+    BatchSpool& operator=(const BatchSpool&) = delete;
+
+    /// Append a batch; overwrites the oldest segment when the ring is full
+    /// @return false if the batch is larger than a segment can hold
+    bool append(const uint8_t* data, size_t size);
+
+    /// Copy the oldest batch into out (capacity reused)
+    /// @param at Set to where the batch was found, for pop()
+    /// @return false if the spool is empty
+    bool peek(std::vector<uint8_t>& out, Position& at);
+
+    /// Remove a peeked batch (after it was delivered). Does nothing if it
+    /// is no longer the oldest: an append overwrote its segment meanwhile,
+    /// or it was removed already.
+    void pop(const Position& at);
+
+    /// True if nothing waits for replay
+    bool empty() const;
+
+    /// Flush mapped segments to disk
+    void sync();
+
+    SpoolStats stats() const;
+
+private:
+    struct Segment {
+        int fd = -1;
+        uint8_t* data = nullptr;
+        uint64_t generation = 0;  // 0 = never written
+        size_t read_offset = 0;
+        size_t write_offset = 0;
+        uint64_t pending = 0;     // Records between read and write offset
+        bool sealed = false;      // Torn tail found by recovery: no appends
+        bool dirty = false;       // Appended to since the last sync
+    };
+
+    explicit BatchSpool(const SpoolConfig& config);
+
+    bool open_segment(size_t index);
+    void recover(Segment& segment);
+    void reset(Segment& segment, uint64_t generation);
+    void persist_read_offset(Segment& segment);
+    void sync_appends();
+    Segment* oldest();
+    bool read_record(const Segment& segment, size_t offset, size_t& size) const;
+
+    SpoolConfig config_;
+    std::vector<Segment> segments_;
+    size_t write_index_ = 0;  // Segment being appended to
+    uint64_t generation_ = 0;  // Highest in use
+    size_t unsynced_bytes_ = 0;  // Appended since the last sync
+
+    mutable std::mutex mutex_;
+    SpoolStats stats_;
+};
+
+}  // namespace vep::exporter
@@ -6,10 +6,22 @@
 /// @file compressor.hpp
 /// @brief Compression/decompression abstraction for exporter pipelines
 ///
-/// Provides pluggable compression strategies (zstd, none, etc.)
+/// Provides pluggable compression strategies (zstd, lz4, none, auto)
 /// Used by exporters (compression) and receivers (decompression)
+///
+/// Payloads are self-describing: zstd and LZ4 output are standard frames
+/// starting with their magic number, and a serialized TransferBatch never
+/// starts with either. Receivers use detect_compressor_type() or an AUTO
+/// decompressor and need no out-of-band codec setting, even when the
+/// exporter switches codecs between batches (CompressorType::AUTO).
+///
+/// zstd can use a dictionary trained on captured batches (see
+/// train_zstd_dictionary() and tools/vep_zstd_dict_trainer). Frames
+/// compressed with one carry its id in the frame header; the receiver
+/// registers the same dictionary with ZstdDecompressor::add_dictionary().
 
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <optional>
 #include <string>
@@ -20,24 +32,41 @@ struct ZSTD_CCtx_s;
 typedef struct ZSTD_CCtx_s ZSTD_CCtx;
 struct ZSTD_DCtx_s;
 typedef struct ZSTD_DCtx_s ZSTD_DCtx;
+struct ZSTD_CDict_s;
+typedef struct ZSTD_CDict_s ZSTD_CDict;
+struct ZSTD_DDict_s;
+typedef struct ZSTD_DDict_s ZSTD_DDict;
+struct LZ4F_cctx_s;
+typedef struct LZ4F_cctx_s LZ4F_cctx;
+struct LZ4F_dctx_s;
+typedef struct LZ4F_dctx_s LZ4F_dctx;
 
 namespace vep::exporter {
 
 /// Supported compressor types
 enum class CompressorType {
     NONE,   ///< No compression (passthrough)
-    ZSTD    ///< Zstandard compression
+    ZSTD,   ///< Zstandard compression (negative levels: fast modes)
+    LZ4,    ///< LZ4 frame compression (cheapest CPU per byte)
+    AUTO    ///< Picks LZ4 or a zstd level per batch to fit a CPU budget
 };
 
 /// Convert CompressorType to string
-/// @return "none" or "zstd"
+/// @return "none", "zstd", "lz4" or "auto"
 const char* to_string(CompressorType type);
 
 /// Parse CompressorType from string
-/// @param name Compressor name (case-insensitive: "zstd", "ZSTD", "none", "NONE")
+/// @param name Compressor name (case-insensitive: "zstd", "lz4", "auto", "none")
 /// @return CompressorType if valid, nullopt if unknown
 std::optional<CompressorType> compressor_type_from_string(const std::string& name);
 
+/// Default level for a compressor type (zstd and auto: 3, lz4: 0)
+int default_compression_level(CompressorType type);
+
+/// Codec of a payload, from the frame magic number
+/// @return ZSTD or LZ4 for their frames, NONE otherwise (uncompressed)
+CompressorType detect_compressor_type(const uint8_t* data, size_t size);
+
 /// Compression statistics
 struct CompressionStats {
     uint64_t bytes_before = 0;
@@ -66,9 +95,31 @@ public:
     /// @return Compressed data (may be larger if incompressible)
     virtual std::vector<uint8_t> compress(const std::vector<uint8_t>& data) = 0;
 
+    /// Compress into a caller-owned (e.g. pooled) buffer, reusing its
+    /// capacity; out is resized to the compressed size
+    /// Default: assigns compress(data)
+    virtual void compress_into(const std::vector<uint8_t>& data, std::vector<uint8_t>& out) {
+        out = compress(data);
+    }
+
+    /// True if output always equals input: callers may send the input
+    /// buffer itself and skip compress()
+    virtual bool passthrough() const { return false; }
+
     /// Get compression statistics
     virtual CompressionStats stats() const = 0;
 
+    /// Largest output compress() can produce for input_size bytes
+    virtual size_t max_compressed_size(size_t input_size) const { return input_size; }
+
+    /// Largest input whose worst-case output fits in output_limit bytes
+    size_t max_input_size(size_t output_limit) const;
+
+    /// New initialized compressor with the same settings and its own
+    /// context, for compressing on another thread
+    /// @return nullptr if not supported
+    virtual std::unique_ptr<Compressor> clone() const { return nullptr; }
+
     /// Get compressor type
     virtual CompressorType type() const = 0;
 
@@ -80,8 +131,10 @@ public:
 class ZstdCompressor : public Compressor {
 public:
     /// Create a ZSTD compressor
-    /// @param level Compression level (1-19, default 3)
-    explicit ZstdCompressor(int level = 3);
+    /// @param level Compression level (1-19, default 3); negative levels
+    ///        (down to ZSTD_minCLevel()) trade ratio for speed
+    /// @param dictionary Trained dictionary (empty = none)
+    explicit ZstdCompressor(int level = 3, std::vector<uint8_t> dictionary = {});
     ~ZstdCompressor() override;
 
     ZstdCompressor(const ZstdCompressor&) = delete;
@@ -89,12 +142,21 @@ public:
 
     bool init() override;
     std::vector<uint8_t> compress(const std::vector<uint8_t>& data) override;
+    void compress_into(const std::vector<uint8_t>& data, std::vector<uint8_t>& out) override;
     CompressionStats stats() const override;
+    size_t max_compressed_size(size_t input_size) const override;
+    std::unique_ptr<Compressor> clone() const override;
     CompressorType type() const override { return CompressorType::ZSTD; }
 
+    /// Id written to each frame (0 = no dictionary)
+    uint32_t dictionary_id() const { return dictionary_id_; }
+
 private:
     int level_;
     ZSTD_CCtx* ctx_ = nullptr;
+    std::vector<uint8_t> dictionary_;    // Until init() digests it
+    std::shared_ptr<ZSTD_CDict> cdict_;  // Read-only, shared with clones
+    uint32_t dictionary_id_ = 0;
     mutable CompressionStats stats_;
 };
 
@@ -110,18 +172,153 @@ public:
         return data;
     }
 
+    void compress_into(const std::vector<uint8_t>& data, std::vector<uint8_t>& out) override {
+        stats_.bytes_before += data.size();
+        stats_.bytes_after += data.size();
+        stats_.operations++;
+        out.assign(data.begin(), data.end());
+    }
+
+    bool passthrough() const override { return true; }
+
     CompressionStats stats() const override { return stats_; }
+    std::unique_ptr<Compressor> clone() const override { return std::make_unique<NoCompressor>(); }
     CompressorType type() const override { return CompressorType::NONE; }
 
 private:
     mutable CompressionStats stats_;
 };
 
+/// LZ4 compressor implementation (LZ4 frame format)
+///
+/// Several times cheaper per byte than zstd, at a lower ratio: for cores
+/// where compression CPU matters more than bandwidth.
+class Lz4Compressor : public Compressor {
+public:
+    /// Create an LZ4 compressor
+    /// @param level 0 = default fast mode, negative = faster (acceleration),
+    ///        3-12 = LZ4HC (slower, better ratio)
+    explicit Lz4Compressor(int level = 0);
+    ~Lz4Compressor() override;
+
+    Lz4Compressor(const Lz4Compressor&) = delete;
+    Lz4Compressor& operator=(const Lz4Compressor&) = delete;
+
+    bool init() override;
+    std::vector<uint8_t> compress(const std::vector<uint8_t>& data) override;
+    void compress_into(const std::vector<uint8_t>& data, std::vector<uint8_t>& out) override;
+    CompressionStats stats() const override { return stats_; }
+    size_t max_compressed_size(size_t input_size) const override;
+    std::unique_ptr<Compressor> clone() const override;
+    CompressorType type() const override { return CompressorType::LZ4; }
+
+private:
+    int level_;
+    LZ4F_cctx* ctx_ = nullptr;
+    mutable CompressionStats stats_;
+};
+
+/// Configuration for automatic codec selection
+struct AutoCompressionConfig {
+    /// CPU budget: compression time per input byte, in nanoseconds
+    double max_ns_per_byte = 10.0;
+
+    /// Strongest zstd level tried (the start level)
+    int max_level = 3;
+
+    /// Batches at one level before trying the next stronger one
+    size_t probe_interval = 32;
+
+    /// EWMA weight of each batch's cost and ratio (0-1]
+    double smoothing = 0.25;
+};
+
+/// Compressor that switches codec and level to stay within a CPU budget
+///
+/// Levels, fastest first: lz4, zstd -5, zstd -1, zstd 1, zstd max_level.
+/// Each batch's thread CPU time per byte and ratio are averaged per level.
+/// Over budget, it steps one level faster; a stronger level that does
+/// not improve the ratio by at least 3% is left again. Every
+/// probe_interval batches it tries the next stronger level, so it climbs
+/// back when input or load gets cheaper (a failed probe costs one batch
+/// over budget).
+///
+/// Frames are plain zstd or LZ4 frames; receivers tell them apart by
+/// magic (see detect_compressor_type()). Clones adapt independently.
+class AutoCompressor : public Compressor {
+public:
+    /// @param dictionary ZSTD dictionary for the zstd levels (empty = none)
+    explicit AutoCompressor(const AutoCompressionConfig& config = {},
+                            std::vector<uint8_t> dictionary = {});
+
+    bool init() override;
+    std::vector<uint8_t> compress(const std::vector<uint8_t>& data) override;
+    void compress_into(const std::vector<uint8_t>& data, std::vector<uint8_t>& out) override;
+    CompressionStats stats() const override { return stats_; }
+    size_t max_compressed_size(size_t input_size) const override;
+    std::unique_ptr<Compressor> clone() const override;
+    CompressorType type() const override { return CompressorType::AUTO; }
+
+    /// Change the CPU budget, e.g. when the core is throttled (call from
+    /// the compressing thread)
+    void set_max_ns_per_byte(double max_ns_per_byte) { config_.max_ns_per_byte = max_ns_per_byte; }
+
+    /// Codec and level the next batch uses (call from the compressing thread)
+    CompressorType current_type() const;
+    int current_level() const;
+
+private:
+    struct Level {
+        std::unique_ptr<Compressor> compressor;
+        int level = 0;
+        double ns_per_byte = 0.0;
+        double ratio = 0.0;  // compressed/uncompressed
+        bool measured = false;
+    };
+
+    void observe(Level& level, int64_t cpu_ns, size_t input_size, size_t output_size);
+    void select();
+
+    AutoCompressionConfig config_;
+    std::vector<uint8_t> dictionary_;  // Until init() hands it to the zstd levels
+    std::vector<Level> levels_;        // Fastest first
+    size_t current_ = 0;
+    size_t batches_at_current_ = 0;
+    mutable CompressionStats stats_;
+};
+
 /// Factory function to create compressor by type
 /// @param type Compressor type
-/// @param level Compression level (for ZSTD, 1-19, default 3)
-/// @return Compressor instance
-std::unique_ptr<Compressor> create_compressor(CompressorType type, int level = 3);
+/// @param level Compression level (ZSTD: 1-19 or negative fast levels;
+///        LZ4: see Lz4Compressor; AUTO: strongest zstd level).
+///        See default_compression_level().
+/// @param dictionary ZSTD dictionary (empty = none; used by ZSTD and AUTO)
+/// @return Compressor instance, or nullptr if initialization failed
+std::unique_ptr<Compressor> create_compressor(CompressorType type, int level = 3,
+                                              const std::vector<uint8_t>& dictionary = {});
+
+/// Create an AUTO compressor with explicit selection settings
+/// @return Compressor instance, or nullptr if initialization failed
+std::unique_ptr<Compressor> create_auto_compressor(const AutoCompressionConfig& config,
+                                                   const std::vector<uint8_t>& dictionary = {});
+
+// =============================================================================
+// ZSTD dictionaries
+// =============================================================================
+
+/// Train a zstd dictionary from sample payloads (serialized TransferBatches)
+/// @param max_size Dictionary capacity in bytes
+/// @return Dictionary with a random id, or nullopt if training failed,
+///         e.g. too few samples (logged)
+std::optional<std::vector<uint8_t>> train_zstd_dictionary(
+    const std::vector<std::vector<uint8_t>>& samples, size_t max_size = 16 * 1024);
+
+/// Read a dictionary file written by vep_zstd_dict_trainer
+/// @return Dictionary, or nullopt if unreadable or without a dictionary id (logged)
+std::optional<std::vector<uint8_t>> load_zstd_dictionary(const std::string& path);
+
+/// Id of a zstd dictionary (0 = not a trained dictionary)
+uint32_t zstd_dictionary_id(const std::vector<uint8_t>& dictionary);
 
 // =============================================================================
 // Decompression
@@ -142,6 +339,14 @@ struct DecompressionStats {
     }
 };
 
+/// Default limit on one decompressed payload
+///
+/// Exporters build batches of at most batch_max_bytes (64 KB default)
+/// before compression; the limit allows 64 times that, so a frame header
+/// claiming more (or a frame that expands further) is rejected instead of
+/// being allocated.
+constexpr size_t kDefaultMaxDecompressedSize = 64 * 64 * 1024;
+
 /// Abstract interface for decompression
 class Decompressor {
 public:
@@ -153,9 +358,14 @@ public:
 
     /// Decompress data
     /// @param data Compressed input data
-    /// @return Decompressed data, or empty vector on error
+    /// @return Decompressed data, or empty vector on error (including
+    ///         output larger than max_output_size())
     virtual std::vector<uint8_t> decompress(const std::vector<uint8_t>& data) = 0;
 
+    /// Limit the decompressed size of one payload
+    virtual void set_max_output_size(size_t max_bytes) { max_output_size_ = max_bytes; }
+    size_t max_output_size() const { return max_output_size_; }
+
     /// Get decompression statistics
     virtual DecompressionStats stats() const = 0;
 
@@ -164,6 +374,9 @@ public:
 
     /// Get decompressor name for logging
     const char* name() const { return to_string(type()); }
+
+protected:
+    size_t max_output_size_ = kDefaultMaxDecompressedSize;
 };
 
 /// ZSTD decompressor implementation
@@ -180,8 +393,14 @@ public:
     DecompressionStats stats() const override { return stats_; }
     CompressorType type() const override { return CompressorType::ZSTD; }
 
+    /// Register a dictionary; frames carrying its id are decompressed
+    /// with it. Several can be registered, e.g. across a rollout.
+    /// @return false if it has no dictionary id or cannot be loaded
+    bool add_dictionary(const std::vector<uint8_t>& dictionary);
+
 private:
     ZSTD_DCtx* ctx_ = nullptr;
+    std::map<uint32_t, ZSTD_DDict*> dictionaries_;  // By dictionary id
     mutable DecompressionStats stats_;
 };
 
@@ -204,9 +423,55 @@ private:
     mutable DecompressionStats stats_;
 };
 
+/// LZ4 frame decompressor implementation
+class Lz4Decompressor : public Decompressor {
+public:
+    Lz4Decompressor() = default;
+    ~Lz4Decompressor() override;
+
+    Lz4Decompressor(const Lz4Decompressor&) = delete;
+    Lz4Decompressor& operator=(const Lz4Decompressor&) = delete;
+
+    bool init() override;
+    std::vector<uint8_t> decompress(const std::vector<uint8_t>& data) override;
+    DecompressionStats stats() const override { return stats_; }
+    CompressorType type() const override { return CompressorType::LZ4; }
+
+private:
+    LZ4F_dctx* ctx_ = nullptr;
+    mutable DecompressionStats stats_;
+};
+
+/// Decompressor for any codec: dispatches each payload on its frame magic
+///
+/// Decodes zstd, LZ4 and uncompressed payloads, so a receiver follows an
+/// exporter that changes codec (e.g. AUTO) without configuration.
+class AutoDecompressor : public Decompressor {
+public:
+    bool init() override;
+    std::vector<uint8_t> decompress(const std::vector<uint8_t>& data) override;
+    DecompressionStats stats() const override;
+    CompressorType type() const override { return CompressorType::AUTO; }
+    void set_max_output_size(size_t max_bytes) override;
+
+    /// Register a ZSTD dictionary (see ZstdDecompressor::add_dictionary())
+    bool add_dictionary(const std::vector<uint8_t>& dictionary) {
+        return zstd_.add_dictionary(dictionary);
+    }
+
+private:
+    ZstdDecompressor zstd_;
+    Lz4Decompressor lz4_;
+    NoDecompressor none_;
+};
+
 /// Factory function to create decompressor by type
-/// @param type Decompressor type (matches CompressorType)
-/// @return Decompressor instance
-std::unique_ptr<Decompressor> create_decompressor(CompressorType type);
+/// @param type Decompressor type (matches CompressorType; AUTO decodes all)
+/// @param dictionary ZSTD dictionary to register (empty = none)
+/// @param max_output_size Largest decompressed payload accepted
+/// @return Decompressor instance, or nullptr if initialization failed
+std::unique_ptr<Decompressor> create_decompressor(
+    CompressorType type, const std::vector<uint8_t>& dictionary = {},
+    size_t max_output_size = kDefaultMaxDecompressedSize);
 
 }  // namespace vep::exporter
@@ -0,0 +1,98 @@
+// Copyright 2025 Vehicle Edge Platform Contributors
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+/// @file direct_encoder.hpp
+/// @brief Direct DDS to protobuf wire format serialization
+///
+/// Writes TransferBatch wire bytes straight from the DDS C structs into a
+/// caller-owned byte buffer, without building generated message objects.
+/// Items are written pre-framed as TransferBatch.items entries. A complete
+/// batch is the header (encode_batch_header), the optional string table and
+/// path dictionary, then the concatenated items. Each item is written as
+/// generated code serializes it (fields in number order, proto3 default
+/// values omitted, packed repeated scalars); the batch is not: the string
+/// table (field 5) precedes the dictionary (field 4), so split batches can
+/// share one preamble. The result is wire-compatible - it parses to a
+/// TransferBatch equal to the one the wire_encoder.hpp conversions build -
+/// but not byte-identical to serializing that message.
+
+#include "log_template.hpp"
+#include "string_table.hpp"
+#include "wire_encoder.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace vep::exporter {
+
+/// @name Append one framed TransferBatch.items entry to out
+/// @param timestamp_delta_ms Item offset from the batch base timestamp
+/// @param strings Batch string table for metric names, labels and log
+///        fields, or nullptr to send them inline; new strings are added
+/// @{
+
+/// @param path_id Interned path id, or 0 to send the path string
+void encode_signal_item(std::vector<uint8_t>& out, const vep_VssSignal& msg,
+                        uint32_t timestamp_delta_ms, uint32_t path_id = 0);
+void encode_event_item(std::vector<uint8_t>& out, const vep_Event& msg,
+                       uint32_t timestamp_delta_ms);
+void encode_gauge_item(std::vector<uint8_t>& out, const vep_OtelGauge& msg,
+                       uint32_t timestamp_delta_ms, StringTable* strings = nullptr);
+void encode_counter_item(std::vector<uint8_t>& out, const vep_OtelCounter& msg,
+                         uint32_t timestamp_delta_ms, StringTable* strings = nullptr);
+void encode_histogram_item(std::vector<uint8_t>& out, const vep_OtelHistogram& msg,
+                           uint32_t timestamp_delta_ms, StringTable* strings = nullptr);
+/// @param repeat Collapsed occurrences (log_dedup.hpp)
+/// @param template_id Interned message template, or 0 to send the message;
+///        params must then hold its parameters
+void encode_log_item(std::vector<uint8_t>& out, const vep_OtelLogEntry& msg,
+                     uint32_t timestamp_delta_ms, const LogRepeat& repeat = {},
+                     uint32_t template_id = 0,
+                     const std::vector<std::string>* params = nullptr,
+                     StringTable* strings = nullptr);
+/// @}
+
+/// Append an already-built generated TransferItem as a framed entry
+void encode_transfer_item(std::vector<uint8_t>& out,
+                          const vep::transfer::TransferItem& item);
+
+/// Append TransferBatch header fields (base timestamp, source, sequence,
+/// session)
+void encode_batch_header(std::vector<uint8_t>& out, int64_t base_timestamp_ms,
+                         const std::string& source_id, uint32_t sequence,
+                         uint64_t session = 0);
+
+/// Append TransferBatch.strings entries; written right after the header
+/// so split batches can repeat header and table as one preamble
+void encode_string_table(std::vector<uint8_t>& out, const StringTable& strings);
+
+/// Append TransferBatch.path_dictionary; must follow the header (and
+/// string table) and precede the items
+void encode_path_dictionary(std::vector<uint8_t>& out,
+                            const vep::transfer::PathDictionary& dict);
+
+/// Bytes a TransferBatch.items entry occupies for an item of item_bytes
+/// (field tag, length prefix, item)
+size_t framed_item_size(size_t item_bytes);
+
+/// Size of the framed items entry starting at data
+/// @return 0 if data does not start with a complete entry
+size_t next_framed_item(const uint8_t* data, size_t size);
+
+/// One field of a serialized message
+struct WireField {
+    uint32_t number = 0;
+    uint32_t wire_type = 0;
+    size_t begin = 0;    // Tag
+    size_t payload = 0;  // Value; after the length prefix if length-delimited
+    size_t end = 0;
+};
+
+/// Read the field at data[pos]
+/// @return false at the end of data, or if the field is malformed
+bool next_wire_field(const uint8_t* data, size_t size, size_t pos, WireField& field);
+
+}  // namespace vep::exporter
@@ -0,0 +1,205 @@
+// Copyright 2025 Vehicle Edge Platform Contributors
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+/// @file export_policy.hpp
+/// @brief Per-path export policy: rate limit, deadband and aggregation
+///
+/// Decides per VSS signal sample whether it is exported to the cloud.
+/// Local DDS consumers (KUKSA, probes) still see every sample; only the
+/// exporter's uplink is reduced.
+///
+/// Rules select paths with dot-separated globs compiled into a segment
+/// trie:
+/// - `Vehicle.Speed`                      exact path
+/// - `Vehicle.Chassis.Axle.*.Wheel.*.Speed`  `*` matches one segment
+/// - `Vehicle.Powertrain.**`              trailing `**` matches the rest
+/// When several rules match, the one with the longest literal prefix
+/// wins (literal segment before `*` before `**` at each level). Each path
+/// is resolved once and cached.
+///
+/// Example policy file:
+/// @code
+///   export_policy:
+///     default: forward
+///     rules:
+///       - match: "Vehicle.Chassis.Axle.*.Wheel.*.Speed"
+///         action: downsample
+///         min_interval_ms: 100
+///       - match: "Vehicle.Speed"
+///         action: deadband
+///         change_threshold: 0.5
+///         max_interval_ms: 1000
+///       - match: "Vehicle.Powertrain.TractionBattery.**"
+///         action: aggregate
+///         window_ms: 1000
+///         stats: [min, max, mean, last]
+///       - match: "Vehicle.Cabin.**"
+///         action: drop
+/// @endcode
+
+#include "wire_encoder.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace vep::exporter {
+
+/// What happens to samples of a matched path
+enum class PolicyAction {
+    Forward,     ///< Export every sample
+    Drop,        ///< Export nothing
+    Downsample,  ///< At most one sample per min_interval_ms
+    Deadband,    ///< Only samples that moved by change_threshold
+    Aggregate    ///< Per-window statistics instead of samples
+};
+
+/// Statistic emitted for an aggregation window
+enum class AggregateStat {
+    Min,
+    Max,
+    Mean,
+    Last
+};
+
+/// Convert action to string
+const char* to_string(PolicyAction action);
+
+/// Parse action from string ("forward", "drop", "downsample", "deadband", "aggregate")
+std::optional<PolicyAction> policy_action_from_string(const std::string& name);
+
+/// Convert statistic to string ("min", "max", "mean", "last")
+const char* to_string(AggregateStat stat);
+
+/// Parse statistic from string
+std::optional<AggregateStat> aggregate_stat_from_string(const std::string& name);
+
+/// One policy rule
+struct ExportRule {
+    /// Path glob (see file comment)
+    std::string match;
+
+    PolicyAction action = PolicyAction::Forward;
+
+    /// Downsample and Deadband: minimum time between exported samples
+    uint32_t min_interval_ms = 0;
+
+    /// Deadband: export anyway after this long without a sample (0 = never)
+    uint32_t max_interval_ms = 0;
+
+    /// Deadband: minimum absolute change from the last exported value
+    double change_threshold = 0.0;
+
+    /// Aggregate: window length, aligned to multiples of window_ms
+    uint32_t window_ms = 1000;
+
+    /// Aggregate: statistics emitted per window
+    std::vector<AggregateStat> stats = {AggregateStat::Min, AggregateStat::Max,
+                                        AggregateStat::Mean, AggregateStat::Last};
+};
+
+/// Configuration for ExportPolicy
+struct ExportPolicyConfig {
+    /// Action for paths no rule matches (Forward or Drop)
+    PolicyAction default_action = PolicyAction::Forward;
+
+    /// Rules; a later rule with the same glob replaces an earlier one
+    std::vector<ExportRule> rules;
+
+    /// True if the policy would forward every sample unchanged
+    bool pass_through() const {
+        return rules.empty() && default_action == PolicyAction::Forward;
+    }
+};
+
+/// Load the `export_policy` section of a YAML file
+/// @return Policy, or nullopt if the file or a rule is invalid (logged)
+std::optional<ExportPolicyConfig> load_export_policy(const std::string& yaml_path);
+
+/// Statistics for ExportPolicy
+struct ExportPolicyStats {
+    uint64_t samples_forwarded = 0;   ///< Exported as signals
+    uint64_t samples_dropped = 0;     ///< Suppressed by drop/downsample/deadband
+    uint64_t samples_aggregated = 0;  ///< Folded into an aggregation window
+    uint64_t aggregates_emitted = 0;  ///< Gauges emitted for closed windows
+};
+
+/// Applies an ExportPolicyConfig to signal samples
+///
+/// Aggregation windows close when a later sample of the same path arrives,
+/// or on flush_expired()/flush_all(). Each closed window emits one
+/// OtelGauge per configured statistic to the sink: name = VSS path,
+/// labels `aggregation` (min/max/mean/last) and `window_ms`.
+///
+/// Only scalar numeric and bool values are subject to deadband and
+/// aggregation; other values (strings, arrays, structs) fall back to
+/// min_interval_ms only. Samples whose quality is not VALID are always
+/// exported so the cloud sees the signal going invalid.
+///
+/// Thread-safe: per-path state is sharded by path hash, so concurrent
+/// DDS callbacks on different signals rarely contend.
+class ExportPolicy {
+public:
+    using AggregateSink = std::function<void(const vep_OtelGauge&)>;
+
+    /// Rules with invalid globs (`**` not last, empty segments) are logged
+    /// and skipped
+    ExportPolicy(const ExportPolicyConfig& config, AggregateSink sink);
+    ~ExportPolicy();
+
+    ExportPolicy(const ExportPolicy&) = delete;
+    ExportPolicy& operator=(const ExportPolicy&) = delete;
+
+    /// Apply the path's rule to a sample
+    /// @return true if the sample should be exported as-is
+    bool filter(const vep_VssSignal& msg);
+
+    /// Emit aggregates of windows that ended at or before now_ms
+    void flush_expired(int64_t now_ms);
+
+    /// Emit aggregates of all open windows (e.g. at shutdown)
+    void flush_all();
+
+    /// Rule for path, or nullptr if the default action applies
+    const ExportRule* match(std::string_view path) const;
+
+    ExportPolicyStats stats() const;
+
+private:
+    struct TrieNode;
+    struct PathState;
+    struct Shard;
+
+    bool add_rule(const ExportRule& rule, size_t index);
+    PathState& state_for(Shard& shard, std::string_view path);
+    bool apply(PathState& state, const vep_VssSignal& msg, int64_t ts_ms);
+    void close_window(PathState& state);
+
+    ExportPolicyConfig config_;
+    AggregateSink sink_;
+    std::unique_ptr<TrieNode> root_;
+
+    static constexpr size_t kShards = 16;
+    std::array<std::unique_ptr<Shard>, kShards> shards_;
+
+    struct Counters {
+        std::atomic<uint64_t> samples_forwarded{0};
+        std::atomic<uint64_t> samples_dropped{0};
+        std::atomic<uint64_t> samples_aggregated{0};
+        std::atomic<uint64_t> aggregates_emitted{0};
+    };
+    Counters counters_;
+};
+
+}  // namespace vep::exporter
@@ -0,0 +1,210 @@
+// Copyright 2025 Vehicle Edge Platform Contributors
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+/// @file flush_stages.hpp
+/// @brief Pipelined compress and publish stages behind the batch builder
+///
+/// Serialized batches are submitted in sequence order, compressed on a
+/// small worker pool (one compressor, and so one ZSTD context, per worker)
+/// and published by a single publisher thread in submission order. The
+/// stages are connected by a bounded window: at most queue_depth batches
+/// are between submit() and publish, so a slow publish holds the flush
+/// thread in submit() instead of queuing compressed batches without bound.
+///
+/// Batches travel as pooled vep::PayloadBuffers: the serialized buffer,
+/// the compressed buffer and the buffer the transport publishes are
+/// recycled, and with a passthrough compressor (NONE) the serialized
+/// buffer itself is published, without a copy.
+///
+/// With an overflow predicate, submit() drops the oldest batches not yet
+/// being compressed or published while the predicate is true, rather than
+/// hold the flush thread at a full window. Dropped batches are reported in
+/// order in place of their publish and leave a sequence gap.
+///
+/// Data flow:
+///   flush thread: build → submit()
+///     → compress workers (any order) → reorder → publisher thread → publish
+
+#include "compressor.hpp"
+#include "latency_histogram.hpp"
+#include "vep/payload_buffer.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vep::exporter {
+
+/// Configuration for the flush stages
+struct FlushStagesConfig {
+    /// Compression threads; 0 compresses and publishes on the submitting
+    /// thread (no pipelining)
+    size_t compress_workers = 2;
+
+    /// Batches in flight between submit() and publish (minimum 1)
+    size_t queue_depth = 4;
+};
+
+/// Compress and publish stages, in order
+///
+/// submit() and drain() are called from one thread (the pipeline's flush
+/// thread). The publish callback runs on the publisher thread, or on the
+/// submitting thread when compress_workers is 0.
+class FlushStages {
+public:
+    /// @param compressed Compressed batch; storage returns to the pool
+    ///        when the callee drops it
+    /// @param raw_size Its size before compression
+    using PublishFn = std::function<void(vep::PayloadBuffer compressed, size_t raw_size)>;
+
+    /// Called instead of PublishFn for a dropped batch, in its turn
+    /// @param raw_size Its serialized size
+    using DropFn = std::function<void(size_t raw_size)>;
+
+    /// Whether submit() should drop the oldest batch; called with the
+    /// stages' lock held
+    using OverflowFn = std::function<bool()>;
+
+    /// Called on the publisher thread before PublishFn, in the batch's
+    /// turn; may rewrite the serialized batch, which is then compressed
+    /// again
+    /// @return true if serialized was changed
+    using RewriteFn = std::function<bool(std::vector<uint8_t>& serialized)>;
+
+    /// @param compressor Used by the first worker (or inline); further
+    ///        workers use clones. Must outlive this object.
+    /// @param overflow Optional; without it submit() always waits
+    /// @param drop Optional; runs on the publisher thread
+    FlushStages(const FlushStagesConfig& config, Compressor& compressor, PublishFn publish,
+                OverflowFn overflow = nullptr, DropFn drop = nullptr);
+    ~FlushStages();
+
+    FlushStages(const FlushStages&) = delete;
+    FlushStages& operator=(const FlushStages&) = delete;
+
+    /// Keep each serialized batch until its turn and pass it to rewrite
+    /// (held in flight next to the compressed one). Call before start().
+    /// @return false if the compressor cannot be cloned for the publisher
+    bool set_rewrite(RewriteFn rewrite);
+
+    /// Rewrite the batch being published once more and compress it again;
+    /// only from PublishFn, after set_rewrite()
+    /// @param compressed The batch PublishFn was given
+    /// @return true if compressed was changed
+    bool rewrite_published(const RewriteFn& rewrite, vep::PayloadBuffer& compressed);
+
+    /// Start worker and publisher threads
+    void start();
+
+    /// Publish everything submitted, then stop the threads
+    void stop();
+
+    /// Buffer for the next serialized batch (pooled, capacity kept)
+    vep::PayloadBuffer acquire_buffer() { return pool_->acquire(); }
+
+    /// Queue a serialized batch; blocks while queue_depth batches are in
+    /// flight, unless the overflow predicate lets it drop the oldest
+    void submit(vep::PayloadBuffer batch);
+
+    /// Wait until every submitted batch is published
+    void drain();
+
+    /// Have a waiting submit() re-check the overflow predicate now, e.g.
+    /// when the caller's memory use crossed its limit
+    void check_overflow();
+
+    /// Batches submitted but not yet published or dropped
+    size_t in_flight() const;
+
+    /// Serialized and compressed bytes held by batches in flight, including
+    /// one waiting in submit(); a batch is the transport's once published
+    size_t bytes_in_flight() const { return bytes_in_flight_.load(std::memory_order_relaxed); }
+
+    /// Batches dropped by submit(), counted when dropped
+    uint64_t batches_dropped() const { return batches_dropped_.load(std::memory_order_relaxed); }
+
+    /// Compression threads actually running
+    size_t workers() const { return compressors_.size(); }
+
+    /// Time from submit() to publish complete of the last batch
+    std::chrono::microseconds last_latency() const {
+        return std::chrono::microseconds(last_latency_us_.load(std::memory_order_relaxed));
+    }
+
+    /// @name Per-batch stage times
+    /// @{
+    /// Compressing one batch
+    const LatencyHistogram& compress_latency() const { return compress_latency_; }
+    /// The publish callback
+    const LatencyHistogram& publish_latency() const { return publish_latency_; }
+    /// submit() to publish complete, including time queued
+    const LatencyHistogram& batch_latency() const { return batch_latency_; }
+    /// @}
+
+private:
+    struct Job {
+        uint64_t seq = 0;
+        vep::PayloadBuffer raw;  // Released once compressed (with rewrite_, once published)
+        vep::PayloadBuffer compressed;
+        size_t raw_size = 0;
+        size_t held = 0;  // Bytes counted in bytes_in_flight_
+        std::chrono::steady_clock::time_point submitted;
+    };
+
+    void compress(Compressor& compressor, Job& job);
+    bool window_full() const;
+    bool drop_oldest();
+    void compress_loop(Compressor* compressor);
+    void publish_loop();
+    void publish(Job& job);
+    bool rewrite_serialized(const RewriteFn& rewrite, vep::PayloadBuffer& raw,
+                            vep::PayloadBuffer& compressed);
+
+    FlushStagesConfig config_;
+    Compressor& compressor_;
+    PublishFn publish_;
+    OverflowFn overflow_;
+    DropFn drop_;
+    RewriteFn rewrite_;
+    std::unique_ptr<Compressor> rewrite_compressor_;  // Publisher's own, if workers run
+    vep::PayloadBuffer* publishing_raw_ = nullptr;  // Serialized batch during PublishFn
+    std::shared_ptr<vep::BufferPool> pool_;
+
+    // Per worker; [0] is compressor_, the rest are owned clones
+    std::vector<Compressor*> compressors_;
+    std::vector<std::unique_ptr<Compressor>> clones_;
+
+    std::vector<std::thread> workers_;
+    std::thread publisher_;
+    bool running_ = false;  // Guarded by mutex_
+
+    mutable std::mutex mutex_;
+    std::condition_variable work_cv_;   // compress_queue_ non-empty or stopping
+    std::condition_variable done_cv_;   // next batch compressed or stopping
+    std::condition_variable space_cv_;  // a batch was published
+
+    std::deque<Job> compress_queue_;
+    std::map<uint64_t, Job> compressed_;  // By seq, until its turn
+    std::map<uint64_t, size_t> dropped_;  // Raw size by seq, until its turn
+    uint64_t next_submit_ = 0;
+    uint64_t next_publish_ = 0;
+
+    std::atomic<size_t> bytes_in_flight_{0};
+    std::atomic<uint64_t> batches_dropped_{0};
+    std::atomic<int64_t> last_latency_us_{0};
+    LatencyHistogram compress_latency_;
+    LatencyHistogram publish_latency_;
+    LatencyHistogram batch_latency_;
+};
+
+}  // namespace vep::exporter
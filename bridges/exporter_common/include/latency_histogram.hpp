@@ -0,0 +1,82 @@
+// Copyright 2025 Vehicle Edge Platform Contributors
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+/// @file latency_histogram.hpp
+/// @brief Lock-free log-linear latency histogram
+///
+/// HDR-style bucketing of microsecond values: 16 linear buckets per power
+/// of two, so every percentile is reported within 6.25% of the recorded
+/// value, from 1 us up to 2^36 us (19 hours; larger values are clamped).
+/// record() is a handful of relaxed atomic adds and never allocates or
+/// locks; readers take a snapshot while writers continue.
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace vep::exporter {
+
+/// Percentiles of a LatencyHistogram, in microseconds
+struct LatencySummary {
+    uint64_t count = 0;
+    double mean_us = 0.0;
+    int64_t p50_us = 0;
+    int64_t p90_us = 0;
+    int64_t p99_us = 0;
+    int64_t p999_us = 0;
+    int64_t max_us = 0;
+};
+
+/// Latency distribution with fixed log-linear buckets
+///
+/// Thread-safe: any number of threads may record() and read concurrently.
+/// Percentiles are the upper bound of the bucket they fall in, capped at
+/// the largest recorded value.
+class LatencyHistogram {
+public:
+    LatencyHistogram();
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    /// Add one value (negative values count as 0)
+    void record(int64_t us);
+
+    /// Values recorded since construction or reset()
+    uint64_t count() const;
+
+    /// Value at quantile q (0.0 - 1.0), 0 if empty
+    int64_t percentile(double q) const;
+
+    /// Count, mean, p50/p90/p99/p99.9 and max
+    LatencySummary summary() const;
+
+    /// Values up to us, including those in the bucket holding us (for
+    /// export with coarser bounds)
+    uint64_t count_at_most(int64_t us) const;
+
+    /// Sum of recorded values
+    uint64_t sum_us() const { return sum_us_.load(std::memory_order_relaxed); }
+
+    /// Drop all values (not atomic with respect to concurrent record())
+    void reset();
+
+private:
+    static constexpr int kSubBucketBits = 4;
+    static constexpr uint64_t kSubBuckets = 1u << kSubBucketBits;
+    static constexpr int kMaxBits = 36;
+    static constexpr size_t kBuckets = kSubBuckets * (kMaxBits - kSubBucketBits + 1);
+
+    static size_t bucket_index(uint64_t us);
+    static uint64_t bucket_upper(size_t index);
+
+    std::array<std::atomic<uint64_t>, kBuckets> buckets_;
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_us_{0};
+    std::atomic<int64_t> max_us_{0};
+};
+
+}  // namespace vep::exporter
@@ -0,0 +1,120 @@
+// Copyright 2025 Vehicle Edge Platform Contributors
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+/// @file log_dedup.hpp
+/// @brief Collapse repeated log entries within a time window
+///
+/// A repeating log line (a connection error in a retry loop, a sensor
+/// timeout) must not take over the uplink. The first occurrence of an
+/// entry is exported unchanged and opens a window; further identical
+/// entries - same level, component and message - inside the window are
+/// counted instead of exported. When the window closes, one summary entry
+/// stands for all of them: LogEntry.repeat_count, with the first and last
+/// collapsed occurrence as timestamps.
+///
+/// A storm of one line therefore costs at most two entries per window,
+/// however fast it repeats. Messages that differ in their numbers are
+/// distinct entries here; BatchBuilderConfig::log_templates sends their
+/// constant text once.
+
+#include "log_template.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace vep::exporter {
+
+/// Configuration for LogDedup
+struct LogDedupConfig {
+    bool enabled = false;
+
+    /// Window opened by the first occurrence of an entry
+    uint32_t window_ms = 10000;
+
+    /// Distinct entries with an open window; entries beyond are exported
+    /// unchanged
+    size_t max_entries = 1024;
+};
+
+/// Statistics for LogDedup
+struct LogDedupStats {
+    uint64_t entries_forwarded = 0;  ///< Exported unchanged
+    uint64_t entries_collapsed = 0;  ///< Counted into a summary instead
+    uint64_t summaries_emitted = 0;  ///< Summary entries for closed windows
+};
+
+/// Windowed deduplication of log entries
+///
+/// Windows close when a later occurrence arrives after the window, or on
+/// flush_expired()/flush_all(). The summary entry carries the attributes
+/// of the first collapsed occurrence.
+///
+/// Thread-safe. The sink is called with the internal lock held and must
+/// not call back into LogDedup.
+class LogDedup {
+public:
+    using SummarySink = std::function<void(const vep_OtelLogEntry&, const LogRepeat&)>;
+
+    LogDedup(const LogDedupConfig& config, SummarySink sink);
+
+    LogDedup(const LogDedup&) = delete;
+    LogDedup& operator=(const LogDedup&) = delete;
+
+    /// Count the entry against its window
+    /// @return true if the entry should be exported as-is
+    bool filter(const vep_OtelLogEntry& msg);
+
+    /// Emit summaries of windows that ended at or before now_ms
+    void flush_expired(int64_t now_ms);
+
+    /// Emit summaries of all open windows (e.g. at shutdown)
+    void flush_all();
+
+    /// Entries with an open window
+    size_t size() const;
+
+    LogDedupStats stats() const;
+
+private:
+    struct Window {
+        int64_t end_ms = 0;
+        uint32_t repeats = 0;         // Collapsed occurrences
+        int64_t first_repeat_ms = 0;
+        int64_t last_repeat_ms = 0;
+
+        // First collapsed occurrence, owned
+        vep_OtelLogLevel level = vep_LOG_LEVEL_DEBUG;
+        std::string component;
+        std::string message;
+        std::string source_id;
+        std::vector<std::pair<std::string, std::string>> attributes;
+    };
+
+    static void capture(Window& window, const vep_OtelLogEntry& msg);
+    void emit(Window& window);
+
+    LogDedupConfig config_;
+    SummarySink sink_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Window> windows_;  // By level, component, message
+    std::string key_;                                  // Lookup scratch
+    std::vector<vep_KeyValue> attributes_;             // Summary scratch
+
+    struct Counters {
+        std::atomic<uint64_t> entries_forwarded{0};
+        std::atomic<uint64_t> entries_collapsed{0};
+        std::atomic<uint64_t> summaries_emitted{0};
+    };
+    Counters counters_;
+};
+
+}  // namespace vep::exporter
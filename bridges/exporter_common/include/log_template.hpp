@@ -0,0 +1,76 @@
+// Copyright 2025 Vehicle Edge Platform Contributors
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+/// @file log_template.hpp
+/// @brief Compact log encodings: repeat counts and message templates
+///
+/// Log storms are mostly the same few lines with changing numbers:
+///   "connect to 10.0.0.5:1883 failed (rc=7), retry in 500 ms"
+/// A template keeps the constant text and replaces every token that
+/// contains a digit by a placeholder; the tokens are sent as parameters:
+///   "connect to <*>:<*> failed (rc=<*>), retry in <*> ms"
+///   params: ["10.0.0.5", "1883", "7", "500"]
+/// Tokens are split at whitespace and at `=:,;()[]{}<>"'`, so keys such as
+/// `rc=` stay in the template. The transformation is lossless: expanding
+/// the template with its parameters gives back the original message.
+
+#include "otel-logs.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace vep::exporter {
+
+/// Placeholder for one parameter in a log template
+inline constexpr std::string_view kLogTemplateParam = "<*>";
+
+/// Identical log entries collapsed into one (LogEntry.repeat_count)
+struct LogRepeat {
+    /// Occurrences the entry stands for (1 = a single entry)
+    uint32_t count = 1;
+
+    /// Timestamp of the last occurrence (ms since epoch)
+    int64_t last_timestamp_ms = 0;
+
+    /// Offset of the last occurrence from the entry's timestamp
+    uint32_t last_delta_ms(const vep_OtelLogEntry& msg) const {
+        int64_t first_ms = msg.header.timestamp_ns / 1000000;
+        return last_timestamp_ms > first_ms ? static_cast<uint32_t>(last_timestamp_ms - first_ms) : 0;
+    }
+};
+
+/// Split a message into template and parameters (capacities reused)
+/// @return false if the message cannot be templated losslessly (it
+///         already contains the placeholder); templ and params are then
+///         unspecified
+bool extract_log_template(std::string_view message, std::string& templ,
+                          std::vector<std::string>& params);
+
+/// Rebuild a message from its template; missing parameters expand to
+/// nothing, extra ones are ignored
+template<typename Params>
+std::string expand_log_template(std::string_view templ, const Params& params) {
+    std::string message;
+    message.reserve(templ.size());
+    auto param = std::begin(params);
+    size_t pos = 0;
+    while (pos < templ.size()) {
+        size_t next = templ.find(kLogTemplateParam, pos);
+        if (next == std::string_view::npos) {
+            message.append(templ.substr(pos));
+            break;
+        }
+        message.append(templ.substr(pos, next - pos));
+        if (param != std::end(params)) {
+            message.append(*param++);
+        }
+        pos = next + kLogTemplateParam.size();
+    }
+    return message;
+}
+
+}  // namespace vep::exporter
@@ -0,0 +1,178 @@
+// Copyright 2025 Vehicle Edge Platform Contributors
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+/// @file pipeline_router.hpp
+/// @brief Routes items to several exporter pipelines (lanes)
+///
+/// Each lane is a complete UnifiedExporterPipeline with its own batching
+/// config, compressor, transport (and so content_id) and flush thread, so
+/// lanes use separate cores and a noisy producer only fills its own lane:
+///
+///   DDS callbacks → PipelineRouter ─┬→ lane "signals" (lz4, 100 ms)  → transport A
+///                                   ├→ lane "logs" (zstd 19, 10 s)   → transport B
+///                                   └→ lane "default"                → transport C
+///
+/// Lanes are matched in the order added; the first whose route accepts
+/// the item takes it. Routes select by item type and by prefix of the
+/// item's key: signal path, event category, metric name or log component.
+
+#include "unified_pipeline.hpp"
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace vep::exporter {
+
+/// Items a lane accepts: both conditions must hold
+struct LaneRoute {
+    /// Item types (empty = all)
+    std::vector<ItemType> types;
+
+    /// Key prefixes (empty = any key), e.g. "Vehicle.Powertrain."
+    std::vector<std::string> prefixes;
+};
+
+/// One lane of a PipelineRouter
+struct LaneConfig {
+    /// Name in logs and stats; unique per router
+    std::string name;
+
+    /// An empty route takes every item not taken by an earlier lane
+    LaneRoute route;
+
+    /// The lane's pipeline; source_id must be unique per router, since
+    /// receivers order batches by source and sequence
+    UnifiedPipelineConfig pipeline;
+};
+
+/// Statistics of one lane
+struct LaneStats {
+    std::string name;
+    UnifiedPipelineStats pipeline;
+};
+
+/// Statistics for the router
+struct PipelineRouterStats {
+    uint64_t items_unrouted = 0;  // Dropped: no lane accepts them
+    std::vector<LaneStats> lanes;
+};
+
+/// Item type from "signal", "event", "metric" or "log"
+std::optional<ItemType> item_type_from_string(std::string_view name);
+
+/// "signal", "event", "metric" or "log"
+const char* to_string(ItemType type);
+
+/// Sends each item to the first lane that accepts it
+///
+/// Lanes are added before start() and fixed afterwards. send() is
+/// thread-safe; routing reads the fixed lane table without locks.
+///
+/// Example:
+/// @code
+///   PipelineRouter router;
+///   LaneConfig logs;
+///   logs.name = "logs";
+///   logs.route.types = {ItemType::Log};
+///   logs.pipeline.source_id = "vep_exporter/logs";
+///   logs.pipeline.batch_timeout = std::chrono::seconds(10);
+///   router.add_lane(logs, std::move(log_transport), create_compressor(CompressorType::ZSTD, 19));
+///   LaneConfig rest;
+///   rest.name = "default";
+///   router.add_lane(rest, std::move(transport), create_compressor(CompressorType::LZ4));
+///   router.start();
+/// @endcode
+class PipelineRouter {
+public:
+    PipelineRouter() = default;
+    ~PipelineRouter();
+
+    PipelineRouter(const PipelineRouter&) = delete;
+    PipelineRouter& operator=(const PipelineRouter&) = delete;
+
+    /// Add a lane (before start())
+    /// @return false if the name or source_id is already used, or the
+    ///         router is running
+    bool add_lane(const LaneConfig& config,
+                  std::unique_ptr<vep::BackendTransport> transport,
+                  std::unique_ptr<Compressor> compressor);
+
+    /// Start every lane; if one fails, stop those already started
+    bool start();
+
+    /// Stop every lane (flushes remaining data)
+    void stop();
+
+    /// Flush every lane's pending batch
+    void flush();
+
+    /// @name Message ingestion
+    /// Thread-safe; items no lane accepts are counted and dropped.
+    /// @{
+    void send(const vep_VssSignal& msg);
+    void send(const vep_Event& msg);
+    void send(const vep_OtelGauge& msg);
+    void send(const vep_OtelCounter& msg);
+    void send(const vep_OtelHistogram& msg);
+    void send(const vep_OtelLogEntry& msg);
+    /// @}
+
+    /// @name Batched ingestion
+    /// Consecutive items bound for the same lane go to its send_batch()
+    /// together.
+    /// @{
+    void send_batch(const vep_VssSignal* msgs, size_t count);
+    void send_batch(const vep_Event* msgs, size_t count);
+    void send_batch(const vep_OtelGauge* msgs, size_t count);
+    void send_batch(const vep_OtelCounter* msgs, size_t count);
+    void send_batch(const vep_OtelHistogram* msgs, size_t count);
+    void send_batch(const vep_OtelLogEntry* msgs, size_t count);
+    /// @}
+
+    /// Number of lanes
+    size_t lanes() const { return lanes_.size(); }
+
+    /// Lane by index, in the order added
+    UnifiedExporterPipeline& lane(size_t index) { return *lanes_[index].pipeline; }
+
+    /// True if every lane is healthy (and there is at least one)
+    bool healthy() const;
+
+    /// Router and per-lane statistics
+    PipelineRouterStats stats() const;
+
+private:
+    /// A lane that may take items of one type
+    struct Candidate {
+        size_t lane;
+        std::vector<std::string> prefixes;  // Empty: any key
+    };
+
+    struct Lane {
+        std::string name;
+        std::string source_id;
+        LaneRoute route;
+        std::unique_ptr<UnifiedExporterPipeline> pipeline;
+    };
+
+    /// Pipeline for an item, null if no lane accepts it
+    UnifiedExporterPipeline* route(ItemType type, const char* key);
+
+    /// Split msgs into runs with the same lane; key(msg) is the route key
+    template<typename T, typename Key>
+    void route_batch(ItemType type, const T* msgs, size_t count, Key&& key);
+
+    std::vector<Lane> lanes_;
+    std::array<std::vector<Candidate>, 4> candidates_;  // By ItemType, in lane order
+    bool running_ = false;
+    std::atomic<uint64_t> items_unrouted_{0};
+};
+
+}  // namespace vep::exporter
@@ -0,0 +1,112 @@
+// Copyright 2025 Vehicle Edge Platform Contributors
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+/// @file signal_block.hpp
+/// @brief Columnar SignalBlock encoding for high-rate numeric signals
+///
+/// Samples of one path are gathered into a SignalColumn and written as a
+/// single SignalBlock item instead of one Signal item per sample:
+/// - Timestamps: delta-of-delta varints (0 per sample at a fixed rate)
+/// - float/double: Gorilla XOR bit stream (Pelkonen et al., VLDB 2015)
+/// - Integers: first value, then differences (modulo 2^64)
+/// - Bools: packed
+///
+/// Values are handled as raw 64-bit patterns so one column type covers all
+/// scalar numeric signals: IEEE-754 bits for float/double, two's
+/// complement (sign-extended) for signed integers, 0/1 for bools.
+
+#include "wire_encoder.hpp"
+#include "transfer.pb.h"
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace vep::exporter {
+
+/// Samples of one signal path sharing value type and quality
+struct SignalColumn {
+    std::string path;
+    vep::transfer::Signal::ValueCase value_case = vep::transfer::Signal::VALUE_NOT_SET;
+    vep::transfer::Quality quality = vep::transfer::QUALITY_NOT_AVAILABLE;
+    std::vector<int64_t> timestamps_ms;
+    std::vector<uint64_t> values;   ///< Raw value bits
+    size_t index = 0;               ///< Position in SignalColumnSet::columns()
+
+    size_t size() const { return values.size(); }
+};
+
+/// Per-path columns for one batch
+///
+/// Column storage is kept across clear(), so a steady set of paths is
+/// collected without allocating once vector capacities have grown.
+/// Not thread-safe.
+class SignalColumnSet {
+public:
+    /// @param max_paths Distinct paths tracked; samples of further paths
+    ///        are rejected (kept as rows by the caller)
+    explicit SignalColumnSet(size_t max_paths = 4096);
+
+    /// Append a sample to path's column
+    /// @return The column, or nullptr if the column already holds another
+    ///         value type or quality in this batch, or the set is full
+    SignalColumn* add(std::string_view path,
+                      vep::transfer::Signal::ValueCase value_case,
+                      vep::transfer::Quality quality,
+                      int64_t timestamp_ms, uint64_t bits);
+
+    /// Columns holding samples, in order of their first sample
+    const std::vector<SignalColumn*>& columns() const { return active_; }
+
+    bool empty() const { return active_.empty(); }
+
+    /// Drop all samples; keeps storage
+    void clear();
+
+private:
+    size_t max_paths_;
+    std::deque<SignalColumn> storage_;  // Stable addresses for by_path_ keys
+    std::unordered_map<std::string_view, SignalColumn*> by_path_;
+    std::vector<SignalColumn*> active_;
+};
+
+/// @name Raw value bits of scalar numeric and bool signals
+/// @return false for strings, arrays, structs and unset values
+/// @{
+bool signal_value_bits(const vep::transfer::Signal& signal, uint64_t* bits);
+
+/// DDS variant; value_case is the Signal field convert_value_to_signal() sets
+bool signal_value_bits(const vep_VssValue& value,
+                       vep::transfer::Signal::ValueCase* value_case, uint64_t* bits);
+/// @}
+
+/// Set signal's value from raw bits (inverse of signal_value_bits)
+void set_signal_value(vep::transfer::Signal::ValueCase value_case, uint64_t bits,
+                      vep::transfer::Signal* signal);
+
+/// Fill block with the column's path, quality, timestamps and values.
+/// The first sample's time is the enclosing TransferItem's timestamp.
+void encode_signal_block(const SignalColumn& column, vep::transfer::SignalBlock* block);
+
+/// Expand a block into absolute timestamps and raw value bits
+/// @param first_timestamp_ms Time of the enclosing TransferItem
+/// @return false if the block is malformed
+bool expand_signal_block(const vep::transfer::SignalBlock& block, int64_t first_timestamp_ms,
+                         vep::transfer::Signal::ValueCase* value_case,
+                         std::vector<int64_t>* timestamps_ms,
+                         std::vector<uint64_t>* values);
+
+/// @name Gorilla XOR bit stream
+/// @param width 64 for doubles, 32 for floats (bits in the low word)
+/// @{
+void xor_encode(const uint64_t* values, size_t count, int width, std::string* out);
+bool xor_decode(const std::string& in, size_t count, int width,
+                std::vector<uint64_t>* values);
+/// @}
+
+}  // namespace vep::exporter
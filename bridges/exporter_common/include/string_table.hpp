@@ -0,0 +1,78 @@
+// Copyright 2025 Vehicle Edge Platform Contributors
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+/// @file string_table.hpp
+/// @brief Per-batch string table for metric names, labels and log fields
+///
+/// Host and application metrics repeat the same names and label sets in
+/// every item ("service" plus the source id, "state", "device", ...). With
+/// the table each distinct string is sent once per batch in
+/// TransferBatch.strings and items reference it by 1-based index.
+///
+/// The table is rebuilt for every batch, so receivers need no state across
+/// batches and lost or reordered batches (spool replay) decode unchanged.
+
+#include "transfer.pb.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace vep::exporter {
+
+/// Strings of one batch, in first-use order
+class StringTable {
+public:
+    /// @param max_bytes Limit on the encoded table (0 = unlimited); strings
+    ///        beyond it are sent inline
+    explicit StringTable(size_t max_bytes = 0) : max_bytes_(max_bytes) {}
+
+    StringTable(const StringTable&) = delete;
+    StringTable& operator=(const StringTable&) = delete;
+
+    void set_max_bytes(size_t max_bytes) { max_bytes_ = max_bytes; }
+
+    /// 1-based reference to text, adding it if new
+    /// @return 0 if text is new and the table is full; text is then not
+    ///         added by any later call either, until clear()
+    uint32_t ref(std::string_view text);
+
+    /// Reference to text if it is in the table, else 0
+    uint32_t find(std::string_view text) const;
+
+    /// String for a reference returned by ref()
+    const std::string& at(uint32_t ref) const { return strings_[ref - 1]; }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    /// Bytes the table adds to a batch (TransferBatch.strings entries)
+    size_t encoded_bytes() const { return bytes_; }
+
+    /// Drop all strings; their storage is reused by the next batch
+    void clear();
+
+    /// Replace the item's metric name and labels, or log component and
+    /// attributes, by references
+    void reference_item(vep::transfer::TransferItem& item);
+
+private:
+    /// Refs for keys/values; strings that did not fit stay in the fields
+    void reference_pairs(google::protobuf::RepeatedPtrField<std::string>* keys,
+                         google::protobuf::RepeatedPtrField<std::string>* values,
+                         google::protobuf::RepeatedField<uint32_t>* key_refs,
+                         google::protobuf::RepeatedField<uint32_t>* value_refs);
+
+    size_t max_bytes_;
+    std::deque<std::string> strings_;  // Stable for ids_ keys; [size_, end) are spare
+    std::unordered_map<std::string_view, uint32_t> ids_;
+    size_t size_ = 0;
+    size_t bytes_ = 0;
+};
+
+}  // namespace vep::exporter
@@ -22,6 +22,7 @@
 /// Uses types from telemetry.idl (which imports vss_signal.idl from libvss-types).
 
 #include "common/dds_wrapper.hpp"
+#include "dds_reactor.hpp"
 #include "events.h"
 #include "otel-metrics.h"
 #include "otel-logs.h"
@@ -31,7 +32,6 @@
 #include <functional>
 #include <memory>
 #include <string>
-#include <thread>
 #include <vector>
 #include <atomic>
 
@@ -67,7 +67,7 @@ struct SubscriptionConfig {
  * SubscriptionManager - manages all DDS subscriptions for VEP.
  *
  * Creates readers based on configuration and dispatches callbacks
- * when data arrives.
+ * when data arrives (from a DdsReactor thread blocked on the readers).
  */
 class SubscriptionManager {
 public:
@@ -75,13 +75,14 @@ public:
                                   const SubscriptionConfig& config);
     ~SubscriptionManager();
 
-    // Start receiving data (spawns background thread)
+    // Start receiving data (spawns the reactor thread); register
+    // callbacks first, readers without one are not dispatched
     void start();
 
     // Stop receiving data
     void stop();
 
-    // Register callbacks
+    // Register callbacks; before start() only, later calls are ignored
     void on_vss_signal(VssSignalCallback callback);
     void on_event(EventCallback callback);
     void on_gauge(GaugeCallback callback);
@@ -91,11 +92,24 @@ public:
     void on_scalar_measurement(ScalarMeasurementCallback callback);
     void on_vector_measurement(VectorMeasurementCallback callback);
 
+    // Send VSS signals, events, metrics and logs to sink.send_batch(msgs,
+    // count) instead of the per-sample callbacks above, one call per run
+    // of samples taken (e.g. a UnifiedExporterPipeline or PipelineRouter).
+    // Call before start(); sink must outlive the subscriptions.
+    template<typename Sink>
+    void send_batches_to(Sink& sink);
+
 private:
-    void poll_loop();
+    // False (and logged) once started: start() has set up the readers
+    bool before_start(const char* setter) const;
 
     template<typename T, typename Callback>
-    void process_reader(dds::Reader& reader, const Callback& callback);
+    void add_reader(const char* name, const std::unique_ptr<dds::Reader>& reader,
+                    const Callback& callback);
+
+    template<typename T, typename Sink>
+    void add_batch_reader(const char* name, const std::unique_ptr<dds::Reader>& reader,
+                          Sink& sink);
 
     dds::Participant& participant_;
     SubscriptionConfig config_;
@@ -130,9 +144,38 @@ private:
     ScalarMeasurementCallback cb_scalar_measurement_;
     VectorMeasurementCallback cb_vector_measurement_;
 
-    // Polling thread
+    // Adds the batch readers to reactor_ (set by send_batches_to())
+    std::function<void()> add_batch_readers_;
+
+    // Dispatch thread
     std::atomic<bool> running_{false};
-    std::thread poll_thread_;
+    std::unique_ptr<bridge::DdsReactor> reactor_;
 };
 
+template<typename Sink>
+void SubscriptionManager::send_batches_to(Sink& sink) {
+    if (!before_start("send_batches_to()")) {
+        return;
+    }
+    add_batch_readers_ = [this, &sink]() {
+        add_batch_reader<vep_VssSignal>("vss_signals", reader_vss_signal_, sink);
+        add_batch_reader<vep_Event>("events", reader_event_, sink);
+        add_batch_reader<vep_OtelGauge>("gauges", reader_gauge_, sink);
+        add_batch_reader<vep_OtelCounter>("counters", reader_counter_, sink);
+        add_batch_reader<vep_OtelHistogram>("histograms", reader_histogram_, sink);
+        add_batch_reader<vep_OtelLogEntry>("logs", reader_log_entry_, sink);
+    };
+}
+
+template<typename T, typename Sink>
+void SubscriptionManager::add_batch_reader(const char* name,
+                                           const std::unique_ptr<dds::Reader>& reader,
+                                           Sink& sink) {
+    if (reader) {
+        reactor_->add_batch_reader<T>(name, *reader, [&sink](const T* msgs, size_t count) {
+            sink.send_batch(msgs, count);
+        });
+    }
+}
+
 }  // namespace integration
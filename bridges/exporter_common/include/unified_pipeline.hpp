@@ -14,22 +14,138 @@
 /// (e.g., SOME/IP with BE Message Proxy).
 ///
 /// Data flow:
-///   DDS messages → UnifiedBatchBuilder → compress → BackendTransport
+///   DDS messages → ExportPolicy / LogDedup → load shedding → UnifiedBatchBuilder
+///     → compress workers → publisher → BackendTransport
+///                                    ↘ BatchSpool (offline) → replay thread ↗
+///   urgent events → express builder → urgent thread ↗
+///   (queue status drives load shedding, connection status drives replay)
+///
+/// A memory budget (optional) bounds the builder and the batches in the
+/// stages; send() applies its overflow policy when they exceed it.
+///
+/// Latency tracking (optional) times every stage of this flow per batch,
+/// and each item from its DDS header timestamp to publish complete.
 
 #include "batch_builder.hpp"
+#include "batch_controller.hpp"
+#include "batch_recovery.hpp"
+#include "batch_spool.hpp"
 #include "compressor.hpp"
+#include "export_policy.hpp"
+#include "flush_stages.hpp"
+#include "latency_histogram.hpp"
+#include "log_dedup.hpp"
 #include "vep/backend_transport.hpp"
 
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <deque>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
+#include <vector>
 
 namespace vep::exporter {
 
+/// Load shedding under transport backpressure
+///
+/// Graded by the transport's QueueStatus level (on_queue_status) and
+/// queue_full(), lowest value data first:
+/// - High:     logs below WARN
+/// - Critical: also WARN logs and all metrics
+/// - Full:     also ERROR logs; signals downsampled to one sample per path
+///             per signal_interval_ms
+/// Events are never shed.
+///
+/// Off by default: enabling it takes over the transport's
+/// on_queue_status() callback (see UnifiedExporterPipeline).
+struct LoadSheddingConfig {
+    bool enabled = false;
+
+    /// Full: minimum time between exported samples of one signal path
+    uint32_t signal_interval_ms = 1000;
+};
+
+/// Express lane for urgent events
+///
+/// Events at or above min_severity skip the bulk batch: they go into a
+/// small express batch that a dedicated thread compresses and publishes
+/// after linger, independent of batch_timeout, the flush stages and load
+/// shedding. Express batches are numbered separately, under source_id +
+/// source_suffix, so receivers see two ordered streams. Bulk batches keep
+/// their size and timeout.
+struct UrgentLaneConfig {
+    bool enabled = false;
+
+    /// Lowest event severity sent on the express lane
+    vep_Severity min_severity = vep_SEVERITY_CRITICAL;
+
+    /// Wait for further urgent events before sending (0 = send at once)
+    std::chrono::milliseconds linger{5};
+
+    /// Appended to source_id for express batches
+    std::string source_suffix = "/urgent";
+
+    /// Persistence requested from the transport for express batches
+    vep::Persistence persistence = vep::Persistence::Volatile;
+};
+
+/// What send() does with an item while the pipeline is over its memory
+/// budget
+enum class OverflowPolicy {
+    DropNewest,  // Drop the item
+    DropOldest,  // Keep the item; drop the oldest batches queued for
+                 // compression or publish (the item is dropped only when
+                 // the unbuilt items alone exceed the budget)
+    Block,       // Wait up to block_timeout for room, then drop the item
+};
+
+/// Policy name as on the command line: drop-newest, drop-oldest or block
+const char* overflow_policy_name(OverflowPolicy policy);
+
+/// Memory budget for data held by the pipeline
+///
+/// Counts the items not yet built (serialized size) and the serialized and
+/// compressed batches in the flush stages. In-memory structures take more
+/// than their serialized size, so leave headroom below the process limit.
+/// Express lane events are counted but never dropped.
+struct MemoryBudgetConfig {
+    /// Bytes in use before the overflow policy applies (0 = unlimited)
+    size_t max_bytes = 0;
+
+    OverflowPolicy policy = OverflowPolicy::DropNewest;
+
+    /// Block: longest wait of one send() call
+    std::chrono::milliseconds block_timeout{50};
+};
+
+/// Latency histograms per stage and item type
+///
+/// Stages are timed per batch: build (serialize, flush thread), compress,
+/// publish (transport call) and batch (submit to publish complete). Items
+/// are timed from their DDS header timestamp to publish complete, in
+/// milliseconds of sample time, so the sources' clocks must be in sync;
+/// items of spooled or failed batches are not counted. Histograms are
+/// cumulative since start().
+struct LatencyConfig {
+    bool enabled = false;
+
+    /// Log percentiles, and call publish, from the flush thread every
+    /// interval
+    std::chrono::seconds interval{60};
+
+    /// Optional: receives one histogram per stage
+    /// ("vep_exporter.stage_latency_ms", label stage) and per item type
+    /// ("vep_exporter.item_latency_ms", label type) every interval, with
+    /// cumulative counts at fixed millisecond bounds. The message and its
+    /// strings are valid only during the call.
+    std::function<void(const vep_OtelHistogram&)> publish;
+};
+
 /// Configuration for the unified exporter pipeline
 struct UnifiedPipelineConfig {
     std::string source_id = "vep_exporter";
@@ -37,23 +153,98 @@ struct UnifiedPipelineConfig {
     // Maximum items per batch (all types combined)
     size_t batch_max_items = 100;
 
-    // Maximum batch size in bytes (approximate, before compression)
+    // Maximum batch size in bytes, enforced before and after compression:
+    // larger output is split into batches with consecutive sequence numbers
     size_t batch_max_bytes = 64 * 1024;  // 64 KB
 
     // Flush timeout - send batch even if not full
     std::chrono::milliseconds batch_timeout{1000};
 
+    // Adjust item/byte limits and the timeout online (off by default).
+    // The values above are the starting point; batch_max_bytes stays the
+    // hard limit.
+    AdaptiveBatchingConfig adaptive;
+
+    // Compression worker pool and batches in flight to the transport
+    FlushStagesConfig stages;
+
+    // Encoding options (path interning, arena mode, etc.)
+    BatchBuilderConfig encoding;
+
+    // Per-path signal policy (rate limit, deadband, aggregation).
+    // Default: forward everything.
+    ExportPolicyConfig policy;
+
+    // Collapse repeated log entries into one entry with a repeat count
+    // (off by default). Message templates are an encoding option
+    // (encoding.log_templates).
+    LogDedupConfig log_dedup;
+
+    // Shedding when the transport queue backs up
+    LoadSheddingConfig shedding;
+
+    // Store-and-forward of batches while the transport is disconnected or
+    // rejects them (off by default)
+    SpoolConfig spool;
+
+    // Express lane for events at or above a severity (off by default)
+    UrgentLaneConfig urgent;
+
+    // Latency histograms in stats(), logs and optionally as telemetry
+    // (off by default)
+    LatencyConfig latency;
+
+    // Bound on buffered data, and what send() does beyond it (unlimited
+    // by default)
+    MemoryBudgetConfig memory;
+
+    // Persistence requested from the transport for each batch
+    vep::Persistence persistence = vep::Persistence::BestEffort;
+
     // Note: content_id is now configured in the transport, not in the pipeline
 };
 
+/// Latency percentiles (latency tracking enabled)
+struct PipelineLatencyStats {
+    LatencySummary build;     // Serializing a batch
+    LatencySummary compress;  // Compressing a batch
+    LatencySummary publish;   // Transport publish of a batch
+    LatencySummary batch;     // Batch submit to publish complete
+    LatencySummary signal;    // Item DDS header timestamp to publish complete
+    LatencySummary event;
+    LatencySummary metric;
+    LatencySummary log;
+};
+
 /// Statistics for the unified exporter pipeline
 struct UnifiedPipelineStats {
     uint64_t signals_processed = 0;
     uint64_t events_processed = 0;
+    uint64_t events_urgent = 0;        // Sent on the express lane
     uint64_t metrics_processed = 0;
     uint64_t logs_processed = 0;
     uint64_t items_total = 0;
-    uint64_t batches_sent = 0;
+    uint64_t signals_suppressed = 0;   // Dropped or aggregated by the export policy
+    uint64_t aggregates_emitted = 0;   // Window statistics added by the export policy
+    uint64_t logs_collapsed = 0;       // Counted into a repeat summary by log dedup
+    uint64_t items_oversized = 0;      // Dropped: larger than batch_max_bytes alone
+    uint64_t signals_shed = 0;         // Dropped by load shedding (per type)
+    uint64_t metrics_shed = 0;
+    uint64_t logs_shed = 0;
+    uint64_t batches_failed = 0;       // Rejected by the transport
+    vep::QueueLevel queue_level = vep::QueueLevel::Empty;  // Level shedding acts on
+    uint64_t batches_sent = 0;           // Accepted by the transport; spooled and
+                                         // replayed batches count in spool
+    uint64_t urgent_batches_sent = 0;    // Express batches, included in batches_sent
+    BatchLimits batch_limits;            // Limits in effect (adaptive batching)
+    uint64_t batches_in_flight = 0;      // Serialized, not yet published
+    uint64_t batches_rewritten = 0;      // Re-encoded after a lost batch
+    uint64_t memory_bytes = 0;           // Counted against the memory budget
+    uint64_t overflow_items_dropped = 0;    // Dropped by send() over budget
+    uint64_t overflow_batches_dropped = 0;  // Dropped from the stages (DropOldest)
+    uint64_t overflow_blocked = 0;          // send() calls that waited (Block)
+    SpoolStats spool;                    // Store-and-forward (spool enabled)
+    PipelineLatencyStats latency;        // Latency tracking enabled
     uint64_t bytes_before_compression = 0;
     uint64_t bytes_after_compression = 0;
 
@@ -70,6 +261,22 @@ struct UnifiedPipelineStats {
 /// and sends via the configured transport.
 ///
 /// Thread-safe for concurrent message ingestion from multiple DDS callbacks.
+/// send() takes no locks on the default (staged) encoding path: the builder
+/// stages items lock-free and statistics are relaxed atomic counters.
+///
+/// The flush thread only serializes; compression and publishing run on
+/// FlushStages threads, so a slow publish does not hold up serializing
+/// the next batch. Batches reach the transport in sequence order.
+///
+/// With load shedding enabled the pipeline installs its own
+/// on_queue_status() callback on the transport at start(), replacing one
+/// the embedder set; with it disabled (default) the callback is left alone.
+///
+/// With the spool enabled it also installs on_connection_status(): while
+/// the transport is disconnected, and whenever a publish fails, batches
+/// go to the spool, and a replay thread sends them oldest-first, rate
+/// limited, once the transport is connected. Replay runs alongside live
+/// batches, so receivers order by batch sequence and timestamp.
 ///
 /// Example:
 /// @code
@@ -120,6 +327,20 @@ public:
     void send(const vep_OtelLogEntry& msg);
     /// @}
 
+    /// @name Batched ingestion
+    /// send() for each of count items, in order, with per-call work done
+    /// once per span: the memory budget is checked once for the items that
+    /// pass the filters, and the builder takes its lock (arena and direct
+    /// modes) or publishes (staged mode) once per run of them.
+    /// @{
+    void send_batch(const vep_VssSignal* msgs, size_t count);
+    void send_batch(const vep_Event* msgs, size_t count);
+    void send_batch(const vep_OtelGauge* msgs, size_t count);
+    void send_batch(const vep_OtelCounter* msgs, size_t count);
+    void send_batch(const vep_OtelHistogram* msgs, size_t count);
+    void send_batch(const vep_OtelLogEntry* msgs, size_t count);
+    /// @}
+
     /// Check if pipeline is healthy
     bool healthy() const;
 
@@ -128,8 +349,49 @@ public:
 
 private:
     void flush_loop();
+    void on_queue_status(const vep::QueueStatus& status);
+    vep::QueueLevel shed_level() const;
+    void sweep_windows();
     void do_flush();
+    void publish_batch(vep::PayloadBuffer compressed, size_t raw_size);
+    void record_item_latency(const std::vector<ItemTime>& items);
+    PipelineLatencyStats latency_stats() const;
+    void report_latency();
+    void publish_latency();
+    void on_connection_status(const vep::ConnectionStatus& status);
+    void spool_batch(const std::vector<uint8_t>& compressed);
+    void replay_loop();
+    void urgent_loop();
+    void flush_urgent();
+    void publish_urgent(const std::vector<uint8_t>& compressed, size_t raw_size,
+                        const std::vector<ItemTime>& items);
+    size_t memory_in_use() const;
+
+    /// Apply the memory budget to items about to be added
+    /// @param wait Block policy: wait for room. Window sinks do not: they
+    ///        run on the flush thread, which makes the room, or under the
+    ///        filter's lock.
+    /// @return false if the items are dropped
+    bool admit(size_t items = 1, bool wait = true);
+
+    /// Add the items keep() accepts (shedding, routing), admitted together
+    /// per chunk, that filter() then passes. Stateful filters see only
+    /// admitted items, as in send().
+    template<typename T, typename Keep, typename Filter>
+    void add_batch(const T* msgs, size_t count, Keep&& keep, Filter&& filter);
+
+    /// Hand an urgent event to the express lane
+    void add_urgent(const vep_Event& msg);
+    void on_batch_dropped(size_t raw_size);
+
+    /// A batch did not reach the transport (dropped, failed or spooled)
+    void batch_lost();
+
+    /// Before a batch is spooled: rewrite it to decode on its own
+    void make_self_contained(vep::PayloadBuffer& compressed);
+    void apply_limits(const BatchLimits& limits);
     void check_flush_needed();
+    void request_flush();
 
     UnifiedPipelineConfig config_;
 
@@ -140,6 +402,72 @@ private:
     // Single unified batch builder
     UnifiedBatchBuilder builder_;
 
+    // Signal export policy (null when it forwards everything)
+    std::unique_ptr<ExportPolicy> policy_;
+
+    // Log deduplication (null when disabled)
+    std::unique_ptr<LogDedup> log_dedup_;
+
+    // Next close of expired policy and log dedup windows (flush thread only)
+    std::chrono::steady_clock::time_point next_window_sweep_;
+
+    // Backpressure: last reported queue level, and queue_full() as polled
+    // after each publish. shed_signals_ downsamples signals at Full.
+    std::atomic<vep::QueueLevel> queue_level_{vep::QueueLevel::Empty};
+    std::atomic<bool> queue_full_{false};
+    std::unique_ptr<ExportPolicy> shed_signals_;
+
+    // Compress and publish, behind the flush thread
+    FlushStages stages_;
+
+    // Rewrites the batch published after a dropped or failed one so the
+    // receiver catches up on the path dictionary (null without one)
+    std::unique_ptr<BatchRecovery> recovery_;
+
+    // Memory budget (config_.memory.max_bytes): send() waits on memory_cv_
+    // under the Block policy, notified when a batch leaves the stages
+    std::mutex memory_mutex_;
+    std::condition_variable memory_cv_;
+
+    // Latency tracking (config_.latency.enabled). item_times_ holds the
+    // items of each submitted batch, in submit order, until the publisher
+    // takes it; the stages publish or drop every submitted batch exactly
+    // once.
+    std::mutex item_times_mutex_;
+    std::deque<std::vector<ItemTime>> item_times_;
+    LatencyHistogram build_latency_;
+    std::array<LatencyHistogram, 4> item_latency_;  // By ItemType
+    std::chrono::steady_clock::time_point next_latency_report_;  // Flush thread
+    uint32_t latency_seq_ = 0;                                   // Flush thread
+
+    // Store-and-forward (null when disabled). Transport publishes from the
+    // publisher and replay threads are serialized by publish_mutex_.
+    std::unique_ptr<BatchSpool> spool_;
+    std::atomic<bool> connected_{true};  // Until the transport says otherwise
+    std::mutex publish_mutex_;
+    std::thread replay_thread_;
+    std::condition_variable replay_cv_;
+    std::mutex replay_mutex_;
+
+    // Express lane (null when disabled): builder and compressor are used
+    // by the urgent thread, and by stop() after it has ended
+    std::unique_ptr<UnifiedBatchBuilder> urgent_builder_;
+    std::unique_ptr<Compressor> urgent_compressor_;
+    std::vector<uint8_t> urgent_raw_;
+    std::vector<uint8_t> urgent_compressed_;
+    std::thread urgent_thread_;
+    std::condition_variable urgent_cv_;
+    std::mutex urgent_mutex_;
+    bool urgent_requested_ = false;  // Guarded by urgent_mutex_
+
+    // Flush limits: fixed from config, or set by controller_ after each
+    // flush. controller_ and last_flush_ are flush thread only.
+    std::unique_ptr<BatchSizeController> controller_;
+    std::atomic<size_t> flush_items_;
+    std::atomic<size_t> flush_bytes_;
+    std::atomic<int64_t> flush_timeout_ms_;
+    std::chrono::steady_clock::time_point last_flush_;
+
     // State
     std::atomic<bool> running_{false};
 
@@ -147,10 +475,27 @@ private:
     std::thread flush_thread_;
     std::condition_variable flush_cv_;
     std::mutex flush_mutex_;
+    std::atomic<bool> flush_requested_{false};  // Wake once per full batch
 
-    // Stats
-    mutable std::mutex stats_mutex_;
-    UnifiedPipelineStats stats_;
+    // Stats (relaxed: counters only, read as a snapshot by stats())
+    struct Counters {
+        std::atomic<uint64_t> signals_processed{0};
+        std::atomic<uint64_t> events_processed{0};
+        std::atomic<uint64_t> events_urgent{0};
+        std::atomic<uint64_t> metrics_processed{0};
+        std::atomic<uint64_t> logs_processed{0};
+        std::atomic<uint64_t> batches_sent{0};
+        std::atomic<uint64_t> urgent_batches_sent{0};
+        std::atomic<uint64_t> batches_failed{0};
+        std::atomic<uint64_t> signals_shed{0};
+        std::atomic<uint64_t> metrics_shed{0};
+        std::atomic<uint64_t> logs_shed{0};
+        std::atomic<uint64_t> overflow_items_dropped{0};
+        std::atomic<uint64_t> overflow_blocked{0};
+        std::atomic<uint64_t> bytes_before_compression{0};
+        std::atomic<uint64_t> bytes_after_compression{0};
+    };
+    Counters counters_;
 };
 
 }  // namespace vep::exporter
@@ -18,6 +18,7 @@
 #include <map>
 #include <optional>
 #include <string>
+#include <unordered_map>
 #include <variant>
 #include <vector>
 
@@ -117,11 +118,14 @@ enum class LogLevel {
 
 /// A decoded log entry
 struct DecodedLogEntry {
-    int64_t timestamp_ms;
+    int64_t timestamp_ms;            ///< First occurrence
     LogLevel level;
     std::string component;
-    std::string message;
+    std::string message;             ///< Expanded from its template, if sent as one
     std::map<std::string, std::string> attributes;
+    uint32_t repeat_count = 1;       ///< Identical occurrences collapsed into this entry
+    int64_t last_timestamp_ms = 0;   ///< Last occurrence (= timestamp_ms if not repeated)
+    uint32_t template_id = 0;        ///< Message template id, 0 if sent verbatim
 };
 
 /// Item type in a transfer batch
@@ -159,6 +163,74 @@ struct DecodedTransferBatch {
     size_t log_count() const;
 };
 
+// =============================================================================
+// Path Dictionary
+// =============================================================================
+
+/// Receiver-side table for resolving interned Signal.path_id values
+/// (and LogEntry.template_id and MetricSample series and schema ids, which
+/// share the dictionary)
+///
+/// Senders with path interning enabled attach dictionary deltas to batches.
+/// Keep one cache per source_id and pass it to decode_transfer_batch() so
+/// ids defined in earlier batches resolve in later ones. The cache also
+/// keeps each metric series' last values, which sample changes apply to.
+class PathDictionaryCache {
+public:
+    /// Last absolute values of a metric series
+    struct SeriesValues {
+        bool has_counter = false;
+        double counter = 0.0;
+        bool has_histogram = false;
+        uint64_t sample_count = 0;
+        std::vector<uint64_t> bucket_counts;
+
+        /// Apply a sample's counter or histogram values
+        /// @return false if it holds changes to values not held here
+        bool apply(const vep::transfer::MetricSample& sample);
+    };
+
+    /// Apply an in-band dictionary (delta or full snapshot)
+    /// @return false if a delta was missed (entries are still applied), or
+    ///         if the dictionary is older than the cache within a session
+    ///         (a late batch's; ignored)
+    bool apply(const vep::transfer::PathDictionary& dict);
+
+    /// Look up a path by id
+    /// @return Path, or nullptr if the id is unknown
+    const std::string* find(uint32_t id) const;
+
+    /// Look up a complete entry (series labels, bucket bounds) by id
+    const vep::transfer::PathEntry* find_entry(uint32_t id) const;
+
+    /// Note the sequence and session of the batch being decoded. After a
+    /// gap all series values are dropped: the missing batch may have
+    /// changed them. A new session (another run of the sender) starts
+    /// over.
+    /// @return false if, within the session, the sequence is older than
+    ///         the last one (a late batch); nothing is changed
+    bool begin_batch(uint32_t sequence, uint64_t session = 0);
+
+    /// Copy of the dictionary and session without any series values, for
+    /// decoding a late batch: its changes apply to values long gone
+    PathDictionaryCache dictionary() const;
+
+    /// Values of a metric series (created empty)
+    SeriesValues& series_values(uint32_t series_id) { return series_[series_id]; }
+
+    uint32_t version() const { return version_; }
+    size_t size() const { return entries_.size(); }
+    void clear();
+
+private:
+    std::unordered_map<uint32_t, vep::transfer::PathEntry> entries_;
+    uint32_t version_ = 0;
+    std::unordered_map<uint32_t, SeriesValues> series_;
+    bool has_sequence_ = false;
+    uint32_t next_sequence_ = 0;
+    uint64_t session_ = 0;
+};
+
 // =============================================================================
 // Decoder Functions
 // =============================================================================
@@ -169,27 +241,63 @@ DecodedQuality decode_quality(vep::transfer::Quality pb_quality);
 /// Decode a Protobuf Signal to DecodedSignal
 /// @param pb_signal Protobuf signal
 /// @param timestamp_ms Absolute timestamp for this item
+/// @param paths Dictionary for resolving path_id (optional)
 /// @return Decoded signal
 DecodedSignal decode_signal(const vep::transfer::Signal& pb_signal,
-                            int64_t timestamp_ms);
+                            int64_t timestamp_ms,
+                            const PathDictionaryCache* paths = nullptr);
+
+/// Expand a SignalBlock into one DecodedSignal per sample
+/// @param timestamp_ms Absolute timestamp of the block's first sample
+/// @return Samples in block order; empty if the block is malformed
+std::vector<DecodedSignal> decode_signal_block(const vep::transfer::SignalBlock& pb_block,
+                                               int64_t timestamp_ms,
+                                               const PathDictionaryCache* paths = nullptr);
 
 /// Decode a Protobuf Event to DecodedEvent
 DecodedEvent decode_event(const vep::transfer::Event& pb_event,
                           int64_t timestamp_ms);
 
+/// TransferBatch.strings of the batch an item came from
+using BatchStrings = google::protobuf::RepeatedPtrField<std::string>;
+
 /// Decode a Protobuf Metric to DecodedMetric
+/// @param strings Batch string table for resolving name and label refs
+///        (optional; unresolved refs decode as "<string:N>")
 DecodedMetric decode_metric(const vep::transfer::Metric& pb_metric,
-                            int64_t timestamp_ms);
+                            int64_t timestamp_ms,
+                            const BatchStrings* strings = nullptr);
+
+/// Decode a MetricSample, applying its changes to the series' values
+/// @return nullopt if it holds changes to values the cache does not have
+///         (a batch was missed; resolves again at the next absolute value)
+std::optional<DecodedMetric> decode_metric_sample(const vep::transfer::MetricSample& pb_sample,
+                                                  int64_t timestamp_ms,
+                                                  PathDictionaryCache& paths);
 
 /// Decode a Protobuf LogEntry to DecodedLogEntry
+/// @param paths Dictionary for resolving template_id (optional)
+/// @param strings Batch string table for resolving component and
+///        attribute refs (optional)
 DecodedLogEntry decode_log(const vep::transfer::LogEntry& pb_log,
-                           int64_t timestamp_ms);
+                           int64_t timestamp_ms,
+                           const PathDictionaryCache* paths = nullptr,
+                           const BatchStrings* strings = nullptr);
 
 /// Decode a complete TransferBatch
+/// SignalBlock items are expanded into consecutive SIGNAL items.
+/// Interned paths resolve only against the batch's own dictionary.
 /// @param data Serialized protobuf bytes
 /// @return Decoded batch, or nullopt if parsing failed
 std::optional<DecodedTransferBatch> decode_transfer_batch(const std::vector<uint8_t>& data);
 
+/// Decode a complete TransferBatch, resolving interned paths
+/// @param data Serialized protobuf bytes
+/// @param paths Per-source dictionary, updated from the batch
+/// @return Decoded batch, or nullopt if parsing failed
+std::optional<DecodedTransferBatch> decode_transfer_batch(const std::vector<uint8_t>& data,
+                                                          PathDictionaryCache& paths);
+
 // =============================================================================
 // Utility Functions
 // =============================================================================
@@ -2,183 +2,149 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "batch_builder.hpp"
+#include "direct_encoder.hpp"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 
 namespace vep::exporter {
 
-// ============================================================================
-// UnifiedBatchBuilder
-// ============================================================================
+namespace {
 
-UnifiedBatchBuilder::UnifiedBatchBuilder(const std::string& source_id, size_t max_items)
-    : source_id_(source_id)
-    , max_items_(max_items) {
+size_t varint_size(uint64_t value) {
+    size_t size = 1;
+    for (; value >= 0x80; value >>= 7) {
+        size++;
+    }
+    return size;
 }
 
-void UnifiedBatchBuilder::add(const vep_VssSignal& msg) {
-    PendingItem item;
-    item.timestamp_ms = msg.header.timestamp_ns / 1000000;
-    item.type = ItemType::Signal;
+/// Encoded size of TransferItem.timestamp_delta_ms (omitted when 0)
+size_t timestamp_field_size(uint32_t delta_ms) {
+    return delta_ms == 0 ? 0 : 1 + varint_size(delta_ms);
+}
 
-    // Build the signal proto
-    auto* signal = item.proto_item.mutable_signal();
-    signal->set_path(msg.path ? msg.path : "");
-    signal->set_quality(convert_quality(msg.quality));
+/// Bytes of a length-delimited field with a one-byte tag
+size_t length_delimited_size(size_t body) {
+    return 1 + varint_size(body) + body;
+}
 
-    // Convert value
-    vep::transfer::Signal temp_signal;
-    convert_value_to_signal(msg.value, &temp_signal);
-    signal->MergeFrom(temp_signal);
+/// PathDictionary version and base_version plus its TransferBatch framing
+constexpr size_t kDictionaryChunkOverhead = 2 * 6 + 1 + 5;
 
-    size_t item_size = item.proto_item.ByteSizeLong();
+// Dictionary keys of metric series and bucket schemas. Paths and templates
+// come from C strings and never start with '\0'.
+constexpr char kSeriesKey[] = {'\0', 's'};
+constexpr char kSchemaKey[] = {'\0', 'b'};
 
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (pending_.empty()) {
-        base_timestamp_ms_ = item.timestamp_ms;
+/// Counter values whose changes are sent as integers: exact integers that
+/// a double holds without rounding (-0.0 would decode as 0.0)
+bool exact_integer(double value) {
+    return value == std::nearbyint(value) && std::fabs(value) <= 9007199254740992.0 &&
+           !(value == 0.0 && std::signbit(value));
+}
+
+/// PathEntry for a series or schema key (see series_sample())
+void fill_series_entry(std::string_view key, vep::transfer::PathEntry* entry) {
+    std::string_view body = key.substr(2);
+    if (key[1] == kSchemaKey[1]) {
+        size_t count = body.size() / sizeof(double);
+        entry->mutable_bucket_bounds()->Resize(static_cast<int>(count), 0.0);
+        std::memcpy(entry->mutable_bucket_bounds()->mutable_data(), body.data(),
+                    count * sizeof(double));
+        return;
+    }
+    // name, then '\0' key '\0' value per label
+    size_t end = body.find('\0');
+    entry->set_path(std::string(body.substr(0, end)));
+    while (end != std::string_view::npos) {
+        size_t value = body.find('\0', end + 1);
+        size_t next = body.find('\0', value + 1);
+        entry->add_label_keys(std::string(body.substr(end + 1, value - end - 1)));
+        entry->add_label_values(std::string(body.substr(value + 1, next - value - 1)));
+        end = next;
     }
-    pending_.push_back(std::move(item));
-    estimated_bytes_ += item_size;
 }
 
-void UnifiedBatchBuilder::add(const vep_Event& msg) {
-    PendingItem item;
-    item.timestamp_ms = msg.header.timestamp_ns / 1000000;
-    item.type = ItemType::Event;
+// Item payload builders - shared by heap-staged and arena modes so every
+// item is converted exactly once, straight into its final TransferItem.
 
-    // Build the event proto
-    auto* event = item.proto_item.mutable_event();
+void fill_signal(const vep_VssSignal& msg, vep::transfer::TransferItem* item) {
+    auto* signal = item->mutable_signal();
+    signal->set_path(msg.path ? msg.path : "");
+    signal->set_quality(convert_quality(msg.quality));
+    convert_value_to_signal(msg.value, signal);
+}
+
+void fill_event(const vep_Event& msg, vep::transfer::TransferItem* item) {
+    auto* event = item->mutable_event();
     event->set_event_id(msg.event_id ? msg.event_id : "");
     event->set_category(msg.category ? msg.category : "");
     event->set_event_type(msg.event_type ? msg.event_type : "");
     event->set_severity(static_cast<vep::transfer::Severity>(msg.severity));
-
-    size_t item_size = item.proto_item.ByteSizeLong();
-
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (pending_.empty()) {
-        base_timestamp_ms_ = item.timestamp_ms;
-    }
-    pending_.push_back(std::move(item));
-    estimated_bytes_ += item_size;
 }
 
-void UnifiedBatchBuilder::add(const vep_OtelGauge& msg) {
-    PendingItem item;
-    item.timestamp_ms = msg.header.timestamp_ns / 1000000;
-    item.type = ItemType::Metric;
-
-    // Build the metric proto
-    auto* metric = item.proto_item.mutable_metric();
-    metric->set_name(msg.name ? msg.name : "");
-    metric->set_gauge(msg.value);
-
-    // Add labels
-    if (msg.header.source_id && msg.header.source_id[0] != '\0') {
+template<typename Labels>
+void fill_labels(const vep_Header& header, const Labels& labels,
+                 vep::transfer::Metric* metric) {
+    if (header.source_id && header.source_id[0] != '\0') {
         metric->add_label_keys("service");
-        metric->add_label_values(msg.header.source_id);
+        metric->add_label_values(header.source_id);
     }
-    for (uint32_t i = 0; i < msg.labels._length; ++i) {
-        if (msg.labels._buffer[i].key) {
-            metric->add_label_keys(msg.labels._buffer[i].key);
+    for (uint32_t i = 0; i < labels._length; ++i) {
+        if (labels._buffer[i].key) {
+            metric->add_label_keys(labels._buffer[i].key);
             metric->add_label_values(
-                msg.labels._buffer[i].value ? msg.labels._buffer[i].value : "");
+                labels._buffer[i].value ? labels._buffer[i].value : "");
         }
     }
-
-    size_t item_size = item.proto_item.ByteSizeLong();
-
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (pending_.empty()) {
-        base_timestamp_ms_ = item.timestamp_ms;
-    }
-    pending_.push_back(std::move(item));
-    estimated_bytes_ += item_size;
 }
 
-void UnifiedBatchBuilder::add(const vep_OtelCounter& msg) {
-    PendingItem item;
-    item.timestamp_ms = msg.header.timestamp_ns / 1000000;
-    item.type = ItemType::Metric;
+void fill_gauge(const vep_OtelGauge& msg, vep::transfer::TransferItem* item) {
+    auto* metric = item->mutable_metric();
+    metric->set_name(msg.name ? msg.name : "");
+    metric->set_gauge(msg.value);
+    fill_labels(msg.header, msg.labels, metric);
+}
 
-    // Build the metric proto
-    auto* metric = item.proto_item.mutable_metric();
+void fill_counter(const vep_OtelCounter& msg, vep::transfer::TransferItem* item) {
+    auto* metric = item->mutable_metric();
     metric->set_name(msg.name ? msg.name : "");
     metric->set_counter(msg.value);
-
-    // Add labels
-    if (msg.header.source_id && msg.header.source_id[0] != '\0') {
-        metric->add_label_keys("service");
-        metric->add_label_values(msg.header.source_id);
-    }
-    for (uint32_t i = 0; i < msg.labels._length; ++i) {
-        if (msg.labels._buffer[i].key) {
-            metric->add_label_keys(msg.labels._buffer[i].key);
-            metric->add_label_values(
-                msg.labels._buffer[i].value ? msg.labels._buffer[i].value : "");
-        }
-    }
-
-    size_t item_size = item.proto_item.ByteSizeLong();
-
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (pending_.empty()) {
-        base_timestamp_ms_ = item.timestamp_ms;
-    }
-    pending_.push_back(std::move(item));
-    estimated_bytes_ += item_size;
+    fill_labels(msg.header, msg.labels, metric);
 }
 
-void UnifiedBatchBuilder::add(const vep_OtelHistogram& msg) {
-    PendingItem item;
-    item.timestamp_ms = msg.header.timestamp_ns / 1000000;
-    item.type = ItemType::Metric;
-
-    // Build the metric proto
-    auto* metric = item.proto_item.mutable_metric();
+void fill_histogram(const vep_OtelHistogram& msg, vep::transfer::TransferItem* item) {
+    auto* metric = item->mutable_metric();
     metric->set_name(msg.name ? msg.name : "");
 
     auto* hist = metric->mutable_histogram();
     hist->set_sample_count(msg.sample_count);
     hist->set_sample_sum(msg.sample_sum);
+    hist->mutable_bucket_bounds()->Reserve(static_cast<int>(msg.buckets._length));
+    hist->mutable_bucket_counts()->Reserve(static_cast<int>(msg.buckets._length));
     for (uint32_t i = 0; i < msg.buckets._length; ++i) {
         hist->add_bucket_bounds(msg.buckets._buffer[i].upper_bound);
         hist->add_bucket_counts(msg.buckets._buffer[i].cumulative_count);
     }
 
-    // Add labels
-    if (msg.header.source_id && msg.header.source_id[0] != '\0') {
-        metric->add_label_keys("service");
-        metric->add_label_values(msg.header.source_id);
-    }
-    for (uint32_t i = 0; i < msg.labels._length; ++i) {
-        if (msg.labels._buffer[i].key) {
-            metric->add_label_keys(msg.labels._buffer[i].key);
-            metric->add_label_values(
-                msg.labels._buffer[i].value ? msg.labels._buffer[i].value : "");
-        }
-    }
-
-    size_t item_size = item.proto_item.ByteSizeLong();
-
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (pending_.empty()) {
-        base_timestamp_ms_ = item.timestamp_ms;
-    }
-    pending_.push_back(std::move(item));
-    estimated_bytes_ += item_size;
+    fill_labels(msg.header, msg.labels, metric);
 }
 
-void UnifiedBatchBuilder::add(const vep_OtelLogEntry& msg) {
-    PendingItem item;
-    item.timestamp_ms = msg.header.timestamp_ns / 1000000;
-    item.type = ItemType::Log;
-
-    // Build the log proto
-    auto* log = item.proto_item.mutable_log();
+void fill_log(const vep_OtelLogEntry& msg, const LogRepeat& repeat,
+              vep::transfer::TransferItem* item) {
+    auto* log = item->mutable_log();
     log->set_level(static_cast<vep::transfer::LogLevel>(msg.level));
     log->set_component(msg.component ? msg.component : "");
     log->set_message(msg.message ? msg.message : "");
+    if (repeat.count > 1) {
+        log->set_repeat_count(repeat.count);
+        log->set_last_occurrence_delta_ms(repeat.last_delta_ms(msg));
+    }
 
-    // Add attributes
     if (msg.header.source_id && msg.header.source_id[0] != '\0') {
         log->add_attr_keys("service");
         log->add_attr_values(msg.header.source_id);
@@ -190,78 +156,1093 @@ void UnifiedBatchBuilder::add(const vep_OtelLogEntry& msg) {
                 msg.attributes._buffer[i].value ? msg.attributes._buffer[i].value : "");
         }
     }
+}
+
+}  // namespace
+
+// ============================================================================
+// UnifiedBatchBuilder
+// ============================================================================
+
+UnifiedBatchBuilder::UnifiedBatchBuilder(const std::string& source_id, size_t max_items,
+                                         const BatchBuilderConfig& config)
+    : source_id_(source_id)
+    , max_items_(max_items)
+    , config_(config)
+    , item_pool_(config.use_arena || config.direct_encoding ? 0 : 2 * max_items) {
+    if (config_.max_batch_bytes > 0) {
+        // Header and table are repeated by every split batch
+        tables_[0].set_max_bytes(config_.max_batch_bytes / 4);
+        tables_[1].set_max_bytes(config_.max_batch_bytes / 4);
+    }
+    if (config_.use_arena && !config_.direct_encoding) {
+        init_arena_buffer(arena_buffers_[0]);
+        init_arena_buffer(arena_buffers_[1]);
+        arena_active_ = &arena_buffers_[0];
+    }
+}
+
+UnifiedBatchBuilder::~UnifiedBatchBuilder() {
+    reset();
+    PendingItem* item;
+    while (item_pool_.try_pop(item)) {
+        delete item;
+    }
+}
 
-    size_t item_size = item.proto_item.ByteSizeLong();
+void UnifiedBatchBuilder::init_arena_buffer(ArenaBuffer& buffer) {
+    if (!buffer.initial_block) {
+        buffer.initial_block = std::make_unique<char[]>(config_.arena_block_bytes);
+        google::protobuf::ArenaOptions options;
+        options.initial_block = buffer.initial_block.get();
+        options.initial_block_size = config_.arena_block_bytes;
+        buffer.arena = std::make_unique<google::protobuf::Arena>(options);
+    } else {
+        // Frees overflow blocks and runs destructors; keeps the initial block
+        buffer.arena->Reset();
+    }
+    buffer.batch = google::protobuf::Arena::CreateMessage<
+        vep::transfer::TransferBatch>(buffer.arena.get());
+}
 
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (pending_.empty()) {
-        base_timestamp_ms_ = item.timestamp_ms;
+UnifiedBatchBuilder::PendingItem* UnifiedBatchBuilder::acquire_item() {
+    PendingItem* item;
+    if (item_pool_.try_pop(item)) {
+        return item;
     }
-    pending_.push_back(std::move(item));
-    estimated_bytes_ += item_size;
+    return new PendingItem;
+}
+
+void UnifiedBatchBuilder::release_item(PendingItem* item) {
+    item->proto_item.Clear();
+    item->next = nullptr;
+    if (!item_pool_.try_push(item)) {
+        delete item;  // Pool full (burst larger than two batches)
+    }
+}
+
+template<typename Fill>
+void UnifiedBatchBuilder::add_item(AddContext& ctx, int64_t timestamp_ms, ItemType type,
+                                   Fill&& fill) {
+    if (config_.use_arena) {
+        // Build in place: the item is constructed once, inside the batch
+        if (!ctx.lock.owns_lock()) {
+            ctx.lock = std::unique_lock<std::mutex>(mutex_);
+        }
+        auto* batch = arena_active_->batch;
+        if (batch->items_size() == 0) {
+            base_timestamp_ms_ = timestamp_ms;
+        }
+        if (config_.track_item_times) {
+            times_active_.push_back({type, timestamp_ms});
+        }
+        auto* pb_item = batch->add_items();
+        pb_item->set_timestamp_delta_ms(
+            static_cast<uint32_t>(timestamp_ms - base_timestamp_ms_));
+        fill(pb_item);
+        estimated_bytes_.fetch_add(framed_item_size(pb_item->ByteSizeLong()),
+                                   std::memory_order_relaxed);
+        item_count_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    auto* item = acquire_item();
+    item->timestamp_ms = timestamp_ms;
+    item->type = type;
+    fill(&item->proto_item);
+
+    // The delta is set by build(); size it against the batch's first item
+    if (item_count_.fetch_add(1, std::memory_order_relaxed) == 0) {
+        size_base_ms_.store(timestamp_ms, std::memory_order_relaxed);
+    }
+    uint32_t delta = static_cast<uint32_t>(
+        timestamp_ms - size_base_ms_.load(std::memory_order_relaxed));
+    item->byte_size = framed_item_size(item->proto_item.ByteSizeLong() +
+                                       timestamp_field_size(delta));
+    estimated_bytes_.fetch_add(item->byte_size, std::memory_order_relaxed);
+
+    // Linked newest first, like the pending list; commit() pushes the chain
+    item->next = ctx.newest;
+    ctx.newest = item;
+    if (!ctx.oldest) {
+        ctx.oldest = item;
+    }
+}
+
+void UnifiedBatchBuilder::commit(AddContext& ctx) {
+    if (ctx.newest) {
+        // Lock-free push; build() takes the whole list and restores order
+        ctx.oldest->next = pending_head_.load(std::memory_order_relaxed);
+        while (!pending_head_.compare_exchange_weak(ctx.oldest->next, ctx.newest,
+                                                    std::memory_order_release,
+                                                    std::memory_order_relaxed)) {
+        }
+    }
+    if (ctx.lock.owns_lock()) {
+        ctx.lock.unlock();
+    }
+}
+
+template<typename Encode>
+void UnifiedBatchBuilder::add_direct(AddContext& ctx, int64_t timestamp_ms, ItemType type,
+                                     Encode&& encode) {
+    if (!ctx.lock.owns_lock()) {
+        ctx.lock = std::unique_lock<std::mutex>(mutex_);
+    }
+    if (config_.track_item_times) {
+        times_active_.push_back({type, timestamp_ms});
+    }
+    // Counters only change under mutex_ in direct mode
+    if (item_count_.load(std::memory_order_relaxed) == 0) {
+        base_timestamp_ms_ = timestamp_ms;
+    }
+    size_t before = direct_items_.size() + table_active_->encoded_bytes();
+    encode(direct_items_, static_cast<uint32_t>(timestamp_ms - base_timestamp_ms_));
+    estimated_bytes_.fetch_add(direct_items_.size() + table_active_->encoded_bytes() - before,
+                               std::memory_order_relaxed);
+    item_count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+template<typename Fill>
+bool UnifiedBatchBuilder::add_direct_series(std::vector<uint8_t>& out,
+                                            uint32_t timestamp_delta_ms, Fill&& fill) {
+    series_item_.Clear();
+    series_item_.set_timestamp_delta_ms(timestamp_delta_ms);
+    fill(&series_item_);
+    if (!series_sample(series_item_)) {
+        return false;
+    }
+    encode_transfer_item(out, series_item_);
+    return true;
+}
+
+bool UnifiedBatchBuilder::add_direct_sample(AddContext& ctx, int64_t timestamp_ms,
+                                            const vep_VssSignal& msg) {
+    vep::transfer::Signal::ValueCase value_case;
+    uint64_t bits;
+    if (!signal_value_bits(msg.value, &value_case, &bits)) {
+        return false;
+    }
+
+    if (!ctx.lock.owns_lock()) {
+        ctx.lock = std::unique_lock<std::mutex>(mutex_);
+    }
+    bool first = item_count_.load(std::memory_order_relaxed) == 0;
+    const SignalColumn* column = columns_active_->add(msg.path ? msg.path : "", value_case,
+                                                      convert_quality(msg.quality),
+                                                      timestamp_ms, bits);
+    if (!column) {
+        return false;
+    }
+    samples_active_.push_back({column, column->size() - 1, direct_items_.size()});
+    if (first) {
+        base_timestamp_ms_ = timestamp_ms;
+    }
+    // Upper bound: timestamp varint plus an uncompressed value
+    estimated_bytes_.fetch_add(value_case == vep::transfer::Signal::kDoubleVal ||
+                               value_case == vep::transfer::Signal::kInt64Val ||
+                               value_case == vep::transfer::Signal::kUint64Val ? 9 : 5,
+                               std::memory_order_relaxed);
+    item_count_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void UnifiedBatchBuilder::add_to(AddContext& ctx, const vep_VssSignal& msg) {
+    int64_t ts_ms = msg.header.timestamp_ns / 1000000;
+    if (config_.direct_encoding) {
+        if (config_.signal_blocks && add_direct_sample(ctx, ts_ms, msg)) {
+            return;
+        }
+        add_direct(ctx, ts_ms, ItemType::Signal,
+                   [this, &msg](std::vector<uint8_t>& out, uint32_t delta) {
+            uint32_t path_id = config_.intern_paths
+                ? intern_path(msg.path ? msg.path : "") : 0;
+            encode_signal_item(out, msg, delta, path_id);
+        });
+        return;
+    }
+    add_item(ctx, ts_ms, ItemType::Signal,
+             [&msg](vep::transfer::TransferItem* item) { fill_signal(msg, item); });
+}
+
+void UnifiedBatchBuilder::add_to(AddContext& ctx, const vep_Event& msg) {
+    int64_t ts_ms = msg.header.timestamp_ns / 1000000;
+    if (config_.direct_encoding) {
+        add_direct(ctx, ts_ms, ItemType::Event, [&msg](std::vector<uint8_t>& out, uint32_t delta) {
+            encode_event_item(out, msg, delta);
+        });
+        return;
+    }
+    add_item(ctx, ts_ms, ItemType::Event,
+             [&msg](vep::transfer::TransferItem* item) { fill_event(msg, item); });
+}
+
+void UnifiedBatchBuilder::add_to(AddContext& ctx, const vep_OtelGauge& msg) {
+    int64_t ts_ms = msg.header.timestamp_ns / 1000000;
+    if (config_.direct_encoding) {
+        add_direct(ctx, ts_ms, ItemType::Metric,
+                   [this, &msg](std::vector<uint8_t>& out, uint32_t delta) {
+            if (config_.metric_series &&
+                add_direct_series(out, delta, [&msg](vep::transfer::TransferItem* item) {
+                    fill_gauge(msg, item);
+                })) {
+                return;
+            }
+            encode_gauge_item(out, msg, delta, config_.string_table ? table_active_ : nullptr);
+        });
+        return;
+    }
+    add_item(ctx, ts_ms, ItemType::Metric,
+             [&msg](vep::transfer::TransferItem* item) { fill_gauge(msg, item); });
+}
+
+void UnifiedBatchBuilder::add_to(AddContext& ctx, const vep_OtelCounter& msg) {
+    int64_t ts_ms = msg.header.timestamp_ns / 1000000;
+    if (config_.direct_encoding) {
+        add_direct(ctx, ts_ms, ItemType::Metric,
+                   [this, &msg](std::vector<uint8_t>& out, uint32_t delta) {
+            if (config_.metric_series &&
+                add_direct_series(out, delta, [&msg](vep::transfer::TransferItem* item) {
+                    fill_counter(msg, item);
+                })) {
+                return;
+            }
+            encode_counter_item(out, msg, delta, config_.string_table ? table_active_ : nullptr);
+        });
+        return;
+    }
+    add_item(ctx, ts_ms, ItemType::Metric,
+             [&msg](vep::transfer::TransferItem* item) { fill_counter(msg, item); });
+}
+
+void UnifiedBatchBuilder::add_to(AddContext& ctx, const vep_OtelHistogram& msg) {
+    int64_t ts_ms = msg.header.timestamp_ns / 1000000;
+    if (config_.direct_encoding) {
+        add_direct(ctx, ts_ms, ItemType::Metric,
+                   [this, &msg](std::vector<uint8_t>& out, uint32_t delta) {
+            if (config_.metric_series &&
+                add_direct_series(out, delta, [&msg](vep::transfer::TransferItem* item) {
+                    fill_histogram(msg, item);
+                })) {
+                return;
+            }
+            encode_histogram_item(out, msg, delta, config_.string_table ? table_active_ : nullptr);
+        });
+        return;
+    }
+    add_item(ctx, ts_ms, ItemType::Metric,
+             [&msg](vep::transfer::TransferItem* item) { fill_histogram(msg, item); });
+}
+
+void UnifiedBatchBuilder::add_to(AddContext& ctx, const vep_OtelLogEntry& msg,
+                                 const LogRepeat& repeat) {
+    int64_t ts_ms = msg.header.timestamp_ns / 1000000;
+    if (config_.direct_encoding) {
+        add_direct(ctx, ts_ms, ItemType::Log,
+                   [this, &msg, &repeat](std::vector<uint8_t>& out, uint32_t delta) {
+            uint32_t template_id = config_.log_templates
+                ? template_message(msg.message ? msg.message : "") : 0;
+            encode_log_item(out, msg, delta, repeat, template_id, &template_params_,
+                            config_.string_table ? table_active_ : nullptr);
+        });
+        return;
+    }
+    add_item(ctx, ts_ms, ItemType::Log, [&msg, &repeat](vep::transfer::TransferItem* item) {
+        fill_log(msg, repeat, item);
+    });
+}
+
+template<typename T>
+void UnifiedBatchBuilder::add_span(const T* msgs, size_t count) {
+    AddContext ctx;
+    for (size_t i = 0; i < count; ++i) {
+        add_to(ctx, msgs[i]);
+    }
+    commit(ctx);
+}
+
+void UnifiedBatchBuilder::add(const vep_VssSignal& msg) {
+    add_span(&msg, 1);
+}
+
+void UnifiedBatchBuilder::add(const vep_Event& msg) {
+    add_span(&msg, 1);
+}
+
+void UnifiedBatchBuilder::add(const vep_OtelGauge& msg) {
+    add_span(&msg, 1);
+}
+
+void UnifiedBatchBuilder::add(const vep_OtelCounter& msg) {
+    add_span(&msg, 1);
+}
+
+void UnifiedBatchBuilder::add(const vep_OtelHistogram& msg) {
+    add_span(&msg, 1);
+}
+
+void UnifiedBatchBuilder::add(const vep_OtelLogEntry& msg) {
+    add_span(&msg, 1);
+}
+
+void UnifiedBatchBuilder::add(const vep_OtelLogEntry& msg, const LogRepeat& repeat) {
+    AddContext ctx;
+    add_to(ctx, msg, repeat);
+    commit(ctx);
+}
+
+void UnifiedBatchBuilder::add(const vep_VssSignal* msgs, size_t count) {
+    add_span(msgs, count);
+}
+
+void UnifiedBatchBuilder::add(const vep_Event* msgs, size_t count) {
+    add_span(msgs, count);
+}
+
+void UnifiedBatchBuilder::add(const vep_OtelGauge* msgs, size_t count) {
+    add_span(msgs, count);
+}
+
+void UnifiedBatchBuilder::add(const vep_OtelCounter* msgs, size_t count) {
+    add_span(msgs, count);
+}
+
+void UnifiedBatchBuilder::add(const vep_OtelHistogram* msgs, size_t count) {
+    add_span(msgs, count);
+}
+
+void UnifiedBatchBuilder::add(const vep_OtelLogEntry* msgs, size_t count) {
+    add_span(msgs, count);
 }
 
 bool UnifiedBatchBuilder::ready() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return !pending_.empty();
+    return item_count_.load(std::memory_order_relaxed) > 0 ||
+           split_pending_.load(std::memory_order_relaxed) > 0;
 }
 
 size_t UnifiedBatchBuilder::size() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return pending_.size();
+    return item_count_.load(std::memory_order_relaxed);
 }
 
 bool UnifiedBatchBuilder::full() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return pending_.size() >= max_items_;
+    return item_count_.load(std::memory_order_relaxed) >= max_items_;
 }
 
 size_t UnifiedBatchBuilder::estimated_size() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return estimated_bytes_;
+    return estimated_bytes_.load(std::memory_order_relaxed);
+}
+
+size_t UnifiedBatchBuilder::pending_batches() const {
+    return split_pending_.load(std::memory_order_relaxed);
+}
+
+uint64_t UnifiedBatchBuilder::oversized_items() const {
+    return oversized_items_.load(std::memory_order_relaxed);
 }
 
 std::vector<uint8_t> UnifiedBatchBuilder::build() {
-    std::vector<PendingItem> items;
+    std::vector<uint8_t> out;
+    build_into(out);
+    return out;
+}
+
+size_t UnifiedBatchBuilder::build_into(std::vector<uint8_t>& out) {
+    item_times_.clear();
+    if (take_split_batch(out)) {
+        return out.size();
+    }
+    if (config_.direct_encoding) {
+        return build_direct_into(out);
+    }
+    if (config_.use_arena) {
+        return build_arena_into(out);
+    }
+    return build_staged_into(out);
+}
+
+size_t UnifiedBatchBuilder::build_staged_into(std::vector<uint8_t>& out) {
+    PendingItem* first = take_pending();
+    if (!first) {
+        out.clear();
+        return 0;
+    }
+
+    int64_t base_ts = first->timestamp_ms;
+    build_items_.clear();
+    for (PendingItem* item = first; item; item = item->next) {
+        item->proto_item.set_timestamp_delta_ms(
+            static_cast<uint32_t>(item->timestamp_ms - base_ts));
+        build_items_.push_back(&item->proto_item);
+        if (config_.track_item_times) {
+            item_times_.push_back({item->type, item->timestamp_ms});
+        }
+    }
+
+    size_t size = write_batch(build_items_, base_ts, out);
+
+    PendingItem* item = first;
+    while (item) {
+        PendingItem* next = item->next;
+        release_item(item);
+        item = next;
+    }
+    return size;
+}
+
+UnifiedBatchBuilder::PendingItem* UnifiedBatchBuilder::take_pending() {
+    PendingItem* item = pending_head_.exchange(nullptr, std::memory_order_acquire);
+
+    // Reverse newest-first into arrival order
+    PendingItem* oldest = nullptr;
+    size_t count = 0;
+    size_t bytes = 0;
+    while (item) {
+        PendingItem* next = item->next;
+        item->next = oldest;
+        oldest = item;
+        count++;
+        bytes += item->byte_size;
+        item = next;
+    }
+
+    item_count_.fetch_sub(count, std::memory_order_relaxed);
+    estimated_bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+    return oldest;
+}
+
+size_t UnifiedBatchBuilder::build_arena_into(std::vector<uint8_t>& out) {
+    ArenaBuffer* filled;
     int64_t base_ts;
 
     {
         std::lock_guard<std::mutex> lock(mutex_);
-        if (pending_.empty()) {
-            return {};
+        if (arena_active_->batch->items_size() == 0) {
+            out.clear();
+            return 0;
         }
-        items = std::move(pending_);
-        pending_.clear();
+        // Producers continue on the other buffer, reset by the previous build
+        filled = arena_active_;
+        arena_active_ = (filled == &arena_buffers_[0]) ? &arena_buffers_[1] : &arena_buffers_[0];
         base_ts = base_timestamp_ms_;
-        estimated_bytes_ = 0;
+        item_count_.store(0, std::memory_order_relaxed);
+        estimated_bytes_.store(0, std::memory_order_relaxed);
+        times_active_.swap(item_times_);
     }
 
-    vep::transfer::TransferBatch batch;
-    batch.set_base_timestamp_ms(base_ts);
-    batch.set_source_id(source_id_);
-    batch.set_sequence(sequence_++);
+    build_items_.clear();
+    for (auto& pb_item : *filled->batch->mutable_items()) {
+        build_items_.push_back(&pb_item);
+    }
+    size_t size = write_batch(build_items_, base_ts, out);
+    init_arena_buffer(*filled);
+    return size;
+}
 
-    for (auto& item : items) {
-        auto* pb_item = batch.add_items();
+size_t UnifiedBatchBuilder::build_direct_into(std::vector<uint8_t>& out) {
+    int64_t base_ts;
+    size_t dict_end = 0;
+    SignalColumnSet* columns;
+    StringTable* strings;
 
-        // Set timestamp delta
-        pb_item->set_timestamp_delta_ms(
-            static_cast<uint32_t>(item.timestamp_ms - base_ts));
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (item_count_.load(std::memory_order_relaxed) == 0) {
+            out.clear();
+            return 0;
+        }
+        // Producers continue into the previous batch's (cleared) buffers
+        direct_items_.swap(direct_building_);
+        times_active_.swap(item_times_);
+        columns = columns_active_;
+        columns_active_ = (columns == &columns_[0]) ? &columns_[1] : &columns_[0];
+        samples_active_.swap(samples_building_);
+        strings = table_active_;
+        table_active_ = (strings == &tables_[0]) ? &tables_[1] : &tables_[0];
+        base_ts = base_timestamp_ms_;
+        item_count_.store(0, std::memory_order_relaxed);
+        estimated_bytes_.store(0, std::memory_order_relaxed);
+        if (interning()) {
+            // Ids this batch may reference were all assigned under mutex_
+            dict_end = path_dictionary_size();
+        }
+    }
+
+    // Columns become blocks, or rows again if too short, spliced in where
+    // their samples arrived: a block at its first sample, rows at theirs.
+    // Encoded before the dictionary is written, which they may extend.
+    column_bytes_.clear();
+    column_pieces_.clear();
+    if (!columns->empty()) {
+        if (block_items_.size() < columns->columns().size()) {
+            block_items_.resize(columns->columns().size());
+        }
+        if (config_.track_item_times) {
+            for (const SignalColumn* column : columns->columns()) {
+                for (int64_t timestamp_ms : column->timestamps_ms) {
+                    item_times_.push_back({ItemType::Signal, timestamp_ms});
+                }
+            }
+        }
+        vep::transfer::TransferItem row;
+        for (const ColumnSample& sample : samples_building_) {
+            const SignalColumn& column = *sample.column;
+            bool block = column.size() >= config_.signal_block_min_samples;
+            if (block && sample.index > 0) {
+                continue;
+            }
+            size_t begin = column_bytes_.size();
+            if (block) {
+                auto* item = block_item(column, base_ts);
+                if (config_.intern_paths) {
+                    intern_item(*item);
+                }
+                encode_transfer_item(column_bytes_, *item);
+            } else {
+                row.Clear();
+                row.set_timestamp_delta_ms(
+                    static_cast<uint32_t>(column.timestamps_ms[sample.index] - base_ts));
+                auto* signal = row.mutable_signal();
+                signal->set_path(column.path);
+                signal->set_quality(column.quality);
+                set_signal_value(column.value_case, column.values[sample.index], signal);
+                if (config_.intern_paths) {
+                    intern_item(row);
+                }
+                encode_transfer_item(column_bytes_, row);
+            }
+            column_pieces_.push_back({sample.offset, begin, column_bytes_.size()});
+        }
+        columns->clear();
+        if (config_.intern_paths) {
+            dict_end = path_dictionary_size();
+        }
+    }
+    samples_building_.clear();
+
+    write_strings_ = config_.string_table ? strings : nullptr;
+    begin_batch(out, base_ts);
+
+    if (interning()) {
+        vep::transfer::PathDictionary dict;
+        if (path_dictionary_update(dict_end, &dict)) {
+            write_path_dictionary(dict);
+        }
+    }
+
+    size_t pos = 0;
+    for (const ColumnPiece& piece : column_pieces_) {
+        append_items(direct_building_.data() + pos, piece.offset - pos);
+        append_items(column_bytes_.data() + piece.begin, piece.end - piece.begin);
+        pos = piece.offset;
+    }
+    append_items(direct_building_.data() + pos, direct_building_.size() - pos);
+    direct_building_.clear();
+    strings->clear();
+    split_pending_.store(split_batches_.size(), std::memory_order_relaxed);
+    return out.size();
+}
+
+size_t UnifiedBatchBuilder::write_batch(std::vector<vep::transfer::TransferItem*>& items,
+                                        int64_t base_ts, std::vector<uint8_t>& out) {
+    if (config_.signal_blocks) {
+        group_signal_blocks(items, base_ts);
+    }
+    if (interning()) {
+        for (auto* item : items) {
+            intern_item(*item);
+        }
+    }
+    write_strings_ = nullptr;
+    if (config_.string_table) {
+        tables_[0].clear();
+        for (auto* item : items) {
+            tables_[0].reference_item(*item);
+        }
+        write_strings_ = &tables_[0];
+    }
+
+    // Laid out like a direct mode batch (direct_encoder.hpp), without
+    // building a TransferBatch
+    begin_batch(out, base_ts);
+
+    if (interning()) {
+        vep::transfer::PathDictionary dict;
+        if (path_dictionary_update(path_dictionary_size(), &dict)) {
+            write_path_dictionary(dict);
+        }
+    }
+
+    for (const auto* item : items) {
+        size_t start = write_out_->size();
+        encode_transfer_item(*write_out_, *item);
+        finish_item(start);
+    }
+    split_pending_.store(split_batches_.size(), std::memory_order_relaxed);
+    return out.size();
+}
+
+// ============================================================================
+// Output batches
+// ============================================================================
+
+void UnifiedBatchBuilder::begin_batch(std::vector<uint8_t>& out, int64_t base_ts) {
+    out.clear();
+    encode_batch_header(out, base_ts, source_id_, sequence_++, config_.session);
+    if (write_strings_) {
+        encode_string_table(out, *write_strings_);
+    }
+    write_out_ = &out;
+    write_header_end_ = out.size();
+    write_base_ts_ = base_ts;
+}
+
+std::vector<uint8_t>& UnifiedBatchBuilder::split_batch() {
+    if (spare_batches_.empty()) {
+        split_batches_.emplace_back();
+    } else {
+        split_batches_.push_back(std::move(spare_batches_.back()));
+        spare_batches_.pop_back();
+    }
+    begin_batch(split_batches_.back(), write_base_ts_);
+    return split_batches_.back();
+}
+
+size_t UnifiedBatchBuilder::next_header_size() {
+    header_scratch_.clear();
+    encode_batch_header(header_scratch_, write_base_ts_, source_id_,
+                        sequence_.load(std::memory_order_relaxed), config_.session);
+    return header_scratch_.size() + (write_strings_ ? write_strings_->encoded_bytes() : 0);
+}
+
+void UnifiedBatchBuilder::finish_item(size_t item_start) {
+    size_t limit = config_.max_batch_bytes;
+    if (limit == 0 || write_out_->size() <= limit) {
+        return;
+    }
+
+    std::vector<uint8_t>& current = *write_out_;
+    size_t item_size = current.size() - item_start;
+    if (item_start > write_header_end_ && next_header_size() + item_size <= limit) {
+        // Close the current batch before this item; it opens the next one
+        std::vector<uint8_t>& next = split_batch();
+        next.insert(next.end(), current.begin() + static_cast<std::ptrdiff_t>(item_start),
+                    current.end());
+        current.resize(item_start);
+        return;
+    }
+
+    current.resize(item_start);
+    oversized_items_.fetch_add(1, std::memory_order_relaxed);
+    LOG_EVERY_N(WARNING, 100) << "UnifiedBatchBuilder: dropped " << item_size
+                              << " byte item exceeding max_batch_bytes=" << limit;
+}
+
+void UnifiedBatchBuilder::append_items(const uint8_t* items, size_t size) {
+    size_t limit = config_.max_batch_bytes;
+    if (limit == 0 || write_out_->size() + size <= limit) {
+        write_out_->insert(write_out_->end(), items, items + size);
+        return;
+    }
+
+    size_t pos = 0;
+    while (pos < size) {
+        size_t item_size = next_framed_item(items + pos, size - pos);
+        if (item_size == 0) {
+            break;  // Not reached: items were framed by direct_encoder
+        }
+        size_t start = write_out_->size();
+        write_out_->insert(write_out_->end(), items + pos, items + pos + item_size);
+        finish_item(start);
+        pos += item_size;
+    }
+}
+
+void UnifiedBatchBuilder::write_path_dictionary(const vep::transfer::PathDictionary& dict) {
+    size_t start = write_out_->size();
+    encode_path_dictionary(*write_out_, dict);
+    size_t limit = config_.max_batch_bytes;
+    if (limit == 0 || write_out_->size() <= limit) {
+        return;
+    }
+    write_out_->resize(start);
+
+    // Lead with batches carrying slices of the entries. Each slice is a
+    // delta on the previous one, so in-order receivers end up with the
+    // same dictionary; items follow the last slice.
+    size_t budget = limit > write_header_end_ + kDictionaryChunkOverhead
+        ? limit - write_header_end_ - kDictionaryChunkOverhead : 0;
+    vep::transfer::PathDictionary chunk;
+    chunk.set_version(dict.version());
+    chunk.set_base_version(dict.base_version());
+    size_t used = 0;
+    for (const auto& entry : dict.entries()) {
+        size_t entry_size = length_delimited_size(entry.ByteSizeLong());
+        if (used + entry_size > budget && chunk.entries_size() > 0) {
+            encode_path_dictionary(*write_out_, chunk);
+            split_batch();
+            chunk.clear_entries();
+            chunk.set_base_version(chunk.version());
+            {
+                std::lock_guard<std::mutex> lock(dict_mutex_);
+                chunk.set_version(++dict_version_);
+            }
+            used = 0;
+        }
+        *chunk.add_entries() = entry;
+        used += entry_size;
+    }
+    encode_path_dictionary(*write_out_, chunk);
+}
+
+bool UnifiedBatchBuilder::take_split_batch(std::vector<uint8_t>& out) {
+    if (split_batches_.empty()) {
+        return false;
+    }
+    out.swap(split_batches_.front());
+    spare_batches_.push_back(std::move(split_batches_.front()));
+    split_batches_.pop_front();
+    split_pending_.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+void UnifiedBatchBuilder::group_signal_blocks(std::vector<vep::transfer::TransferItem*>& items,
+                                              int64_t base_ts) {
+    SignalColumnSet& columns = columns_[0];
+    columns.clear();
+    item_columns_.assign(items.size(), ColumnRef{});
+
+    for (size_t i = 0; i < items.size(); ++i) {
+        const auto& item = *items[i];
+        uint64_t bits;
+        if (!item.has_signal() || !item.signal().has_path() ||
+            !signal_value_bits(item.signal(), &bits)) {
+            continue;
+        }
+        const auto& signal = item.signal();
+        SignalColumn* column = columns.add(signal.path(), signal.value_case(), signal.quality(),
+                                           base_ts + item.timestamp_delta_ms(), bits);
+        item_columns_[i] = ColumnRef{column, column && column->size() == 1};
+    }
+    if (columns.empty()) {
+        return;
+    }
+
+    if (block_items_.size() < columns.columns().size()) {
+        block_items_.resize(columns.columns().size());
+    }
+
+    // Compact in place: a grouped column's first sample becomes its block,
+    // later samples are dropped; everything else keeps its position
+    size_t out = 0;
+    for (size_t i = 0; i < items.size(); ++i) {
+        const ColumnRef& ref = item_columns_[i];
+        if (!ref.column || ref.column->size() < config_.signal_block_min_samples) {
+            items[out++] = items[i];
+        } else if (ref.first) {
+            items[out++] = block_item(*ref.column, base_ts);
+        }
+    }
+    items.resize(out);
+}
+
+vep::transfer::TransferItem* UnifiedBatchBuilder::block_item(const SignalColumn& column,
+                                                             int64_t base_ts) {
+    auto* item = &block_items_[column.index];
+    item->Clear();
+    item->set_timestamp_delta_ms(static_cast<uint32_t>(column.timestamps_ms[0] - base_ts));
+    encode_signal_block(column, item->mutable_signal_block());
+    return item;
+}
+
+void UnifiedBatchBuilder::intern_item(vep::transfer::TransferItem& item) {
+    if (item.has_metric()) {
+        if (config_.metric_series) {
+            series_sample(item);
+        }
+        return;
+    }
+    if (item.has_log()) {
+        if (config_.log_templates) {
+            uint32_t id = template_message(item.log().message());
+            if (id != 0) {
+                auto* log = item.mutable_log();
+                log->clear_message();
+                log->set_template_id(id);
+                for (auto& param : template_params_) {
+                    log->add_params(std::move(param));
+                }
+            }
+        }
+        return;
+    }
+    if (!config_.intern_paths) {
+        return;
+    }
+    if (item.has_signal() && item.signal().has_path()) {
+        uint32_t id = intern_path(item.signal().path());
+        if (id != 0) {
+            item.mutable_signal()->set_path_id(id);
+        }
+    } else if (item.has_signal_block() && item.signal_block().has_path()) {
+        uint32_t id = intern_path(item.signal_block().path());
+        if (id != 0) {
+            item.mutable_signal_block()->set_path_id(id);
+        }
+    }
+}
+
+bool UnifiedBatchBuilder::series_sample(vep::transfer::TransferItem& item) {
+    const auto& metric = item.metric();
+    series_key_.assign(kSeriesKey, sizeof(kSeriesKey));
+    series_key_ += metric.name();
+    int labels = std::min(metric.label_keys_size(), metric.label_values_size());
+    for (int i = 0; i < labels; ++i) {
+        series_key_ += '\0';
+        series_key_ += metric.label_keys(i);
+        series_key_ += '\0';
+        series_key_ += metric.label_values(i);
+    }
+    uint32_t series_id = intern_string(series_key_, EntryKind::MetricSeries);
+    if (series_id == 0) {
+        return false;
+    }
+    uint32_t schema_id = 0;
+    if (metric.has_histogram() && metric.histogram().bucket_bounds_size() > 0) {
+        const auto& bounds = metric.histogram().bucket_bounds();
+        series_key_.assign(kSchemaKey, sizeof(kSchemaKey));
+        series_key_.append(reinterpret_cast<const char*>(bounds.data()),
+                           static_cast<size_t>(bounds.size()) * sizeof(double));
+        schema_id = intern_string(series_key_, EntryKind::MetricSeries);
+        if (schema_id == 0) {
+            return false;
+        }
+    }
+
+    SeriesState& state = series_state_[series_id];
+    uint32_t epoch = keyframe_epoch_.load(std::memory_order_relaxed);
+    if (state.epoch != epoch) {
+        // A batch may have been lost: start over from absolute values
+        state = SeriesState{};
+        state.epoch = epoch;
+    }
+    bool keyframe = config_.metric_keyframe_samples > 0
+        ? state.samples % config_.metric_keyframe_samples == 0 : state.samples == 0;
+    state.samples++;
 
-        // Move the pre-built item data
-        pb_item->MergeFrom(item.proto_item);
+    series_metric_.Swap(item.mutable_metric());
+    auto* sample = item.mutable_metric_sample();
+    sample->set_series_id(series_id);
+    switch (series_metric_.metric_type_case()) {
+        case vep::transfer::Metric::kGauge:
+            sample->set_gauge(series_metric_.gauge());
+            break;
+        case vep::transfer::Metric::kCounter: {
+            double value = series_metric_.counter();
+            if (!keyframe && state.has_counter && exact_integer(value) &&
+                exact_integer(state.counter)) {
+                sample->set_counter_delta(static_cast<int64_t>(value) -
+                                          static_cast<int64_t>(state.counter));
+            } else {
+                sample->set_counter(value);
+            }
+            state.has_counter = true;
+            state.counter = value;
+            break;
+        }
+        case vep::transfer::Metric::kHistogram: {
+            const auto& hist = series_metric_.histogram();
+            auto* pb_hist = sample->mutable_histogram();
+            bool delta = !keyframe && state.has_histogram && state.schema_id == schema_id &&
+                         state.bucket_counts.size() ==
+                             static_cast<size_t>(hist.bucket_counts_size());
+            pb_hist->set_schema_id(schema_id);
+            pb_hist->set_delta(delta);
+            // Unsigned differences wrap; receivers add them back modulo 2^64
+            pb_hist->set_sample_count(static_cast<int64_t>(
+                hist.sample_count() - (delta ? state.sample_count : 0)));
+            pb_hist->set_sample_sum(hist.sample_sum());
+            pb_hist->mutable_bucket_counts()->Reserve(hist.bucket_counts_size());
+            state.bucket_counts.resize(static_cast<size_t>(hist.bucket_counts_size()));
+            for (int i = 0; i < hist.bucket_counts_size(); ++i) {
+                uint64_t count = hist.bucket_counts(i);
+                pb_hist->add_bucket_counts(static_cast<int64_t>(
+                    count - (delta ? state.bucket_counts[static_cast<size_t>(i)] : 0)));
+                state.bucket_counts[static_cast<size_t>(i)] = count;
+            }
+            state.has_histogram = true;
+            state.schema_id = schema_id;
+            state.sample_count = hist.sample_count();
+            break;
+        }
+        default:
+            break;
     }
+    series_metric_.Clear();
+    return true;
+}
 
-    std::string serialized;
-    batch.SerializeToString(&serialized);
-    return std::vector<uint8_t>(serialized.begin(), serialized.end());
+uint32_t UnifiedBatchBuilder::intern_path(std::string_view path) {
+    return intern_string(path, EntryKind::Path);
+}
+
+uint32_t UnifiedBatchBuilder::template_message(std::string_view message) {
+    if (message.empty() || !extract_log_template(message, template_, template_params_)) {
+        template_params_.clear();
+        return 0;
+    }
+    uint32_t id = intern_string(template_, EntryKind::LogTemplate);
+    if (id == 0) {
+        template_params_.clear();
+    }
+    return id;
+}
+
+uint32_t UnifiedBatchBuilder::intern_string(std::string_view text, EntryKind kind) {
+    std::lock_guard<std::mutex> lock(dict_mutex_);
+
+    auto it = path_ids_.find(text);
+    if (it != path_ids_.end()) {
+        return it->second;
+    }
+    if (paths_.size() >= config_.path_dictionary_max_entries) {
+        return 0;  // Dictionary full - keep the string
+    }
+    if (kind == EntryKind::LogTemplate && log_templates_ >= config_.log_template_max_entries) {
+        return 0;
+    }
+    if (kind == EntryKind::MetricSeries && metric_series_ >= config_.metric_series_max_entries) {
+        return 0;
+    }
+    if (config_.max_batch_bytes > 0 && text.size() > config_.max_batch_bytes / 4) {
+        return 0;  // Entry must fit in a dictionary slice with room to spare
+    }
+    uint32_t id = static_cast<uint32_t>(paths_.size() + 1);
+    paths_.emplace_back(text);
+    path_ids_.emplace(paths_.back(), id);
+    if (kind == EntryKind::LogTemplate) {
+        log_templates_++;
+    } else if (kind == EntryKind::MetricSeries) {
+        metric_series_++;
+    }
+    return id;
+}
+
+bool UnifiedBatchBuilder::path_dictionary_update(size_t end,
+                                                 vep::transfer::PathDictionary* dict) {
+    std::lock_guard<std::mutex> lock(dict_mutex_);
+
+    size_t first_new = paths_sent_;
+    paths_sent_ = end;
+
+    if (end == 0) {
+        return false;
+    }
+
+    bool has_new = end > first_new;
+    batches_since_snapshot_++;
+    bool snapshot = snapshot_pending_ ||
+        (config_.path_dictionary_refresh_batches > 0 &&
+         batches_since_snapshot_ >= config_.path_dictionary_refresh_batches);
+
+    if (!has_new && !snapshot) {
+        return false;
+    }
+
+    uint32_t base_version = dict_version_;
+    if (has_new) {
+        dict_version_++;
+    }
+
+    dict->set_version(dict_version_);
+
+    size_t from = first_new;
+    if (snapshot) {
+        dict->set_base_version(0);
+        from = 0;
+        snapshot_pending_ = false;
+        batches_since_snapshot_ = 0;
+    } else {
+        dict->set_base_version(base_version);
+    }
+
+    add_dictionary_entries(from, end, dict);
+    return true;
+}
+
+void UnifiedBatchBuilder::add_dictionary_entries(size_t from, size_t end,
+                                                 vep::transfer::PathDictionary* dict) const {
+    for (size_t i = from; i < end; ++i) {
+        auto* entry = dict->add_entries();
+        entry->set_id(static_cast<uint32_t>(i + 1));
+        const std::string& key = paths_[i];
+        if (!key.empty() && key[0] == '\0') {
+            fill_series_entry(key, entry);
+        } else {
+            entry->set_path(key);
+        }
+    }
+}
+
+void UnifiedBatchBuilder::resend_path_dictionary() {
+    std::lock_guard<std::mutex> lock(dict_mutex_);
+    snapshot_pending_ = true;
+    keyframe_epoch_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void UnifiedBatchBuilder::path_dictionary_entries(uint32_t first, uint32_t last,
+                                                  vep::transfer::PathDictionary* dict) const {
+    std::lock_guard<std::mutex> lock(dict_mutex_);
+    size_t end = std::min<size_t>(last, paths_.size());
+    if (first > 0 && first <= end) {
+        add_dictionary_entries(first - 1, end, dict);
+    }
+}
+
+size_t UnifiedBatchBuilder::path_dictionary_size() const {
+    std::lock_guard<std::mutex> lock(dict_mutex_);
+    return paths_.size();
+}
+
+size_t UnifiedBatchBuilder::log_template_count() const {
+    std::lock_guard<std::mutex> lock(dict_mutex_);
+    return log_templates_;
+}
+
+size_t UnifiedBatchBuilder::metric_series_count() const {
+    std::lock_guard<std::mutex> lock(dict_mutex_);
+    return metric_series_;
 }
 
 void UnifiedBatchBuilder::reset() {
+    while (!split_batches_.empty()) {
+        spare_batches_.push_back(std::move(split_batches_.front()));
+        split_batches_.pop_front();
+    }
+    split_pending_.store(0, std::memory_order_relaxed);
+
+    PendingItem* item = take_pending();
+    while (item) {
+        PendingItem* next = item->next;
+        release_item(item);
+        item = next;
+    }
+
     std::lock_guard<std::mutex> lock(mutex_);
-    pending_.clear();
+    if (arena_active_) {
+        init_arena_buffer(*arena_active_);
+    }
+    direct_items_.clear();
+    columns_active_->clear();
+    samples_active_.clear();
+    table_active_->clear();
+    times_active_.clear();
+    item_times_.clear();
+    if (config_.direct_encoding || config_.use_arena) {
+        // Counters only change under mutex_ in these modes
+        item_count_.store(0, std::memory_order_relaxed);
+        estimated_bytes_.store(0, std::memory_order_relaxed);
+    }
     base_timestamp_ms_ = 0;
-    estimated_bytes_ = 0;
 }
 
 }  // namespace vep::exporter
@@ -0,0 +1,96 @@
+// Copyright 2025 Vehicle Edge Platform Contributors
+// SPDX-License-Identifier: Apache-2.0
+
+#include "batch_controller.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace vep::exporter {
+
+namespace {
+
+// Item limit headroom over the items expected per timeout
+constexpr double kBurstFactor = 2.0;
+
+// Byte-rate target: largest timeout change per flush
+constexpr double kMaxGrowth = 2.0;
+constexpr double kShrink = 1.5;
+
+}  // namespace
+
+BatchSizeController::BatchSizeController(const AdaptiveBatchingConfig& config,
+                                         const BatchLimits& initial)
+    : config_(config)
+    , base_(initial)
+    , limits_(initial) {
+    config_.smoothing = std::clamp(config_.smoothing, 0.01, 1.0);
+    config_.min_items = std::max<size_t>(1, config_.min_items);
+    config_.max_items = std::max(config_.min_items, config_.max_items);
+    config_.min_timeout = std::max(std::chrono::milliseconds(1), config_.min_timeout);
+    config_.max_timeout = std::max(config_.min_timeout, config_.max_timeout);
+}
+
+double BatchSizeController::smooth(double average, double sample) const {
+    if (!observed_) {
+        return sample;
+    }
+    return average + config_.smoothing * (sample - average);
+}
+
+const BatchLimits& BatchSizeController::update(const BatchObservation& observation) {
+    if (observation.items == 0 || observation.interval.count() <= 0) {
+        return limits_;
+    }
+
+    double interval_s = observation.interval.count() / 1e6;
+    ingest_rate_ = smooth(ingest_rate_, observation.items / interval_s);
+    item_bytes_ = smooth(item_bytes_,
+                         static_cast<double>(observation.bytes) / observation.items);
+    if (observation.bytes > 0) {
+        compression_ratio_ = smooth(compression_ratio_,
+            static_cast<double>(observation.compressed_bytes) / observation.bytes);
+    }
+    flush_ms_ = smooth(flush_ms_, observation.flush_time.count() / 1e3);
+    observed_ = true;
+
+    double timeout_ms = std::clamp(target_timeout_ms(),
+                                   static_cast<double>(config_.min_timeout.count()),
+                                   static_cast<double>(config_.max_timeout.count()));
+    limits_.timeout = std::chrono::milliseconds(static_cast<int64_t>(timeout_ms));
+
+    double expected_items = ingest_rate_ * timeout_ms / 1e3;
+    limits_.max_items = std::clamp(static_cast<size_t>(std::ceil(expected_items * kBurstFactor)),
+                                   config_.min_items, config_.max_items);
+
+    // The configured byte limit stays the ceiling: it is what the
+    // transport accepts
+    double expected_bytes = std::ceil(item_bytes_ * limits_.max_items);
+    limits_.max_bytes = std::clamp(static_cast<size_t>(expected_bytes),
+                                   std::min<size_t>(1024, base_.max_bytes), base_.max_bytes);
+    return limits_;
+}
+
+double BatchSizeController::target_timeout_ms() const {
+    double timeout_ms = static_cast<double>(limits_.timeout.count());
+    double base_ms = static_cast<double>(base_.timeout.count());
+
+    if (config_.target_bytes_per_sec > 0) {
+        double target = static_cast<double>(config_.target_bytes_per_sec);
+        double output = ingest_rate_ * item_bytes_ * compression_ratio_;
+        if (output > target) {
+            timeout_ms *= std::min(output / target, kMaxGrowth);
+        } else if (output < target / 2 && timeout_ms > base_ms) {
+            timeout_ms = std::max(base_ms, timeout_ms / kShrink);
+        }
+    }
+
+    if (config_.target_latency_ms > 0) {
+        // Oldest item waits one full timeout, then for the flush
+        double budget_ms = config_.target_latency_ms - flush_ms_;
+        timeout_ms = config_.target_bytes_per_sec > 0 ? std::min(timeout_ms, budget_ms) : budget_ms;
+    }
+    return timeout_ms;
+}
+
+}  // namespace vep::exporter
@@ -0,0 +1,330 @@
+// Copyright 2025 Vehicle Edge Platform Contributors
+// SPDX-License-Identifier: Apache-2.0
+
+#include "batch_recovery.hpp"
+#include "direct_encoder.hpp"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+
+namespace vep::exporter {
+
+namespace {
+
+// Field numbers from transfer.proto
+constexpr uint32_t kBatchPathDictionary = 4;
+constexpr uint32_t kBatchItems = 10;
+constexpr uint32_t kItemMetricSample = 15;
+
+constexpr uint32_t kLengthDelimited = 2;
+
+/// True if a sample's values are changes since the series' previous one
+bool holds_changes(const vep::transfer::MetricSample& sample) {
+    return sample.value_case() == vep::transfer::MetricSample::kCounterDelta ||
+           (sample.has_histogram() && sample.histogram().delta());
+}
+
+/// Replace a sample's changes with the values they lead to from values
+bool make_absolute(vep::transfer::MetricSample& sample,
+                   PathDictionaryCache::SeriesValues values) {
+    if (!values.apply(sample)) {
+        return false;
+    }
+    if (sample.value_case() == vep::transfer::MetricSample::kCounterDelta) {
+        sample.set_counter(values.counter);
+    } else if (sample.has_histogram()) {
+        auto* hist = sample.mutable_histogram();
+        hist->set_delta(false);
+        hist->set_sample_count(static_cast<int64_t>(values.sample_count));
+        for (int i = 0; i < hist->bucket_counts_size(); ++i) {
+            hist->set_bucket_counts(
+                i, static_cast<int64_t>(values.bucket_counts[static_cast<size_t>(i)]));
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+BatchRecovery::BatchRecovery(UnifiedBatchBuilder& builder, const BatchBuilderConfig& config)
+    : builder_(builder)
+    , max_batch_bytes_(config.max_batch_bytes)
+    , metric_series_(config.metric_series) {}
+
+void BatchRecovery::observe(const std::vector<uint8_t>& batch) {
+    Record record;
+    record.base_version = version_;
+    batch_series_.clear();
+    WireField field;
+    for (size_t pos = 0; next_wire_field(batch.data(), batch.size(), pos, field);
+         pos = field.end) {
+        if (field.wire_type != kLengthDelimited) {
+            continue;
+        }
+        if (field.number == kBatchItems) {
+            if (!metric_series_) {
+                break;  // The dictionary precedes the items
+            }
+            observe_item(batch.data() + field.payload, field.end - field.payload, record);
+        } else if (field.number == kBatchPathDictionary &&
+                   dict_.ParseFromArray(batch.data() + field.payload,
+                                        static_cast<int>(field.end - field.payload))) {
+            record.base_version = dict_.base_version();
+            version_ = dict_.version();
+            for (const auto& entry : dict_.entries()) {
+                end_ = std::max(end_, entry.id());
+            }
+        }
+    }
+    record.version = version_;
+    record.end = end_;
+    record.series_known = series_.size();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    records_.push_back(std::move(record));
+}
+
+void BatchRecovery::observe_item(const uint8_t* data, size_t size, Record& record) {
+    WireField field;
+    for (size_t pos = 0; next_wire_field(data, size, pos, field); pos = field.end) {
+        if (field.number != kItemMetricSample || field.wire_type != kLengthDelimited) {
+            continue;
+        }
+        if (!sample_.ParseFromArray(data + field.payload,
+                                    static_cast<int>(field.end - field.payload))) {
+            return;
+        }
+        auto& values = series_[sample_.series_id()];
+        if (batch_series_.insert(sample_.series_id()).second) {
+            record.series.push_back(sample_.series_id());
+            if (holds_changes(sample_)) {
+                record.before.emplace_back(sample_.series_id(), values);
+            }
+        }
+        values.apply(sample_);
+        return;
+    }
+}
+
+const BatchRecovery::Record* BatchRecovery::front() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return records_.empty() ? nullptr : &records_.front();
+}
+
+bool BatchRecovery::rewrite(std::vector<uint8_t>& batch) {
+    const Record* next = front();
+    if (!next) {
+        return false;  // Not reached: every batch is observed
+    }
+    const Record& record = *next;
+
+    // A snapshot, or a delta on what the receiver has, decodes as it is
+    bool dictionary = behind_ && record.base_version != 0 &&
+                      record.base_version != sent_version_;
+    pending_.clear();
+    if (series_behind_) {
+        for (const auto& [series_id, values] : record.before) {
+            if (synced_.count(series_id) == 0) {
+                pending_.emplace(series_id, &values);
+            }
+        }
+    }
+    if (!dictionary && pending_.empty()) {
+        return false;
+    }
+
+    // The batch's own entries and those of the lost batches, as a delta
+    // on the receiver's version (a snapshot if it has none)
+    vep::transfer::PathDictionary dict;
+    if (dictionary) {
+        dict.set_base_version(sent_version_);
+        dict.set_version(record.version);
+        builder_.path_dictionary_entries(sent_end_ + 1, record.end, &dict);
+    }
+
+    // Same fields with the dictionary replaced, still ahead of the items
+    rewritten_.clear();
+    bool written = !dictionary;
+    WireField field;
+    size_t pos = 0;
+    for (; next_wire_field(batch.data(), batch.size(), pos, field); pos = field.end) {
+        if (dictionary && field.number == kBatchPathDictionary) {
+            continue;
+        }
+        if (field.number == kBatchItems) {
+            if (!written) {
+                encode_path_dictionary(rewritten_, dict);
+                written = true;
+            }
+            if (!pending_.empty() && field.wire_type == kLengthDelimited &&
+                rewrite_item(batch.data() + field.payload, field.end - field.payload)) {
+                continue;
+            }
+        }
+        rewritten_.insert(rewritten_.end(), batch.begin() + static_cast<std::ptrdiff_t>(pos),
+                          batch.begin() + static_cast<std::ptrdiff_t>(field.end));
+    }
+    if (pos != batch.size()) {
+        LOG(ERROR) << "BatchRecovery: malformed batch at byte " << pos << ", not rewritten";
+        return false;
+    }
+    if (!written) {
+        encode_path_dictionary(rewritten_, dict);
+    }
+
+    if (max_batch_bytes_ > 0 && rewritten_.size() > max_batch_bytes_) {
+        LOG(WARNING) << "BatchRecovery: " << dict.entries_size()
+                     << " missed dictionary entries exceed max_batch_bytes, resending the"
+                     << " dictionary with the next batch built";
+        builder_.resend_path_dictionary();
+        behind_ = false;
+        series_behind_ = false;  // Samples built from now on are absolute
+        synced_.clear();
+        return false;
+    }
+    batch.swap(rewritten_);
+    batches_rewritten_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool BatchRecovery::rewrite_item(const uint8_t* data, size_t size) {
+    WireField field;
+    for (size_t pos = 0; next_wire_field(data, size, pos, field); pos = field.end) {
+        if (field.number != kItemMetricSample) {
+            continue;
+        }
+        vep::transfer::MetricSample sample;
+        if (!sample.ParseFromArray(data + field.payload,
+                                   static_cast<int>(field.end - field.payload))) {
+            return false;
+        }
+        auto it = pending_.find(sample.series_id());
+        if (it == pending_.end()) {
+            return false;
+        }
+        const SeriesValues& before = *it->second;
+        pending_.erase(it);
+
+        vep::transfer::TransferItem item;
+        if (!item.ParseFromArray(data, static_cast<int>(size)) ||
+            !make_absolute(*item.mutable_metric_sample(), before)) {
+            return false;
+        }
+        encode_transfer_item(rewritten_, item);
+        return true;
+    }
+    return false;
+}
+
+bool BatchRecovery::make_self_contained(std::vector<uint8_t>& batch) {
+    const Record* next = front();
+    vep::transfer::TransferBatch pb_batch;
+    if (!next || !pb_batch.ParseFromArray(batch.data(), static_cast<int>(batch.size()))) {
+        LOG(ERROR) << "BatchRecovery: malformed batch, spooled as it is";
+        return false;
+    }
+    const Record& record = *next;
+
+    // Entries the items use; the first sample of each series made absolute
+    std::vector<uint32_t> ids;
+    std::unordered_set<uint32_t> sampled;
+    for (auto& item : *pb_batch.mutable_items()) {
+        switch (item.item_case()) {
+            case vep::transfer::TransferItem::kSignal:
+                if (item.signal().path_ref_case() == vep::transfer::Signal::kPathId) {
+                    ids.push_back(item.signal().path_id());
+                }
+                break;
+            case vep::transfer::TransferItem::kSignalBlock:
+                if (item.signal_block().path_ref_case() == vep::transfer::SignalBlock::kPathId) {
+                    ids.push_back(item.signal_block().path_id());
+                }
+                break;
+            case vep::transfer::TransferItem::kLog:
+                if (item.log().template_id() != 0) {
+                    ids.push_back(item.log().template_id());
+                }
+                break;
+            case vep::transfer::TransferItem::kMetricSample: {
+                auto& sample = *item.mutable_metric_sample();
+                ids.push_back(sample.series_id());
+                if (sample.has_histogram() && sample.histogram().schema_id() != 0) {
+                    ids.push_back(sample.histogram().schema_id());
+                }
+                if (!sampled.insert(sample.series_id()).second || !holds_changes(sample)) {
+                    break;
+                }
+                auto before = std::find_if(record.before.begin(), record.before.end(),
+                                           [&](const auto& series) {
+                                               return series.first == sample.series_id();
+                                           });
+                if (before == record.before.end() || !make_absolute(sample, before->second)) {
+                    LOG(ERROR) << "BatchRecovery: no values of series " << sample.series_id()
+                               << ", spooled as it is";
+                    return false;
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+    pb_batch.clear_path_dictionary();
+    if (!ids.empty()) {
+        auto* dict = pb_batch.mutable_path_dictionary();
+        dict->set_version(record.version);
+        for (uint32_t id : ids) {
+            builder_.path_dictionary_entries(id, id, dict);
+        }
+    }
+    pb_batch.set_replayed(true);
+
+    size_t size = pb_batch.ByteSizeLong();
+    if (max_batch_bytes_ > 0 && size > max_batch_bytes_) {
+        LOG(WARNING) << "BatchRecovery: self-contained batch of " << size
+                     << " bytes exceeds max_batch_bytes, spooled as it is";
+        return false;
+    }
+    batch.resize(size);
+    pb_batch.SerializeWithCachedSizesToArray(batch.data());
+    return true;
+}
+
+BatchRecovery::Record BatchRecovery::pop() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Record record;
+    if (!records_.empty()) {
+        record = std::move(records_.front());
+        records_.pop_front();
+    }
+    return record;
+}
+
+void BatchRecovery::published() {
+    Record record = pop();
+    sent_version_ = record.version;
+    sent_end_ = record.end;
+    behind_ = false;
+    if (series_behind_) {
+        synced_.insert(record.series.begin(), record.series.end());
+        if (synced_.size() >= record.series_known) {
+            series_behind_ = false;
+            synced_.clear();
+        }
+    }
+}
+
+void BatchRecovery::lost() {
+    pop();
+    behind_ = true;
+    if (metric_series_) {
+        series_behind_ = true;  // The receiver drops all series values at the gap
+        synced_.clear();
+    }
+}
+
+}  // namespace vep::exporter
@@ -0,0 +1,382 @@
+// Copyright 2025 Vehicle Edge Platform Contributors
+// SPDX-License-Identifier: Apache-2.0
+
+#include "batch_spool.hpp"
+
+#include <glog/logging.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+
+namespace vep::exporter {
+
+namespace {
+
+// Segment header: magic, version, generation, read offset
+constexpr uint32_t kSegmentMagic = 0x53504556;  // "VEPS"
+constexpr uint32_t kSegmentVersion = 1;
+constexpr size_t kHeaderSize = 64;
+constexpr size_t kGenerationOffset = 8;
+constexpr size_t kReadOffsetOffset = 16;
+
+// Record header: payload size, CRC32, generation
+constexpr size_t kRecordHeaderSize = 16;
+constexpr size_t kRecordAlignment = 8;
+
+constexpr size_t kMinSegmentBytes = 4096;
+
+template <typename T>
+T load(const uint8_t* data) {
+    T value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+template <typename T>
+void store(uint8_t* data, T value) {
+    std::memcpy(data, &value, sizeof(value));
+}
+
+/// Bytes a record of size payload bytes occupies
+size_t record_span(size_t size) {
+    return kRecordHeaderSize + (size + kRecordAlignment - 1) / kRecordAlignment * kRecordAlignment;
+}
+
+/// CRC-32 (IEEE), continuing from crc
+uint32_t crc32(uint32_t crc, const uint8_t* data, size_t size) {
+    static const auto table = [] {
+        std::array<uint32_t, 256> table{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            table[i] = c;
+        }
+        return table;
+    }();
+
+    crc = ~crc;
+    for (size_t i = 0; i < size; ++i) {
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+/// CRC over the record's generation, size and payload
+uint32_t record_crc(uint64_t generation, uint32_t size, const uint8_t* payload) {
+    uint8_t fields[12];
+    store(fields, generation);
+    store(fields + 8, size);
+    return crc32(crc32(0, fields, sizeof(fields)), payload, size);
+}
+
+}  // namespace
+
+BatchSpool::BatchSpool(const SpoolConfig& config)
+    : config_(config) {
+    config_.segments = std::max<size_t>(2, config_.segments);
+    config_.segment_bytes = std::max(kMinSegmentBytes, config_.segment_bytes);
+    segments_.resize(config_.segments);
+}
+
+BatchSpool::~BatchSpool() {
+    sync();
+    for (auto& segment : segments_) {
+        if (segment.data) {
+            munmap(segment.data, config_.segment_bytes);
+        }
+        if (segment.fd >= 0) {
+            ::close(segment.fd);
+        }
+    }
+}
+
+size_t BatchSpool::segment_bytes_for(size_t batch_bytes) {
+    return std::max(kMinSegmentBytes, kHeaderSize + record_span(batch_bytes));
+}
+
+std::unique_ptr<BatchSpool> BatchSpool::open(const SpoolConfig& config) {
+    std::error_code ec;
+    std::filesystem::create_directories(config.directory, ec);
+    if (ec) {
+        LOG(ERROR) << "BatchSpool: cannot create " << config.directory << ": " << ec.message();
+        return nullptr;
+    }
+
+    std::unique_ptr<BatchSpool> spool(new BatchSpool(config));
+    for (size_t i = 0; i < spool->segments_.size(); ++i) {
+        if (!spool->open_segment(i)) {
+            return nullptr;
+        }
+    }
+
+    // Appends continue in the newest segment; the ring order from there
+    // is oldest first
+    Segment* newest = nullptr;
+    for (size_t i = 0; i < spool->segments_.size(); ++i) {
+        Segment& segment = spool->segments_[i];
+        spool->stats_.batches_recovered += segment.pending;
+        if (segment.generation > spool->generation_) {
+            spool->generation_ = segment.generation;
+            spool->write_index_ = i;
+            newest = &segment;
+        }
+    }
+    if (!newest) {
+        spool->reset(spool->segments_[0], ++spool->generation_);
+    }
+
+    if (spool->stats_.batches_recovered > 0) {
+        LOG(INFO) << "BatchSpool: recovered " << spool->stats_.batches_recovered
+                  << " unreplayed batches from " << config.directory;
+    }
+    return spool;
+}
+
+bool BatchSpool::open_segment(size_t index) {
+    Segment& segment = segments_[index];
+    auto path = std::filesystem::path(config_.directory) /
+                ("segment-" + std::to_string(index) + ".spool");
+
+    segment.fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (segment.fd < 0) {
+        LOG(ERROR) << "BatchSpool: cannot open " << path << ": " << std::strerror(errno);
+        return false;
+    }
+
+    struct stat st {};
+    if (fstat(segment.fd, &st) != 0) {
+        LOG(ERROR) << "BatchSpool: cannot stat " << path << ": " << std::strerror(errno);
+        return false;
+    }
+    bool resized = static_cast<size_t>(st.st_size) != config_.segment_bytes;
+    if (resized) {
+        if (st.st_size > 0) {
+            LOG(WARNING) << "BatchSpool: " << path << " has another segment size, discarding it";
+        }
+        if (ftruncate(segment.fd, static_cast<off_t>(config_.segment_bytes)) != 0) {
+            LOG(ERROR) << "BatchSpool: cannot size " << path << ": " << std::strerror(errno);
+            return false;
+        }
+    }
+
+    void* data = mmap(nullptr, config_.segment_bytes, PROT_READ | PROT_WRITE, MAP_SHARED,
+                      segment.fd, 0);
+    if (data == MAP_FAILED) {
+        LOG(ERROR) << "BatchSpool: cannot map " << path << ": " << std::strerror(errno);
+        return false;
+    }
+    segment.data = static_cast<uint8_t*>(data);
+
+    if (resized) {
+        std::memset(segment.data, 0, kHeaderSize);
+    }
+    recover(segment);
+    return true;
+}
+
+void BatchSpool::recover(Segment& segment) {
+    segment.generation = 0;
+    segment.read_offset = segment.write_offset = kHeaderSize;
+    segment.pending = 0;
+    segment.sealed = false;
+
+    if (load<uint32_t>(segment.data) != kSegmentMagic ||
+        load<uint32_t>(segment.data + 4) != kSegmentVersion) {
+        return;  // Never written
+    }
+    segment.generation = load<uint64_t>(segment.data + kGenerationOffset);
+    size_t read_offset = static_cast<size_t>(load<uint64_t>(segment.data + kReadOffsetOffset));
+    segment.read_offset = std::clamp(read_offset, kHeaderSize, config_.segment_bytes);
+
+    // Unreplayed records up to the first torn or stale one
+    size_t offset = segment.read_offset;
+    size_t size = 0;
+    while (read_record(segment, offset, size)) {
+        offset += record_span(size);
+        ++segment.pending;
+    }
+    segment.write_offset = offset;
+
+    if (offset + kRecordHeaderSize <= config_.segment_bytes &&
+        load<uint64_t>(segment.data + offset + 8) == segment.generation) {
+        // Torn record: later records of this generation may still be
+        // valid and must not be read again, so append in a fresh segment
+        segment.sealed = true;
+    }
+}
+
+void BatchSpool::reset(Segment& segment, uint64_t generation) {
+    store(segment.data, kSegmentMagic);
+    store(segment.data + 4, kSegmentVersion);
+    store(segment.data + kGenerationOffset, generation);
+    store(segment.data + kReadOffsetOffset, static_cast<uint64_t>(kHeaderSize));
+    std::memset(segment.data + kHeaderSize, 0, kRecordHeaderSize);
+
+    segment.generation = generation;
+    segment.read_offset = segment.write_offset = kHeaderSize;
+    segment.pending = 0;
+    segment.sealed = false;
+}
+
+void BatchSpool::persist_read_offset(Segment& segment) {
+    store(segment.data + kReadOffsetOffset, static_cast<uint64_t>(segment.read_offset));
+}
+
+bool BatchSpool::read_record(const Segment& segment, size_t offset, size_t& size) const {
+    if (offset + kRecordHeaderSize > config_.segment_bytes) {
+        return false;
+    }
+    const uint8_t* header = segment.data + offset;
+    uint32_t record_size = load<uint32_t>(header);
+    uint32_t crc = load<uint32_t>(header + 4);
+    uint64_t generation = load<uint64_t>(header + 8);
+
+    if (record_size == 0 || generation != segment.generation ||
+        offset + record_span(record_size) > config_.segment_bytes) {
+        return false;
+    }
+    if (record_crc(generation, record_size, header + kRecordHeaderSize) != crc) {
+        return false;
+    }
+    size = record_size;
+    return true;
+}
+
+bool BatchSpool::append(const uint8_t* data, size_t size) {
+    size_t span = record_span(size);
+    if (size == 0 || kHeaderSize + span > config_.segment_bytes) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Segment* segment = &segments_[write_index_];
+    if (segment->sealed || segment->write_offset + span > config_.segment_bytes) {
+        // Segment full: written out asynchronously, continue in the next
+        msync(segment->data, config_.segment_bytes, MS_ASYNC);
+        write_index_ = (write_index_ + 1) % segments_.size();
+        segment = &segments_[write_index_];
+        if (segment->pending > 0) {
+            LOG(WARNING) << "BatchSpool: full, dropping " << segment->pending
+                         << " oldest unreplayed batches";
+            stats_.batches_dropped += segment->pending;
+        }
+        reset(*segment, ++generation_);
+    }
+
+    // Payload before header: a record is only valid once both are written
+    uint8_t* record = segment->data + segment->write_offset;
+    auto record_size = static_cast<uint32_t>(size);
+    std::memcpy(record + kRecordHeaderSize, data, size);
+    store(record + 4, record_crc(segment->generation, record_size, data));
+    store(record + 8, segment->generation);
+    store(record, record_size);
+
+    segment->write_offset += span;
+    ++segment->pending;
+    ++stats_.batches_spooled;
+    segment->dirty = true;
+    unsynced_bytes_ += span;
+    if (unsynced_bytes_ >= std::max<size_t>(config_.sync_bytes, 1)) {
+        sync_appends();
+    }
+    return true;
+}
+
+void BatchSpool::sync_appends() {
+    // A full segment may still be dirty: its write-out was only started
+    for (auto& segment : segments_) {
+        if (segment.dirty) {
+            msync(segment.data, config_.segment_bytes, MS_SYNC);
+            segment.dirty = false;
+        }
+    }
+    unsynced_bytes_ = 0;
+}
+
+BatchSpool::Segment* BatchSpool::oldest() {
+    for (size_t i = 1; i <= segments_.size(); ++i) {
+        Segment& segment = segments_[(write_index_ + i) % segments_.size()];
+        if (segment.pending > 0) {
+            return &segment;
+        }
+    }
+    return nullptr;
+}
+
+bool BatchSpool::peek(std::vector<uint8_t>& out, Position& at) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    while (Segment* segment = oldest()) {
+        size_t size = 0;
+        if (read_record(*segment, segment->read_offset, size)) {
+            const uint8_t* payload = segment->data + segment->read_offset + kRecordHeaderSize;
+            out.assign(payload, payload + size);
+            at.segment = static_cast<size_t>(segment - segments_.data());
+            at.generation = segment->generation;
+            at.offset = segment->read_offset;
+            return true;
+        }
+        // Corrupted on disk since recovery: skip the rest of the segment
+        LOG(ERROR) << "BatchSpool: unreadable record, dropping " << segment->pending << " batches";
+        stats_.batches_dropped += segment->pending;
+        segment->pending = 0;
+        segment->read_offset = segment->write_offset;
+        persist_read_offset(*segment);
+    }
+    return false;
+}
+
+void BatchSpool::pop(const Position& at) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Segment* segment = oldest();
+    size_t size = 0;
+    if (!segment || segment != &segments_[at.segment] || segment->generation != at.generation ||
+        segment->read_offset != at.offset ||
+        !read_record(*segment, segment->read_offset, size)) {
+        return;
+    }
+    segment->read_offset += record_span(size);
+    --segment->pending;
+    persist_read_offset(*segment);
+    ++stats_.batches_replayed;
+}
+
+bool BatchSpool::empty() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::none_of(segments_.begin(), segments_.end(),
+                        [](const Segment& segment) { return segment.pending > 0; });
+}
+
+void BatchSpool::sync() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& segment : segments_) {
+        if (segment.data) {
+            msync(segment.data, config_.segment_bytes, MS_SYNC);
+            segment.dirty = false;
+        }
+    }
+    unsynced_bytes_ = 0;
+}
+
+SpoolStats BatchSpool::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    SpoolStats stats = stats_;
+    for (const auto& segment : segments_) {
+        if (segment.pending > 0) {
+            stats.batches_pending += segment.pending;
+            stats.bytes_pending += segment.write_offset - segment.read_offset;
+        }
+    }
+    return stats;
+}
+
+}  // namespace vep::exporter
@@ -4,16 +4,63 @@
 #include "compressor.hpp"
 
 #include <glog/logging.h>
+#include <lz4frame.h>
+#include <zdict.h>
 #include <zstd.h>
 
+#include <time.h>
+
 #include <algorithm>
 #include <cctype>
+#include <fstream>
+#include <iterator>
 
 namespace vep::exporter {
 
+namespace {
+
+// Frame magic numbers, little-endian on the wire
+constexpr uint32_t kZstdMagic = 0xFD2FB528;
+constexpr uint32_t kLz4Magic = 0x184D2204;
+
+// AUTO: zstd levels between lz4 and the configured maximum
+constexpr int kAutoZstdLevels[] = {-5, -1, 1};
+
+// AUTO: a stronger level must shrink output by this much to be kept
+constexpr double kAutoMinGain = 0.97;
+
+// AUTO: smaller batches are compressed but not timed (clock noise)
+constexpr size_t kAutoMinSampleBytes = 512;
+
+uint32_t read_le32(const uint8_t* data) {
+    return static_cast<uint32_t>(data[0]) | static_cast<uint32_t>(data[1]) << 8 |
+           static_cast<uint32_t>(data[2]) << 16 | static_cast<uint32_t>(data[3]) << 24;
+}
+
+// CPU time of the calling thread; unlike wall time, not inflated when
+// the compress worker is preempted
+int64_t thread_cpu_ns() {
+    timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+LZ4F_preferences_t lz4_preferences(int level, size_t content_size) {
+    LZ4F_preferences_t prefs{};
+    prefs.compressionLevel = level;
+    prefs.autoFlush = 1;
+    // Lets the receiver size its buffer exactly
+    prefs.frameInfo.contentSize = content_size;
+    return prefs;
+}
+
+}  // namespace
+
 const char* to_string(CompressorType type) {
     switch (type) {
         case CompressorType::ZSTD: return "zstd";
+        case CompressorType::LZ4: return "lz4";
+        case CompressorType::AUTO: return "auto";
         case CompressorType::NONE: return "none";
     }
     return "unknown";
@@ -27,6 +74,10 @@ std::optional<CompressorType> compressor_type_from_string(const std::string& nam
 
     if (lower == "zstd") {
         return CompressorType::ZSTD;
+    } else if (lower == "lz4") {
+        return CompressorType::LZ4;
+    } else if (lower == "auto") {
+        return CompressorType::AUTO;
     } else if (lower == "none") {
         return CompressorType::NONE;
     }
@@ -34,8 +85,32 @@ std::optional<CompressorType> compressor_type_from_string(const std::string& nam
     return std::nullopt;
 }
 
-ZstdCompressor::ZstdCompressor(int level)
-    : level_(level) {
+int default_compression_level(CompressorType type) {
+    switch (type) {
+        case CompressorType::ZSTD: return 3;
+        case CompressorType::AUTO: return 3;
+        case CompressorType::LZ4: return 0;
+        case CompressorType::NONE: return 0;
+    }
+    return 0;
+}
+
+CompressorType detect_compressor_type(const uint8_t* data, size_t size) {
+    if (size < 4) {
+        return CompressorType::NONE;
+    }
+    // A TransferBatch starts with a field tag (0x09, 0x12, ...), never
+    // with either magic's first byte
+    switch (read_le32(data)) {
+        case kZstdMagic: return CompressorType::ZSTD;
+        case kLz4Magic: return CompressorType::LZ4;
+        default: return CompressorType::NONE;
+    }
+}
+
+ZstdCompressor::ZstdCompressor(int level, std::vector<uint8_t> dictionary)
+    : level_(level)
+    , dictionary_(std::move(dictionary)) {
 }
 
 ZstdCompressor::~ZstdCompressor() {
@@ -52,23 +127,50 @@ bool ZstdCompressor::init() {
         return false;
     }
     ZSTD_CCtx_setParameter(ctx_, ZSTD_c_compressionLevel, level_);
+
+    if (!dictionary_.empty()) {
+        // The CDict keeps its own copy, digested for level_
+        ZSTD_CDict* cdict = ZSTD_createCDict(dictionary_.data(), dictionary_.size(), level_);
+        if (!cdict) {
+            LOG(ERROR) << "Failed to load ZSTD dictionary (" << dictionary_.size() << " bytes)";
+            return false;
+        }
+        cdict_.reset(cdict, ZSTD_freeCDict);
+        dictionary_id_ = ZSTD_getDictID_fromDict(dictionary_.data(), dictionary_.size());
+        dictionary_.clear();
+        dictionary_.shrink_to_fit();
+    }
     return true;
 }
 
 std::vector<uint8_t> ZstdCompressor::compress(const std::vector<uint8_t>& data) {
+    std::vector<uint8_t> compressed;
+    compress_into(data, compressed);
+    return compressed;
+}
+
+void ZstdCompressor::compress_into(const std::vector<uint8_t>& data, std::vector<uint8_t>& out) {
     if (!ctx_) {
         LOG(WARNING) << "ZSTD context not initialized, returning uncompressed";
-        return std::vector<uint8_t>(data.begin(), data.end());
+        out.assign(data.begin(), data.end());
+        return;
     }
 
-    size_t max_size = ZSTD_compressBound(data.size());
-    std::vector<uint8_t> compressed(max_size);
-
-    size_t result = ZSTD_compressCCtx(
-        ctx_,
-        compressed.data(), compressed.size(),
-        data.data(), data.size(),
-        level_);
+    // Allocates only if out's capacity is below the bound
+    out.resize(ZSTD_compressBound(data.size()));
+
+    // With a dictionary the frame header carries its id
+    size_t result = cdict_
+        ? ZSTD_compress_usingCDict(
+              ctx_,
+              out.data(), out.size(),
+              data.data(), data.size(),
+              cdict_.get())
+        : ZSTD_compressCCtx(
+              ctx_,
+              out.data(), out.size(),
+              data.data(), data.size(),
+              level_);
 
     stats_.bytes_before += data.size();
     stats_.operations++;
@@ -77,44 +179,382 @@ std::vector<uint8_t> ZstdCompressor::compress(const std::vector<uint8_t>& data)
         LOG(WARNING) << "Compression failed: " << ZSTD_getErrorName(result);
         // Fall back to uncompressed
         stats_.bytes_after += data.size();
-        return std::vector<uint8_t>(data.begin(), data.end());
+        out.assign(data.begin(), data.end());
+        return;
     }
 
-    compressed.resize(result);
+    out.resize(result);
     stats_.bytes_after += result;
-    return compressed;
 }
 
 CompressionStats ZstdCompressor::stats() const {
     return stats_;
 }
 
-std::unique_ptr<Compressor> create_compressor(CompressorType type, int level) {
+size_t ZstdCompressor::max_compressed_size(size_t input_size) const {
+    // Also covers the uncompressed fallback on error
+    return ZSTD_compressBound(input_size);
+}
+
+std::unique_ptr<Compressor> ZstdCompressor::clone() const {
+    auto clone = std::make_unique<ZstdCompressor>(level_);
+    clone->cdict_ = cdict_;
+    clone->dictionary_id_ = dictionary_id_;
+    if (!clone->init()) {
+        return nullptr;
+    }
+    return clone;
+}
+
+// =============================================================================
+// LZ4
+// =============================================================================
+
+Lz4Compressor::Lz4Compressor(int level)
+    : level_(level) {
+}
+
+Lz4Compressor::~Lz4Compressor() {
+    if (ctx_) {
+        LZ4F_freeCompressionContext(ctx_);
+        ctx_ = nullptr;
+    }
+}
+
+bool Lz4Compressor::init() {
+    LZ4F_errorCode_t result = LZ4F_createCompressionContext(&ctx_, LZ4F_VERSION);
+    if (LZ4F_isError(result)) {
+        LOG(ERROR) << "Failed to create LZ4 compression context: " << LZ4F_getErrorName(result);
+        ctx_ = nullptr;
+        return false;
+    }
+    return true;
+}
+
+std::vector<uint8_t> Lz4Compressor::compress(const std::vector<uint8_t>& data) {
+    std::vector<uint8_t> compressed;
+    compress_into(data, compressed);
+    return compressed;
+}
+
+void Lz4Compressor::compress_into(const std::vector<uint8_t>& data, std::vector<uint8_t>& out) {
+    if (!ctx_) {
+        LOG(WARNING) << "LZ4 context not initialized, returning uncompressed";
+        out.assign(data.begin(), data.end());
+        return;
+    }
+
+    // One frame per batch; the context is reused, so no allocation
+    // beyond out's capacity
+    LZ4F_preferences_t prefs = lz4_preferences(level_, data.size());
+    out.resize(LZ4F_compressFrameBound(data.size(), &prefs));
+
+    size_t pos = LZ4F_compressBegin(ctx_, out.data(), out.size(), &prefs);
+    if (!LZ4F_isError(pos)) {
+        size_t result = LZ4F_compressUpdate(ctx_, out.data() + pos, out.size() - pos,
+                                            data.data(), data.size(), nullptr);
+        pos = LZ4F_isError(result) ? result : pos + result;
+    }
+    if (!LZ4F_isError(pos)) {
+        size_t result = LZ4F_compressEnd(ctx_, out.data() + pos, out.size() - pos, nullptr);
+        pos = LZ4F_isError(result) ? result : pos + result;
+    }
+
+    stats_.bytes_before += data.size();
+    stats_.operations++;
+
+    if (LZ4F_isError(pos)) {
+        LOG(WARNING) << "Compression failed: " << LZ4F_getErrorName(pos);
+        // Fall back to uncompressed
+        stats_.bytes_after += data.size();
+        out.assign(data.begin(), data.end());
+        return;
+    }
+
+    out.resize(pos);
+    stats_.bytes_after += pos;
+}
+
+size_t Lz4Compressor::max_compressed_size(size_t input_size) const {
+    LZ4F_preferences_t prefs = lz4_preferences(level_, input_size);
+    return std::max(LZ4F_compressFrameBound(input_size, &prefs), input_size);
+}
+
+std::unique_ptr<Compressor> Lz4Compressor::clone() const {
+    auto clone = std::make_unique<Lz4Compressor>(level_);
+    if (!clone->init()) {
+        return nullptr;
+    }
+    return clone;
+}
+
+// =============================================================================
+// AUTO
+// =============================================================================
+
+AutoCompressor::AutoCompressor(const AutoCompressionConfig& config, std::vector<uint8_t> dictionary)
+    : config_(config)
+    , dictionary_(std::move(dictionary)) {
+    config_.smoothing = std::clamp(config_.smoothing, 0.01, 1.0);
+    config_.probe_interval = std::max<size_t>(1, config_.probe_interval);
+}
+
+bool AutoCompressor::init() {
+    auto lz4 = std::make_unique<Lz4Compressor>();
+    if (!lz4->init()) {
+        return false;
+    }
+    levels_.push_back(Level{std::move(lz4), 0});
+
+    std::vector<int> zstd_levels;
+    for (int level : kAutoZstdLevels) {
+        if (level < config_.max_level) {
+            zstd_levels.push_back(level);
+        }
+    }
+    zstd_levels.push_back(config_.max_level);
+
+    for (int level : zstd_levels) {
+        auto zstd = std::make_unique<ZstdCompressor>(level, dictionary_);
+        if (!zstd->init()) {
+            return false;
+        }
+        levels_.push_back(Level{std::move(zstd), level});
+    }
+    dictionary_.clear();
+    dictionary_.shrink_to_fit();
+
+    // Start strongest: bandwidth first until the budget says otherwise
+    current_ = levels_.size() - 1;
+    return true;
+}
+
+std::vector<uint8_t> AutoCompressor::compress(const std::vector<uint8_t>& data) {
+    std::vector<uint8_t> compressed;
+    compress_into(data, compressed);
+    return compressed;
+}
+
+void AutoCompressor::compress_into(const std::vector<uint8_t>& data, std::vector<uint8_t>& out) {
+    if (levels_.empty()) {
+        LOG(WARNING) << "AUTO compressor not initialized, returning uncompressed";
+        out.assign(data.begin(), data.end());
+        return;
+    }
+
+    Level& level = levels_[current_];
+    int64_t start = thread_cpu_ns();
+    level.compressor->compress_into(data, out);
+    int64_t cpu_ns = thread_cpu_ns() - start;
+
+    stats_.bytes_before += data.size();
+    stats_.bytes_after += out.size();
+    stats_.operations++;
+
+    if (data.size() >= kAutoMinSampleBytes) {
+        observe(level, cpu_ns, data.size(), out.size());
+        select();
+    }
+}
+
+void AutoCompressor::observe(Level& level, int64_t cpu_ns, size_t input_size,
+                             size_t output_size) {
+    double ns_per_byte = static_cast<double>(cpu_ns) / input_size;
+    double ratio = static_cast<double>(output_size) / input_size;
+    if (!level.measured) {
+        level.ns_per_byte = ns_per_byte;
+        level.ratio = ratio;
+        level.measured = true;
+    } else {
+        level.ns_per_byte += config_.smoothing * (ns_per_byte - level.ns_per_byte);
+        level.ratio += config_.smoothing * (ratio - level.ratio);
+    }
+    ++batches_at_current_;
+}
+
+void AutoCompressor::select() {
+    const Level& level = levels_[current_];
+    size_t next = current_;
+
+    if (current_ > 0 && level.ns_per_byte > config_.max_ns_per_byte) {
+        next = current_ - 1;
+    } else if (current_ > 0 && levels_[current_ - 1].measured &&
+               level.ratio > levels_[current_ - 1].ratio * kAutoMinGain) {
+        // Costs more for (almost) nothing, e.g. incompressible input
+        next = current_ - 1;
+    } else if (current_ + 1 < levels_.size() &&
+               batches_at_current_ >= config_.probe_interval) {
+        next = current_ + 1;
+    }
+
+    if (next != current_) {
+        current_ = next;
+        batches_at_current_ = 0;
+    }
+}
+
+size_t AutoCompressor::max_compressed_size(size_t input_size) const {
+    // Any level may compress the next batch
+    size_t bound = input_size;
+    for (const auto& level : levels_) {
+        bound = std::max(bound, level.compressor->max_compressed_size(input_size));
+    }
+    return bound;
+}
+
+std::unique_ptr<Compressor> AutoCompressor::clone() const {
+    auto clone = std::make_unique<AutoCompressor>(config_);
+    for (const auto& level : levels_) {
+        auto compressor = level.compressor->clone();
+        if (!compressor) {
+            return nullptr;
+        }
+        clone->levels_.push_back(Level{std::move(compressor), level.level});
+    }
+    clone->current_ = current_;
+    return clone;
+}
+
+CompressorType AutoCompressor::current_type() const {
+    return levels_.empty() ? CompressorType::NONE : levels_[current_].compressor->type();
+}
+
+int AutoCompressor::current_level() const {
+    return levels_.empty() ? 0 : levels_[current_].level;
+}
+
+size_t Compressor::max_input_size(size_t output_limit) const {
+    // Bounds grow with the input: binary search the largest input that fits
+    size_t low = 0;
+    size_t high = output_limit;
+    while (low < high) {
+        size_t mid = high - (high - low) / 2;
+        if (max_compressed_size(mid) <= output_limit) {
+            low = mid;
+        } else {
+            high = mid - 1;
+        }
+    }
+    return low;
+}
+
+std::unique_ptr<Compressor> create_compressor(CompressorType type, int level,
+                                              const std::vector<uint8_t>& dictionary) {
     switch (type) {
         case CompressorType::ZSTD: {
-            auto comp = std::make_unique<ZstdCompressor>(level);
+            auto comp = std::make_unique<ZstdCompressor>(level, dictionary);
+            if (!comp->init()) {
+                return nullptr;
+            }
+            return comp;
+        }
+        case CompressorType::LZ4: {
+            auto comp = std::make_unique<Lz4Compressor>(level);
             if (!comp->init()) {
                 return nullptr;
             }
             return comp;
         }
+        case CompressorType::AUTO: {
+            AutoCompressionConfig config;
+            config.max_level = level;
+            return create_auto_compressor(config, dictionary);
+        }
         case CompressorType::NONE:
             return std::make_unique<NoCompressor>();
     }
     return nullptr;
 }
 
+std::unique_ptr<Compressor> create_auto_compressor(const AutoCompressionConfig& config,
+                                                   const std::vector<uint8_t>& dictionary) {
+    auto comp = std::make_unique<AutoCompressor>(config, dictionary);
+    if (!comp->init()) {
+        return nullptr;
+    }
+    return comp;
+}
+
+// =============================================================================
+// ZSTD dictionaries
+// =============================================================================
+
+std::optional<std::vector<uint8_t>> train_zstd_dictionary(
+    const std::vector<std::vector<uint8_t>>& samples, size_t max_size) {
+    // ZDICT takes the samples concatenated, with their sizes
+    std::vector<uint8_t> buffer;
+    std::vector<size_t> sizes;
+    sizes.reserve(samples.size());
+    for (const auto& sample : samples) {
+        buffer.insert(buffer.end(), sample.begin(), sample.end());
+        sizes.push_back(sample.size());
+    }
+
+    std::vector<uint8_t> dictionary(max_size);
+    size_t result = ZDICT_trainFromBuffer(dictionary.data(), dictionary.size(),
+                                          buffer.data(), sizes.data(),
+                                          static_cast<unsigned>(sizes.size()));
+    if (ZDICT_isError(result)) {
+        LOG(ERROR) << "ZSTD dictionary training on " << samples.size() << " samples ("
+                   << buffer.size() << " bytes) failed: " << ZDICT_getErrorName(result);
+        return std::nullopt;
+    }
+    dictionary.resize(result);
+    return dictionary;
+}
+
+std::optional<std::vector<uint8_t>> load_zstd_dictionary(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        LOG(ERROR) << "Cannot open ZSTD dictionary: " << path;
+        return std::nullopt;
+    }
+    std::vector<uint8_t> dictionary((std::istreambuf_iterator<char>(file)),
+                                    std::istreambuf_iterator<char>());
+    if (zstd_dictionary_id(dictionary) == 0) {
+        LOG(ERROR) << "Not a trained ZSTD dictionary (no dictionary id): " << path;
+        return std::nullopt;
+    }
+    return dictionary;
+}
+
+uint32_t zstd_dictionary_id(const std::vector<uint8_t>& dictionary) {
+    return ZSTD_getDictID_fromDict(dictionary.data(), dictionary.size());
+}
+
 // =============================================================================
 // Decompression
 // =============================================================================
 
 ZstdDecompressor::~ZstdDecompressor() {
+    for (auto& [id, ddict] : dictionaries_) {
+        ZSTD_freeDDict(ddict);
+    }
     if (ctx_) {
         ZSTD_freeDCtx(ctx_);
         ctx_ = nullptr;
     }
 }
 
+bool ZstdDecompressor::add_dictionary(const std::vector<uint8_t>& dictionary) {
+    uint32_t id = zstd_dictionary_id(dictionary);
+    if (id == 0) {
+        LOG(ERROR) << "ZSTD dictionary has no dictionary id";
+        return false;
+    }
+    ZSTD_DDict* ddict = ZSTD_createDDict(dictionary.data(), dictionary.size());
+    if (!ddict) {
+        LOG(ERROR) << "Failed to load ZSTD dictionary " << id;
+        return false;
+    }
+    auto [it, inserted] = dictionaries_.emplace(id, ddict);
+    if (!inserted) {
+        ZSTD_freeDDict(it->second);
+        it->second = ddict;
+    }
+    return true;
+}
+
 bool ZstdDecompressor::init() {
     ctx_ = ZSTD_createDCtx();
     if (!ctx_) {
@@ -140,19 +580,42 @@ std::vector<uint8_t> ZstdDecompressor::decompress(const std::vector<uint8_t>& da
 
     if (decompressed_size == ZSTD_CONTENTSIZE_UNKNOWN) {
         // Size unknown, use a reasonable estimate
-        decompressed_size = data.size() * 10;
+        decompressed_size = std::min<unsigned long long>(data.size() * 10, max_output_size_);
     } else if (decompressed_size == ZSTD_CONTENTSIZE_ERROR) {
         LOG(ERROR) << "Invalid zstd frame";
         stats_.errors++;
         return {};
+    } else if (decompressed_size > max_output_size_) {
+        // Untrusted header: do not allocate what it claims
+        LOG(ERROR) << "Zstd frame of " << decompressed_size << " bytes exceeds limit of "
+                   << max_output_size_;
+        stats_.errors++;
+        return {};
+    }
+
+    const ZSTD_DDict* ddict = nullptr;
+    if (uint32_t dict_id = ZSTD_getDictID_fromFrame(data.data(), data.size())) {
+        auto it = dictionaries_.find(dict_id);
+        if (it == dictionaries_.end()) {
+            LOG(ERROR) << "Frame needs unknown ZSTD dictionary " << dict_id;
+            stats_.errors++;
+            return {};
+        }
+        ddict = it->second;
     }
 
     std::vector<uint8_t> decompressed(decompressed_size);
 
-    size_t result = ZSTD_decompressDCtx(
-        ctx_,
-        decompressed.data(), decompressed.size(),
-        data.data(), data.size());
+    size_t result = ddict
+        ? ZSTD_decompress_usingDDict(
+              ctx_,
+              decompressed.data(), decompressed.size(),
+              data.data(), data.size(),
+              ddict)
+        : ZSTD_decompressDCtx(
+              ctx_,
+              decompressed.data(), decompressed.size(),
+              data.data(), data.size());
 
     stats_.bytes_before += data.size();
     stats_.operations++;
@@ -168,13 +631,165 @@ std::vector<uint8_t> ZstdDecompressor::decompress(const std::vector<uint8_t>& da
     return decompressed;
 }
 
-std::unique_ptr<Decompressor> create_decompressor(CompressorType type) {
+Lz4Decompressor::~Lz4Decompressor() {
+    if (ctx_) {
+        LZ4F_freeDecompressionContext(ctx_);
+        ctx_ = nullptr;
+    }
+}
+
+bool Lz4Decompressor::init() {
+    LZ4F_errorCode_t result = LZ4F_createDecompressionContext(&ctx_, LZ4F_VERSION);
+    if (LZ4F_isError(result)) {
+        LOG(ERROR) << "Failed to create LZ4 decompression context: " << LZ4F_getErrorName(result);
+        ctx_ = nullptr;
+        return false;
+    }
+    return true;
+}
+
+std::vector<uint8_t> Lz4Decompressor::decompress(const std::vector<uint8_t>& data) {
+    if (!ctx_) {
+        LOG(WARNING) << "LZ4 decompression context not initialized";
+        stats_.errors++;
+        return {};
+    }
+
+    if (data.empty()) {
+        return {};
+    }
+
+    // Get decompressed size from frame header
+    LZ4F_frameInfo_t info{};
+    size_t pos = data.size();
+    size_t result = LZ4F_getFrameInfo(ctx_, &info, data.data(), &pos);
+    if (LZ4F_isError(result)) {
+        LOG(ERROR) << "Invalid lz4 frame: " << LZ4F_getErrorName(result);
+        LZ4F_resetDecompressionContext(ctx_);
+        stats_.errors++;
+        return {};
+    }
+
+    if (info.contentSize > max_output_size_) {
+        // Untrusted header: do not allocate what it claims
+        LOG(ERROR) << "LZ4 frame of " << info.contentSize << " bytes exceeds limit of "
+                   << max_output_size_;
+        LZ4F_resetDecompressionContext(ctx_);
+        stats_.errors++;
+        return {};
+    }
+
+    std::vector<uint8_t> decompressed(
+        info.contentSize > 0 ? info.contentSize : std::min(data.size() * 10, max_output_size_));
+    size_t written = 0;
+
+    // result is 0 once the frame is complete
+    while (result != 0) {
+        if (written == decompressed.size()) {
+            if (written >= max_output_size_) {
+                LOG(ERROR) << "LZ4 frame exceeds limit of " << max_output_size_ << " bytes";
+                LZ4F_resetDecompressionContext(ctx_);
+                stats_.errors++;
+                return {};
+            }
+            decompressed.resize(std::min(decompressed.size() * 2, max_output_size_));
+        }
+        size_t out_size = decompressed.size() - written;
+        size_t in_size = data.size() - pos;
+        result = LZ4F_decompress(ctx_, decompressed.data() + written, &out_size,
+                                 data.data() + pos, &in_size, nullptr);
+        if (LZ4F_isError(result)) {
+            break;
+        }
+        pos += in_size;
+        written += out_size;
+        if (result != 0 && pos == data.size() && written < decompressed.size()) {
+            LOG(ERROR) << "Truncated lz4 frame";
+            LZ4F_resetDecompressionContext(ctx_);
+            stats_.errors++;
+            return {};
+        }
+    }
+
+    stats_.bytes_before += data.size();
+    stats_.operations++;
+
+    if (LZ4F_isError(result)) {
+        LOG(ERROR) << "Decompression failed: " << LZ4F_getErrorName(result);
+        LZ4F_resetDecompressionContext(ctx_);
+        stats_.errors++;
+        return {};
+    }
+
+    decompressed.resize(written);
+    stats_.bytes_after += written;
+    return decompressed;
+}
+
+bool AutoDecompressor::init() {
+    return zstd_.init() && lz4_.init() && none_.init();
+}
+
+std::vector<uint8_t> AutoDecompressor::decompress(const std::vector<uint8_t>& data) {
+    switch (detect_compressor_type(data.data(), data.size())) {
+        case CompressorType::ZSTD: return zstd_.decompress(data);
+        case CompressorType::LZ4: return lz4_.decompress(data);
+        default: return none_.decompress(data);
+    }
+}
+
+void AutoDecompressor::set_max_output_size(size_t max_bytes) {
+    Decompressor::set_max_output_size(max_bytes);
+    zstd_.set_max_output_size(max_bytes);
+    lz4_.set_max_output_size(max_bytes);
+}
+
+DecompressionStats AutoDecompressor::stats() const {
+    DecompressionStats total;
+    for (const Decompressor* codec : {static_cast<const Decompressor*>(&zstd_),
+                                      static_cast<const Decompressor*>(&lz4_),
+                                      static_cast<const Decompressor*>(&none_)}) {
+        DecompressionStats stats = codec->stats();
+        total.bytes_before += stats.bytes_before;
+        total.bytes_after += stats.bytes_after;
+        total.operations += stats.operations;
+        total.errors += stats.errors;
+    }
+    return total;
+}
+
+std::unique_ptr<Decompressor> create_decompressor(CompressorType type,
+                                                  const std::vector<uint8_t>& dictionary,
+                                                  size_t max_output_size) {
     switch (type) {
         case CompressorType::ZSTD: {
             auto decomp = std::make_unique<ZstdDecompressor>();
             if (!decomp->init()) {
                 return nullptr;
             }
+            if (!dictionary.empty() && !decomp->add_dictionary(dictionary)) {
+                return nullptr;
+            }
+            decomp->set_max_output_size(max_output_size);
+            return decomp;
+        }
+        case CompressorType::LZ4: {
+            auto decomp = std::make_unique<Lz4Decompressor>();
+            if (!decomp->init()) {
+                return nullptr;
+            }
+            decomp->set_max_output_size(max_output_size);
+            return decomp;
+        }
+        case CompressorType::AUTO: {
+            auto decomp = std::make_unique<AutoDecompressor>();
+            if (!decomp->init()) {
+                return nullptr;
+            }
+            if (!dictionary.empty() && !decomp->add_dictionary(dictionary)) {
+                return nullptr;
+            }
+            decomp->set_max_output_size(max_output_size);
             return decomp;
         }
         case CompressorType::NONE:
@@ -0,0 +1,767 @@
+// Copyright 2025 Vehicle Edge Platform Contributors
+// SPDX-License-Identifier: Apache-2.0
+
+#include "direct_encoder.hpp"
+
+#include <cstring>
+
+namespace vep::exporter {
+
+namespace {
+
+// Field numbers from transfer.proto
+constexpr uint32_t kBatchBaseTimestamp = 1;
+constexpr uint32_t kBatchSourceId = 2;
+constexpr uint32_t kBatchSequence = 3;
+constexpr uint32_t kBatchPathDictionary = 4;
+constexpr uint32_t kBatchStrings = 5;
+constexpr uint32_t kBatchSession = 6;
+constexpr uint32_t kBatchItems = 10;
+
+constexpr uint32_t kItemTimestampDelta = 1;
+constexpr uint32_t kItemSignal = 10;
+constexpr uint32_t kItemEvent = 11;
+constexpr uint32_t kItemMetric = 12;
+constexpr uint32_t kItemLog = 13;
+
+// Signal and StructField share value field numbers
+constexpr uint32_t kValueBool = 10;
+constexpr uint32_t kValueInt32 = 11;
+constexpr uint32_t kValueInt64 = 12;
+constexpr uint32_t kValueUint32 = 13;
+constexpr uint32_t kValueUint64 = 14;
+constexpr uint32_t kValueFloat = 15;
+constexpr uint32_t kValueDouble = 16;
+constexpr uint32_t kValueString = 17;
+constexpr uint32_t kValueBoolArray = 20;
+constexpr uint32_t kValueInt32Array = 21;
+constexpr uint32_t kValueInt64Array = 22;
+constexpr uint32_t kValueUint32Array = 23;
+constexpr uint32_t kValueUint64Array = 24;
+constexpr uint32_t kValueFloatArray = 25;
+constexpr uint32_t kValueDoubleArray = 26;
+constexpr uint32_t kValueStringArray = 27;
+constexpr uint32_t kValueStruct = 30;
+constexpr uint32_t kValueStructArray = 31;
+
+enum WireType : uint32_t {
+    kVarint = 0,
+    kFixed64 = 1,
+    kLengthDelimited = 2,
+    kFixed32 = 5,
+};
+
+/// Appends protobuf wire primitives to a byte buffer
+///
+/// Nested messages reserve one length byte and are shifted in end_nested()
+/// in the rare case the body exceeds 127 bytes, so items are written in a
+/// single pass without a separate size computation.
+class WireWriter {
+public:
+    explicit WireWriter(std::vector<uint8_t>& out) : out_(out) {}
+
+    void varint(uint64_t value) {
+        while (value >= 0x80) {
+            out_.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out_.push_back(static_cast<uint8_t>(value));
+    }
+
+    void tag(uint32_t field, WireType type) {
+        varint((static_cast<uint64_t>(field) << 3) | type);
+    }
+
+    void fixed32(float value) {
+        uint32_t raw;
+        std::memcpy(&raw, &value, sizeof(raw));
+        for (int i = 0; i < 4; ++i) {
+            out_.push_back(static_cast<uint8_t>(raw >> (8 * i)));
+        }
+    }
+
+    void fixed64(uint64_t raw) {
+        for (int i = 0; i < 8; ++i) {
+            out_.push_back(static_cast<uint8_t>(raw >> (8 * i)));
+        }
+    }
+
+    void fixed64(double value) {
+        uint64_t raw;
+        std::memcpy(&raw, &value, sizeof(raw));
+        fixed64(raw);
+    }
+
+    void uint_field(uint32_t field, uint64_t value) {
+        tag(field, kVarint);
+        varint(value);
+    }
+
+    // int32 and enums are sign-extended to 64 bits on the wire
+    void int_field(uint32_t field, int64_t value) {
+        uint_field(field, static_cast<uint64_t>(value));
+    }
+
+    void float_field(uint32_t field, float value) {
+        tag(field, kFixed32);
+        fixed32(value);
+    }
+
+    void double_field(uint32_t field, double value) {
+        tag(field, kFixed64);
+        fixed64(value);
+    }
+
+    void string_field(uint32_t field, const char* value) {
+        size_t len = value ? std::strlen(value) : 0;
+        tag(field, kLengthDelimited);
+        varint(len);
+        out_.insert(out_.end(), value, value + len);
+    }
+
+    /// Proto3 implicit presence: empty strings are not written
+    void optional_string_field(uint32_t field, const char* value) {
+        if (value && value[0] != '\0') {
+            string_field(field, value);
+        }
+    }
+
+    void bytes_field(uint32_t field, const uint8_t* data, size_t len) {
+        tag(field, kLengthDelimited);
+        varint(len);
+        out_.insert(out_.end(), data, data + len);
+    }
+
+    size_t begin_nested(uint32_t field) {
+        tag(field, kLengthDelimited);
+        out_.push_back(0);
+        return out_.size();
+    }
+
+    void end_nested(size_t body_start) {
+        size_t len = out_.size() - body_start;
+        if (len < 0x80) {
+            out_[body_start - 1] = static_cast<uint8_t>(len);
+            return;
+        }
+        size_t prefix = 1;
+        for (size_t v = len; v >= 0x80; v >>= 7) {
+            prefix++;
+        }
+        out_.insert(out_.begin() + static_cast<std::ptrdiff_t>(body_start), prefix - 1, 0);
+        uint8_t* p = out_.data() + body_start - 1;
+        while (len >= 0x80) {
+            *p++ = static_cast<uint8_t>(len | 0x80);
+            len >>= 7;
+        }
+        *p = static_cast<uint8_t>(len);
+    }
+
+private:
+    std::vector<uint8_t>& out_;
+};
+
+// Array message ({Type}Array.values = 1, packed). A set oneof array is
+// always written, even when empty, matching mutable_*_array().
+
+template<typename Seq, typename Conv>
+void write_varint_array(WireWriter& w, uint32_t field, const Seq& seq, Conv conv) {
+    size_t arr = w.begin_nested(field);
+    if (seq._buffer && seq._length > 0) {
+        size_t packed = w.begin_nested(1);
+        for (uint32_t i = 0; i < seq._length; ++i) {
+            w.varint(conv(seq._buffer[i]));
+        }
+        w.end_nested(packed);
+    }
+    w.end_nested(arr);
+}
+
+template<typename Seq>
+void write_int_array(WireWriter& w, uint32_t field, const Seq& seq) {
+    write_varint_array(w, field, seq, [](auto v) {
+        return static_cast<uint64_t>(static_cast<int64_t>(v));
+    });
+}
+
+template<typename Seq>
+void write_uint_array(WireWriter& w, uint32_t field, const Seq& seq) {
+    write_varint_array(w, field, seq, [](auto v) {
+        return static_cast<uint64_t>(v);
+    });
+}
+
+void write_double_array(WireWriter& w, uint32_t field, const dds_sequence_double& seq) {
+    size_t arr = w.begin_nested(field);
+    if (seq._buffer && seq._length > 0) {
+        size_t packed = w.begin_nested(1);
+        for (uint32_t i = 0; i < seq._length; ++i) {
+            w.fixed64(seq._buffer[i]);
+        }
+        w.end_nested(packed);
+    }
+    w.end_nested(arr);
+}
+
+void write_float_array(WireWriter& w, uint32_t field, const dds_sequence_float& seq) {
+    size_t arr = w.begin_nested(field);
+    if (seq._buffer && seq._length > 0) {
+        size_t packed = w.begin_nested(1);
+        for (uint32_t i = 0; i < seq._length; ++i) {
+            w.fixed32(seq._buffer[i]);
+        }
+        w.end_nested(packed);
+    }
+    w.end_nested(arr);
+}
+
+void write_string_array(WireWriter& w, uint32_t field, const dds_sequence_string& seq) {
+    size_t arr = w.begin_nested(field);
+    if (seq._buffer) {
+        for (uint32_t i = 0; i < seq._length; ++i) {
+            w.string_field(1, seq._buffer[i]);
+        }
+    }
+    w.end_nested(arr);
+}
+
+/// Value types common to vep_VssValue and vep_VssStructField
+/// @return true if the type was handled
+template<typename Value>
+bool write_common_value(WireWriter& w, const Value& value) {
+    switch (value.type) {
+        case vep_VSS_VALUE_TYPE_BOOL:
+            w.uint_field(kValueBool, value.bool_value ? 1 : 0);
+            return true;
+        case vep_VSS_VALUE_TYPE_INT8:
+            w.int_field(kValueInt32, static_cast<int32_t>(value.int8_value));
+            return true;
+        case vep_VSS_VALUE_TYPE_INT16:
+            w.int_field(kValueInt32, value.int16_value);
+            return true;
+        case vep_VSS_VALUE_TYPE_INT32:
+            w.int_field(kValueInt32, value.int32_value);
+            return true;
+        case vep_VSS_VALUE_TYPE_INT64:
+            w.int_field(kValueInt64, value.int64_value);
+            return true;
+        case vep_VSS_VALUE_TYPE_UINT8:
+            w.uint_field(kValueUint32, value.uint8_value);
+            return true;
+        case vep_VSS_VALUE_TYPE_UINT16:
+            w.uint_field(kValueUint32, value.uint16_value);
+            return true;
+        case vep_VSS_VALUE_TYPE_UINT32:
+            w.uint_field(kValueUint32, value.uint32_value);
+            return true;
+        case vep_VSS_VALUE_TYPE_UINT64:
+            w.uint_field(kValueUint64, value.uint64_value);
+            return true;
+        case vep_VSS_VALUE_TYPE_FLOAT:
+            w.float_field(kValueFloat, value.float_value);
+            return true;
+        case vep_VSS_VALUE_TYPE_DOUBLE:
+            w.double_field(kValueDouble, value.double_value);
+            return true;
+        case vep_VSS_VALUE_TYPE_STRING:
+            w.string_field(kValueString, value.string_value);
+            return true;
+
+        case vep_VSS_VALUE_TYPE_BOOL_ARRAY:
+            write_varint_array(w, kValueBoolArray, value.bool_array,
+                               [](bool v) { return static_cast<uint64_t>(v ? 1 : 0); });
+            return true;
+        case vep_VSS_VALUE_TYPE_INT32_ARRAY:
+            write_int_array(w, kValueInt32Array, value.int32_array);
+            return true;
+        case vep_VSS_VALUE_TYPE_INT64_ARRAY:
+            write_int_array(w, kValueInt64Array, value.int64_array);
+            return true;
+        case vep_VSS_VALUE_TYPE_FLOAT_ARRAY:
+            write_float_array(w, kValueFloatArray, value.float_array);
+            return true;
+        case vep_VSS_VALUE_TYPE_DOUBLE_ARRAY:
+            write_double_array(w, kValueDoubleArray, value.double_array);
+            return true;
+        case vep_VSS_VALUE_TYPE_STRING_ARRAY:
+            write_string_array(w, kValueStringArray, value.string_array);
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+void write_struct_value(WireWriter& w, const vep_VssStructValue& dds_struct) {
+    w.optional_string_field(1, dds_struct.type_name);
+
+    if (dds_struct.fields._buffer) {
+        for (uint32_t i = 0; i < dds_struct.fields._length; ++i) {
+            const auto& dds_field = dds_struct.fields._buffer[i];
+            size_t field = w.begin_nested(2);
+            w.optional_string_field(1, dds_field.name);
+            write_common_value(w, dds_field);
+            w.end_nested(field);
+        }
+    }
+}
+
+/// Mirrors convert_value_to_signal()
+void write_signal_value(WireWriter& w, const vep_VssValue& value) {
+    if (write_common_value(w, value)) {
+        return;
+    }
+
+    switch (value.type) {
+        case vep_VSS_VALUE_TYPE_INT8_ARRAY:
+            write_varint_array(w, kValueInt32Array, value.int8_array, [](auto v) {
+                return static_cast<uint64_t>(static_cast<int64_t>(static_cast<int32_t>(v)));
+            });
+            break;
+        case vep_VSS_VALUE_TYPE_INT16_ARRAY:
+            write_int_array(w, kValueInt32Array, value.int16_array);
+            break;
+        case vep_VSS_VALUE_TYPE_UINT8_ARRAY:
+            write_uint_array(w, kValueUint32Array, value.uint8_array);
+            break;
+        case vep_VSS_VALUE_TYPE_UINT16_ARRAY:
+            write_uint_array(w, kValueUint32Array, value.uint16_array);
+            break;
+        case vep_VSS_VALUE_TYPE_UINT32_ARRAY:
+            write_uint_array(w, kValueUint32Array, value.uint32_array);
+            break;
+        case vep_VSS_VALUE_TYPE_UINT64_ARRAY:
+            write_uint_array(w, kValueUint64Array, value.uint64_array);
+            break;
+
+        case vep_VSS_VALUE_TYPE_STRUCT: {
+            size_t pb_struct = w.begin_nested(kValueStruct);
+            write_struct_value(w, value.struct_value);
+            w.end_nested(pb_struct);
+            break;
+        }
+        case vep_VSS_VALUE_TYPE_STRUCT_ARRAY: {
+            size_t arr = w.begin_nested(kValueStructArray);
+            if (value.struct_array._buffer) {
+                for (uint32_t i = 0; i < value.struct_array._length; ++i) {
+                    size_t pb_struct = w.begin_nested(1);
+                    write_struct_value(w, value.struct_array._buffer[i]);
+                    w.end_nested(pb_struct);
+                }
+            }
+            w.end_nested(arr);
+            break;
+        }
+
+        default:
+            break;  // EMPTY or unsupported: no value field
+    }
+}
+
+/// Calls fn(key) for every label key, or fn(value) for every value, in
+/// the order fill_labels() adds them: "service" first, then the labels
+template<typename Labels, typename Fn>
+void for_each_label(const vep_Header& header, const Labels& labels, bool values, Fn&& fn) {
+    if (header.source_id && header.source_id[0] != '\0') {
+        fn(values ? header.source_id : "service");
+    }
+    for (uint32_t i = 0; i < labels._length; ++i) {
+        const auto& label = labels._buffer[i];
+        if (label.key) {
+            fn(values ? (label.value ? label.value : "") : label.key);
+        }
+    }
+}
+
+/// Label keys and values as parallel repeated fields (all keys first)
+template<typename Labels>
+void write_labels(WireWriter& w, uint32_t keys_field, uint32_t values_field,
+                  const vep_Header& header, const Labels& labels) {
+    for_each_label(header, labels, false,
+                   [&](const char* key) { w.string_field(keys_field, key); });
+    for_each_label(header, labels, true,
+                   [&](const char* value) { w.string_field(values_field, value); });
+}
+
+/// Add label keys, then values, to strings (StringTable::reference_item order)
+template<typename Labels>
+void reference_labels(StringTable& strings, const vep_Header& header, const Labels& labels) {
+    for_each_label(header, labels, false, [&](const char* key) { strings.ref(key); });
+    for_each_label(header, labels, true, [&](const char* value) { strings.ref(value); });
+}
+
+/// Packed label references; labels must have been passed to strings
+/// already, keys before values
+template<typename Labels>
+void write_label_refs(WireWriter& w, uint32_t key_refs_field, uint32_t value_refs_field,
+                      const vep_Header& header, const Labels& labels,
+                      const StringTable& strings) {
+    size_t count = 0;
+    for_each_label(header, labels, false, [&](const char*) { count++; });
+    if (count == 0) {
+        return;
+    }
+    size_t keys = w.begin_nested(key_refs_field);
+    for_each_label(header, labels, false,
+                   [&](const char* key) { w.varint(strings.find(key)); });
+    w.end_nested(keys);
+    size_t values = w.begin_nested(value_refs_field);
+    for_each_label(header, labels, true,
+                   [&](const char* value) { w.varint(strings.find(value)); });
+    w.end_nested(values);
+}
+
+/// Labels that did not fit in the string table, sent inline
+template<typename Labels>
+void write_spilled_labels(WireWriter& w, uint32_t keys_field, uint32_t values_field,
+                          const vep_Header& header, const Labels& labels,
+                          const StringTable& strings) {
+    for_each_label(header, labels, false, [&](const char* key) {
+        if (strings.find(key) == 0) {
+            w.string_field(keys_field, key);
+        }
+    });
+    for_each_label(header, labels, true, [&](const char* value) {
+        if (strings.find(value) == 0) {
+            w.string_field(values_field, value);
+        }
+    });
+}
+
+/// Metric name (field 1), or its reference (field 3) and the label
+/// references (fields 4 and 5) that follow it in field order
+template<typename Msg>
+void write_metric_head(WireWriter& w, const Msg& msg, StringTable* strings) {
+    if (!strings) {
+        w.optional_string_field(1, msg.name);
+        return;
+    }
+    uint32_t name_ref = msg.name && msg.name[0] != '\0' ? strings->ref(msg.name) : 0;
+    if (name_ref == 0) {
+        w.optional_string_field(1, msg.name);
+    }
+    reference_labels(*strings, msg.header, msg.labels);
+    if (name_ref != 0) {
+        w.uint_field(3, name_ref);
+    }
+    write_label_refs(w, 4, 5, msg.header, msg.labels, *strings);
+}
+
+/// Metric labels (fields 20 and 21): all of them, or those not in strings
+template<typename Msg>
+void write_metric_labels(WireWriter& w, const Msg& msg, const StringTable* strings) {
+    if (strings) {
+        write_spilled_labels(w, 20, 21, msg.header, msg.labels, *strings);
+    } else {
+        write_labels(w, 20, 21, msg.header, msg.labels);
+    }
+}
+
+/// Opens TransferItem and its payload; returns {item, payload} marks
+struct ItemFrame {
+    size_t item;
+    size_t payload;
+};
+
+ItemFrame begin_item(WireWriter& w, uint32_t payload_field, uint32_t timestamp_delta_ms) {
+    ItemFrame frame;
+    frame.item = w.begin_nested(kBatchItems);
+    if (timestamp_delta_ms != 0) {
+        w.uint_field(kItemTimestampDelta, timestamp_delta_ms);
+    }
+    frame.payload = w.begin_nested(payload_field);
+    return frame;
+}
+
+void end_item(WireWriter& w, const ItemFrame& frame) {
+    w.end_nested(frame.payload);
+    w.end_nested(frame.item);
+}
+
+}  // namespace
+
+// ============================================================================
+// Items
+// ============================================================================
+
+void encode_signal_item(std::vector<uint8_t>& out, const vep_VssSignal& msg,
+                        uint32_t timestamp_delta_ms, uint32_t path_id) {
+    WireWriter w(out);
+    auto frame = begin_item(w, kItemSignal, timestamp_delta_ms);
+
+    if (path_id != 0) {
+        w.uint_field(2, path_id);
+    } else {
+        w.string_field(1, msg.path);
+    }
+    auto quality = convert_quality(msg.quality);
+    if (quality != 0) {
+        w.int_field(4, quality);
+    }
+    write_signal_value(w, msg.value);
+
+    end_item(w, frame);
+}
+
+void encode_event_item(std::vector<uint8_t>& out, const vep_Event& msg,
+                       uint32_t timestamp_delta_ms) {
+    WireWriter w(out);
+    auto frame = begin_item(w, kItemEvent, timestamp_delta_ms);
+
+    w.optional_string_field(1, msg.event_id);
+    w.optional_string_field(3, msg.category);
+    w.optional_string_field(4, msg.event_type);
+    if (msg.severity != 0) {
+        w.int_field(5, static_cast<int32_t>(msg.severity));
+    }
+
+    end_item(w, frame);
+}
+
+void encode_gauge_item(std::vector<uint8_t>& out, const vep_OtelGauge& msg,
+                       uint32_t timestamp_delta_ms, StringTable* strings) {
+    WireWriter w(out);
+    auto frame = begin_item(w, kItemMetric, timestamp_delta_ms);
+
+    write_metric_head(w, msg, strings);
+    w.double_field(10, msg.value);
+    write_metric_labels(w, msg, strings);
+
+    end_item(w, frame);
+}
+
+void encode_counter_item(std::vector<uint8_t>& out, const vep_OtelCounter& msg,
+                         uint32_t timestamp_delta_ms, StringTable* strings) {
+    WireWriter w(out);
+    auto frame = begin_item(w, kItemMetric, timestamp_delta_ms);
+
+    write_metric_head(w, msg, strings);
+    w.double_field(11, msg.value);
+    write_metric_labels(w, msg, strings);
+
+    end_item(w, frame);
+}
+
+void encode_histogram_item(std::vector<uint8_t>& out, const vep_OtelHistogram& msg,
+                           uint32_t timestamp_delta_ms, StringTable* strings) {
+    WireWriter w(out);
+    auto frame = begin_item(w, kItemMetric, timestamp_delta_ms);
+
+    write_metric_head(w, msg, strings);
+
+    size_t hist = w.begin_nested(12);
+    if (msg.sample_count != 0) {
+        w.uint_field(1, msg.sample_count);
+    }
+    uint64_t raw_sum;
+    std::memcpy(&raw_sum, &msg.sample_sum, sizeof(raw_sum));
+    if (raw_sum != 0) {  // -0.0 is written, like generated code
+        w.double_field(2, msg.sample_sum);
+    }
+    if (msg.buckets._length > 0) {
+        w.tag(3, kLengthDelimited);
+        w.varint(static_cast<uint64_t>(msg.buckets._length) * sizeof(double));
+        for (uint32_t i = 0; i < msg.buckets._length; ++i) {
+            w.fixed64(static_cast<double>(msg.buckets._buffer[i].upper_bound));
+        }
+        size_t counts = w.begin_nested(4);
+        for (uint32_t i = 0; i < msg.buckets._length; ++i) {
+            w.varint(msg.buckets._buffer[i].cumulative_count);
+        }
+        w.end_nested(counts);
+    }
+    w.end_nested(hist);
+
+    write_metric_labels(w, msg, strings);
+
+    end_item(w, frame);
+}
+
+void encode_log_item(std::vector<uint8_t>& out, const vep_OtelLogEntry& msg,
+                     uint32_t timestamp_delta_ms, const LogRepeat& repeat,
+                     uint32_t template_id, const std::vector<std::string>* params,
+                     StringTable* strings) {
+    WireWriter w(out);
+    auto frame = begin_item(w, kItemLog, timestamp_delta_ms);
+
+    uint32_t component_ref = 0;
+    if (strings) {
+        if (msg.component && msg.component[0] != '\0') {
+            component_ref = strings->ref(msg.component);
+        }
+        reference_labels(*strings, msg.header, msg.attributes);
+    }
+
+    if (msg.level != 0) {
+        w.int_field(2, static_cast<int32_t>(msg.level));
+    }
+    if (component_ref == 0) {
+        w.optional_string_field(3, msg.component);
+    }
+    if (template_id == 0) {
+        w.optional_string_field(4, msg.message);
+    }
+    if (repeat.count > 1) {
+        w.uint_field(5, repeat.count);
+        if (uint32_t last_delta = repeat.last_delta_ms(msg)) {
+            w.uint_field(6, last_delta);
+        }
+    }
+    if (template_id != 0) {
+        w.uint_field(7, template_id);
+        for (const auto& param : *params) {
+            w.bytes_field(8, reinterpret_cast<const uint8_t*>(param.data()), param.size());
+        }
+    }
+    if (strings) {
+        if (component_ref != 0) {
+            w.uint_field(9, component_ref);
+        }
+        write_spilled_labels(w, 10, 11, msg.header, msg.attributes, *strings);
+        write_label_refs(w, 12, 13, msg.header, msg.attributes, *strings);
+    } else {
+        write_labels(w, 10, 11, msg.header, msg.attributes);
+    }
+
+    end_item(w, frame);
+}
+
+// ============================================================================
+// Batch framing
+// ============================================================================
+
+void encode_batch_header(std::vector<uint8_t>& out, int64_t base_timestamp_ms,
+                         const std::string& source_id, uint32_t sequence,
+                         uint64_t session) {
+    WireWriter w(out);
+    if (base_timestamp_ms != 0) {
+        w.tag(kBatchBaseTimestamp, kFixed64);
+        w.fixed64(static_cast<uint64_t>(base_timestamp_ms));
+    }
+    if (!source_id.empty()) {
+        w.bytes_field(kBatchSourceId,
+                      reinterpret_cast<const uint8_t*>(source_id.data()), source_id.size());
+    }
+    if (sequence != 0) {
+        w.uint_field(kBatchSequence, sequence);
+    }
+    if (session != 0) {
+        w.tag(kBatchSession, kFixed64);
+        w.fixed64(session);
+    }
+}
+
+void encode_string_table(std::vector<uint8_t>& out, const StringTable& strings) {
+    WireWriter w(out);
+    for (size_t i = 1; i <= strings.size(); ++i) {
+        const std::string& text = strings.at(static_cast<uint32_t>(i));
+        w.bytes_field(kBatchStrings, reinterpret_cast<const uint8_t*>(text.data()), text.size());
+    }
+}
+
+namespace {
+
+template<typename Message>
+void write_message_field(std::vector<uint8_t>& out, uint32_t field, const Message& msg) {
+    WireWriter w(out);
+    size_t size = msg.ByteSizeLong();
+    w.tag(field, kLengthDelimited);
+    w.varint(size);
+    size_t offset = out.size();
+    out.resize(offset + size);
+    msg.SerializeWithCachedSizesToArray(out.data() + offset);
+}
+
+}  // namespace
+
+void encode_transfer_item(std::vector<uint8_t>& out,
+                          const vep::transfer::TransferItem& item) {
+    write_message_field(out, kBatchItems, item);
+}
+
+void encode_path_dictionary(std::vector<uint8_t>& out,
+                            const vep::transfer::PathDictionary& dict) {
+    write_message_field(out, kBatchPathDictionary, dict);
+}
+
+size_t framed_item_size(size_t item_bytes) {
+    size_t prefix = 1;
+    for (size_t value = item_bytes; value >= 0x80; value >>= 7) {
+        prefix++;
+    }
+    return 1 + prefix + item_bytes;  // Field 10 tag fits in one byte
+}
+
+namespace {
+
+bool read_varint(const uint8_t* data, size_t size, size_t& pos, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; pos < size && shift < 64; shift += 7) {
+        uint8_t byte = data[pos++];
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
+bool next_wire_field(const uint8_t* data, size_t size, size_t pos, WireField& field) {
+    uint64_t tag;
+    field.begin = pos;
+    if (pos >= size || !read_varint(data, size, pos, tag)) {
+        return false;
+    }
+    field.number = static_cast<uint32_t>(tag >> 3);
+    field.wire_type = static_cast<uint32_t>(tag & 7);
+    uint64_t length;
+    switch (field.wire_type) {
+        case kVarint:
+            field.payload = pos;
+            if (!read_varint(data, size, pos, length)) {
+                return false;
+            }
+            break;
+        case kFixed64:
+        case kFixed32:
+            length = field.wire_type == kFixed64 ? 8 : 4;
+            if (length > size - pos) {
+                return false;
+            }
+            field.payload = pos;
+            pos += length;
+            break;
+        case kLengthDelimited:
+            if (!read_varint(data, size, pos, length) || length > size - pos) {
+                return false;
+            }
+            field.payload = pos;
+            pos += static_cast<size_t>(length);
+            break;
+        default:
+            return false;  // Groups are not used by transfer.proto
+    }
+    field.end = pos;
+    return field.number != 0;
+}
+
+size_t next_framed_item(const uint8_t* data, size_t size) {
+    constexpr uint8_t kItemTag = (kBatchItems << 3) | kLengthDelimited;
+    if (size < 2 || data[0] != kItemTag) {
+        return 0;
+    }
+    uint64_t length = 0;
+    size_t pos = 1;
+    for (int shift = 0; pos < size && shift < 64; shift += 7) {
+        uint8_t byte = data[pos++];
+        length |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return length <= size - pos ? pos + static_cast<size_t>(length) : 0;
+        }
+    }
+    return 0;
+}
+
+}  // namespace vep::exporter
@@ -0,0 +1,468 @@
+// Copyright 2025 Vehicle Edge Platform Contributors
+// SPDX-License-Identifier: Apache-2.0
+
+#include "export_policy.hpp"
+
+#include <glog/logging.h>
+#include <yaml-cpp/yaml.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace vep::exporter {
+
+namespace {
+
+/// Split a glob into segments; false if a segment is empty or `**` is
+/// not the last one
+bool split_glob(std::string_view glob, std::vector<std::string_view>* segments) {
+    segments->clear();
+    while (true) {
+        size_t dot = glob.find('.');
+        std::string_view segment = glob.substr(0, dot);
+        if (segment.empty()) {
+            return false;
+        }
+        if (!segments->empty() && segments->back() == "**") {
+            return false;
+        }
+        segments->push_back(segment);
+        if (dot == std::string_view::npos) {
+            return true;
+        }
+        glob.remove_prefix(dot + 1);
+    }
+}
+
+/// Scalar numeric or bool value as double
+bool numeric_value(const vep_VssValue& value, double* out) {
+    switch (value.type) {
+        case vep_VSS_VALUE_TYPE_BOOL:   *out = value.bool_value ? 1.0 : 0.0; return true;
+        case vep_VSS_VALUE_TYPE_INT8:   *out = value.int8_value; return true;
+        case vep_VSS_VALUE_TYPE_INT16:  *out = value.int16_value; return true;
+        case vep_VSS_VALUE_TYPE_INT32:  *out = value.int32_value; return true;
+        case vep_VSS_VALUE_TYPE_INT64:  *out = static_cast<double>(value.int64_value); return true;
+        case vep_VSS_VALUE_TYPE_UINT8:  *out = value.uint8_value; return true;
+        case vep_VSS_VALUE_TYPE_UINT16: *out = value.uint16_value; return true;
+        case vep_VSS_VALUE_TYPE_UINT32: *out = value.uint32_value; return true;
+        case vep_VSS_VALUE_TYPE_UINT64: *out = static_cast<double>(value.uint64_value); return true;
+        case vep_VSS_VALUE_TYPE_FLOAT:  *out = value.float_value; return true;
+        case vep_VSS_VALUE_TYPE_DOUBLE: *out = value.double_value; return true;
+        default:
+            return false;
+    }
+}
+
+}  // namespace
+
+// =============================================================================
+// String conversion
+// =============================================================================
+
+const char* to_string(PolicyAction action) {
+    switch (action) {
+        case PolicyAction::Forward: return "forward";
+        case PolicyAction::Drop: return "drop";
+        case PolicyAction::Downsample: return "downsample";
+        case PolicyAction::Deadband: return "deadband";
+        case PolicyAction::Aggregate: return "aggregate";
+        default: return "unknown";
+    }
+}
+
+std::optional<PolicyAction> policy_action_from_string(const std::string& name) {
+    if (name == "forward") return PolicyAction::Forward;
+    if (name == "drop") return PolicyAction::Drop;
+    if (name == "downsample") return PolicyAction::Downsample;
+    if (name == "deadband") return PolicyAction::Deadband;
+    if (name == "aggregate") return PolicyAction::Aggregate;
+    return std::nullopt;
+}
+
+const char* to_string(AggregateStat stat) {
+    switch (stat) {
+        case AggregateStat::Min: return "min";
+        case AggregateStat::Max: return "max";
+        case AggregateStat::Mean: return "mean";
+        case AggregateStat::Last: return "last";
+        default: return "unknown";
+    }
+}
+
+std::optional<AggregateStat> aggregate_stat_from_string(const std::string& name) {
+    if (name == "min") return AggregateStat::Min;
+    if (name == "max") return AggregateStat::Max;
+    if (name == "mean") return AggregateStat::Mean;
+    if (name == "last") return AggregateStat::Last;
+    return std::nullopt;
+}
+
+// =============================================================================
+// Policy file
+// =============================================================================
+
+std::optional<ExportPolicyConfig> load_export_policy(const std::string& yaml_path) {
+    ExportPolicyConfig config;
+    std::vector<std::string_view> segments;
+
+    try {
+        YAML::Node root = YAML::LoadFile(yaml_path);
+        YAML::Node policy = root["export_policy"];
+        if (!policy) {
+            LOG(ERROR) << "No 'export_policy' section in " << yaml_path;
+            return std::nullopt;
+        }
+
+        if (policy["default"]) {
+            auto action = policy_action_from_string(policy["default"].as<std::string>());
+            if (!action || (*action != PolicyAction::Forward && *action != PolicyAction::Drop)) {
+                LOG(ERROR) << yaml_path << ": invalid default action '"
+                           << policy["default"].as<std::string>() << "'";
+                return std::nullopt;
+            }
+            config.default_action = *action;
+        }
+
+        for (const auto& node : policy["rules"]) {
+            ExportRule rule;
+            rule.match = node["match"].as<std::string>();
+            if (!split_glob(rule.match, &segments)) {
+                LOG(ERROR) << yaml_path << ": invalid path glob '" << rule.match << "'";
+                return std::nullopt;
+            }
+
+            std::string action = node["action"].as<std::string>("forward");
+            auto parsed = policy_action_from_string(action);
+            if (!parsed) {
+                LOG(ERROR) << yaml_path << ": unknown action '" << action
+                           << "' for " << rule.match;
+                return std::nullopt;
+            }
+            rule.action = *parsed;
+
+            // Same field names as the vssdag signal mappings
+            rule.min_interval_ms = node["min_interval_ms"].as<uint32_t>(0);
+            rule.max_interval_ms = node["max_interval_ms"].as<uint32_t>(0);
+            rule.change_threshold = node["change_threshold"].as<double>(0.0);
+            rule.window_ms = node["window_ms"].as<uint32_t>(rule.window_ms);
+            if (rule.action == PolicyAction::Aggregate && rule.window_ms == 0) {
+                LOG(ERROR) << yaml_path << ": aggregate rule " << rule.match
+                           << " needs window_ms > 0";
+                return std::nullopt;
+            }
+
+            if (node["stats"]) {
+                rule.stats.clear();
+                for (const auto& stat_node : node["stats"]) {
+                    auto stat = aggregate_stat_from_string(stat_node.as<std::string>());
+                    if (!stat) {
+                        LOG(ERROR) << yaml_path << ": unknown statistic '"
+                                   << stat_node.as<std::string>() << "' for " << rule.match;
+                        return std::nullopt;
+                    }
+                    rule.stats.push_back(*stat);
+                }
+            }
+
+            config.rules.push_back(std::move(rule));
+        }
+    } catch (const YAML::Exception& e) {
+        LOG(ERROR) << "Failed to load export policy " << yaml_path << ": " << e.what();
+        return std::nullopt;
+    }
+
+    LOG(INFO) << "Loaded " << config.rules.size() << " export policy rules from " << yaml_path;
+    return config;
+}
+
+// =============================================================================
+// ExportPolicy
+// =============================================================================
+
+struct ExportPolicy::TrieNode {
+    // Keys view the rule globs in config_, which never change after construction
+    std::unordered_map<std::string_view, std::unique_ptr<TrieNode>> children;
+    std::unique_ptr<TrieNode> any;  // "*"
+    int rule = -1;                  // Glob ends at this node
+    int rest = -1;                  // Glob ends with "**" below this node
+};
+
+struct ExportPolicy::PathState {
+    std::string path;
+    const ExportRule* rule = nullptr;
+    PolicyAction action = PolicyAction::Forward;
+
+    // Downsample/deadband: last exported sample
+    bool exported = false;
+    int64_t last_export_ms = 0;
+    double last_value = 0.0;
+    vep_VssQuality last_quality = vep_VSS_QUALITY_VALID;
+
+    // Aggregate: open window (count == 0: none)
+    int64_t window_end_ms = 0;
+    uint64_t count = 0;
+    double min = 0.0;
+    double max = 0.0;
+    double sum = 0.0;
+    double last = 0.0;
+    int64_t last_ts_ms = 0;
+    std::string source_id;
+    std::string window_label;
+};
+
+struct ExportPolicy::Shard {
+    std::mutex mutex;
+    std::deque<PathState> states;  // Stable addresses for by_path keys
+    std::unordered_map<std::string_view, PathState*> by_path;
+};
+
+ExportPolicy::ExportPolicy(const ExportPolicyConfig& config, AggregateSink sink)
+    : config_(config)
+    , sink_(std::move(sink))
+    , root_(std::make_unique<TrieNode>()) {
+    for (auto& shard : shards_) {
+        shard = std::make_unique<Shard>();
+    }
+    for (size_t i = 0; i < config_.rules.size(); ++i) {
+        if (!add_rule(config_.rules[i], i)) {
+            LOG(WARNING) << "ExportPolicy: ignoring rule with invalid glob '"
+                         << config_.rules[i].match << "'";
+        }
+    }
+}
+
+ExportPolicy::~ExportPolicy() = default;
+
+bool ExportPolicy::add_rule(const ExportRule& rule, size_t index) {
+    std::vector<std::string_view> segments;
+    if (!split_glob(rule.match, &segments)) {
+        return false;
+    }
+
+    TrieNode* node = root_.get();
+    for (std::string_view segment : segments) {
+        if (segment == "**") {
+            node->rest = static_cast<int>(index);
+            return true;
+        }
+        std::unique_ptr<TrieNode>& next = segment == "*" ? node->any : node->children[segment];
+        if (!next) {
+            next = std::make_unique<TrieNode>();
+        }
+        node = next.get();
+    }
+    node->rule = static_cast<int>(index);
+    return true;
+}
+
+namespace {
+
+template<typename Node>
+int match_node(const Node* node, std::string_view rest) {
+    if (rest.empty()) {
+        return node->rule >= 0 ? node->rule : node->rest;  // "**" also matches nothing
+    }
+
+    size_t dot = rest.find('.');
+    std::string_view segment = rest.substr(0, dot);
+    std::string_view tail = dot == std::string_view::npos ? std::string_view{} : rest.substr(dot + 1);
+
+    // Most specific first: literal, then "*", then "**"
+    auto it = node->children.find(segment);
+    if (it != node->children.end()) {
+        int rule = match_node(it->second.get(), tail);
+        if (rule >= 0) {
+            return rule;
+        }
+    }
+    if (node->any) {
+        int rule = match_node(node->any.get(), tail);
+        if (rule >= 0) {
+            return rule;
+        }
+    }
+    return node->rest;
+}
+
+}  // namespace
+
+const ExportRule* ExportPolicy::match(std::string_view path) const {
+    int rule = match_node(root_.get(), path);
+    return rule >= 0 ? &config_.rules[static_cast<size_t>(rule)] : nullptr;
+}
+
+ExportPolicy::PathState& ExportPolicy::state_for(Shard& shard, std::string_view path) {
+    auto it = shard.by_path.find(path);
+    if (it != shard.by_path.end()) {
+        return *it->second;
+    }
+
+    // First sample of this path: resolve its rule once
+    PathState& state = shard.states.emplace_back();
+    state.path = path;
+    state.rule = match(path);
+    if (state.rule) {
+        state.action = state.rule->action;
+    } else {
+        // Other actions need rule parameters
+        state.action = config_.default_action == PolicyAction::Drop ? PolicyAction::Drop
+                                                                     : PolicyAction::Forward;
+    }
+    if (state.action == PolicyAction::Aggregate) {
+        if (state.rule->window_ms == 0) {
+            state.action = PolicyAction::Forward;
+        } else {
+            state.window_label = std::to_string(state.rule->window_ms);
+        }
+    }
+    shard.by_path.emplace(state.path, &state);
+    return state;
+}
+
+bool ExportPolicy::filter(const vep_VssSignal& msg) {
+    std::string_view path = msg.path ? msg.path : "";
+    Shard& shard = *shards_[std::hash<std::string_view>{}(path) % kShards];
+
+    bool exported;
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        exported = apply(state_for(shard, path), msg, msg.header.timestamp_ns / 1000000);
+    }
+
+    if (exported) {
+        counters_.samples_forwarded.fetch_add(1, std::memory_order_relaxed);
+    }
+    return exported;
+}
+
+bool ExportPolicy::apply(PathState& state, const vep_VssSignal& msg, int64_t ts_ms) {
+    switch (state.action) {
+        case PolicyAction::Forward:
+            return true;
+
+        case PolicyAction::Drop:
+            counters_.samples_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+
+        case PolicyAction::Downsample:
+        case PolicyAction::Deadband: {
+            const ExportRule& rule = *state.rule;
+            double value = 0.0;
+            bool numeric = numeric_value(msg.value, &value);
+            int64_t since = ts_ms - state.last_export_ms;
+
+            bool send;
+            if (!state.exported || msg.quality != state.last_quality) {
+                send = true;
+            } else if (rule.min_interval_ms > 0 && since < rule.min_interval_ms) {
+                send = false;
+            } else if (state.action == PolicyAction::Downsample || !numeric) {
+                send = true;
+            } else if (rule.max_interval_ms > 0 && since >= rule.max_interval_ms) {
+                send = true;  // Heartbeat
+            } else {
+                double change = std::fabs(value - state.last_value);
+                send = rule.change_threshold > 0.0 ? change >= rule.change_threshold
+                                                   : value != state.last_value;
+            }
+
+            if (!send) {
+                counters_.samples_dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            state.exported = true;
+            state.last_export_ms = ts_ms;
+            state.last_value = value;
+            state.last_quality = msg.quality;
+            return true;
+        }
+
+        case PolicyAction::Aggregate: {
+            double value;
+            if (msg.quality != vep_VSS_QUALITY_VALID || !numeric_value(msg.value, &value)) {
+                return true;
+            }
+
+            if (state.count > 0 && ts_ms >= state.window_end_ms) {
+                close_window(state);
+            }
+            if (state.count == 0) {
+                int64_t window = state.rule->window_ms;
+                int64_t start = ts_ms - ((ts_ms % window) + window) % window;
+                state.window_end_ms = start + window;
+                state.min = value;
+                state.max = value;
+                state.sum = 0.0;
+                if (msg.header.source_id && state.source_id != msg.header.source_id) {
+                    state.source_id = msg.header.source_id;
+                }
+            }
+            state.count++;
+            state.min = std::min(state.min, value);
+            state.max = std::max(state.max, value);
+            state.sum += value;
+            state.last = value;
+            state.last_ts_ms = ts_ms;
+            counters_.samples_aggregated.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+    return true;
+}
+
+void ExportPolicy::close_window(PathState& state) {
+    vep_KeyValue labels[2];
+    labels[1].key = const_cast<char*>("window_ms");
+    labels[1].value = state.window_label.data();
+    labels[0].key = const_cast<char*>("aggregation");
+
+    vep_OtelGauge gauge = {};
+    gauge.header.source_id = state.source_id.data();
+    gauge.header.timestamp_ns = state.last_ts_ms * 1000000;
+    gauge.header.correlation_id = const_cast<char*>("");
+    gauge.name = state.path.data();
+    gauge.labels._buffer = labels;
+    gauge.labels._length = 2;
+    gauge.labels._maximum = 2;
+    gauge.labels._release = false;
+
+    for (AggregateStat stat : state.rule->stats) {
+        labels[0].value = const_cast<char*>(to_string(stat));
+        switch (stat) {
+            case AggregateStat::Min: gauge.value = state.min; break;
+            case AggregateStat::Max: gauge.value = state.max; break;
+            case AggregateStat::Mean: gauge.value = state.sum / static_cast<double>(state.count); break;
+            case AggregateStat::Last: gauge.value = state.last; break;
+        }
+        sink_(gauge);
+        counters_.aggregates_emitted.fetch_add(1, std::memory_order_relaxed);
+    }
+    state.count = 0;
+}
+
+void ExportPolicy::flush_expired(int64_t now_ms) {
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        for (auto& state : shard->states) {
+            if (state.count > 0 && state.window_end_ms <= now_ms) {
+                close_window(state);
+            }
+        }
+    }
+}
+
+void ExportPolicy::flush_all() {
+    flush_expired(std::numeric_limits<int64_t>::max());
+}
+
+ExportPolicyStats ExportPolicy::stats() const {
+    ExportPolicyStats stats;
+    stats.samples_forwarded = counters_.samples_forwarded.load(std::memory_order_relaxed);
+    stats.samples_dropped = counters_.samples_dropped.load(std::memory_order_relaxed);
+    stats.samples_aggregated = counters_.samples_aggregated.load(std::memory_order_relaxed);
+    stats.aggregates_emitted = counters_.aggregates_emitted.load(std::memory_order_relaxed);
+    return stats;
+}
+
+}  // namespace vep::exporter
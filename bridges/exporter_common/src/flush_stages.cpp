@@ -0,0 +1,298 @@
+// Copyright 2025 Vehicle Edge Platform Contributors
+// SPDX-License-Identifier: Apache-2.0
+
+#include "flush_stages.hpp"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+
+namespace vep::exporter {
+
+namespace {
+
+/// Re-check of the overflow predicate while the window is full
+constexpr auto kOverflowPoll = std::chrono::milliseconds(10);
+
+int64_t elapsed_us(std::chrono::steady_clock::time_point since,
+                   std::chrono::steady_clock::time_point now) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(now - since).count();
+}
+
+}  // namespace
+
+FlushStages::FlushStages(const FlushStagesConfig& config, Compressor& compressor,
+                         PublishFn publish, OverflowFn overflow, DropFn drop)
+    : config_(config)
+    , compressor_(compressor)
+    , publish_(std::move(publish))
+    , overflow_(std::move(overflow))
+    , drop_(std::move(drop)) {
+    config_.queue_depth = std::max<size_t>(1, config_.queue_depth);
+    // Serialized and compressed buffers of the batches in flight, plus
+    // the one being built
+    pool_ = vep::BufferPool::create(2 * config_.queue_depth + 2);
+
+    if (config_.compress_workers == 0) {
+        return;
+    }
+    compressors_.push_back(&compressor_);
+    while (compressors_.size() < config_.compress_workers) {
+        auto clone = compressor_.clone();
+        if (!clone) {
+            LOG(WARNING) << "FlushStages: " << compressor_.name()
+                         << " compressor cannot be cloned, using " << compressors_.size()
+                         << " compression worker(s)";
+            break;
+        }
+        compressors_.push_back(clone.get());
+        clones_.push_back(std::move(clone));
+    }
+}
+
+FlushStages::~FlushStages() {
+    stop();
+}
+
+bool FlushStages::set_rewrite(RewriteFn rewrite) {
+    if (!compressors_.empty() && !compressor_.passthrough()) {
+        // Workers keep compressing while the publisher recompresses
+        rewrite_compressor_ = compressor_.clone();
+        if (!rewrite_compressor_) {
+            return false;
+        }
+    }
+    rewrite_ = std::move(rewrite);
+    return true;
+}
+
+void FlushStages::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_ || compressors_.empty()) {
+        return;
+    }
+    running_ = true;
+    for (Compressor* compressor : compressors_) {
+        workers_.emplace_back(&FlushStages::compress_loop, this, compressor);
+    }
+    publisher_ = std::thread(&FlushStages::publish_loop, this);
+}
+
+void FlushStages::stop() {
+    drain();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    work_cv_.notify_all();
+    done_cv_.notify_all();
+
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    workers_.clear();
+    if (publisher_.joinable()) {
+        publisher_.join();
+    }
+}
+
+void FlushStages::compress(Compressor& compressor, Job& job) {
+    job.raw_size = job.raw.size();
+    if (compressor.passthrough()) {
+        job.compressed = std::move(job.raw);
+        return;
+    }
+    auto start = std::chrono::steady_clock::now();
+    job.compressed = pool_->acquire();
+    compressor.compress_into(job.raw.bytes(), job.compressed.bytes());
+    if (!rewrite_) {
+        job.raw.release();
+    }
+    compress_latency_.record(elapsed_us(start, std::chrono::steady_clock::now()));
+}
+
+void FlushStages::submit(vep::PayloadBuffer batch) {
+    Job job;
+    job.raw = std::move(batch);
+    job.submitted = std::chrono::steady_clock::now();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!running_) {
+        // Inline: no workers configured, or not started
+        lock.unlock();
+        compress(compressor_, job);
+        publish(job);
+        return;
+    }
+
+    // Counted while waiting: it is what pushes the budget over
+    job.held = job.raw.size();
+    bytes_in_flight_.fetch_add(job.held, std::memory_order_relaxed);
+
+    // Over budget: make room from the oldest batches still queued
+    while (overflow_ && overflow_() && drop_oldest()) {
+    }
+    while (window_full()) {
+        if (!overflow_) {
+            space_cv_.wait(lock, [this] { return !window_full(); });
+        } else if (!overflow_() || !drop_oldest()) {
+            // Everything is being compressed or published, or no overflow
+            // yet: wait, re-checking the predicate
+            space_cv_.wait_for(lock, kOverflowPoll);
+        }
+    }
+    job.seq = next_submit_++;
+    compress_queue_.push_back(std::move(job));
+    lock.unlock();
+    work_cv_.notify_one();
+}
+
+void FlushStages::check_overflow() {
+    {
+        // Pairs with the wait in submit() (no lost wakeup)
+        std::lock_guard<std::mutex> lock(mutex_);
+    }
+    space_cv_.notify_all();
+}
+
+bool FlushStages::window_full() const {
+    return next_submit_ - next_publish_ - dropped_.size() >= config_.queue_depth;
+}
+
+bool FlushStages::drop_oldest() {
+    // Oldest of: queued for a worker, compressed and waiting for its turn
+    bool from_queue = !compress_queue_.empty() &&
+                      (compressed_.empty() ||
+                       compress_queue_.front().seq < compressed_.begin()->first);
+    Job job;
+    if (from_queue) {
+        job = std::move(compress_queue_.front());
+        compress_queue_.pop_front();
+    } else if (!compressed_.empty()) {
+        job = std::move(compressed_.begin()->second);
+        compressed_.erase(compressed_.begin());
+    } else {
+        return false;
+    }
+    dropped_.emplace(job.seq, from_queue ? job.raw.size() : job.raw_size);
+    bytes_in_flight_.fetch_sub(job.held, std::memory_order_relaxed);
+    batches_dropped_.fetch_add(1, std::memory_order_relaxed);
+    if (job.seq == next_publish_) {
+        done_cv_.notify_one();
+    }
+    return true;  // Buffers return to the pool with job
+}
+
+void FlushStages::drain() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    space_cv_.wait(lock, [this] { return next_publish_ == next_submit_; });
+}
+
+size_t FlushStages::in_flight() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return next_submit_ - next_publish_ - dropped_.size();
+}
+
+void FlushStages::compress_loop(Compressor* compressor) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        work_cv_.wait(lock, [this] { return !compress_queue_.empty() || !running_; });
+        if (compress_queue_.empty()) {
+            return;
+        }
+        Job job = std::move(compress_queue_.front());
+        compress_queue_.pop_front();
+        lock.unlock();
+
+        compress(*compressor, job);
+        size_t held = job.compressed.size() + job.raw.size();
+        bytes_in_flight_.fetch_add(held, std::memory_order_relaxed);
+        bytes_in_flight_.fetch_sub(job.held, std::memory_order_relaxed);
+        job.held = held;
+
+        lock.lock();
+        uint64_t seq = job.seq;
+        compressed_.emplace(seq, std::move(job));
+        if (seq == next_publish_) {
+            done_cv_.notify_one();
+        }
+    }
+}
+
+void FlushStages::publish_loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        done_cv_.wait(lock, [this] {
+            return compressed_.count(next_publish_) > 0 || dropped_.count(next_publish_) > 0 ||
+                   (!running_ && next_publish_ == next_submit_);
+        });
+        auto dropped = dropped_.find(next_publish_);
+        if (dropped != dropped_.end()) {
+            size_t raw_size = dropped->second;
+            lock.unlock();
+            if (drop_) {
+                drop_(raw_size);
+            }
+            lock.lock();
+            dropped_.erase(next_publish_++);
+            space_cv_.notify_all();
+            continue;
+        }
+        auto it = compressed_.find(next_publish_);
+        if (it == compressed_.end()) {
+            return;
+        }
+        Job job = std::move(it->second);
+        compressed_.erase(it);
+        // From here the batch is the transport's
+        bytes_in_flight_.fetch_sub(job.held, std::memory_order_relaxed);
+        lock.unlock();
+
+        publish(job);
+
+        lock.lock();
+        ++next_publish_;
+        space_cv_.notify_all();
+    }
+}
+
+bool FlushStages::rewrite_published(const RewriteFn& rewrite, vep::PayloadBuffer& compressed) {
+    return publishing_raw_ && rewrite_serialized(rewrite, *publishing_raw_, compressed);
+}
+
+bool FlushStages::rewrite_serialized(const RewriteFn& rewrite, vep::PayloadBuffer& raw,
+                                     vep::PayloadBuffer& compressed) {
+    // Passthrough: the serialized batch is the one to publish
+    bool passthrough = compressor_.passthrough();
+    if (!rewrite(passthrough ? compressed.bytes() : raw.bytes())) {
+        return false;
+    }
+    if (!passthrough) {
+        Compressor& compressor = rewrite_compressor_ ? *rewrite_compressor_ : compressor_;
+        compressor.compress_into(raw.bytes(), compressed.bytes());
+    }
+    return true;
+}
+
+void FlushStages::publish(Job& job) {
+    auto start = std::chrono::steady_clock::now();
+    if (rewrite_) {
+        if (rewrite_serialized(rewrite_, job.raw, job.compressed)) {
+            job.raw_size = compressor_.passthrough() ? job.compressed.size() : job.raw.size();
+        }
+        publishing_raw_ = &job.raw;
+    }
+    publish_(std::move(job.compressed), job.raw_size);
+    if (rewrite_) {
+        publishing_raw_ = nullptr;
+        job.raw.release();
+    }
+    auto now = std::chrono::steady_clock::now();
+    publish_latency_.record(elapsed_us(start, now));
+    batch_latency_.record(elapsed_us(job.submitted, now));
+    last_latency_us_.store(elapsed_us(job.submitted, now), std::memory_order_relaxed);
+}
+
+}  // namespace vep::exporter
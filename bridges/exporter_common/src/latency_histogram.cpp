@@ -0,0 +1,115 @@
+// Copyright 2025 Vehicle Edge Platform Contributors
+// SPDX-License-Identifier: Apache-2.0
+
+#include "latency_histogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace vep::exporter {
+
+LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+
+size_t LatencyHistogram::bucket_index(uint64_t us) {
+    if (us < kSubBuckets) {
+        return static_cast<size_t>(us);  // Exact below 16 us
+    }
+    // Top kSubBucketBits + 1 bits: power of two, then linear step within it
+    int msb = 63 - __builtin_clzll(us);
+    int shift = msb - kSubBucketBits;
+    return static_cast<size_t>(kSubBuckets * (shift + 1) + ((us >> shift) & (kSubBuckets - 1)));
+}
+
+uint64_t LatencyHistogram::bucket_upper(size_t index) {
+    if (index < kSubBuckets) {
+        return index;
+    }
+    int shift = static_cast<int>(index / kSubBuckets) - 1;
+    uint64_t lower = (kSubBuckets + index % kSubBuckets) << shift;
+    return lower + (uint64_t{1} << shift) - 1;
+}
+
+void LatencyHistogram::record(int64_t us) {
+    uint64_t value = us > 0 ? static_cast<uint64_t>(us) : 0;
+    value = std::min<uint64_t>(value, (uint64_t{1} << kMaxBits) - 1);
+    buckets_[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_us_.fetch_add(value, std::memory_order_relaxed);
+
+    int64_t max = max_us_.load(std::memory_order_relaxed);
+    while (static_cast<int64_t>(value) > max &&
+           !max_us_.compare_exchange_weak(max, static_cast<int64_t>(value),
+                                          std::memory_order_relaxed)) {
+    }
+}
+
+uint64_t LatencyHistogram::count() const {
+    return count_.load(std::memory_order_relaxed);
+}
+
+int64_t LatencyHistogram::percentile(double q) const {
+    // Bucket counts are the snapshot; count_ may already include values
+    // whose bucket is not yet incremented
+    std::array<uint64_t, kBuckets> counts;
+    uint64_t total = 0;
+    for (size_t i = 0; i < kBuckets; ++i) {
+        counts[i] = buckets_[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    uint64_t rank = static_cast<uint64_t>(std::ceil(std::clamp(q, 0.0, 1.0) * total));
+    rank = std::max<uint64_t>(rank, 1);
+    int64_t max = max_us_.load(std::memory_order_relaxed);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBuckets; ++i) {
+        seen += counts[i];
+        if (seen >= rank) {
+            return std::min(static_cast<int64_t>(bucket_upper(i)), max);
+        }
+    }
+    return max;
+}
+
+LatencySummary LatencyHistogram::summary() const {
+    LatencySummary summary;
+    summary.count = count();
+    if (summary.count == 0) {
+        return summary;
+    }
+    summary.mean_us = static_cast<double>(sum_us()) / static_cast<double>(summary.count);
+    summary.p50_us = percentile(0.5);
+    summary.p90_us = percentile(0.9);
+    summary.p99_us = percentile(0.99);
+    summary.p999_us = percentile(0.999);
+    summary.max_us = max_us_.load(std::memory_order_relaxed);
+    return summary;
+}
+
+uint64_t LatencyHistogram::count_at_most(int64_t us) const {
+    if (us < 0) {
+        return 0;
+    }
+    size_t last = bucket_index(std::min<uint64_t>(static_cast<uint64_t>(us),
+                                                  (uint64_t{1} << kMaxBits) - 1));
+    uint64_t total = 0;
+    for (size_t i = 0; i <= last; ++i) {
+        total += buckets_[i].load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+void LatencyHistogram::reset() {
+    for (auto& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+    sum_us_.store(0, std::memory_order_relaxed);
+    max_us_.store(0, std::memory_order_relaxed);
+}
+
+}  // namespace vep::exporter
@@ -0,0 +1,125 @@
+// Copyright 2025 Vehicle Edge Platform Contributors
+// SPDX-License-Identifier: Apache-2.0
+
+#include "log_dedup.hpp"
+
+#include <limits>
+
+namespace vep::exporter {
+
+LogDedup::LogDedup(const LogDedupConfig& config, SummarySink sink)
+    : config_(config)
+    , sink_(std::move(sink)) {
+}
+
+bool LogDedup::filter(const vep_OtelLogEntry& msg) {
+    int64_t ts_ms = msg.header.timestamp_ns / 1000000;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    key_.assign(1, static_cast<char>('0' + msg.level));
+    key_.append(msg.component ? msg.component : "");
+    key_.push_back('\0');
+    key_.append(msg.message ? msg.message : "");
+
+    auto it = windows_.find(key_);
+    if (it == windows_.end()) {
+        if (windows_.size() >= config_.max_entries) {
+            counters_.entries_forwarded.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        it = windows_.emplace(key_, Window{}).first;
+    } else if (ts_ms < it->second.end_ms) {
+        Window& window = it->second;
+        if (window.repeats == 0) {
+            capture(window, msg);
+            window.first_repeat_ms = ts_ms;
+        }
+        window.repeats++;
+        window.last_repeat_ms = ts_ms;
+        counters_.entries_collapsed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    } else if (it->second.repeats > 0) {
+        emit(it->second);
+    }
+
+    // Exported: opens the next window
+    it->second.end_ms = ts_ms + config_.window_ms;
+    counters_.entries_forwarded.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void LogDedup::capture(Window& window, const vep_OtelLogEntry& msg) {
+    window.level = msg.level;
+    window.component = msg.component ? msg.component : "";
+    window.message = msg.message ? msg.message : "";
+    window.source_id = msg.header.source_id ? msg.header.source_id : "";
+    window.attributes.clear();
+    for (uint32_t i = 0; i < msg.attributes._length; ++i) {
+        const auto& kv = msg.attributes._buffer[i];
+        if (kv.key) {
+            window.attributes.emplace_back(kv.key, kv.value ? kv.value : "");
+        }
+    }
+}
+
+void LogDedup::emit(Window& window) {
+    attributes_.clear();
+    for (auto& [key, value] : window.attributes) {
+        attributes_.push_back(vep_KeyValue{key.data(), value.data()});
+    }
+
+    vep_OtelLogEntry entry = {};
+    entry.header.source_id = window.source_id.data();
+    entry.header.timestamp_ns = window.first_repeat_ms * 1000000;
+    entry.header.correlation_id = const_cast<char*>("");
+    entry.level = window.level;
+    entry.component = window.component.data();
+    entry.message = window.message.data();
+    entry.attributes._buffer = attributes_.data();
+    entry.attributes._length = static_cast<uint32_t>(attributes_.size());
+    entry.attributes._maximum = entry.attributes._length;
+    entry.attributes._release = false;
+    entry.trace_id = const_cast<char*>("");
+    entry.span_id = const_cast<char*>("");
+
+    LogRepeat repeat;
+    repeat.count = window.repeats;
+    repeat.last_timestamp_ms = window.last_repeat_ms;
+    sink_(entry, repeat);
+
+    window.repeats = 0;
+    counters_.summaries_emitted.fetch_add(1, std::memory_order_relaxed);
+}
+
+void LogDedup::flush_expired(int64_t now_ms) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = windows_.begin(); it != windows_.end();) {
+        if (it->second.end_ms > now_ms) {
+            ++it;
+            continue;
+        }
+        if (it->second.repeats > 0) {
+            emit(it->second);
+        }
+        it = windows_.erase(it);
+    }
+}
+
+void LogDedup::flush_all() {
+    flush_expired(std::numeric_limits<int64_t>::max());
+}
+
+size_t LogDedup::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return windows_.size();
+}
+
+LogDedupStats LogDedup::stats() const {
+    LogDedupStats stats;
+    stats.entries_forwarded = counters_.entries_forwarded.load(std::memory_order_relaxed);
+    stats.entries_collapsed = counters_.entries_collapsed.load(std::memory_order_relaxed);
+    stats.summaries_emitted = counters_.summaries_emitted.load(std::memory_order_relaxed);
+    return stats;
+}
+
+}  // namespace vep::exporter
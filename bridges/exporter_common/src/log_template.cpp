@@ -0,0 +1,55 @@
+// Copyright 2025 Vehicle Edge Platform Contributors
+// SPDX-License-Identifier: Apache-2.0
+
+#include "log_template.hpp"
+
+#include <cstring>
+
+namespace vep::exporter {
+
+namespace {
+
+bool is_separator(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' ||
+           (c != '\0' && std::strchr("=:,;()[]{}<>\"'", c) != nullptr);
+}
+
+bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+}  // namespace
+
+bool extract_log_template(std::string_view message, std::string& templ,
+                          std::vector<std::string>& params) {
+    templ.clear();
+    params.clear();
+    if (message.find(kLogTemplateParam) != std::string_view::npos) {
+        return false;
+    }
+
+    size_t pos = 0;
+    while (pos < message.size()) {
+        if (is_separator(message[pos])) {
+            templ.push_back(message[pos++]);
+            continue;
+        }
+        size_t end = pos;
+        bool variable = false;
+        while (end < message.size() && !is_separator(message[end])) {
+            variable = variable || is_digit(message[end]);
+            ++end;
+        }
+        std::string_view token = message.substr(pos, end - pos);
+        if (variable) {
+            templ.append(kLogTemplateParam);
+            params.emplace_back(token);
+        } else {
+            templ.append(token);
+        }
+        pos = end;
+    }
+    return true;
+}
+
+}  // namespace vep::exporter
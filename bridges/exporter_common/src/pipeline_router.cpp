@@ -0,0 +1,234 @@
+// Copyright 2025 Vehicle Edge Platform Contributors
+// SPDX-License-Identifier: Apache-2.0
+
+#include "pipeline_router.hpp"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+
+namespace vep::exporter {
+
+std::optional<ItemType> item_type_from_string(std::string_view name) {
+    if (name == "signal") return ItemType::Signal;
+    if (name == "event") return ItemType::Event;
+    if (name == "metric") return ItemType::Metric;
+    if (name == "log") return ItemType::Log;
+    return std::nullopt;
+}
+
+const char* to_string(ItemType type) {
+    switch (type) {
+        case ItemType::Signal: return "signal";
+        case ItemType::Event: return "event";
+        case ItemType::Metric: return "metric";
+        case ItemType::Log: return "log";
+    }
+    return "unknown";
+}
+
+PipelineRouter::~PipelineRouter() {
+    stop();
+}
+
+bool PipelineRouter::add_lane(const LaneConfig& config,
+                              std::unique_ptr<vep::BackendTransport> transport,
+                              std::unique_ptr<Compressor> compressor) {
+    if (running_) {
+        LOG(ERROR) << "PipelineRouter: lane " << config.name << " added while running";
+        return false;
+    }
+    for (const auto& lane : lanes_) {
+        if (lane.name == config.name || lane.source_id == config.pipeline.source_id) {
+            LOG(ERROR) << "PipelineRouter: lane " << config.name << " (source "
+                       << config.pipeline.source_id << ") duplicates lane " << lane.name;
+            return false;
+        }
+    }
+
+    size_t index = lanes_.size();
+    for (size_t type = 0; type < candidates_.size(); ++type) {
+        const auto& types = config.route.types;
+        if (types.empty() ||
+            std::find(types.begin(), types.end(), static_cast<ItemType>(type)) != types.end()) {
+            candidates_[type].push_back({index, config.route.prefixes});
+        }
+    }
+    lanes_.push_back({config.name, config.pipeline.source_id, config.route,
+                      std::make_unique<UnifiedExporterPipeline>(
+                          std::move(transport), std::move(compressor), config.pipeline)});
+    return true;
+}
+
+bool PipelineRouter::start() {
+    if (running_) {
+        return true;
+    }
+    for (size_t i = 0; i < lanes_.size(); ++i) {
+        if (!lanes_[i].pipeline->start()) {
+            LOG(ERROR) << "PipelineRouter: Failed to start lane " << lanes_[i].name;
+            while (i-- > 0) {
+                lanes_[i].pipeline->stop();
+            }
+            return false;
+        }
+    }
+    running_ = true;
+
+    for (const auto& lane : lanes_) {
+        std::string types;
+        for (ItemType type : lane.route.types) {
+            types += (types.empty() ? "" : ",") + std::string(to_string(type));
+        }
+        std::string prefixes;
+        for (const auto& prefix : lane.route.prefixes) {
+            prefixes += (prefixes.empty() ? "" : ",") + prefix;
+        }
+        LOG(INFO) << "PipelineRouter: lane " << lane.name << " (source=" << lane.source_id
+                  << ", types=" << (types.empty() ? "all" : types)
+                  << ", prefixes=" << (prefixes.empty() ? "any" : prefixes) << ")";
+    }
+    return true;
+}
+
+void PipelineRouter::stop() {
+    if (!running_) {
+        return;
+    }
+    running_ = false;
+    for (auto& lane : lanes_) {
+        lane.pipeline->stop();
+    }
+    uint64_t unrouted = items_unrouted_.load(std::memory_order_relaxed);
+    if (unrouted > 0) {
+        LOG(WARNING) << "PipelineRouter: " << unrouted << " items matched no lane";
+    }
+}
+
+void PipelineRouter::flush() {
+    for (auto& lane : lanes_) {
+        lane.pipeline->flush();
+    }
+}
+
+UnifiedExporterPipeline* PipelineRouter::route(ItemType type, const char* key) {
+    std::string_view view = key ? key : "";
+    for (const auto& candidate : candidates_[static_cast<size_t>(type)]) {
+        if (candidate.prefixes.empty()) {
+            return lanes_[candidate.lane].pipeline.get();
+        }
+        for (const auto& prefix : candidate.prefixes) {
+            if (view.compare(0, prefix.size(), prefix) == 0) {
+                return lanes_[candidate.lane].pipeline.get();
+            }
+        }
+    }
+    items_unrouted_.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+}
+
+void PipelineRouter::send(const vep_VssSignal& msg) {
+    if (auto* pipeline = route(ItemType::Signal, msg.path)) {
+        pipeline->send(msg);
+    }
+}
+
+void PipelineRouter::send(const vep_Event& msg) {
+    if (auto* pipeline = route(ItemType::Event, msg.category)) {
+        pipeline->send(msg);
+    }
+}
+
+void PipelineRouter::send(const vep_OtelGauge& msg) {
+    if (auto* pipeline = route(ItemType::Metric, msg.name)) {
+        pipeline->send(msg);
+    }
+}
+
+void PipelineRouter::send(const vep_OtelCounter& msg) {
+    if (auto* pipeline = route(ItemType::Metric, msg.name)) {
+        pipeline->send(msg);
+    }
+}
+
+void PipelineRouter::send(const vep_OtelHistogram& msg) {
+    if (auto* pipeline = route(ItemType::Metric, msg.name)) {
+        pipeline->send(msg);
+    }
+}
+
+void PipelineRouter::send(const vep_OtelLogEntry& msg) {
+    if (auto* pipeline = route(ItemType::Log, msg.component)) {
+        pipeline->send(msg);
+    }
+}
+
+template<typename T, typename Key>
+void PipelineRouter::route_batch(ItemType type, const T* msgs, size_t count, Key&& key) {
+    UnifiedExporterPipeline* current = nullptr;
+    size_t start = 0;
+    for (size_t i = 0; i < count; ++i) {
+        UnifiedExporterPipeline* pipeline = route(type, key(msgs[i]));
+        if (pipeline != current) {
+            if (current) {
+                current->send_batch(msgs + start, i - start);
+            }
+            current = pipeline;
+            start = i;
+        }
+    }
+    if (current) {
+        current->send_batch(msgs + start, count - start);
+    }
+}
+
+void PipelineRouter::send_batch(const vep_VssSignal* msgs, size_t count) {
+    route_batch(ItemType::Signal, msgs, count, [](const vep_VssSignal& msg) { return msg.path; });
+}
+
+void PipelineRouter::send_batch(const vep_Event* msgs, size_t count) {
+    route_batch(ItemType::Event, msgs, count, [](const vep_Event& msg) { return msg.category; });
+}
+
+void PipelineRouter::send_batch(const vep_OtelGauge* msgs, size_t count) {
+    route_batch(ItemType::Metric, msgs, count,
+                [](const vep_OtelGauge& msg) { return msg.name; });
+}
+
+void PipelineRouter::send_batch(const vep_OtelCounter* msgs, size_t count) {
+    route_batch(ItemType::Metric, msgs, count,
+                [](const vep_OtelCounter& msg) { return msg.name; });
+}
+
+void PipelineRouter::send_batch(const vep_OtelHistogram* msgs, size_t count) {
+    route_batch(ItemType::Metric, msgs, count,
+                [](const vep_OtelHistogram& msg) { return msg.name; });
+}
+
+void PipelineRouter::send_batch(const vep_OtelLogEntry* msgs, size_t count) {
+    route_batch(ItemType::Log, msgs, count,
+                [](const vep_OtelLogEntry& msg) { return msg.component; });
+}
+
+bool PipelineRouter::healthy() const {
+    if (lanes_.empty()) {
+        return false;
+    }
+    for (const auto& lane : lanes_) {
+        if (!lane.pipeline->healthy()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+PipelineRouterStats PipelineRouter::stats() const {
+    PipelineRouterStats stats;
+    stats.items_unrouted = items_unrouted_.load(std::memory_order_relaxed);
+    for (const auto& lane : lanes_) {
+        stats.lanes.push_back({lane.name, lane.pipeline->stats()});
+    }
+    return stats;
+}
+
+}  // namespace vep::exporter
@@ -0,0 +1,469 @@
+// Copyright 2025 Vehicle Edge Platform Contributors
+// SPDX-License-Identifier: Apache-2.0
+
+#include "signal_block.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace vep::exporter {
+
+namespace {
+
+using vep::transfer::Signal;
+
+template<typename T>
+uint64_t bits_of(T value) {
+    if constexpr (sizeof(T) == 4) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    } else {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+}
+
+template<typename T>
+T value_of(uint64_t bits) {
+    T value;
+    if constexpr (sizeof(T) == 4) {
+        auto low = static_cast<uint32_t>(bits);
+        std::memcpy(&value, &low, sizeof(value));
+    } else {
+        std::memcpy(&value, &bits, sizeof(value));
+    }
+    return value;
+}
+
+uint64_t signed_bits(int64_t value) { return static_cast<uint64_t>(value); }
+
+/// MSB-first bit writer appending to a string
+class BitWriter {
+public:
+    explicit BitWriter(std::string* out) : out_(out) {}
+
+    /// Write the low `count` bits of value (count <= 64)
+    void write(uint64_t value, int count) {
+        while (count > 0) {
+            if (used_ == 0) {
+                out_->push_back('\0');
+            }
+            int room = 8 - used_;
+            int take = std::min(room, count);
+            auto chunk = static_cast<unsigned>((value >> (count - take)) & ((1u << take) - 1));
+            out_->back() = static_cast<char>(
+                static_cast<unsigned char>(out_->back()) | (chunk << (room - take)));
+            used_ = (used_ + take) & 7;
+            count -= take;
+        }
+    }
+
+private:
+    std::string* out_;
+    int used_ = 0;  // Bits used in the last byte
+};
+
+class BitReader {
+public:
+    explicit BitReader(const std::string& in) : in_(in) {}
+
+    bool read(int count, uint64_t* value) {
+        uint64_t result = 0;
+        while (count > 0) {
+            if (byte_ >= in_.size()) {
+                return false;
+            }
+            int avail = 8 - bit_;
+            int take = std::min(avail, count);
+            auto byte = static_cast<unsigned char>(in_[byte_]);
+            result = (result << take) | ((byte >> (avail - take)) & ((1u << take) - 1));
+            bit_ += take;
+            if (bit_ == 8) {
+                bit_ = 0;
+                byte_++;
+            }
+            count -= take;
+        }
+        *value = result;
+        return true;
+    }
+
+private:
+    const std::string& in_;
+    size_t byte_ = 0;
+    int bit_ = 0;
+};
+
+void write_deltas(const std::vector<uint64_t>& values, vep::transfer::DeltaArray* array) {
+    auto* out = array->mutable_values();
+    out->Reserve(static_cast<int>(values.size()));
+    uint64_t prev = 0;
+    for (uint64_t v : values) {
+        out->Add(static_cast<int64_t>(v - prev));
+        prev = v;
+    }
+}
+
+bool read_deltas(const vep::transfer::DeltaArray& array, size_t count,
+                 std::vector<uint64_t>* values) {
+    if (static_cast<size_t>(array.values_size()) != count) {
+        return false;
+    }
+    uint64_t v = 0;
+    for (int64_t delta : array.values()) {
+        v += static_cast<uint64_t>(delta);
+        values->push_back(v);
+    }
+    return true;
+}
+
+}  // namespace
+
+// =============================================================================
+// SignalColumnSet
+// =============================================================================
+
+SignalColumnSet::SignalColumnSet(size_t max_paths) : max_paths_(max_paths) {}
+
+SignalColumn* SignalColumnSet::add(std::string_view path, Signal::ValueCase value_case,
+                                   vep::transfer::Quality quality,
+                                   int64_t timestamp_ms, uint64_t bits) {
+    SignalColumn* column;
+    auto it = by_path_.find(path);
+    if (it != by_path_.end()) {
+        column = it->second;
+    } else {
+        if (storage_.size() >= max_paths_) {
+            return nullptr;
+        }
+        column = &storage_.emplace_back();
+        column->path = path;
+        by_path_.emplace(column->path, column);
+    }
+
+    if (column->values.empty()) {
+        column->value_case = value_case;
+        column->quality = quality;
+        column->index = active_.size();
+        active_.push_back(column);
+    } else if (column->value_case != value_case || column->quality != quality) {
+        return nullptr;
+    }
+
+    column->timestamps_ms.push_back(timestamp_ms);
+    column->values.push_back(bits);
+    return column;
+}
+
+void SignalColumnSet::clear() {
+    for (SignalColumn* column : active_) {
+        column->timestamps_ms.clear();
+        column->values.clear();
+    }
+    active_.clear();
+}
+
+// =============================================================================
+// Value bits
+// =============================================================================
+
+bool signal_value_bits(const Signal& signal, uint64_t* bits) {
+    switch (signal.value_case()) {
+        case Signal::kBoolVal:   *bits = signal.bool_val() ? 1 : 0; return true;
+        case Signal::kInt32Val:  *bits = signed_bits(signal.int32_val()); return true;
+        case Signal::kInt64Val:  *bits = signed_bits(signal.int64_val()); return true;
+        case Signal::kUint32Val: *bits = signal.uint32_val(); return true;
+        case Signal::kUint64Val: *bits = signal.uint64_val(); return true;
+        case Signal::kFloatVal:  *bits = bits_of(signal.float_val()); return true;
+        case Signal::kDoubleVal: *bits = bits_of(signal.double_val()); return true;
+        default:
+            return false;
+    }
+}
+
+bool signal_value_bits(const vep_VssValue& value, Signal::ValueCase* value_case,
+                       uint64_t* bits) {
+    // Same type mapping as convert_value_to_signal()
+    switch (value.type) {
+        case vep_VSS_VALUE_TYPE_BOOL:
+            *value_case = Signal::kBoolVal;
+            *bits = value.bool_value ? 1 : 0;
+            return true;
+        case vep_VSS_VALUE_TYPE_INT8:
+            *value_case = Signal::kInt32Val;
+            *bits = signed_bits(value.int8_value);
+            return true;
+        case vep_VSS_VALUE_TYPE_INT16:
+            *value_case = Signal::kInt32Val;
+            *bits = signed_bits(value.int16_value);
+            return true;
+        case vep_VSS_VALUE_TYPE_INT32:
+            *value_case = Signal::kInt32Val;
+            *bits = signed_bits(value.int32_value);
+            return true;
+        case vep_VSS_VALUE_TYPE_INT64:
+            *value_case = Signal::kInt64Val;
+            *bits = signed_bits(value.int64_value);
+            return true;
+        case vep_VSS_VALUE_TYPE_UINT8:
+            *value_case = Signal::kUint32Val;
+            *bits = value.uint8_value;
+            return true;
+        case vep_VSS_VALUE_TYPE_UINT16:
+            *value_case = Signal::kUint32Val;
+            *bits = value.uint16_value;
+            return true;
+        case vep_VSS_VALUE_TYPE_UINT32:
+            *value_case = Signal::kUint32Val;
+            *bits = value.uint32_value;
+            return true;
+        case vep_VSS_VALUE_TYPE_UINT64:
+            *value_case = Signal::kUint64Val;
+            *bits = value.uint64_value;
+            return true;
+        case vep_VSS_VALUE_TYPE_FLOAT:
+            *value_case = Signal::kFloatVal;
+            *bits = bits_of(value.float_value);
+            return true;
+        case vep_VSS_VALUE_TYPE_DOUBLE:
+            *value_case = Signal::kDoubleVal;
+            *bits = bits_of(value.double_value);
+            return true;
+        default:
+            return false;
+    }
+}
+
+void set_signal_value(Signal::ValueCase value_case, uint64_t bits, Signal* signal) {
+    switch (value_case) {
+        case Signal::kBoolVal:   signal->set_bool_val(bits != 0); break;
+        case Signal::kInt32Val:  signal->set_int32_val(static_cast<int32_t>(bits)); break;
+        case Signal::kInt64Val:  signal->set_int64_val(static_cast<int64_t>(bits)); break;
+        case Signal::kUint32Val: signal->set_uint32_val(static_cast<uint32_t>(bits)); break;
+        case Signal::kUint64Val: signal->set_uint64_val(bits); break;
+        case Signal::kFloatVal:  signal->set_float_val(value_of<float>(bits)); break;
+        case Signal::kDoubleVal: signal->set_double_val(value_of<double>(bits)); break;
+        default: break;
+    }
+}
+
+// =============================================================================
+// SignalBlock
+// =============================================================================
+
+void encode_signal_block(const SignalColumn& column, vep::transfer::SignalBlock* block) {
+    size_t count = column.size();
+    block->set_path(column.path);
+    block->set_quality(column.quality);
+    block->set_count(static_cast<uint32_t>(count));
+
+    auto* dod = block->mutable_timestamp_dod_ms();
+    dod->Reserve(static_cast<int>(count > 0 ? count - 1 : 0));
+    int64_t prev_delta = 0;
+    for (size_t i = 1; i < count; ++i) {
+        int64_t delta = column.timestamps_ms[i] - column.timestamps_ms[i - 1];
+        dod->Add(delta - prev_delta);
+        prev_delta = delta;
+    }
+
+    switch (column.value_case) {
+        case Signal::kDoubleVal:
+            xor_encode(column.values.data(), count, 64, block->mutable_double_xor());
+            break;
+        case Signal::kFloatVal:
+            xor_encode(column.values.data(), count, 32, block->mutable_float_xor());
+            break;
+        case Signal::kInt32Val:
+            write_deltas(column.values, block->mutable_int32_delta());
+            break;
+        case Signal::kInt64Val:
+            write_deltas(column.values, block->mutable_int64_delta());
+            break;
+        case Signal::kUint32Val:
+            write_deltas(column.values, block->mutable_uint32_delta());
+            break;
+        case Signal::kUint64Val:
+            write_deltas(column.values, block->mutable_uint64_delta());
+            break;
+        case Signal::kBoolVal: {
+            auto* values = block->mutable_bool_values()->mutable_values();
+            values->Reserve(static_cast<int>(count));
+            for (uint64_t v : column.values) {
+                values->Add(v != 0);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+bool expand_signal_block(const vep::transfer::SignalBlock& block, int64_t first_timestamp_ms,
+                         Signal::ValueCase* value_case,
+                         std::vector<int64_t>* timestamps_ms,
+                         std::vector<uint64_t>* values) {
+    timestamps_ms->clear();
+    values->clear();
+
+    size_t count = block.count();
+    if (count == 0) {
+        return false;
+    }
+    // Also bounds count by the message size before anything is reserved
+    if (static_cast<size_t>(block.timestamp_dod_ms_size()) != count - 1) {
+        return false;
+    }
+
+    timestamps_ms->reserve(count);
+    int64_t ts = first_timestamp_ms;
+    int64_t delta = 0;
+    timestamps_ms->push_back(ts);
+    for (int64_t dod : block.timestamp_dod_ms()) {
+        delta += dod;
+        ts += delta;
+        timestamps_ms->push_back(ts);
+    }
+
+    values->reserve(count);
+    switch (block.values_case()) {
+        case vep::transfer::SignalBlock::kDoubleXor:
+            *value_case = Signal::kDoubleVal;
+            return xor_decode(block.double_xor(), count, 64, values);
+        case vep::transfer::SignalBlock::kFloatXor:
+            *value_case = Signal::kFloatVal;
+            return xor_decode(block.float_xor(), count, 32, values);
+        case vep::transfer::SignalBlock::kInt32Delta:
+            *value_case = Signal::kInt32Val;
+            return read_deltas(block.int32_delta(), count, values);
+        case vep::transfer::SignalBlock::kInt64Delta:
+            *value_case = Signal::kInt64Val;
+            return read_deltas(block.int64_delta(), count, values);
+        case vep::transfer::SignalBlock::kUint32Delta:
+            *value_case = Signal::kUint32Val;
+            return read_deltas(block.uint32_delta(), count, values);
+        case vep::transfer::SignalBlock::kUint64Delta:
+            *value_case = Signal::kUint64Val;
+            return read_deltas(block.uint64_delta(), count, values);
+        case vep::transfer::SignalBlock::kBoolValues:
+            *value_case = Signal::kBoolVal;
+            if (static_cast<size_t>(block.bool_values().values_size()) != count) {
+                return false;
+            }
+            for (bool v : block.bool_values().values()) {
+                values->push_back(v ? 1 : 0);
+            }
+            return true;
+        default:
+            return false;
+    }
+}
+
+// =============================================================================
+// Gorilla XOR
+// =============================================================================
+//
+// First value: `width` raw bits. Each following value is XORed with its
+// predecessor:
+//   '0'                     identical value
+//   '1' '0' <bits>          meaningful bits fit the previous window
+//   '1' '1' <lead:5> <len-1:6|5> <bits>   new window
+// Slowly changing sensor values share sign, exponent and high mantissa
+// bits, so most samples cost well under a byte.
+
+void xor_encode(const uint64_t* values, size_t count, int width, std::string* out) {
+    out->clear();
+    if (count == 0) {
+        return;
+    }
+
+    const int len_bits = width == 64 ? 6 : 5;
+    BitWriter writer(out);
+    writer.write(values[0], width);
+
+    int prev_lead = -1;
+    int prev_trail = 0;
+    for (size_t i = 1; i < count; ++i) {
+        uint64_t x = values[i] ^ values[i - 1];
+        if (x == 0) {
+            writer.write(0, 1);
+            continue;
+        }
+        writer.write(1, 1);
+
+        int lead = __builtin_clzll(x) - (64 - width);
+        int trail = __builtin_ctzll(x);
+        lead = std::min(lead, 31);
+
+        if (prev_lead >= 0 && lead >= prev_lead && trail >= prev_trail) {
+            writer.write(0, 1);
+            writer.write(x >> prev_trail, width - prev_lead - prev_trail);
+        } else {
+            int len = width - lead - trail;
+            writer.write(1, 1);
+            writer.write(static_cast<uint64_t>(lead), 5);
+            writer.write(static_cast<uint64_t>(len - 1), len_bits);
+            writer.write(x >> trail, len);
+            prev_lead = lead;
+            prev_trail = trail;
+        }
+    }
+}
+
+bool xor_decode(const std::string& in, size_t count, int width,
+                std::vector<uint64_t>* values) {
+    values->clear();
+    if (count == 0) {
+        return true;
+    }
+
+    const int len_bits = width == 64 ? 6 : 5;
+    BitReader reader(in);
+    uint64_t value;
+    if (!reader.read(width, &value)) {
+        return false;
+    }
+    values->push_back(value);
+
+    int lead = -1;
+    int trail = 0;
+    for (size_t i = 1; i < count; ++i) {
+        uint64_t bit;
+        if (!reader.read(1, &bit)) {
+            return false;
+        }
+        if (bit == 0) {
+            values->push_back(value);
+            continue;
+        }
+
+        if (!reader.read(1, &bit)) {
+            return false;
+        }
+        if (bit == 1) {
+            uint64_t new_lead;
+            uint64_t len_minus_one;
+            if (!reader.read(5, &new_lead) || !reader.read(len_bits, &len_minus_one)) {
+                return false;
+            }
+            lead = static_cast<int>(new_lead);
+            trail = width - lead - static_cast<int>(len_minus_one + 1);
+            if (trail < 0) {
+                return false;
+            }
+        } else if (lead < 0) {
+            return false;  // Window reuse before any window was sent
+        }
+
+        uint64_t meaningful;
+        if (!reader.read(width - lead - trail, &meaningful)) {
+            return false;
+        }
+        value ^= meaningful << trail;
+        values->push_back(value);
+    }
+    return true;
+}
+
+}  // namespace vep::exporter
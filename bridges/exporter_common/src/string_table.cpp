@@ -0,0 +1,110 @@
+// Copyright 2025 Vehicle Edge Platform Contributors
+// SPDX-License-Identifier: Apache-2.0
+
+#include "string_table.hpp"
+
+namespace vep::exporter {
+
+namespace {
+
+size_t varint_size(uint64_t value) {
+    size_t size = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        size++;
+    }
+    return size;
+}
+
+}  // namespace
+
+uint32_t StringTable::ref(std::string_view text) {
+    auto it = ids_.find(text);
+    if (it != ids_.end()) {
+        return it->second;
+    }
+
+    // Field tag, length prefix, string
+    size_t entry_bytes = 1 + varint_size(text.size()) + text.size();
+    if (max_bytes_ > 0 && bytes_ + entry_bytes > max_bytes_) {
+        return 0;
+    }
+    if (size_ == strings_.size()) {
+        strings_.emplace_back();
+    }
+    std::string& stored = strings_[size_];
+    stored.assign(text.data(), text.size());
+    uint32_t id = static_cast<uint32_t>(++size_);
+    ids_.emplace(stored, id);
+    bytes_ += entry_bytes;
+    return id;
+}
+
+uint32_t StringTable::find(std::string_view text) const {
+    auto it = ids_.find(text);
+    return it != ids_.end() ? it->second : 0;
+}
+
+void StringTable::clear() {
+    ids_.clear();
+    size_ = 0;
+    bytes_ = 0;
+}
+
+void StringTable::reference_pairs(google::protobuf::RepeatedPtrField<std::string>* keys,
+                                  google::protobuf::RepeatedPtrField<std::string>* values,
+                                  google::protobuf::RepeatedField<uint32_t>* key_refs,
+                                  google::protobuf::RepeatedField<uint32_t>* value_refs) {
+    if (keys->empty() && values->empty()) {
+        return;
+    }
+    key_refs->Reserve(keys->size());
+    value_refs->Reserve(values->size());
+
+    // Keys first, then values: direct_encoder adds them in the same order
+    int kept = 0;
+    for (int i = 0; i < keys->size(); ++i) {
+        uint32_t id = ref(keys->Get(i));
+        key_refs->Add(id);
+        if (id == 0) {
+            keys->Mutable(kept++)->swap(*keys->Mutable(i));
+        }
+    }
+    keys->DeleteSubrange(kept, keys->size() - kept);
+
+    kept = 0;
+    for (int i = 0; i < values->size(); ++i) {
+        uint32_t id = ref(values->Get(i));
+        value_refs->Add(id);
+        if (id == 0) {
+            values->Mutable(kept++)->swap(*values->Mutable(i));
+        }
+    }
+    values->DeleteSubrange(kept, values->size() - kept);
+}
+
+void StringTable::reference_item(vep::transfer::TransferItem& item) {
+    if (item.has_metric()) {
+        auto* metric = item.mutable_metric();
+        if (!metric->name().empty()) {
+            if (uint32_t id = ref(metric->name())) {
+                metric->set_name_ref(id);
+                metric->clear_name();
+            }
+        }
+        reference_pairs(metric->mutable_label_keys(), metric->mutable_label_values(),
+                        metric->mutable_label_key_refs(), metric->mutable_label_value_refs());
+    } else if (item.has_log()) {
+        auto* log = item.mutable_log();
+        if (!log->component().empty()) {
+            if (uint32_t id = ref(log->component())) {
+                log->set_component_ref(id);
+                log->clear_component();
+            }
+        }
+        reference_pairs(log->mutable_attr_keys(), log->mutable_attr_values(),
+                        log->mutable_attr_key_refs(), log->mutable_attr_value_refs());
+    }
+}
+
+}  // namespace vep::exporter
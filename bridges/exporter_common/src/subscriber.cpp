@@ -111,7 +111,28 @@ void SubscriptionManager::start() {
         return;
     }
 
-    poll_thread_ = std::thread(&SubscriptionManager::poll_loop, this);
+    reactor_ = std::make_unique<bridge::DdsReactor>("SubscriptionManager");
+    if (add_batch_readers_) {
+        add_batch_readers_();
+    } else {
+        add_reader<vep_VssSignal>("vss_signals", reader_vss_signal_, cb_vss_signal_);
+        add_reader<vep_Event>("events", reader_event_, cb_event_);
+        add_reader<vep_OtelGauge>("gauges", reader_gauge_, cb_gauge_);
+        add_reader<vep_OtelCounter>("counters", reader_counter_, cb_counter_);
+        add_reader<vep_OtelHistogram>("histograms", reader_histogram_, cb_histogram_);
+        add_reader<vep_OtelLogEntry>("logs", reader_log_entry_, cb_log_entry_);
+    }
+    add_reader<vep_ScalarMeasurement>(
+        "scalar_measurements", reader_scalar_measurement_, cb_scalar_measurement_);
+    add_reader<vep_VectorMeasurement>(
+        "vector_measurements", reader_vector_measurement_, cb_vector_measurement_);
+
+    if (!reactor_->start()) {
+        LOG(ERROR) << "SubscriptionManager failed to start";
+        reactor_.reset();
+        running_ = false;
+        return;
+    }
     LOG(INFO) << "SubscriptionManager started";
 }
 
@@ -120,96 +141,74 @@ void SubscriptionManager::stop() {
         return;
     }
 
-    if (poll_thread_.joinable()) {
-        poll_thread_.join();
-    }
+    reactor_->stop();
+    reactor_.reset();
     LOG(INFO) << "SubscriptionManager stopped";
 }
 
 void SubscriptionManager::on_vss_signal(VssSignalCallback callback) {
-    cb_vss_signal_ = std::move(callback);
+    if (before_start("on_vss_signal()")) {
+        cb_vss_signal_ = std::move(callback);
+    }
 }
 
 void SubscriptionManager::on_event(EventCallback callback) {
-    cb_event_ = std::move(callback);
+    if (before_start("on_event()")) {
+        cb_event_ = std::move(callback);
+    }
 }
 
 void SubscriptionManager::on_gauge(GaugeCallback callback) {
-    cb_gauge_ = std::move(callback);
+    if (before_start("on_gauge()")) {
+        cb_gauge_ = std::move(callback);
+    }
 }
 
 void SubscriptionManager::on_counter(CounterCallback callback) {
-    cb_counter_ = std::move(callback);
+    if (before_start("on_counter()")) {
+        cb_counter_ = std::move(callback);
+    }
 }
 
 void SubscriptionManager::on_histogram(HistogramCallback callback) {
-    cb_histogram_ = std::move(callback);
+    if (before_start("on_histogram()")) {
+        cb_histogram_ = std::move(callback);
+    }
 }
 
 void SubscriptionManager::on_log_entry(LogEntryCallback callback) {
-    cb_log_entry_ = std::move(callback);
+    if (before_start("on_log_entry()")) {
+        cb_log_entry_ = std::move(callback);
+    }
 }
 
 void SubscriptionManager::on_scalar_measurement(ScalarMeasurementCallback callback) {
-    cb_scalar_measurement_ = std::move(callback);
+    if (before_start("on_scalar_measurement()")) {
+        cb_scalar_measurement_ = std::move(callback);
+    }
 }
 
 void SubscriptionManager::on_vector_measurement(VectorMeasurementCallback callback) {
-    cb_vector_measurement_ = std::move(callback);
+    if (before_start("on_vector_measurement()")) {
+        cb_vector_measurement_ = std::move(callback);
+    }
 }
 
-void SubscriptionManager::poll_loop() {
-    LOG(INFO) << "Poll loop started";
-
-    while (running_) {
-        // Poll each reader
-        if (reader_vss_signal_ && cb_vss_signal_) {
-            process_reader<vep_VssSignal>(*reader_vss_signal_, cb_vss_signal_);
-        }
-
-        if (reader_event_ && cb_event_) {
-            process_reader<vep_Event>(*reader_event_, cb_event_);
-        }
-
-        if (reader_gauge_ && cb_gauge_) {
-            process_reader<vep_OtelGauge>(*reader_gauge_, cb_gauge_);
-        }
-
-        if (reader_counter_ && cb_counter_) {
-            process_reader<vep_OtelCounter>(*reader_counter_, cb_counter_);
-        }
-
-        if (reader_histogram_ && cb_histogram_) {
-            process_reader<vep_OtelHistogram>(*reader_histogram_, cb_histogram_);
-        }
-
-        if (reader_log_entry_ && cb_log_entry_) {
-            process_reader<vep_OtelLogEntry>(*reader_log_entry_, cb_log_entry_);
-        }
-
-        if (reader_scalar_measurement_ && cb_scalar_measurement_) {
-            process_reader<vep_ScalarMeasurement>(
-                *reader_scalar_measurement_, cb_scalar_measurement_);
-        }
-
-        if (reader_vector_measurement_ && cb_vector_measurement_) {
-            process_reader<vep_VectorMeasurement>(
-                *reader_vector_measurement_, cb_vector_measurement_);
-        }
-
-        // Small sleep to avoid busy-waiting
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+bool SubscriptionManager::before_start(const char* setter) const {
+    if (running_) {
+        // Readers are added to the reactor by start() only
+        LOG(ERROR) << "SubscriptionManager " << setter << " called after start(), ignored";
+        return false;
     }
-
-    LOG(INFO) << "Poll loop exited";
+    return true;
 }
 
 template<typename T, typename Callback>
-void SubscriptionManager::process_reader(dds::Reader& reader, const Callback& callback) {
-    try {
-        reader.take_each<T>(callback, 100);
-    } catch (const dds::Error& e) {
-        LOG(ERROR) << "Error reading from DDS: " << e.what();
+void SubscriptionManager::add_reader(const char* name,
+                                     const std::unique_ptr<dds::Reader>& reader,
+                                     const Callback& callback) {
+    if (reader && callback) {
+        reactor_->add_reader<T>(name, *reader, callback);
     }
 }
 
@@ -5,16 +5,191 @@
 
 #include <glog/logging.h>
 
+#include <algorithm>
+#include <bitset>
+#include <limits>
+#include <random>
+#include <sstream>
+
 namespace vep::exporter {
 
+namespace {
+
+/// Exported latency histogram bounds, milliseconds
+constexpr double kLatencyBoundsMs[] = {0.1, 0.25, 0.5, 1, 2.5, 5, 10, 25, 50, 100,
+                                       250, 500, 1000, 2500, 5000, 10000};
+
+/// Indexed by ItemType
+constexpr const char* kItemTypeNames[] = {"signal", "event", "metric", "log"};
+
+constexpr const char* kStageNames[] = {"build", "compress", "publish", "batch"};
+
+int64_t elapsed_us(std::chrono::steady_clock::time_point since) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - since).count();
+}
+
+/// Whether a log of this level is shed at the given queue level
+bool shed_log(vep::QueueLevel level, vep_OtelLogLevel log_level) {
+    switch (level) {
+        case vep::QueueLevel::Full: return true;
+        case vep::QueueLevel::Critical: return log_level < vep_LOG_LEVEL_ERROR;
+        case vep::QueueLevel::High: return log_level < vep_LOG_LEVEL_WARN;
+        default: return false;
+    }
+}
+
+/// add_batch() step that passes every item
+struct KeepAll {
+    template<typename T>
+    bool operator()(const T&) const { return true; }
+};
+
+const char* queue_level_name(vep::QueueLevel level) {
+    switch (level) {
+        case vep::QueueLevel::Empty: return "empty";
+        case vep::QueueLevel::Low: return "low";
+        case vep::QueueLevel::Normal: return "normal";
+        case vep::QueueLevel::High: return "high";
+        case vep::QueueLevel::Critical: return "critical";
+        case vep::QueueLevel::Full: return "full";
+    }
+    return "unknown";
+}
+
+/// Builder settings with the byte limit that keeps compressed batches
+/// within batch_max_bytes
+BatchBuilderConfig builder_config(const UnifiedPipelineConfig& config,
+                                  const Compressor& compressor) {
+    BatchBuilderConfig encoding = config.encoding;
+    // At least 1: a limit below the compressor's fixed overhead drops
+    // everything rather than silently meaning "unlimited"
+    encoding.max_batch_bytes = std::max<size_t>(1, compressor.max_input_size(config.batch_max_bytes));
+    encoding.track_item_times = encoding.track_item_times || config.latency.enabled;
+    return encoding;
+}
+
+/// config with a random encoding session, unless one is set
+UnifiedPipelineConfig with_session(UnifiedPipelineConfig config) {
+    std::random_device random;
+    while (config.encoding.session == 0) {
+        config.encoding.session = (static_cast<uint64_t>(random()) << 32) | random();
+    }
+    return config;
+}
+
+bool drop_oldest(const UnifiedPipelineConfig& config) {
+    return config.memory.max_bytes > 0 && config.memory.policy == OverflowPolicy::DropOldest;
+}
+
+}  // namespace
+
+const char* overflow_policy_name(OverflowPolicy policy) {
+    switch (policy) {
+        case OverflowPolicy::DropNewest: return "drop-newest";
+        case OverflowPolicy::DropOldest: return "drop-oldest";
+        case OverflowPolicy::Block: return "block";
+    }
+    return "unknown";
+}
+
 UnifiedExporterPipeline::UnifiedExporterPipeline(
     std::unique_ptr<vep::BackendTransport> transport,
     std::unique_ptr<Compressor> compressor,
     const UnifiedPipelineConfig& config)
-    : config_(config)
+    : config_(with_session(config))
     , transport_(std::move(transport))
     , compressor_(std::move(compressor))
-    , builder_(config.source_id, config.batch_max_items) {
+    , builder_(config.source_id,
+               config.adaptive.enabled ? std::max(config.batch_max_items, config.adaptive.max_items)
+                                       : config.batch_max_items,
+               builder_config(config_, *compressor_))
+    , stages_(config.stages, *compressor_,
+              [this](vep::PayloadBuffer compressed, size_t raw_size) {
+                  publish_batch(std::move(compressed), raw_size);
+              },
+              drop_oldest(config) ? FlushStages::OverflowFn([this] {
+                  return memory_in_use() >= config_.memory.max_bytes;
+              }) : nullptr,
+              [this](size_t raw_size) { on_batch_dropped(raw_size); })
+    , flush_items_(config.batch_max_items)
+    , flush_bytes_(config.batch_max_bytes)
+    , flush_timeout_ms_(config.batch_timeout.count()) {
+    const auto& encoding = config_.encoding;
+    if (encoding.intern_paths || encoding.log_templates || encoding.metric_series) {
+        recovery_ = std::make_unique<BatchRecovery>(builder_,
+                                                    builder_config(config_, *compressor_));
+        if (!stages_.set_rewrite([this](std::vector<uint8_t>& batch) {
+                return recovery_->rewrite(batch);
+            })) {
+            LOG(WARNING) << "UnifiedExporterPipeline: " << compressor_->name()
+                         << " compressor cannot be cloned, batches after a lost one wait"
+                         << " for the dictionary to be resent";
+            recovery_.reset();
+        }
+    }
+    if (config_.adaptive.enabled) {
+        BatchLimits initial;
+        initial.max_items = config_.batch_max_items;
+        initial.max_bytes = config_.batch_max_bytes;
+        initial.timeout = config_.batch_timeout;
+        controller_ = std::make_unique<BatchSizeController>(config_.adaptive, initial);
+    }
+    if (!config_.policy.pass_through()) {
+        policy_ = std::make_unique<ExportPolicy>(
+            config_.policy, [this](const vep_OtelGauge& aggregate) {
+                // Stands for the signals it aggregates: shed and admitted
+                // like them
+                if (shed_level() == vep::QueueLevel::Full) {
+                    counters_.signals_shed.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                if (!admit(1, false)) {
+                    return;
+                }
+                builder_.add(aggregate);
+                check_flush_needed();
+            });
+    }
+    if (config_.log_dedup.enabled) {
+        log_dedup_ = std::make_unique<LogDedup>(
+            config_.log_dedup, [this](const vep_OtelLogEntry& summary, const LogRepeat& repeat) {
+                if (shed_log(shed_level(), summary.level)) {
+                    counters_.logs_shed.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                if (!admit(1, false)) {
+                    return;
+                }
+                builder_.add(summary, repeat);
+                check_flush_needed();
+            });
+    }
+    if (config_.shedding.enabled) {
+        ExportRule rule;
+        rule.match = "**";
+        rule.action = PolicyAction::Downsample;
+        rule.min_interval_ms = config_.shedding.signal_interval_ms;
+        ExportPolicyConfig shed_config;
+        shed_config.rules.push_back(rule);
+        shed_signals_ = std::make_unique<ExportPolicy>(shed_config, nullptr);
+    }
+    if (config_.urgent.enabled) {
+        // Own context: compresses on the urgent thread
+        urgent_compressor_ = compressor_->clone();
+        if (!urgent_compressor_) {
+            LOG(WARNING) << "UnifiedExporterPipeline: " << compressor_->name()
+                         << " compressor cannot be cloned, urgent batches are not compressed";
+            urgent_compressor_ = create_compressor(CompressorType::NONE);
+        }
+        // Events only: no interning, no dictionary state shared with bulk
+        BatchBuilderConfig encoding;
+        encoding.max_batch_bytes = builder_config(config_, *urgent_compressor_).max_batch_bytes;
+        encoding.track_item_times = config_.latency.enabled;
+        encoding.session = config_.encoding.session;
+        urgent_builder_ = std::make_unique<UnifiedBatchBuilder>(
+            config_.source_id + config_.urgent.source_suffix, config_.batch_max_items, encoding);
+    }
 }
 
 UnifiedExporterPipeline::~UnifiedExporterPipeline() {
@@ -26,19 +201,64 @@ bool UnifiedExporterPipeline::start() {
         return true;
     }
 
+    if (config_.shedding.enabled) {
+        transport_->on_queue_status([this](const vep::QueueStatus& status) {
+            on_queue_status(status);
+        });
+    }
+
+    if (config_.spool.enabled) {
+        spool_ = BatchSpool::open(config_.spool);
+        if (!spool_) {
+            LOG(ERROR) << "UnifiedExporterPipeline: Failed to open spool in "
+                       << config_.spool.directory;
+            return false;
+        }
+        transport_->on_connection_status([this](const vep::ConnectionStatus& status) {
+            on_connection_status(status);
+        });
+    }
+
     if (!transport_->start()) {
         LOG(ERROR) << "UnifiedExporterPipeline: Failed to start transport";
         return false;
     }
 
+    stages_.start();
     running_ = true;
+    last_flush_ = std::chrono::steady_clock::now();
+    next_latency_report_ = last_flush_ + config_.latency.interval;
     flush_thread_ = std::thread(&UnifiedExporterPipeline::flush_loop, this);
+    if (spool_) {
+        replay_thread_ = std::thread(&UnifiedExporterPipeline::replay_loop, this);
+    }
+    if (urgent_builder_) {
+        urgent_thread_ = std::thread(&UnifiedExporterPipeline::urgent_loop, this);
+    }
 
     LOG(INFO) << "UnifiedExporterPipeline started"
               << " (transport=" << transport_->name()
               << ", compression=" << compressor_->name()
+              << ", compress_workers=" << stages_.workers()
               << ", max_items=" << config_.batch_max_items
-              << ", timeout=" << config_.batch_timeout.count() << "ms)";
+              << ", timeout=" << config_.batch_timeout.count() << "ms"
+              << ", adaptive=" << (controller_ ? "on" : "off")
+              << ", intern_paths=" << (config_.encoding.intern_paths ? "on" : "off")
+              << ", arena=" << (config_.encoding.use_arena ? "on" : "off")
+              << ", direct=" << (config_.encoding.direct_encoding ? "on" : "off")
+              << ", signal_blocks=" << (config_.encoding.signal_blocks ? "on" : "off")
+              << ", log_templates=" << (config_.encoding.log_templates ? "on" : "off")
+              << ", string_table=" << (config_.encoding.string_table ? "on" : "off")
+              << ", metric_series=" << (config_.encoding.metric_series ? "on" : "off")
+              << ", policy_rules=" << config_.policy.rules.size()
+              << ", log_dedup=" << (log_dedup_ ? "on" : "off")
+              << ", spool=" << (spool_ ? config_.spool.directory : "off")
+              << ", urgent=" << (urgent_builder_ ? "on" : "off")
+              << ", memory_budget=" << (config_.memory.max_bytes > 0
+                                            ? std::to_string(config_.memory.max_bytes) + " " +
+                                                  overflow_policy_name(config_.memory.policy)
+                                            : std::string("off"))
+              << ", latency=" << (config_.latency.enabled ? "on" : "off") << ")";
     return true;
 }
 
@@ -47,41 +267,160 @@ void UnifiedExporterPipeline::stop() {
         return;
     }
 
-    running_ = false;
+    {
+        std::lock_guard<std::mutex> lock(flush_mutex_);
+        running_ = false;
+    }
     flush_cv_.notify_all();
+    {
+        std::lock_guard<std::mutex> lock(replay_mutex_);
+    }
+    replay_cv_.notify_all();
+    {
+        std::lock_guard<std::mutex> lock(urgent_mutex_);
+    }
+    urgent_cv_.notify_all();
+    {
+        std::lock_guard<std::mutex> lock(memory_mutex_);
+    }
+    memory_cv_.notify_all();
 
     if (flush_thread_.joinable()) {
         flush_thread_.join();
     }
+    if (replay_thread_.joinable()) {
+        replay_thread_.join();
+    }
+    if (urgent_thread_.joinable()) {
+        urgent_thread_.join();
+    }
+    if (urgent_builder_) {
+        flush_urgent();
+    }
 
-    // Final flush
+    // Final flush, including partial aggregation and log dedup windows
+    if (policy_) {
+        policy_->flush_all();
+    }
+    if (log_dedup_) {
+        log_dedup_->flush_all();
+    }
     do_flush();
+    stages_.stop();
 
     transport_->stop();
+    if (spool_) {
+        // Unreplayed batches are sent after the next start
+        spool_->sync();
+    }
 
+    auto final_stats = stats();
     LOG(INFO) << "UnifiedExporterPipeline stopped. Stats:"
-              << " items=" << stats_.items_total
-              << " (signals=" << stats_.signals_processed
-              << ", events=" << stats_.events_processed
-              << ", metrics=" << stats_.metrics_processed
-              << ", logs=" << stats_.logs_processed << ")"
-              << " batches=" << stats_.batches_sent
-              << " compression=" << (stats_.compression_ratio() * 100.0) << "%";
+              << " items=" << final_stats.items_total
+              << " (signals=" << final_stats.signals_processed
+              << ", events=" << final_stats.events_processed
+              << ", metrics=" << final_stats.metrics_processed
+              << ", logs=" << final_stats.logs_processed << ")"
+              << " suppressed=" << final_stats.signals_suppressed
+              << " aggregates=" << final_stats.aggregates_emitted
+              << " logs_collapsed=" << final_stats.logs_collapsed
+              << " shed=" << (final_stats.signals_shed + final_stats.metrics_shed +
+                              final_stats.logs_shed)
+              << " batches=" << final_stats.batches_sent
+              << " urgent=" << final_stats.urgent_batches_sent
+              << " spooled=" << final_stats.spool.batches_spooled
+              << " overflow=" << (final_stats.overflow_items_dropped +
+                                  final_stats.overflow_batches_dropped)
+              << " compression=" << (final_stats.compression_ratio() * 100.0) << "%";
+    if (config_.latency.enabled) {
+        report_latency();
+    }
 }
 
 void UnifiedExporterPipeline::flush() {
+    request_flush();
+}
+
+void UnifiedExporterPipeline::request_flush() {
+    // Only the first request per batch pays for the wakeup
+    if (flush_requested_.exchange(true, std::memory_order_acq_rel)) {
+        return;
+    }
+    {
+        // Pairs with the predicate check in flush_loop (no lost wakeup)
+        std::lock_guard<std::mutex> lock(flush_mutex_);
+    }
     flush_cv_.notify_one();
 }
 
 void UnifiedExporterPipeline::flush_loop() {
     while (running_) {
         std::unique_lock<std::mutex> lock(flush_mutex_);
-        flush_cv_.wait_for(lock, config_.batch_timeout);
+        auto timeout = std::chrono::milliseconds(flush_timeout_ms_.load(std::memory_order_relaxed));
+        flush_cv_.wait_for(lock, timeout, [this] {
+            return flush_requested_.load(std::memory_order_acquire) || !running_;
+        });
 
         if (!running_) break;
 
+        // Cleared before building so items added meanwhile can re-arm it
+        flush_requested_.store(false, std::memory_order_release);
         lock.unlock();
+        sweep_windows();
         do_flush();
+
+        if (config_.latency.enabled && std::chrono::steady_clock::now() >= next_latency_report_) {
+            next_latency_report_ = std::chrono::steady_clock::now() + config_.latency.interval;
+            report_latency();
+            publish_latency();
+        }
+    }
+}
+
+void UnifiedExporterPipeline::on_queue_status(const vep::QueueStatus& status) {
+    vep::QueueLevel previous = queue_level_.exchange(status.level, std::memory_order_relaxed);
+    if (previous == status.level) {
+        return;
+    }
+    if (status.level >= vep::QueueLevel::High) {
+        LOG(WARNING) << "UnifiedExporterPipeline: transport queue " << queue_level_name(status.level)
+                     << ", shedding load";
+    } else if (previous >= vep::QueueLevel::High) {
+        LOG(INFO) << "UnifiedExporterPipeline: transport queue " << queue_level_name(status.level)
+                  << ", shedding stopped";
+    }
+}
+
+vep::QueueLevel UnifiedExporterPipeline::shed_level() const {
+    if (!config_.shedding.enabled) {
+        return vep::QueueLevel::Empty;
+    }
+    if (queue_full_.load(std::memory_order_relaxed)) {
+        return vep::QueueLevel::Full;
+    }
+    return queue_level_.load(std::memory_order_relaxed);
+}
+
+void UnifiedExporterPipeline::sweep_windows() {
+    if (!policy_ && !log_dedup_) {
+        return;
+    }
+    // Close windows of signals and log lines that stopped repeating, at
+    // most once per timeout
+    auto now = std::chrono::steady_clock::now();
+    if (now < next_window_sweep_) {
+        return;
+    }
+    next_window_sweep_ = now + config_.batch_timeout;
+
+    // Windows are in sample time, which DDS headers carry as wall-clock time
+    auto wall_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    if (policy_) {
+        policy_->flush_expired(wall_ms);
+    }
+    if (log_dedup_) {
+        log_dedup_->flush_expired(wall_ms);
     }
 }
 
@@ -90,124 +429,740 @@ void UnifiedExporterPipeline::do_flush() {
         return;
     }
 
-    auto batch_data = builder_.build();
-    if (batch_data.empty()) {
+    auto start = std::chrono::steady_clock::now();
+    BatchObservation observation;
+    observation.items = builder_.size();  // Approximate: producers keep adding
+
+    // First batch, then the rest of one split at batch_max_bytes; the
+    // stages publish them in this order
+    size_t parts = 0;
+    do {
+        auto buffer = stages_.acquire_buffer();
+        size_t bytes = builder_.build_into(buffer.bytes());
+        if (bytes == 0) {
+            break;
+        }
+        observation.bytes += bytes;
+        if (config_.latency.enabled) {
+            if (parts++ == 0) {
+                // Later parts were serialized with the first
+                build_latency_.record(elapsed_us(start));
+            }
+            std::lock_guard<std::mutex> lock(item_times_mutex_);
+            item_times_.push_back(builder_.item_times());
+        }
+        if (recovery_) {
+            recovery_->observe(buffer.bytes());
+        }
+        stages_.submit(std::move(buffer));
+    } while (builder_.pending_batches() > 0);
+
+    if (controller_ && observation.bytes > 0) {
+        // Compression and publish finish later: use the running ratio and
+        // the latest batch's time in the stages
+        uint64_t before = counters_.bytes_before_compression.load(std::memory_order_relaxed);
+        uint64_t after = counters_.bytes_after_compression.load(std::memory_order_relaxed);
+        double ratio = before > 0 ? static_cast<double>(after) / before : 1.0;
+        observation.compressed_bytes = static_cast<size_t>(observation.bytes * ratio);
+
+        auto now = std::chrono::steady_clock::now();
+        observation.interval =
+            std::chrono::duration_cast<std::chrono::microseconds>(start - last_flush_);
+        observation.flush_time =
+            std::chrono::duration_cast<std::chrono::microseconds>(now - start) +
+            stages_.last_latency();
+        apply_limits(controller_->update(observation));
+    }
+    last_flush_ = start;
+}
+
+void UnifiedExporterPipeline::apply_limits(const BatchLimits& limits) {
+    flush_items_.store(limits.max_items, std::memory_order_relaxed);
+    flush_bytes_.store(limits.max_bytes, std::memory_order_relaxed);
+    flush_timeout_ms_.store(limits.timeout.count(), std::memory_order_relaxed);
+}
+
+void UnifiedExporterPipeline::publish_batch(vep::PayloadBuffer compressed, size_t raw_size) {
+    std::vector<ItemTime> items;
+    if (config_.latency.enabled) {
+        std::lock_guard<std::mutex> lock(item_times_mutex_);
+        if (!item_times_.empty()) {
+            items = std::move(item_times_.front());
+            item_times_.pop_front();
+        }
+    }
+
+    if (compressed.size() > config_.batch_max_bytes) {
+        // Not reached: the builder limit leaves room for the worst case
+        LOG(ERROR) << "UnifiedExporterPipeline: compressed batch of " << compressed.size()
+                   << " bytes exceeds batch_max_bytes, dropped";
+        batch_lost();
         return;
     }
 
-    auto compressed = compressor_->compress(batch_data);
+    counters_.bytes_before_compression.fetch_add(raw_size, std::memory_order_relaxed);
+    counters_.bytes_after_compression.fetch_add(compressed.size(), std::memory_order_relaxed);
+
+    if (spool_ && !connected_.load(std::memory_order_relaxed)) {
+        make_self_contained(compressed);
+        spool_batch(compressed.bytes());
+        batch_lost();  // To the live stream: it arrives later, out of order
+        return;
+    }
 
+    bool success;
     {
-        std::lock_guard<std::mutex> lock(stats_mutex_);
-        stats_.bytes_before_compression += batch_data.size();
-        stats_.bytes_after_compression += compressed.size();
-        stats_.batches_sent++;
+        std::lock_guard<std::mutex> lock(publish_mutex_);
+        // With a spool the batch must survive a failed publish, so the
+        // transport gets a copy; otherwise its storage returns to the
+        // stages' pool when the transport is done
+        success = spool_ ? transport_->publish(compressed.bytes(), config_.persistence)
+                         : transport_->publish_buffer(std::move(compressed), config_.persistence);
+    }
+    if (config_.shedding.enabled) {
+        // For transports that report backpressure only through queue_full()
+        queue_full_.store(transport_->queue_full(), std::memory_order_relaxed);
+    }
+    if (!success) {
+        counters_.batches_failed.fetch_add(1, std::memory_order_relaxed);
+        LOG(WARNING) << "UnifiedExporterPipeline: Failed to publish batch"
+                     << (spool_ ? ", spooled" : "");
+        if (spool_) {
+            make_self_contained(compressed);
+            spool_batch(compressed.bytes());
+        }
+        batch_lost();
+    } else {
+        if (recovery_) {
+            recovery_->published();
+        }
+        counters_.batches_sent.fetch_add(1, std::memory_order_relaxed);
+        if (config_.latency.enabled) {
+            record_item_latency(items);
+        }
+    }
+    if (config_.memory.max_bytes > 0 && config_.memory.policy == OverflowPolicy::Block) {
+        {
+            // Pairs with the predicate check in admit() (no lost wakeup)
+            std::lock_guard<std::mutex> lock(memory_mutex_);
+        }
+        memory_cv_.notify_all();
+    }
+}
+
+void UnifiedExporterPipeline::on_batch_dropped(size_t raw_size) {
+    if (config_.latency.enabled) {
+        std::lock_guard<std::mutex> lock(item_times_mutex_);
+        if (!item_times_.empty()) {
+            item_times_.pop_front();
+        }
     }
+    batch_lost();
+    LOG_EVERY_N(WARNING, 100) << "UnifiedExporterPipeline: over memory budget, dropped batch of "
+                              << raw_size << " bytes (" << stages_.batches_dropped() << " so far)";
+}
+
+void UnifiedExporterPipeline::make_self_contained(vep::PayloadBuffer& compressed) {
+    // Replayed after later batches, maybe by another run: must not depend
+    // on the dictionary or series values of the batches around it
+    if (recovery_) {
+        stages_.rewrite_published([this](std::vector<uint8_t>& batch) {
+            return recovery_->make_self_contained(batch);
+        }, compressed);
+    }
+}
+
+void UnifiedExporterPipeline::batch_lost() {
+    // The lost batch may have carried dictionary entries
+    if (recovery_) {
+        recovery_->lost();
+    } else {
+        builder_.resend_path_dictionary();
+    }
+}
+
+void UnifiedExporterPipeline::urgent_loop() {
+    std::unique_lock<std::mutex> lock(urgent_mutex_);
+    while (running_) {
+        urgent_cv_.wait(lock, [this] { return urgent_requested_ || !running_; });
+        if (!running_) {
+            break;
+        }
+        // Let a burst of urgent events share one batch; stop() sends the rest
+        urgent_cv_.wait_for(lock, config_.urgent.linger, [this] { return !running_; });
+        urgent_requested_ = false;
+        lock.unlock();
+        flush_urgent();
+        lock.lock();
+    }
+}
+
+void UnifiedExporterPipeline::flush_urgent() {
+    while (urgent_builder_->ready()) {
+        size_t raw_size = urgent_builder_->build_into(urgent_raw_);
+        if (raw_size == 0) {
+            break;
+        }
+        if (urgent_compressor_->passthrough()) {
+            publish_urgent(urgent_raw_, raw_size, urgent_builder_->item_times());
+            continue;
+        }
+        urgent_compressor_->compress_into(urgent_raw_, urgent_compressed_);
+        publish_urgent(urgent_compressed_, raw_size, urgent_builder_->item_times());
+    }
+}
+
+void UnifiedExporterPipeline::publish_urgent(const std::vector<uint8_t>& compressed,
+                                             size_t raw_size,
+                                             const std::vector<ItemTime>& items) {
+    counters_.bytes_before_compression.fetch_add(raw_size, std::memory_order_relaxed);
+    counters_.bytes_after_compression.fetch_add(compressed.size(), std::memory_order_relaxed);
 
-    bool success = transport_->publish(compressed);
+    if (spool_ && !connected_.load(std::memory_order_relaxed)) {
+        spool_batch(compressed);
+        return;
+    }
+
+    bool success;
+    {
+        std::lock_guard<std::mutex> lock(publish_mutex_);
+        success = transport_->publish(compressed, config_.urgent.persistence);
+    }
     if (!success) {
-        LOG(WARNING) << "UnifiedExporterPipeline: Failed to publish batch";
+        counters_.batches_failed.fetch_add(1, std::memory_order_relaxed);
+        LOG(WARNING) << "UnifiedExporterPipeline: Failed to publish urgent batch"
+                     << (spool_ ? ", spooled" : "");
+        if (spool_) {
+            spool_batch(compressed);
+        }
+        return;
+    }
+    counters_.batches_sent.fetch_add(1, std::memory_order_relaxed);
+    counters_.urgent_batches_sent.fetch_add(1, std::memory_order_relaxed);
+    if (config_.latency.enabled) {
+        record_item_latency(items);
+    }
+}
+
+void UnifiedExporterPipeline::record_item_latency(const std::vector<ItemTime>& items) {
+    // Item timestamps are wall-clock milliseconds from the DDS header
+    int64_t now_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    for (const auto& item : items) {
+        item_latency_[static_cast<size_t>(item.type)].record(now_us - item.timestamp_ms * 1000);
+    }
+}
+
+PipelineLatencyStats UnifiedExporterPipeline::latency_stats() const {
+    PipelineLatencyStats latency;
+    latency.build = build_latency_.summary();
+    latency.compress = stages_.compress_latency().summary();
+    latency.publish = stages_.publish_latency().summary();
+    latency.batch = stages_.batch_latency().summary();
+    latency.signal = item_latency_[static_cast<size_t>(ItemType::Signal)].summary();
+    latency.event = item_latency_[static_cast<size_t>(ItemType::Event)].summary();
+    latency.metric = item_latency_[static_cast<size_t>(ItemType::Metric)].summary();
+    latency.log = item_latency_[static_cast<size_t>(ItemType::Log)].summary();
+    return latency;
+}
+
+void UnifiedExporterPipeline::report_latency() {
+    auto latency = latency_stats();
+    const std::pair<const char*, const LatencySummary*> summaries[] = {
+        {"build", &latency.build}, {"compress", &latency.compress},
+        {"publish", &latency.publish}, {"batch", &latency.batch},
+        {"signal", &latency.signal}, {"event", &latency.event},
+        {"metric", &latency.metric}, {"log", &latency.log},
+    };
+    std::ostringstream line;
+    for (const auto& [name, summary] : summaries) {
+        if (summary->count > 0) {
+            line << " " << name << "=" << summary->p50_us << "/" << summary->p99_us << "/"
+                 << summary->p999_us << "/" << summary->max_us;
+        }
+    }
+    if (line.tellp() > 0) {
+        LOG(INFO) << "UnifiedExporterPipeline: latency us (p50/p99/p99.9/max):" << line.str();
     }
 }
 
+void UnifiedExporterPipeline::publish_latency() {
+    if (!config_.latency.publish) {
+        return;
+    }
+    constexpr size_t kBounds = sizeof(kLatencyBoundsMs) / sizeof(kLatencyBoundsMs[0]);
+    vep_OtelHistogramBucket buckets[kBounds + 1];
+    vep_KeyValue label = {};
+    int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    auto publish = [&](const char* name, const char* key, const char* value,
+                       const LatencyHistogram& histogram) {
+        uint64_t count = histogram.count();
+        if (count == 0) {
+            return;
+        }
+        for (size_t i = 0; i < kBounds; ++i) {
+            buckets[i].upper_bound = kLatencyBoundsMs[i];
+            buckets[i].cumulative_count = std::min(
+                count, histogram.count_at_most(static_cast<int64_t>(kLatencyBoundsMs[i] * 1000)));
+        }
+        buckets[kBounds].upper_bound = std::numeric_limits<double>::infinity();
+        buckets[kBounds].cumulative_count = count;
+
+        label.key = const_cast<char*>(key);
+        label.value = const_cast<char*>(value);
+
+        vep_OtelHistogram msg = {};
+        msg.header.source_id = const_cast<char*>(config_.source_id.c_str());
+        msg.header.timestamp_ns = now_ns;
+        msg.header.seq_num = latency_seq_++;
+        msg.header.correlation_id = const_cast<char*>("");
+        msg.name = const_cast<char*>(name);
+        msg.labels._buffer = &label;
+        msg.labels._length = 1;
+        msg.labels._maximum = 1;
+        msg.sample_count = count;
+        msg.sample_sum = static_cast<double>(histogram.sum_us()) / 1000.0;
+        msg.buckets._buffer = buckets;
+        msg.buckets._length = kBounds + 1;
+        msg.buckets._maximum = kBounds + 1;
+        config_.latency.publish(msg);
+    };
+
+    const LatencyHistogram* stages[] = {&build_latency_, &stages_.compress_latency(),
+                                        &stages_.publish_latency(), &stages_.batch_latency()};
+    for (size_t i = 0; i < 4; ++i) {
+        publish("vep_exporter.stage_latency_ms", "stage", kStageNames[i], *stages[i]);
+    }
+    for (size_t i = 0; i < item_latency_.size(); ++i) {
+        publish("vep_exporter.item_latency_ms", "type", kItemTypeNames[i], item_latency_[i]);
+    }
+}
+
+void UnifiedExporterPipeline::spool_batch(const std::vector<uint8_t>& compressed) {
+    if (!spool_->append(compressed.data(), compressed.size())) {
+        LOG(ERROR) << "UnifiedExporterPipeline: batch of " << compressed.size()
+                   << " bytes does not fit a spool segment, dropped";
+    }
+}
+
+void UnifiedExporterPipeline::on_connection_status(const vep::ConnectionStatus& status) {
+    bool connected = status.state == vep::ConnectionState::Connected ||
+                     status.state == vep::ConnectionState::Unknown;
+    bool previous = connected_.exchange(connected, std::memory_order_relaxed);
+    if (connected == previous) {
+        return;
+    }
+    if (connected) {
+        LOG(INFO) << "UnifiedExporterPipeline: transport connected, replaying "
+                  << spool_->stats().batches_pending << " spooled batches";
+        {
+            // Pairs with the predicate check in replay_loop (no lost wakeup)
+            std::lock_guard<std::mutex> lock(replay_mutex_);
+        }
+        replay_cv_.notify_one();
+    } else {
+        LOG(WARNING) << "UnifiedExporterPipeline: transport disconnected, spooling batches";
+    }
+}
+
+void UnifiedExporterPipeline::replay_loop() {
+    std::vector<uint8_t> batch;
+    BatchSpool::Position at;
+    std::unique_lock<std::mutex> lock(replay_mutex_);
+    while (running_) {
+        replay_cv_.wait_for(lock, config_.spool.retry_interval, [this] {
+            return !running_ || (connected_.load(std::memory_order_relaxed) && !spool_->empty());
+        });
+        if (!running_ || !connected_.load(std::memory_order_relaxed) || !spool_->peek(batch, at)) {
+            continue;
+        }
+        lock.unlock();
+
+        bool success;
+        {
+            std::lock_guard<std::mutex> publish_lock(publish_mutex_);
+            success = transport_->publish(batch, config_.persistence);
+        }
+        if (success) {
+            spool_->pop(at);
+        }
+
+        // Failed: retry later. Sent: pace to the replay rate.
+        auto pause = config_.spool.retry_interval;
+        if (success) {
+            pause = config_.spool.replay_bytes_per_sec > 0
+                ? std::chrono::milliseconds(batch.size() * 1000 / config_.spool.replay_bytes_per_sec)
+                : std::chrono::milliseconds(0);
+        }
+        lock.lock();
+        replay_cv_.wait_for(lock, pause, [this] { return !running_; });
+    }
+}
+
+size_t UnifiedExporterPipeline::memory_in_use() const {
+    // Split parts waiting in the builder are submitted by the same flush
+    size_t bytes = builder_.estimated_size() + stages_.bytes_in_flight();
+    if (urgent_builder_) {
+        bytes += urgent_builder_->estimated_size();
+    }
+    return bytes;
+}
+
+bool UnifiedExporterPipeline::admit(size_t items, bool wait) {
+    size_t max_bytes = config_.memory.max_bytes;
+    if (max_bytes == 0 || memory_in_use() < max_bytes) {
+        return true;
+    }
+    switch (config_.memory.policy) {
+        case OverflowPolicy::DropOldest:
+            // Room comes from queued batches: move what is built to the
+            // stages, unless the unbuilt items alone fill the budget
+            if (builder_.estimated_size() < max_bytes) {
+                request_flush();
+                stages_.check_overflow();
+                return true;
+            }
+            break;
+        case OverflowPolicy::Block: {
+            if (!wait) {
+                break;
+            }
+            counters_.overflow_blocked.fetch_add(1, std::memory_order_relaxed);
+            request_flush();
+            std::unique_lock<std::mutex> lock(memory_mutex_);
+            if (memory_cv_.wait_for(lock, config_.memory.block_timeout, [this, max_bytes] {
+                    return memory_in_use() < max_bytes || !running_;
+                })) {
+                return running_;
+            }
+            break;
+        }
+        case OverflowPolicy::DropNewest:
+            break;
+    }
+    uint64_t dropped =
+        counters_.overflow_items_dropped.fetch_add(items, std::memory_order_relaxed) + items;
+    LOG_EVERY_N(WARNING, 1000) << "UnifiedExporterPipeline: over memory budget of " << max_bytes
+                               << " bytes, dropping items (" << dropped << " so far)";
+    return false;
+}
+
 void UnifiedExporterPipeline::check_flush_needed() {
     // Flush if batch is full (by item count or size)
-    if (builder_.full() || builder_.estimated_size() >= config_.batch_max_bytes) {
-        flush_cv_.notify_one();
+    if (builder_.size() >= flush_items_.load(std::memory_order_relaxed) ||
+        builder_.estimated_size() >= flush_bytes_.load(std::memory_order_relaxed)) {
+        request_flush();
     }
 }
 
 void UnifiedExporterPipeline::send(const vep_VssSignal& msg) {
     if (!running_) return;
 
-    builder_.add(msg);
+    counters_.signals_processed.fetch_add(1, std::memory_order_relaxed);
 
-    {
-        std::lock_guard<std::mutex> lock(stats_mutex_);
-        stats_.signals_processed++;
-        stats_.items_total++;
+    if (shed_level() == vep::QueueLevel::Full && !shed_signals_->filter(msg)) {
+        counters_.signals_shed.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // Filters keep state for what they pass: only for admitted samples
+    if (!admit()) {
+        return;
+    }
+
+    if (policy_ && !policy_->filter(msg)) {
+        return;
     }
 
+    builder_.add(msg);
+
     check_flush_needed();
 }
 
 void UnifiedExporterPipeline::send(const vep_Event& msg) {
     if (!running_) return;
 
-    builder_.add(msg);
+    if (urgent_builder_ && msg.severity >= config_.urgent.min_severity) {
+        counters_.events_processed.fetch_add(1, std::memory_order_relaxed);
+        add_urgent(msg);
+        return;
+    }
 
-    {
-        std::lock_guard<std::mutex> lock(stats_mutex_);
-        stats_.events_processed++;
-        stats_.items_total++;
+    counters_.events_processed.fetch_add(1, std::memory_order_relaxed);
+
+    if (!admit()) {
+        return;
     }
 
+    builder_.add(msg);
+
     check_flush_needed();
 }
 
 void UnifiedExporterPipeline::send(const vep_OtelGauge& msg) {
     if (!running_) return;
 
-    builder_.add(msg);
+    counters_.metrics_processed.fetch_add(1, std::memory_order_relaxed);
 
-    {
-        std::lock_guard<std::mutex> lock(stats_mutex_);
-        stats_.metrics_processed++;
-        stats_.items_total++;
+    if (shed_level() >= vep::QueueLevel::Critical) {
+        counters_.metrics_shed.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    if (!admit()) {
+        return;
     }
 
+    builder_.add(msg);
+
     check_flush_needed();
 }
 
 void UnifiedExporterPipeline::send(const vep_OtelCounter& msg) {
     if (!running_) return;
 
-    builder_.add(msg);
+    counters_.metrics_processed.fetch_add(1, std::memory_order_relaxed);
 
-    {
-        std::lock_guard<std::mutex> lock(stats_mutex_);
-        stats_.metrics_processed++;
-        stats_.items_total++;
+    if (shed_level() >= vep::QueueLevel::Critical) {
+        counters_.metrics_shed.fetch_add(1, std::memory_order_relaxed);
+        return;
     }
 
+    if (!admit()) {
+        return;
+    }
+
+    builder_.add(msg);
+
     check_flush_needed();
 }
 
 void UnifiedExporterPipeline::send(const vep_OtelHistogram& msg) {
     if (!running_) return;
 
-    builder_.add(msg);
+    counters_.metrics_processed.fetch_add(1, std::memory_order_relaxed);
 
-    {
-        std::lock_guard<std::mutex> lock(stats_mutex_);
-        stats_.metrics_processed++;
-        stats_.items_total++;
+    if (shed_level() >= vep::QueueLevel::Critical) {
+        counters_.metrics_shed.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    if (!admit()) {
+        return;
     }
 
+    builder_.add(msg);
+
     check_flush_needed();
 }
 
 void UnifiedExporterPipeline::send(const vep_OtelLogEntry& msg) {
     if (!running_) return;
 
+    counters_.logs_processed.fetch_add(1, std::memory_order_relaxed);
+
+    if (shed_log(shed_level(), msg.level)) {
+        counters_.logs_shed.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    if (!admit()) {
+        return;
+    }
+
+    if (log_dedup_ && !log_dedup_->filter(msg)) {
+        return;
+    }
+
     builder_.add(msg);
 
+    check_flush_needed();
+}
+
+void UnifiedExporterPipeline::add_urgent(const vep_Event& msg) {
+    urgent_builder_->add(msg);
+    counters_.events_urgent.fetch_add(1, std::memory_order_relaxed);
     {
-        std::lock_guard<std::mutex> lock(stats_mutex_);
-        stats_.logs_processed++;
-        stats_.items_total++;
+        std::lock_guard<std::mutex> lock(urgent_mutex_);
+        urgent_requested_ = true;
     }
+    urgent_cv_.notify_one();
+}
 
+template<typename T, typename Keep, typename Filter>
+void UnifiedExporterPipeline::add_batch(const T* msgs, size_t count, Keep&& keep,
+                                        Filter&& filter) {
+    constexpr size_t kChunk = 256;
+    for (size_t base = 0; base < count; base += kChunk) {
+        size_t n = std::min(kChunk, count - base);
+        std::bitset<kChunk> kept;
+        for (size_t i = 0; i < n; ++i) {
+            kept[i] = keep(msgs[base + i]);
+        }
+        if (kept.none() || !admit(kept.count())) {
+            continue;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            if (kept[i] && !filter(msgs[base + i])) {
+                kept[i] = false;
+            }
+        }
+        size_t start = 0;
+        for (size_t i = 0; i <= n; ++i) {
+            if (i == n || !kept[i]) {
+                if (i > start) {
+                    builder_.add(msgs + base + start, i - start);
+                }
+                start = i + 1;
+            }
+        }
+    }
     check_flush_needed();
 }
 
+void UnifiedExporterPipeline::send_batch(const vep_VssSignal* msgs, size_t count) {
+    if (!running_ || count == 0) return;
+
+    counters_.signals_processed.fetch_add(count, std::memory_order_relaxed);
+    bool shed = shed_level() == vep::QueueLevel::Full;
+
+    add_batch(msgs, count,
+              [this, shed](const vep_VssSignal& msg) {
+                  if (shed && !shed_signals_->filter(msg)) {
+                      counters_.signals_shed.fetch_add(1, std::memory_order_relaxed);
+                      return false;
+                  }
+                  return true;
+              },
+              [this](const vep_VssSignal& msg) { return !policy_ || policy_->filter(msg); });
+}
+
+void UnifiedExporterPipeline::send_batch(const vep_Event* msgs, size_t count) {
+    if (!running_ || count == 0) return;
+
+    counters_.events_processed.fetch_add(count, std::memory_order_relaxed);
+
+    add_batch(msgs, count, [this](const vep_Event& msg) {
+        if (urgent_builder_ && msg.severity >= config_.urgent.min_severity) {
+            add_urgent(msg);
+            return false;
+        }
+        return true;
+    }, KeepAll{});
+}
+
+void UnifiedExporterPipeline::send_batch(const vep_OtelGauge* msgs, size_t count) {
+    if (!running_ || count == 0) return;
+
+    counters_.metrics_processed.fetch_add(count, std::memory_order_relaxed);
+
+    if (shed_level() >= vep::QueueLevel::Critical) {
+        counters_.metrics_shed.fetch_add(count, std::memory_order_relaxed);
+        return;
+    }
+
+    add_batch(msgs, count, KeepAll{}, KeepAll{});
+}
+
+void UnifiedExporterPipeline::send_batch(const vep_OtelCounter* msgs, size_t count) {
+    if (!running_ || count == 0) return;
+
+    counters_.metrics_processed.fetch_add(count, std::memory_order_relaxed);
+
+    if (shed_level() >= vep::QueueLevel::Critical) {
+        counters_.metrics_shed.fetch_add(count, std::memory_order_relaxed);
+        return;
+    }
+
+    add_batch(msgs, count, KeepAll{}, KeepAll{});
+}
+
+void UnifiedExporterPipeline::send_batch(const vep_OtelHistogram* msgs, size_t count) {
+    if (!running_ || count == 0) return;
+
+    counters_.metrics_processed.fetch_add(count, std::memory_order_relaxed);
+
+    if (shed_level() >= vep::QueueLevel::Critical) {
+        counters_.metrics_shed.fetch_add(count, std::memory_order_relaxed);
+        return;
+    }
+
+    add_batch(msgs, count, KeepAll{}, KeepAll{});
+}
+
+void UnifiedExporterPipeline::send_batch(const vep_OtelLogEntry* msgs, size_t count) {
+    if (!running_ || count == 0) return;
+
+    counters_.logs_processed.fetch_add(count, std::memory_order_relaxed);
+    vep::QueueLevel level = shed_level();
+
+    // A dedup summary released by the filter is added at once, ahead of
+    // accepted entries of the span that arrived before it
+    add_batch(msgs, count,
+              [this, level](const vep_OtelLogEntry& msg) {
+                  if (shed_log(level, msg.level)) {
+                      counters_.logs_shed.fetch_add(1, std::memory_order_relaxed);
+                      return false;
+                  }
+                  return true;
+              },
+              [this](const vep_OtelLogEntry& msg) {
+                  return !log_dedup_ || log_dedup_->filter(msg);
+              });
+}
+
 bool UnifiedExporterPipeline::healthy() const {
     return running_ && transport_->healthy();
 }
 
 UnifiedPipelineStats UnifiedExporterPipeline::stats() const {
-    std::lock_guard<std::mutex> lock(stats_mutex_);
-    return stats_;
+    UnifiedPipelineStats stats;
+    stats.signals_processed = counters_.signals_processed.load(std::memory_order_relaxed);
+    stats.events_processed = counters_.events_processed.load(std::memory_order_relaxed);
+    stats.events_urgent = counters_.events_urgent.load(std::memory_order_relaxed);
+    stats.metrics_processed = counters_.metrics_processed.load(std::memory_order_relaxed);
+    stats.logs_processed = counters_.logs_processed.load(std::memory_order_relaxed);
+    stats.items_total = stats.signals_processed + stats.events_processed +
+                        stats.metrics_processed + stats.logs_processed;
+    if (policy_) {
+        auto policy_stats = policy_->stats();
+        stats.signals_suppressed = policy_stats.samples_dropped + policy_stats.samples_aggregated;
+        stats.aggregates_emitted = policy_stats.aggregates_emitted;
+    }
+    if (log_dedup_) {
+        stats.logs_collapsed = log_dedup_->stats().entries_collapsed;
+    }
+    stats.items_oversized = builder_.oversized_items();
+    stats.signals_shed = counters_.signals_shed.load(std::memory_order_relaxed);
+    stats.metrics_shed = counters_.metrics_shed.load(std::memory_order_relaxed);
+    stats.logs_shed = counters_.logs_shed.load(std::memory_order_relaxed);
+    stats.batches_failed = counters_.batches_failed.load(std::memory_order_relaxed);
+    stats.queue_level = shed_level();
+    stats.batches_sent = counters_.batches_sent.load(std::memory_order_relaxed);
+    stats.urgent_batches_sent = counters_.urgent_batches_sent.load(std::memory_order_relaxed);
+    stats.batches_in_flight = stages_.in_flight();
+    stats.batches_rewritten = recovery_ ? recovery_->batches_rewritten() : 0;
+    stats.memory_bytes = memory_in_use();
+    stats.overflow_items_dropped = counters_.overflow_items_dropped.load(std::memory_order_relaxed);
+    stats.overflow_batches_dropped = stages_.batches_dropped();
+    stats.overflow_blocked = counters_.overflow_blocked.load(std::memory_order_relaxed);
+    if (spool_) {
+        stats.spool = spool_->stats();
+    }
+    if (config_.latency.enabled) {
+        stats.latency = latency_stats();
+    }
+    stats.batch_limits.max_items = flush_items_.load(std::memory_order_relaxed);
+    stats.batch_limits.max_bytes = flush_bytes_.load(std::memory_order_relaxed);
+    stats.batch_limits.timeout =
+        std::chrono::milliseconds(flush_timeout_ms_.load(std::memory_order_relaxed));
+    stats.bytes_before_compression =
+        counters_.bytes_before_compression.load(std::memory_order_relaxed);
+    stats.bytes_after_compression =
+        counters_.bytes_after_compression.load(std::memory_order_relaxed);
+    return stats;
 }
 
 }  // namespace vep::exporter
@@ -2,6 +2,8 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "wire_decoder.hpp"
+#include "log_template.hpp"
+#include "signal_block.hpp"
 
 #include <sstream>
 
@@ -69,17 +71,125 @@ static DecodedStruct decode_struct_value(const vep::transfer::StructValue& pb_st
     return result;
 }
 
-DecodedSignal decode_signal(const vep::transfer::Signal& pb_signal,
-                            int64_t timestamp_ms) {
-    DecodedSignal signal;
+// =============================================================================
+// PathDictionaryCache
+// =============================================================================
 
-    // Get path (either full path or interned ID)
-    if (pb_signal.has_path()) {
-        signal.path = pb_signal.path();
-    } else {
-        // Path ID - would need dictionary lookup
-        signal.path = "<path_id:" + std::to_string(pb_signal.path_id()) + ">";
+bool PathDictionaryCache::apply(const vep::transfer::PathDictionary& dict) {
+    if (session_ != 0 && dict.version() < version_) {
+        // Versions only grow within a session; ids are never reassigned,
+        // so the entries are known
+        return false;
+    }
+    bool in_sequence = true;
+    if (dict.base_version() == 0) {
+        // Full snapshot replaces everything we know
+        entries_.clear();
+    } else if (dict.base_version() != version_) {
+        in_sequence = false;
+    }
+
+    for (const auto& entry : dict.entries()) {
+        entries_[entry.id()] = entry;
     }
+    version_ = dict.version();
+    return in_sequence;
+}
+
+const std::string* PathDictionaryCache::find(uint32_t id) const {
+    auto it = entries_.find(id);
+    return it != entries_.end() ? &it->second.path() : nullptr;
+}
+
+const vep::transfer::PathEntry* PathDictionaryCache::find_entry(uint32_t id) const {
+    auto it = entries_.find(id);
+    return it != entries_.end() ? &it->second : nullptr;
+}
+
+bool PathDictionaryCache::begin_batch(uint32_t sequence, uint64_t session) {
+    if (session != session_) {
+        clear();
+        session_ = session;
+    } else if (session_ != 0 && has_sequence_ &&
+               static_cast<int32_t>(sequence - next_sequence_) < 0) {
+        return false;
+    }
+    if (has_sequence_ && sequence != next_sequence_) {
+        series_.clear();
+    }
+    has_sequence_ = true;
+    next_sequence_ = sequence + 1;
+    return true;
+}
+
+PathDictionaryCache PathDictionaryCache::dictionary() const {
+    PathDictionaryCache copy;
+    copy.entries_ = entries_;
+    copy.version_ = version_;
+    copy.session_ = session_;
+    return copy;
+}
+
+bool PathDictionaryCache::SeriesValues::apply(const vep::transfer::MetricSample& sample) {
+    switch (sample.value_case()) {
+        case vep::transfer::MetricSample::kCounter:
+            has_counter = true;
+            counter = sample.counter();
+            return true;
+        case vep::transfer::MetricSample::kCounterDelta:
+            if (!has_counter) {
+                return false;
+            }
+            counter = static_cast<double>(static_cast<int64_t>(counter) +
+                                          sample.counter_delta());
+            return true;
+        case vep::transfer::MetricSample::kHistogram: {
+            const auto& hist = sample.histogram();
+            size_t buckets = static_cast<size_t>(hist.bucket_counts_size());
+            if (hist.delta() && (!has_histogram || bucket_counts.size() != buckets)) {
+                return false;
+            }
+            uint64_t base = hist.delta() ? sample_count : 0;
+            sample_count = base + static_cast<uint64_t>(hist.sample_count());
+            bucket_counts.resize(buckets);
+            for (size_t i = 0; i < buckets; ++i) {
+                uint64_t count = static_cast<uint64_t>(hist.bucket_counts(static_cast<int>(i)));
+                bucket_counts[i] = hist.delta() ? bucket_counts[i] + count : count;
+            }
+            has_histogram = true;
+            return true;
+        }
+        default:
+            return true;  // Gauges are not kept
+    }
+}
+
+void PathDictionaryCache::clear() {
+    entries_.clear();
+    version_ = 0;
+    series_.clear();
+    has_sequence_ = false;
+    session_ = 0;
+}
+
+// Full path, or interned ID resolved against the dictionary
+template<typename PathRef>
+static std::string resolve_path(const PathRef& pb, const PathDictionaryCache* paths) {
+    if (pb.has_path()) {
+        return pb.path();
+    }
+    if (const std::string* path = paths ? paths->find(pb.path_id()) : nullptr) {
+        return *path;
+    }
+    // Unknown ID - dictionary entry not (yet) received
+    return "<path_id:" + std::to_string(pb.path_id()) + ">";
+}
+
+DecodedSignal decode_signal(const vep::transfer::Signal& pb_signal,
+                            int64_t timestamp_ms,
+                            const PathDictionaryCache* paths) {
+    DecodedSignal signal;
+    signal.path = resolve_path(pb_signal, paths);
 
     // Use the pre-computed timestamp from the TransferItem
     signal.timestamp_ms = timestamp_ms;
@@ -194,6 +304,34 @@ DecodedSignal decode_signal(const vep::transfer::Signal& pb_signal,
     return signal;
 }
 
+std::vector<DecodedSignal> decode_signal_block(const vep::transfer::SignalBlock& pb_block,
+                                               int64_t timestamp_ms,
+                                               const PathDictionaryCache* paths) {
+    std::vector<DecodedSignal> signals;
+
+    vep::transfer::Signal::ValueCase value_case;
+    std::vector<int64_t> timestamps;
+    std::vector<uint64_t> values;
+    if (!expand_signal_block(pb_block, timestamp_ms, &value_case, &timestamps, &values)) {
+        return signals;
+    }
+
+    std::string path = resolve_path(pb_block, paths);
+    DecodedQuality quality = decode_quality(pb_block.quality());
+
+    // Reuse the row decoder's value mapping via a scratch Signal
+    vep::transfer::Signal pb_sample;
+    signals.reserve(values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+        set_signal_value(value_case, values[i], &pb_sample);
+        DecodedSignal signal = decode_signal(pb_sample, timestamps[i]);
+        signal.path = path;
+        signal.quality = quality;
+        signals.push_back(std::move(signal));
+    }
+    return signals;
+}
+
 DecodedEvent decode_event(const vep::transfer::Event& pb_event,
                           int64_t timestamp_ms) {
     DecodedEvent event;
@@ -210,10 +348,56 @@ DecodedEvent decode_event(const vep::transfer::Event& pb_event,
     return event;
 }
 
+namespace {
+
+std::string batch_string(const BatchStrings* strings, uint32_t ref) {
+    if (strings && ref <= static_cast<uint32_t>(strings->size())) {
+        return strings->Get(static_cast<int>(ref - 1));
+    }
+    return "<string:" + std::to_string(ref) + ">";
+}
+
+/// Strings of a ref array, a ref of 0 taking the next inline string; just
+/// the inline strings if there are no refs
+std::vector<std::string> resolve_strings(
+    const google::protobuf::RepeatedField<uint32_t>& refs,
+    const google::protobuf::RepeatedPtrField<std::string>& inline_strings,
+    const BatchStrings* strings) {
+    if (refs.empty()) {
+        return {inline_strings.begin(), inline_strings.end()};
+    }
+    std::vector<std::string> out;
+    out.reserve(static_cast<size_t>(refs.size()));
+    int next = 0;
+    for (uint32_t ref : refs) {
+        if (ref != 0) {
+            out.push_back(batch_string(strings, ref));
+        } else if (next < inline_strings.size()) {
+            out.push_back(inline_strings.Get(next++));
+        } else {
+            out.emplace_back();
+        }
+    }
+    return out;
+}
+
+/// Parallel key/value arrays into a map
+void decode_pairs(const std::vector<std::string>& keys, const std::vector<std::string>& values,
+                  std::map<std::string, std::string>& out) {
+    size_t count = std::min(keys.size(), values.size());
+    for (size_t i = 0; i < count; ++i) {
+        out[keys[i]] = values[i];
+    }
+}
+
+}  // namespace
+
 DecodedMetric decode_metric(const vep::transfer::Metric& pb_metric,
-                            int64_t timestamp_ms) {
+                            int64_t timestamp_ms,
+                            const BatchStrings* strings) {
     DecodedMetric metric;
-    metric.name = pb_metric.name();
+    metric.name = pb_metric.name_ref() != 0 ? batch_string(strings, pb_metric.name_ref())
+                                            : pb_metric.name();
     metric.timestamp_ms = timestamp_ms;
 
     // Determine metric type from oneof
@@ -245,37 +429,126 @@ DecodedMetric decode_metric(const vep::transfer::Metric& pb_metric,
     }
 
     // Decode labels from parallel arrays
-    int label_count = std::min(pb_metric.label_keys_size(), pb_metric.label_values_size());
-    for (int i = 0; i < label_count; ++i) {
-        metric.labels[pb_metric.label_keys(i)] = pb_metric.label_values(i);
+    decode_pairs(resolve_strings(pb_metric.label_key_refs(), pb_metric.label_keys(), strings),
+                 resolve_strings(pb_metric.label_value_refs(), pb_metric.label_values(), strings),
+                 metric.labels);
+
+    return metric;
+}
+
+std::optional<DecodedMetric> decode_metric_sample(const vep::transfer::MetricSample& pb_sample,
+                                                  int64_t timestamp_ms,
+                                                  PathDictionaryCache& paths) {
+    DecodedMetric metric;
+    metric.timestamp_ms = timestamp_ms;
+    if (const auto* series = paths.find_entry(pb_sample.series_id())) {
+        metric.name = series->path();
+        int label_count = std::min(series->label_keys_size(), series->label_values_size());
+        for (int i = 0; i < label_count; ++i) {
+            metric.labels[series->label_keys(i)] = series->label_values(i);
+        }
+    } else {
+        // Unknown ID - dictionary entry not (yet) received
+        metric.name = "<series_id:" + std::to_string(pb_sample.series_id()) + ">";
     }
 
+    auto& values = paths.series_values(pb_sample.series_id());
+    if (!values.apply(pb_sample)) {
+        return std::nullopt;
+    }
+    switch (pb_sample.value_case()) {
+        case vep::transfer::MetricSample::kGauge:
+            metric.type = MetricType::GAUGE;
+            metric.value = pb_sample.gauge();
+            break;
+        case vep::transfer::MetricSample::kCounter:
+        case vep::transfer::MetricSample::kCounterDelta:
+            metric.type = MetricType::COUNTER;
+            metric.value = values.counter;
+            break;
+        case vep::transfer::MetricSample::kHistogram: {
+            const auto& hist = pb_sample.histogram();
+            metric.type = MetricType::HISTOGRAM;
+            metric.value = 0.0;
+            metric.sample_count = values.sample_count;
+            metric.sample_sum = hist.sample_sum();
+            metric.bucket_counts = values.bucket_counts;
+            if (const auto* schema = hist.schema_id() ? paths.find_entry(hist.schema_id())
+                                                      : nullptr) {
+                metric.bucket_bounds.assign(schema->bucket_bounds().begin(),
+                                            schema->bucket_bounds().end());
+            }
+            break;
+        }
+        default:
+            metric.type = MetricType::GAUGE;
+            metric.value = 0.0;
+            break;
+    }
     return metric;
 }
 
 DecodedLogEntry decode_log(const vep::transfer::LogEntry& pb_log,
-                           int64_t timestamp_ms) {
+                           int64_t timestamp_ms,
+                           const PathDictionaryCache* paths,
+                           const BatchStrings* strings) {
     DecodedLogEntry entry;
     entry.timestamp_ms = timestamp_ms;
     entry.level = static_cast<LogLevel>(pb_log.level());
-    entry.component = pb_log.component();
-    entry.message = pb_log.message();
+    entry.component = pb_log.component_ref() != 0
+        ? batch_string(strings, pb_log.component_ref()) : pb_log.component();
+    entry.template_id = pb_log.template_id();
+    if (entry.template_id == 0) {
+        entry.message = pb_log.message();
+    } else if (const std::string* templ = paths ? paths->find(entry.template_id) : nullptr) {
+        entry.message = expand_log_template(*templ, pb_log.params());
+    } else {
+        // Unknown ID - dictionary entry not (yet) received
+        entry.message = "<template_id:" + std::to_string(entry.template_id) + ">";
+        for (const auto& param : pb_log.params()) {
+            entry.message += " " + param;
+        }
+    }
+    entry.repeat_count = std::max<uint32_t>(1, pb_log.repeat_count());
+    entry.last_timestamp_ms = timestamp_ms + pb_log.last_occurrence_delta_ms();
 
     // Decode attributes from parallel arrays
-    int attr_count = std::min(pb_log.attr_keys_size(), pb_log.attr_values_size());
-    for (int i = 0; i < attr_count; ++i) {
-        entry.attributes[pb_log.attr_keys(i)] = pb_log.attr_values(i);
-    }
+    decode_pairs(resolve_strings(pb_log.attr_key_refs(), pb_log.attr_keys(), strings),
+                 resolve_strings(pb_log.attr_value_refs(), pb_log.attr_values(), strings),
+                 entry.attributes);
 
     return entry;
 }
 
 std::optional<DecodedTransferBatch> decode_transfer_batch(const std::vector<uint8_t>& data) {
+    PathDictionaryCache paths;
+    return decode_transfer_batch(data, paths);
+}
+
+std::optional<DecodedTransferBatch> decode_transfer_batch(const std::vector<uint8_t>& data,
+                                                          PathDictionaryCache& paths) {
     vep::transfer::TransferBatch pb_batch;
     if (!pb_batch.ParseFromArray(data.data(), static_cast<int>(data.size()))) {
         return std::nullopt;
     }
 
+    // Replayed from the sender's spool: self-contained, and older than the
+    // cache (or of another session), so decoded without it. A late batch
+    // resolves ids against the cache, but its changes must not touch the
+    // series values of the batches after it.
+    PathDictionaryCache own;
+    PathDictionaryCache* cache = &paths;
+    if (pb_batch.replayed()) {
+        cache = &own;
+        own.begin_batch(pb_batch.sequence(), pb_batch.session());
+    } else if (!paths.begin_batch(pb_batch.sequence(), pb_batch.session())) {
+        own = paths.dictionary();
+        cache = &own;
+    }
+    if (pb_batch.has_path_dictionary()) {
+        cache->apply(pb_batch.path_dictionary());
+    }
+
     DecodedTransferBatch batch;
     batch.source_id = pb_batch.source_id();
     batch.sequence = pb_batch.sequence();
@@ -288,7 +561,7 @@ std::optional<DecodedTransferBatch> decode_transfer_batch(const std::vector<uint
         switch (pb_item.item_case()) {
             case vep::transfer::TransferItem::kSignal:
                 item.type = DecodedItemType::SIGNAL;
-                item.signal = decode_signal(pb_item.signal(), item.timestamp_ms);
+                item.signal = decode_signal(pb_item.signal(), item.timestamp_ms, cache);
                 break;
             case vep::transfer::TransferItem::kEvent:
                 item.type = DecodedItemType::EVENT;
@@ -296,12 +569,35 @@ std::optional<DecodedTransferBatch> decode_transfer_batch(const std::vector<uint
                 break;
             case vep::transfer::TransferItem::kMetric:
                 item.type = DecodedItemType::METRIC;
-                item.metric = decode_metric(pb_item.metric(), item.timestamp_ms);
+                item.metric = decode_metric(pb_item.metric(), item.timestamp_ms,
+                                            &pb_batch.strings());
                 break;
             case vep::transfer::TransferItem::kLog:
                 item.type = DecodedItemType::LOG;
-                item.log = decode_log(pb_item.log(), item.timestamp_ms);
+                item.log = decode_log(pb_item.log(), item.timestamp_ms, cache,
+                                      &pb_batch.strings());
                 break;
+            case vep::transfer::TransferItem::kMetricSample:
+                item.metric = decode_metric_sample(pb_item.metric_sample(), item.timestamp_ms,
+                                                   *cache);
+                item.type = item.metric ? DecodedItemType::METRIC : DecodedItemType::UNKNOWN;
+                break;
+            case vep::transfer::TransferItem::kSignalBlock: {
+                auto signals = decode_signal_block(pb_item.signal_block(),
+                                                   item.timestamp_ms, cache);
+                if (signals.empty()) {
+                    item.type = DecodedItemType::UNKNOWN;
+                    break;
+                }
+                for (auto& signal : signals) {
+                    DecodedItem sample;
+                    sample.timestamp_ms = signal.timestamp_ms;
+                    sample.type = DecodedItemType::SIGNAL;
+                    sample.signal = std::move(signal);
+                    batch.items.push_back(std::move(sample));
+                }
+                continue;
+            }
             default:
                 item.type = DecodedItemType::UNKNOWN;
                 break;
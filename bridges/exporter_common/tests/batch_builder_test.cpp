@@ -5,7 +5,9 @@
 #include "transfer.pb.h"
 
 #include <gtest/gtest.h>
+#include <atomic>
 #include <cstring>
+#include <map>
 #include <thread>
 
 namespace vep::exporter::test {
@@ -264,6 +266,55 @@ TEST_F(UnifiedBatchBuilderTest, ThreadSafety) {
     EXPECT_EQ(builder_.size(), NUM_THREADS * ITEMS_PER_THREAD);
 }
 
+TEST_F(UnifiedBatchBuilderTest, ConcurrentAddAndBuildKeepsEveryItemInOrder) {
+    const int NUM_THREADS = 4;
+    const int ITEMS_PER_THREAD = 2000;
+    const char* paths[NUM_THREADS] = {"Signal_0", "Signal_1", "Signal_2", "Signal_3"};
+
+    std::atomic<bool> producing{true};
+    std::vector<std::vector<uint8_t>> batches;
+    std::thread consumer([&]() {
+        while (producing) {
+            auto data = builder_.build();
+            if (!data.empty()) {
+                batches.push_back(std::move(data));
+            }
+        }
+    });
+
+    std::vector<std::thread> producers;
+    for (int t = 0; t < NUM_THREADS; ++t) {
+        producers.emplace_back([&, t]() {
+            for (int i = 0; i < ITEMS_PER_THREAD; ++i) {
+                builder_.add(create_test_signal(paths[t], i * 1.0, 1000000000 + i));
+            }
+        });
+    }
+    for (auto& t : producers) {
+        t.join();
+    }
+    producing = false;
+    consumer.join();
+    batches.push_back(builder_.build());
+
+    EXPECT_EQ(builder_.size(), 0);
+    EXPECT_EQ(builder_.estimated_size(), 0);
+
+    // Every item arrives exactly once, in per-producer order
+    std::map<std::string, double> next_value;
+    int total = 0;
+    for (const auto& data : batches) {
+        vep::transfer::TransferBatch batch;
+        ASSERT_TRUE(batch.ParseFromArray(data.data(), static_cast<int>(data.size())));
+        for (const auto& item : batch.items()) {
+            EXPECT_EQ(item.signal().double_val(), next_value[item.signal().path()]);
+            next_value[item.signal().path()] += 1.0;
+            total++;
+        }
+    }
+    EXPECT_EQ(total, NUM_THREADS * ITEMS_PER_THREAD);
+}
+
 TEST_F(UnifiedBatchBuilderTest, MixedTypesProduceCorrectItemTypes) {
     builder_.add(create_test_signal("Vehicle.Speed", 100.5, 1000000000));
     builder_.add(create_test_event("evt_1", "diagnostic", vep_SEVERITY_ERROR));
@@ -314,4 +365,190 @@ TEST_F(UnifiedBatchBuilderTest, SourceIdIsSet) {
     EXPECT_EQ(batch.source_id(), "test_source");
 }
 
+// =============================================================================
+// Arena Mode Tests
+// =============================================================================
+
+class ArenaBatchBuilderTest : public ::testing::Test {
+protected:
+    static BatchBuilderConfig arena_config() {
+        BatchBuilderConfig config;
+        config.use_arena = true;
+        return config;
+    }
+
+    template<typename Builder>
+    static void add_mixed(Builder& builder) {
+        builder.add(create_test_signal("Vehicle.Speed", 100.5, 1000000000));
+        builder.add(create_test_event("evt_1", "diagnostic", vep_SEVERITY_ERROR));
+        builder.add(create_test_gauge("memory_usage", 8192.0));
+        builder.add(create_test_counter("request_count", 7.0));
+        builder.add(create_test_log("exporter", "Connection established", vep_LOG_LEVEL_INFO));
+        builder.add(create_test_signal("Vehicle.Speed", 101.0, 1010000000));
+    }
+};
+
+TEST_F(ArenaBatchBuilderTest, MatchesHeapModeOutput) {
+    UnifiedBatchBuilder heap_builder("test_source", 100);
+    UnifiedBatchBuilder arena_builder("test_source", 100, arena_config());
+
+    add_mixed(heap_builder);
+    add_mixed(arena_builder);
+
+    EXPECT_EQ(arena_builder.size(), heap_builder.size());
+    EXPECT_EQ(arena_builder.build(), heap_builder.build());
+}
+
+TEST_F(ArenaBatchBuilderTest, BuildClearsAndRestarts) {
+    UnifiedBatchBuilder builder("test_source", 2, arena_config());
+
+    EXPECT_FALSE(builder.ready());
+    builder.add(create_test_signal("Signal1", 1.0, 1000000000));
+    builder.add(create_test_signal("Signal2", 2.0, 1005000000));
+    EXPECT_TRUE(builder.full());
+
+    auto data1 = builder.build();
+    EXPECT_FALSE(builder.ready());
+    EXPECT_EQ(builder.estimated_size(), 0);
+
+    builder.add(create_test_signal("Signal3", 3.0, 2000000000));
+    auto data2 = builder.build();
+
+    vep::transfer::TransferBatch batch1, batch2;
+    ASSERT_TRUE(batch1.ParseFromArray(data1.data(), static_cast<int>(data1.size())));
+    ASSERT_TRUE(batch2.ParseFromArray(data2.data(), static_cast<int>(data2.size())));
+    EXPECT_EQ(batch1.items_size(), 2);
+    EXPECT_EQ(batch1.items(1).timestamp_delta_ms(), 5);
+    EXPECT_EQ(batch2.items_size(), 1);
+    EXPECT_EQ(batch2.base_timestamp_ms(), 2000);
+    EXPECT_EQ(batch2.sequence(), batch1.sequence() + 1);
+}
+
+TEST_F(ArenaBatchBuilderTest, ReusedBuffersMatchHeapModeAcrossBuilds) {
+    UnifiedBatchBuilder heap_builder("test_source", 100);
+    BatchBuilderConfig config = arena_config();
+    config.arena_block_bytes = 256;  // Force overflow blocks on every batch
+    UnifiedBatchBuilder arena_builder("test_source", 100, config);
+
+    std::vector<uint8_t> heap_buffer;
+    std::vector<uint8_t> arena_buffer;
+    for (int round = 0; round < 10; ++round) {
+        for (int i = 0; i <= round; ++i) {
+            add_mixed(heap_builder);
+            add_mixed(arena_builder);
+        }
+        heap_builder.build_into(heap_buffer);
+        arena_builder.build_into(arena_buffer);
+        EXPECT_EQ(arena_buffer, heap_buffer) << "round " << round;
+    }
+}
+
+TEST_F(ArenaBatchBuilderTest, ThreadSafety) {
+    UnifiedBatchBuilder builder("test_source", 1000, arena_config());
+    const int NUM_THREADS = 4;
+    const int ITEMS_PER_THREAD = 100;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < NUM_THREADS; ++t) {
+        threads.emplace_back([&builder]() {
+            for (int i = 0; i < ITEMS_PER_THREAD; ++i) {
+                builder.add(create_test_signal("Vehicle.Speed", i * 1.0, 1000000000 + i));
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    EXPECT_EQ(builder.size(), NUM_THREADS * ITEMS_PER_THREAD);
+}
+
+TEST_F(UnifiedBatchBuilderTest, BuildIntoReusesCallerBuffer) {
+    std::vector<uint8_t> buffer;
+
+    builder_.add(create_test_signal("Vehicle.Speed", 100.5, 1000000000));
+    size_t written = builder_.build_into(buffer);
+    EXPECT_EQ(written, buffer.size());
+
+    vep::transfer::TransferBatch batch;
+    ASSERT_TRUE(batch.ParseFromArray(buffer.data(), static_cast<int>(buffer.size())));
+    EXPECT_EQ(batch.items(0).signal().path(), "Vehicle.Speed");
+
+    // Nothing pending: buffer is cleared, nothing written
+    EXPECT_EQ(builder_.build_into(buffer), 0);
+    EXPECT_TRUE(buffer.empty());
+}
+
+TEST(ItemTimesTest, EveryModeListsItemsOfTheBuiltBatch) {
+    BatchBuilderConfig staged;
+    BatchBuilderConfig arena;
+    arena.use_arena = true;
+    BatchBuilderConfig direct;
+    direct.direct_encoding = true;
+    direct.signal_blocks = true;  // Samples in columns are listed too
+
+    for (auto config : {staged, arena, direct}) {
+        config.track_item_times = true;
+        UnifiedBatchBuilder builder("test", 100, config);
+        for (int i = 0; i < 5; ++i) {
+            builder.add(create_test_signal("Vehicle.Speed", i, (2000 + i) * 1000000LL));
+        }
+        builder.add(create_test_event("evt-1", "ADAS", vep_SEVERITY_INFO));
+        builder.add(create_test_log("exporter", "started", vep_LOG_LEVEL_INFO));
+
+        ASSERT_GT(builder.build().size(), 0u);
+        std::map<ItemType, std::vector<int64_t>> times;
+        for (const auto& item : builder.item_times()) {
+            times[item.type].push_back(item.timestamp_ms);
+        }
+        EXPECT_EQ(times[ItemType::Signal], (std::vector<int64_t>{2000, 2001, 2002, 2003, 2004}));
+        EXPECT_EQ(times[ItemType::Event], (std::vector<int64_t>{1000}));
+        EXPECT_EQ(times[ItemType::Log].size(), 1u);
+        EXPECT_EQ(times[ItemType::Metric].size(), 0u);
+
+        // The next build lists only its own items
+        builder.add(create_test_gauge("cpu_usage", 42.0));
+        builder.build();
+        ASSERT_EQ(builder.item_times().size(), 1u);
+        EXPECT_EQ(builder.item_times()[0].type, ItemType::Metric);
+    }
+}
+
+TEST(SpanAddTest, EveryModeMatchesAddingItemsOneByOne) {
+    BatchBuilderConfig staged;
+    BatchBuilderConfig arena;
+    arena.use_arena = true;
+    BatchBuilderConfig direct;
+    direct.direct_encoding = true;
+    direct.signal_blocks = true;
+    direct.intern_paths = true;
+
+    std::vector<vep_VssSignal> signals;
+    for (int i = 0; i < 20; ++i) {
+        signals.push_back(create_test_signal(i % 2 ? "Vehicle.Speed" : "Vehicle.Cabin.Temp",
+                                             i, (2000 + i) * 1000000LL));
+    }
+    std::vector<vep_OtelLogEntry> logs = {
+        create_test_log("exporter", "started", vep_LOG_LEVEL_INFO),
+        create_test_log("exporter", "connected", vep_LOG_LEVEL_INFO),
+    };
+
+    for (const auto& config : {staged, arena, direct}) {
+        UnifiedBatchBuilder one_by_one("test", 100, config);
+        UnifiedBatchBuilder spans("test", 100, config);
+        for (const auto& signal : signals) {
+            one_by_one.add(signal);
+        }
+        for (const auto& log : logs) {
+            one_by_one.add(log);
+        }
+        spans.add(signals.data(), signals.size());
+        spans.add(logs.data(), logs.size());
+
+        EXPECT_EQ(spans.size(), one_by_one.size());
+        EXPECT_EQ(spans.estimated_size(), one_by_one.estimated_size());
+        EXPECT_EQ(spans.build(), one_by_one.build());
+    }
+}
+
 }  // namespace vep::exporter::test
@@ -0,0 +1,126 @@
+// Copyright 2025 Vehicle Edge Platform Contributors
+// SPDX-License-Identifier: Apache-2.0
+
+/// @file batch_controller_test.cpp
+/// @brief Tests for BatchSizeController without a pipeline
+///
+/// Each flush is described by a BatchObservation; the limits the
+/// controller returns are checked against the configured targets.
+
+#include "batch_controller.hpp"
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstddef>
+
+namespace vep::exporter::test {
+
+namespace {
+
+BatchObservation observe(size_t items, size_t bytes_per_item, double ratio,
+                         std::chrono::milliseconds interval,
+                         std::chrono::milliseconds flush_time = std::chrono::milliseconds(0)) {
+    BatchObservation observation;
+    observation.items = items;
+    observation.bytes = items * bytes_per_item;
+    observation.compressed_bytes = static_cast<size_t>(observation.bytes * ratio);
+    observation.interval = interval;
+    observation.flush_time = flush_time;
+    return observation;
+}
+
+}  // namespace
+
+TEST(BatchSizeControllerTest, LatencyTargetSetsTimeoutFromBudget) {
+    AdaptiveBatchingConfig config;
+    config.enabled = true;
+    config.target_latency_ms = 500;
+    BatchSizeController controller(config, BatchLimits{});
+
+    auto limits = controller.update(observe(100, 50, 0.3, std::chrono::milliseconds(1000),
+                                            std::chrono::milliseconds(100)));
+    EXPECT_EQ(limits.timeout.count(), 400);
+    // 100 items/s over 400 ms, twice for bursts
+    EXPECT_EQ(limits.max_items, 80u);
+    EXPECT_EQ(limits.max_bytes, 80u * 50);
+}
+
+TEST(BatchSizeControllerTest, LowRateWaitsForLargerBatches) {
+    AdaptiveBatchingConfig config;
+    config.enabled = true;
+    config.target_latency_ms = 5000;
+    BatchLimits initial;
+    initial.max_items = 100;
+    initial.timeout = std::chrono::milliseconds(1000);
+    BatchSizeController controller(config, initial);
+
+    // 5 items per second: a fixed 1 s timeout sends 5-item batches
+    auto limits = controller.update(observe(5, 50, 0.8, std::chrono::milliseconds(1000)));
+    EXPECT_EQ(limits.timeout.count(), 5000);
+    EXPECT_EQ(limits.max_items, 50u);
+    EXPECT_DOUBLE_EQ(controller.ingest_rate(), 5.0);
+}
+
+TEST(BatchSizeControllerTest, HighRateRaisesItemLimit) {
+    AdaptiveBatchingConfig config;
+    config.enabled = true;
+    config.max_items = 5000;
+    BatchLimits initial;
+    initial.max_items = 100;
+    BatchSizeController controller(config, initial);
+
+    // 100-item batches every 10 ms: item limit, not timeout, drives flushes
+    auto limits = controller.update(observe(100, 40, 0.3, std::chrono::milliseconds(10)));
+    EXPECT_EQ(limits.timeout.count(), 1000);  // No target: timeout unchanged
+    EXPECT_EQ(limits.max_items, 5000u);        // 10k items/s, clamped
+    EXPECT_EQ(limits.max_bytes, initial.max_bytes);  // Capped by the hard limit
+}
+
+TEST(BatchSizeControllerTest, ByteRateTargetGrowsTimeoutOverBudget) {
+    AdaptiveBatchingConfig config;
+    config.enabled = true;
+    config.target_bytes_per_sec = 10000;
+    config.max_timeout = std::chrono::milliseconds(8000);
+    BatchSizeController controller(config, BatchLimits{});
+
+    // 1000 items/s * 100 B * 0.5 = 50 kB/s, five times the budget
+    int64_t previous = 1000;
+    for (int i = 0; i < 5; ++i) {
+        auto limits = controller.update(observe(1000, 100, 0.5, std::chrono::milliseconds(1000)));
+        EXPECT_GE(limits.timeout.count(), previous);
+        previous = limits.timeout.count();
+    }
+    EXPECT_EQ(previous, 8000);
+
+    // Far below budget: back to the configured timeout, never below it
+    for (int i = 0; i < 30; ++i) {
+        controller.update(observe(10, 100, 0.5, std::chrono::milliseconds(1000)));
+    }
+    EXPECT_EQ(controller.limits().timeout.count(), 1000);
+}
+
+TEST(BatchSizeControllerTest, LatencyTargetCapsByteRateTarget) {
+    AdaptiveBatchingConfig config;
+    config.enabled = true;
+    config.target_bytes_per_sec = 1000;
+    config.target_latency_ms = 1500;
+    BatchSizeController controller(config, BatchLimits{});
+
+    for (int i = 0; i < 5; ++i) {
+        controller.update(observe(1000, 100, 0.5, std::chrono::milliseconds(1000)));
+    }
+    EXPECT_EQ(controller.limits().timeout.count(), 1500);
+}
+
+TEST(BatchSizeControllerTest, EmptyFlushChangesNothing) {
+    AdaptiveBatchingConfig config;
+    config.enabled = true;
+    config.target_latency_ms = 200;
+    BatchSizeController controller(config, BatchLimits{});
+
+    auto limits = controller.update(observe(0, 0, 1.0, std::chrono::milliseconds(1000)));
+    EXPECT_EQ(limits.timeout.count(), 1000);
+    EXPECT_EQ(limits.max_items, 100u);
+}
+
+}  // namespace vep::exporter::test
@@ -0,0 +1,251 @@
+// Copyright 2025 Vehicle Edge Platform Contributors
+// SPDX-License-Identifier: Apache-2.0
+
+/// @file batch_recovery_test.cpp
+/// @brief Tests for BatchRecovery without a pipeline
+///
+/// Batches are built, observed, then published or lost in order, as the
+/// flush stages do, and the published ones are decoded by one receiver.
+
+#include "batch_builder.hpp"
+#include "batch_recovery.hpp"
+#include "wire_decoder.hpp"
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace vep::exporter::test {
+
+namespace {
+
+vep_VssSignal make_signal(const char* path, double value) {
+    vep_VssSignal signal = {};
+    signal.path = const_cast<char*>(path);
+    signal.header.source_id = const_cast<char*>("test");
+    signal.header.timestamp_ns = 1000000000;
+    signal.header.correlation_id = const_cast<char*>("");
+    signal.quality = vep_VSS_QUALITY_VALID;
+    signal.value.type = vep_VSS_VALUE_TYPE_DOUBLE;
+    signal.value.double_value = value;
+    return signal;
+}
+
+vep_OtelCounter make_counter(const char* name, double value) {
+    vep_OtelCounter counter = {};
+    counter.name = const_cast<char*>(name);
+    counter.header.source_id = const_cast<char*>("test");
+    counter.header.timestamp_ns = 1000000000;
+    counter.header.correlation_id = const_cast<char*>("");
+    counter.value = value;
+    return counter;
+}
+
+}  // namespace
+
+class BatchRecoveryTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        config_.intern_paths = true;
+    }
+
+    void start() {
+        builder_ = std::make_unique<UnifiedBatchBuilder>("test_source", 1000, config_);
+        recovery_ = std::make_unique<BatchRecovery>(*builder_, config_);
+    }
+
+    /// Build and observe one batch of a signal per path
+    std::vector<uint8_t> build(const std::vector<const char*>& paths) {
+        for (const char* path : paths) {
+            builder_->add(make_signal(path, 1.0));
+        }
+        return observe();
+    }
+
+    /// Build and observe one batch of one counter value
+    std::vector<uint8_t> build_counter(double value) {
+        builder_->add(make_counter("exporter.items", value));
+        return observe();
+    }
+
+    std::vector<uint8_t> observe() {
+        auto batch = builder_->build();
+        recovery_->observe(batch);
+        return batch;
+    }
+
+    /// Publish the next batch, rewritten if needed
+    void publish(std::vector<uint8_t> batch) {
+        recovery_->rewrite(batch);
+        recovery_->published();
+        published_.push_back(std::move(batch));
+    }
+
+    /// Decoded items of the published batches, in order
+    std::vector<DecodedItem> receive() {
+        PathDictionaryCache cache;
+        std::vector<DecodedItem> items;
+        for (const auto& data : published_) {
+            auto decoded = decode_transfer_batch(data, cache);
+            EXPECT_TRUE(decoded);
+            if (decoded) {
+                items.insert(items.end(), decoded->items.begin(), decoded->items.end());
+            }
+        }
+        return items;
+    }
+
+    std::vector<std::string> receive_paths() {
+        std::vector<std::string> paths;
+        for (const auto& item : receive()) {
+            paths.push_back(item.signal ? item.signal->path : "unknown");
+        }
+        return paths;
+    }
+
+    static vep::transfer::TransferBatch parse(const std::vector<uint8_t>& data) {
+        vep::transfer::TransferBatch batch;
+        EXPECT_TRUE(batch.ParseFromArray(data.data(), static_cast<int>(data.size())));
+        return batch;
+    }
+
+    BatchBuilderConfig config_;
+    std::unique_ptr<UnifiedBatchBuilder> builder_;
+    std::unique_ptr<BatchRecovery> recovery_;
+    std::vector<std::vector<uint8_t>> published_;
+};
+
+TEST_F(BatchRecoveryTest, BatchesWithoutLossAreNotRewritten) {
+    start();
+    auto b1 = build({"Vehicle.A"});
+    auto b2 = build({"Vehicle.B", "Vehicle.A"});
+    for (auto* batch : {&b1, &b2}) {
+        auto original = *batch;
+        EXPECT_FALSE(recovery_->rewrite(*batch));
+        EXPECT_EQ(*batch, original);
+        recovery_->published();
+    }
+    EXPECT_EQ(recovery_->batches_rewritten(), 0u);
+}
+
+TEST_F(BatchRecoveryTest, LostEntriesMoveToTheNextBatch) {
+    start();
+    auto b1 = build({"Vehicle.A"});
+    auto b2 = build({"Vehicle.B"});
+    auto b3 = build({"Vehicle.B", "Vehicle.C"});
+    publish(b1);
+    recovery_->lost();
+    publish(b3);
+
+    EXPECT_EQ(recovery_->batches_rewritten(), 1u);
+    auto batch = parse(published_[1]);
+    EXPECT_EQ(batch.path_dictionary().base_version(), parse(b1).path_dictionary().version());
+    EXPECT_EQ(batch.path_dictionary().entries_size(), 2);
+    EXPECT_EQ(receive_paths(), (std::vector<std::string>{"Vehicle.A", "Vehicle.B", "Vehicle.C"}));
+}
+
+TEST_F(BatchRecoveryTest, BatchWithoutDictionaryGetsTheLostEntries) {
+    start();
+    auto b1 = build({"Vehicle.A"});
+    auto b2 = build({"Vehicle.B"});
+    auto b3 = build({"Vehicle.B", "Vehicle.A"});  // Nothing new: no dictionary
+    ASSERT_FALSE(parse(b3).has_path_dictionary());
+    publish(b1);
+    recovery_->lost();
+    publish(b3);
+
+    EXPECT_EQ(receive_paths(), (std::vector<std::string>{"Vehicle.A", "Vehicle.B", "Vehicle.A"}));
+}
+
+TEST_F(BatchRecoveryTest, SnapshotAfterLossIsLeftAlone) {
+    start();
+    auto b1 = build({"Vehicle.A"});
+    auto b2 = build({"Vehicle.B"});
+    builder_->resend_path_dictionary();
+    auto b3 = build({"Vehicle.B"});
+    ASSERT_EQ(parse(b3).path_dictionary().base_version(), 0u);
+    publish(b1);
+    recovery_->lost();
+    publish(b3);
+
+    EXPECT_EQ(published_[1], b3);
+    EXPECT_EQ(receive_paths(), (std::vector<std::string>{"Vehicle.A", "Vehicle.B"}));
+}
+
+TEST_F(BatchRecoveryTest, OversizedRewriteResendsTheDictionary) {
+    config_.max_batch_bytes = 300;
+    start();
+    auto b1 = build({"Vehicle.Cabin.Seat.Row1.DriverSide.Position",
+                     "Vehicle.Cabin.Seat.Row1.DriverSide.Height",
+                     "Vehicle.Cabin.Seat.Row1.DriverSide.Tilt"});
+    auto b2 = build({"Vehicle.Cabin.Seat.Row2.PassengerSide.Position",
+                     "Vehicle.Cabin.Seat.Row2.PassengerSide.Height",
+                     "Vehicle.Cabin.Seat.Row2.PassengerSide.Tilt"});
+    recovery_->lost();
+
+    // Both batches' entries do not fit one batch: published as it is
+    auto original = b2;
+    EXPECT_FALSE(recovery_->rewrite(b2));
+    EXPECT_EQ(b2, original);
+    recovery_->published();
+    EXPECT_EQ(recovery_->batches_rewritten(), 0u);
+
+    auto b3 = build({"Vehicle.Speed"});
+    EXPECT_EQ(parse(b3).path_dictionary().base_version(), 0u);
+    EXPECT_FALSE(recovery_->rewrite(b3));
+}
+
+TEST_F(BatchRecoveryTest, FirstSampleAfterLossIsAbsolute) {
+    config_.intern_paths = false;
+    config_.metric_series = true;
+    start();
+    auto b1 = build_counter(10);
+    auto b2 = build_counter(15);
+    auto b3 = build_counter(17);
+    auto b4 = build_counter(18);
+    ASSERT_TRUE(parse(b3).items(0).metric_sample().has_counter_delta());
+    publish(b1);
+    recovery_->lost();
+    publish(b3);
+    publish(b4);
+
+    EXPECT_EQ(recovery_->batches_rewritten(), 1u);
+    EXPECT_EQ(parse(published_[1]).items(0).metric_sample().counter(), 17.0);
+    EXPECT_TRUE(parse(published_[2]).items(0).metric_sample().has_counter_delta());
+
+    std::vector<double> values;
+    for (const auto& item : receive()) {
+        ASSERT_TRUE(item.metric);
+        values.push_back(item.metric->value);
+    }
+    EXPECT_EQ(values, (std::vector<double>{10, 17, 18}));
+}
+
+TEST_F(BatchRecoveryTest, SelfContainedBatchDecodesAlone) {
+    config_.metric_series = true;
+    start();
+    builder_->add(make_signal("Vehicle.A", 1.0));
+    auto b1 = build_counter(10);
+    builder_->add(make_signal("Vehicle.B", 2.0));
+    builder_->add(make_signal("Vehicle.A", 3.0));
+    auto b2 = build_counter(12);
+    ASSERT_TRUE(parse(b2).items(2).metric_sample().has_counter_delta());
+    publish(b1);
+
+    ASSERT_TRUE(recovery_->make_self_contained(b2));
+    recovery_->lost();
+    auto batch = parse(b2);
+    EXPECT_TRUE(batch.replayed());
+    EXPECT_EQ(batch.path_dictionary().base_version(), 0u);
+
+    PathDictionaryCache cache;
+    auto decoded = decode_transfer_batch(b2, cache);
+    ASSERT_TRUE(decoded);
+    ASSERT_EQ(decoded->items.size(), 3u);
+    EXPECT_EQ(decoded->items[0].signal->path, "Vehicle.B");
+    EXPECT_EQ(decoded->items[1].signal->path, "Vehicle.A");
+    ASSERT_TRUE(decoded->items[2].metric);
+    EXPECT_EQ(decoded->items[2].metric->value, 12.0);
+}
+
+}  // namespace vep::exporter::test
@@ -0,0 +1,230 @@
+// Copyright 2025 Vehicle Edge Platform Contributors
+// SPDX-License-Identifier: Apache-2.0
+
+#include "batch_spool.hpp"
+
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace vep::exporter::test {
+
+class BatchSpoolTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        char dir[] = "/tmp/vep_spool_XXXXXX";
+        ASSERT_NE(mkdtemp(dir), nullptr);
+        config_.enabled = true;
+        config_.directory = dir;
+        config_.segment_bytes = 4096;
+        config_.segments = 4;
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(config_.directory);
+    }
+
+    // Batch of size bytes tagged with its number
+    static std::vector<uint8_t> make_batch(uint32_t number, size_t size = 100) {
+        std::vector<uint8_t> batch(size, static_cast<uint8_t>(number));
+        batch[0] = static_cast<uint8_t>(number >> 8);
+        return batch;
+    }
+
+    static void append(BatchSpool& spool, const std::vector<uint8_t>& batch) {
+        ASSERT_TRUE(spool.append(batch.data(), batch.size()));
+    }
+
+    /// Replay everything: batch numbers, oldest first
+    static std::vector<uint32_t> drain(BatchSpool& spool) {
+        std::vector<uint32_t> numbers;
+        std::vector<uint8_t> batch;
+        BatchSpool::Position at;
+        while (spool.peek(batch, at)) {
+            numbers.push_back(static_cast<uint32_t>(batch[0]) << 8 | batch[1]);
+            spool.pop(at);
+        }
+        return numbers;
+    }
+
+    SpoolConfig config_;
+};
+
+TEST_F(BatchSpoolTest, ReplaysOldestFirst) {
+    auto spool = BatchSpool::open(config_);
+    ASSERT_NE(spool, nullptr);
+    EXPECT_TRUE(spool->empty());
+
+    for (uint32_t i = 0; i < 5; ++i) {
+        append(*spool, make_batch(i));
+    }
+    EXPECT_FALSE(spool->empty());
+    EXPECT_EQ(spool->stats().batches_pending, 5u);
+
+    std::vector<uint8_t> batch;
+    BatchSpool::Position at;
+    ASSERT_TRUE(spool->peek(batch, at));
+    EXPECT_EQ(batch, make_batch(0));
+    ASSERT_TRUE(spool->peek(batch, at));  // Peek does not consume
+    EXPECT_EQ(batch, make_batch(0));
+
+    EXPECT_EQ(drain(*spool), (std::vector<uint32_t>{0, 1, 2, 3, 4}));
+    EXPECT_TRUE(spool->empty());
+    EXPECT_EQ(spool->stats().batches_replayed, 5u);
+    EXPECT_FALSE(spool->peek(batch, at));
+}
+
+TEST_F(BatchSpoolTest, SpansSegments) {
+    auto spool = BatchSpool::open(config_);
+    ASSERT_NE(spool, nullptr);
+
+    // ~3 segments of 1000-byte batches
+    std::vector<uint32_t> expected;
+    for (uint32_t i = 0; i < 10; ++i) {
+        append(*spool, make_batch(i, 1000));
+        expected.push_back(i);
+    }
+    EXPECT_EQ(drain(*spool), expected);
+    EXPECT_EQ(spool->stats().batches_dropped, 0u);
+}
+
+TEST_F(BatchSpoolTest, FullRingDropsOldestSegment) {
+    auto spool = BatchSpool::open(config_);
+    ASSERT_NE(spool, nullptr);
+
+    // 3 batches per 4 KB segment, 4 segments: room for 12
+    for (uint32_t i = 0; i < 15; ++i) {
+        append(*spool, make_batch(i, 1200));
+    }
+    auto stats = spool->stats();
+    EXPECT_EQ(stats.batches_dropped, 3u);
+    EXPECT_EQ(stats.batches_pending, 12u);
+
+    auto numbers = drain(*spool);
+    ASSERT_EQ(numbers.size(), 12u);
+    EXPECT_EQ(numbers.front(), 3u);
+    EXPECT_EQ(numbers.back(), 14u);
+}
+
+TEST_F(BatchSpoolTest, PopAfterOverwriteKeepsNewerBatches) {
+    auto spool = BatchSpool::open(config_);
+    ASSERT_NE(spool, nullptr);
+    for (uint32_t i = 0; i < 12; ++i) {
+        append(*spool, make_batch(i, 1200));
+    }
+    std::vector<uint8_t> batch;
+    BatchSpool::Position at;
+    ASSERT_TRUE(spool->peek(batch, at));
+    spool->pop(at);
+    spool->pop(at);  // Removed already: batch 1 stays
+    ASSERT_TRUE(spool->peek(batch, at));
+    EXPECT_EQ(batch, make_batch(1, 1200));
+
+    // The ring wraps while batch 1 is being replayed: its segment is gone
+    append(*spool, make_batch(12, 1200));
+    spool->pop(at);
+
+    auto numbers = drain(*spool);
+    ASSERT_EQ(numbers.size(), 10u);
+    EXPECT_EQ(numbers.front(), 3u);
+    EXPECT_EQ(spool->stats().batches_replayed, 11u);
+}
+
+TEST_F(BatchSpoolTest, RejectsBatchLargerThanSegment) {
+    auto spool = BatchSpool::open(config_);
+    ASSERT_NE(spool, nullptr);
+    auto batch = make_batch(0, config_.segment_bytes);
+    EXPECT_FALSE(spool->append(batch.data(), batch.size()));
+    EXPECT_TRUE(spool->empty());
+}
+
+TEST_F(BatchSpoolTest, SegmentBytesForHoldsTheBatch) {
+    config_.segment_bytes = BatchSpool::segment_bytes_for(10000);
+    auto spool = BatchSpool::open(config_);
+    ASSERT_NE(spool, nullptr);
+    auto batch = make_batch(0, 10000);
+    EXPECT_TRUE(spool->append(batch.data(), batch.size()));
+    batch = make_batch(1, 10001);
+    EXPECT_FALSE(spool->append(batch.data(), batch.size()));
+}
+
+TEST_F(BatchSpoolTest, SurvivesRestart) {
+    {
+        auto spool = BatchSpool::open(config_);
+        ASSERT_NE(spool, nullptr);
+        for (uint32_t i = 0; i < 8; ++i) {
+            append(*spool, make_batch(i, 1000));
+        }
+        // Replayed before the restart: not replayed again
+        std::vector<uint8_t> batch;
+        BatchSpool::Position at;
+        ASSERT_TRUE(spool->peek(batch, at));
+        spool->pop(at);
+        ASSERT_TRUE(spool->peek(batch, at));
+        spool->pop(at);
+    }
+
+    auto spool = BatchSpool::open(config_);
+    ASSERT_NE(spool, nullptr);
+    EXPECT_EQ(spool->stats().batches_recovered, 6u);
+
+    // New batches go after the recovered ones
+    append(*spool, make_batch(100, 1000));
+    EXPECT_EQ(drain(*spool), (std::vector<uint32_t>{2, 3, 4, 5, 6, 7, 100}));
+}
+
+TEST_F(BatchSpoolTest, RecoveryStopsAtTornRecord) {
+    {
+        auto spool = BatchSpool::open(config_);
+        ASSERT_NE(spool, nullptr);
+        for (uint32_t i = 0; i < 3; ++i) {
+            append(*spool, make_batch(i, 500));
+        }
+    }
+
+    // Corrupt the payload of the second record (as a torn write would)
+    auto path = std::filesystem::path(config_.directory) / "segment-0.spool";
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(64 + 16 + 512 + 16 + 10);
+        file.put('\x7f');
+    }
+
+    auto spool = BatchSpool::open(config_);
+    ASSERT_NE(spool, nullptr);
+    EXPECT_EQ(spool->stats().batches_recovered, 1u);
+
+    // Appends continue in a fresh segment, the valid third record is not
+    // resurrected
+    append(*spool, make_batch(50, 500));
+    EXPECT_EQ(drain(*spool), (std::vector<uint32_t>{0, 50}));
+
+    spool.reset();
+    spool = BatchSpool::open(config_);
+    ASSERT_NE(spool, nullptr);
+    EXPECT_TRUE(spool->empty());
+}
+
+TEST_F(BatchSpoolTest, SegmentSizeChangeDiscardsOldFiles) {
+    {
+        auto spool = BatchSpool::open(config_);
+        ASSERT_NE(spool, nullptr);
+        append(*spool, make_batch(1));
+    }
+    config_.segment_bytes = 8192;
+    auto spool = BatchSpool::open(config_);
+    ASSERT_NE(spool, nullptr);
+    EXPECT_TRUE(spool->empty());
+    append(*spool, make_batch(2, 6000));
+    EXPECT_EQ(drain(*spool), (std::vector<uint32_t>{2}));
+}
+
+TEST_F(BatchSpoolTest, OpenFailsOnUnusableDirectory) {
+    config_.directory = "/proc/vep_spool_not_allowed";
+    EXPECT_EQ(BatchSpool::open(config_), nullptr);
+}
+
+}  // namespace vep::exporter::test
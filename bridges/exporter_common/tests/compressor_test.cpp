@@ -4,8 +4,14 @@
 #include "compressor.hpp"
 
 #include <gtest/gtest.h>
+#include <lz4frame.h>
+#include <zstd.h>
 #include <algorithm>
+#include <cstdio>
+#include <fstream>
 #include <random>
+#include <string>
+#include <unistd.h>
 
 namespace vep::exporter::test {
 
@@ -31,6 +37,26 @@ protected:
         }
         return data;
     }
+
+    // Generate small telemetry-like batches: shared names, varying values
+    std::vector<std::vector<uint8_t>> generate_batch_samples(size_t count) {
+        static const char* names[] = {
+            "Vehicle.Speed", "Vehicle.Powertrain.TractionBattery.StateOfCharge.Current",
+            "Vehicle.Chassis.Axle.Row1.Wheel.Left.Tire.Pressure", "cpu_usage",
+            "Vehicle.Cabin.HVAC.AmbientAirTemperature", "memory_used_bytes"};
+        std::mt19937 gen(42);
+        std::uniform_int_distribution<> value(0, 100000);
+        std::uniform_int_distribution<> pick(0, 5);
+        std::vector<std::vector<uint8_t>> samples;
+        for (size_t i = 0; i < count; ++i) {
+            std::string batch = "vep_exporter|seq=" + std::to_string(i);
+            for (int item = 0; item < 12; ++item) {
+                batch += std::string("|") + names[pick(gen)] + "=" + std::to_string(value(gen));
+            }
+            samples.emplace_back(batch.begin(), batch.end());
+        }
+        return samples;
+    }
 };
 
 // =============================================================================
@@ -40,11 +66,15 @@ protected:
 TEST_F(CompressorTest, ToString) {
     EXPECT_STREQ(to_string(CompressorType::ZSTD), "zstd");
     EXPECT_STREQ(to_string(CompressorType::NONE), "none");
+    EXPECT_STREQ(to_string(CompressorType::LZ4), "lz4");
+    EXPECT_STREQ(to_string(CompressorType::AUTO), "auto");
 }
 
 TEST_F(CompressorTest, FromString_Valid) {
     EXPECT_EQ(compressor_type_from_string("zstd"), CompressorType::ZSTD);
     EXPECT_EQ(compressor_type_from_string("none"), CompressorType::NONE);
+    EXPECT_EQ(compressor_type_from_string("lz4"), CompressorType::LZ4);
+    EXPECT_EQ(compressor_type_from_string("AUTO"), CompressorType::AUTO);
 }
 
 TEST_F(CompressorTest, FromString_CaseInsensitive) {
@@ -191,6 +221,31 @@ TEST_F(CompressorTest, NoCompressor_Stats) {
     EXPECT_EQ(stats.operations, 1);
 }
 
+// =============================================================================
+// Output Bound Tests
+// =============================================================================
+
+TEST_F(CompressorTest, ZstdCompressor_MaxInputSizeFitsWorstCase) {
+    ZstdCompressor compressor;
+    ASSERT_TRUE(compressor.init());
+
+    for (size_t limit : {size_t{256}, size_t{4096}, size_t{64 * 1024}, size_t{1024 * 1024}}) {
+        size_t input = compressor.max_input_size(limit);
+        EXPECT_LE(compressor.max_compressed_size(input), limit);
+        EXPECT_GT(compressor.max_compressed_size(input + 1), limit);
+
+        // Incompressible data grows, but stays within the limit
+        auto compressed = compressor.compress(generate_random_data(input));
+        EXPECT_LE(compressed.size(), limit);
+    }
+}
+
+TEST_F(CompressorTest, NoCompressor_MaxInputSizeIsLimit) {
+    NoCompressor compressor;
+    EXPECT_EQ(compressor.max_compressed_size(1000), 1000);
+    EXPECT_EQ(compressor.max_input_size(64 * 1024), 64 * 1024);
+}
+
 // =============================================================================
 // Factory Function Tests
 // =============================================================================
@@ -366,4 +421,349 @@ TEST_F(CompressorTest, DecompressionStats_RatioZeroInput) {
     EXPECT_DOUBLE_EQ(stats.ratio(), 0.0);
 }
 
+// =============================================================================
+// Buffer Reuse Tests
+// =============================================================================
+
+TEST_F(CompressorTest, ZstdCompressor_CompressIntoReusesBuffer) {
+    ZstdCompressor compressor(3);
+    ASSERT_TRUE(compressor.init());
+    auto data = generate_compressible_data(10000);
+
+    std::vector<uint8_t> out;
+    compressor.compress_into(data, out);
+    EXPECT_EQ(out, compressor.compress(data));
+
+    const uint8_t* storage = out.data();
+    compressor.compress_into(data, out);
+    EXPECT_EQ(out.data(), storage);  // No new allocation
+    EXPECT_FALSE(compressor.passthrough());
+}
+
+TEST_F(CompressorTest, NoCompressor_IsPassthrough) {
+    NoCompressor compressor;
+    auto data = generate_random_data(100);
+    std::vector<uint8_t> out;
+    compressor.compress_into(data, out);
+
+    EXPECT_TRUE(compressor.passthrough());
+    EXPECT_EQ(out, data);
+    EXPECT_EQ(compressor.stats().operations, 1u);
+}
+
+// =============================================================================
+// ZSTD Dictionary Tests
+// =============================================================================
+
+TEST_F(CompressorTest, ZstdDictionary_TrainHasId) {
+    auto dictionary = train_zstd_dictionary(generate_batch_samples(500), 4096);
+    ASSERT_TRUE(dictionary.has_value());
+    EXPECT_LE(dictionary->size(), 4096u);
+    EXPECT_NE(zstd_dictionary_id(*dictionary), 0u);
+}
+
+TEST_F(CompressorTest, ZstdDictionary_TrainTooFewSamplesFails) {
+    EXPECT_FALSE(train_zstd_dictionary(generate_batch_samples(2), 4096).has_value());
+}
+
+TEST_F(CompressorTest, ZstdDictionary_RoundTripTagsFrame) {
+    auto samples = generate_batch_samples(500);
+    auto dictionary = train_zstd_dictionary(samples, 4096);
+    ASSERT_TRUE(dictionary.has_value());
+
+    auto compressor = create_compressor(CompressorType::ZSTD, 3, *dictionary);
+    ASSERT_NE(compressor, nullptr);
+    auto* zstd = static_cast<ZstdCompressor*>(compressor.get());
+    EXPECT_EQ(zstd->dictionary_id(), zstd_dictionary_id(*dictionary));
+
+    auto decompressor = create_decompressor(CompressorType::ZSTD, *dictionary);
+    ASSERT_NE(decompressor, nullptr);
+
+    auto compressed = compressor->compress(samples[7]);
+    EXPECT_EQ(decompressor->decompress(compressed), samples[7]);
+}
+
+TEST_F(CompressorTest, ZstdDictionary_ImprovesSmallBatchRatio) {
+    auto samples = generate_batch_samples(600);
+    std::vector<std::vector<uint8_t>> training(samples.begin(), samples.begin() + 500);
+    auto dictionary = train_zstd_dictionary(training, 8192);
+    ASSERT_TRUE(dictionary.has_value());
+
+    auto plain = create_compressor(CompressorType::ZSTD, 3);
+    auto with_dict = create_compressor(CompressorType::ZSTD, 3, *dictionary);
+    size_t plain_bytes = 0;
+    size_t dict_bytes = 0;
+    for (size_t i = 500; i < samples.size(); ++i) {  // Not seen in training
+        plain_bytes += plain->compress(samples[i]).size();
+        dict_bytes += with_dict->compress(samples[i]).size();
+    }
+    EXPECT_LT(dict_bytes, plain_bytes * 3 / 4);
+}
+
+TEST_F(CompressorTest, ZstdDictionary_UnknownIdFails) {
+    auto dictionary = train_zstd_dictionary(generate_batch_samples(500), 4096);
+    ASSERT_TRUE(dictionary.has_value());
+    auto compressor = create_compressor(CompressorType::ZSTD, 3, *dictionary);
+    auto compressed = compressor->compress(generate_batch_samples(1)[0]);
+
+    ZstdDecompressor decompressor;
+    ASSERT_TRUE(decompressor.init());
+    EXPECT_TRUE(decompressor.decompress(compressed).empty());
+    EXPECT_EQ(decompressor.stats().errors, 1u);
+
+    // Plain frames still decompress with dictionaries registered
+    ASSERT_TRUE(decompressor.add_dictionary(*dictionary));
+    auto plain = create_compressor(CompressorType::ZSTD, 3)->compress(generate_compressible_data(100));
+    EXPECT_EQ(decompressor.decompress(plain), generate_compressible_data(100));
+}
+
+TEST_F(CompressorTest, ZstdDictionary_CloneSharesDictionary) {
+    auto samples = generate_batch_samples(500);
+    auto dictionary = train_zstd_dictionary(samples, 4096);
+    ASSERT_TRUE(dictionary.has_value());
+    auto compressor = create_compressor(CompressorType::ZSTD, 3, *dictionary);
+    auto clone = compressor->clone();
+    ASSERT_NE(clone, nullptr);
+
+    EXPECT_EQ(clone->compress(samples[3]), compressor->compress(samples[3]));
+}
+
+TEST_F(CompressorTest, ZstdDictionary_LoadFile) {
+    auto dictionary = train_zstd_dictionary(generate_batch_samples(500), 4096);
+    ASSERT_TRUE(dictionary.has_value());
+
+    char path[] = "/tmp/zstd_dict_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    close(fd);
+    {
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(dictionary->data()),
+                   static_cast<std::streamsize>(dictionary->size()));
+    }
+    auto loaded = load_zstd_dictionary(path);
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(*loaded, *dictionary);
+
+    // Raw content without a dictionary header is rejected
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << "Vehicle.Speed Vehicle.Speed Vehicle.Speed";
+    }
+    EXPECT_FALSE(load_zstd_dictionary(path).has_value());
+    EXPECT_FALSE(load_zstd_dictionary("/nonexistent/dict.zdict").has_value());
+    std::remove(path);
+}
+
+// =============================================================================
+// LZ4, Fast Zstd and AUTO Tests
+// =============================================================================
+
+TEST_F(CompressorTest, Lz4_RoundTrip) {
+    auto compressor = create_compressor(CompressorType::LZ4, 0);
+    auto decompressor = create_decompressor(CompressorType::LZ4);
+    ASSERT_NE(compressor, nullptr);
+    ASSERT_NE(decompressor, nullptr);
+
+    auto data = generate_compressible_data(100000);
+    auto compressed = compressor->compress(data);
+    EXPECT_LT(compressed.size(), data.size() / 10);
+    EXPECT_LE(compressed.size(), compressor->max_compressed_size(data.size()));
+    EXPECT_EQ(decompressor->decompress(compressed), data);
+
+    // Incompressible input stays within the bound
+    auto random = generate_random_data(70000);
+    compressed = compressor->compress(random);
+    EXPECT_LE(compressed.size(), compressor->max_compressed_size(random.size()));
+    EXPECT_EQ(decompressor->decompress(compressed), random);
+    EXPECT_EQ(decompressor->stats().errors, 0u);
+}
+
+TEST_F(CompressorTest, Lz4_InvalidAndTruncatedData) {
+    auto decompressor = create_decompressor(CompressorType::LZ4);
+    EXPECT_TRUE(decompressor->decompress({1, 2, 3, 4, 5}).empty());
+
+    auto compressed = create_compressor(CompressorType::LZ4, 0)->compress(generate_random_data(5000));
+    compressed.resize(compressed.size() / 2);
+    EXPECT_TRUE(decompressor->decompress(compressed).empty());
+    EXPECT_EQ(decompressor->stats().errors, 2u);
+
+    // Context is usable again after errors
+    auto data = generate_compressible_data(1000);
+    EXPECT_EQ(decompressor->decompress(create_compressor(CompressorType::LZ4, 0)->compress(data)),
+              data);
+}
+
+TEST_F(CompressorTest, Lz4_OutputOverLimitIsRejected) {
+    auto decompressor = create_decompressor(CompressorType::LZ4, {}, 64 * 1024);
+    ASSERT_NE(decompressor, nullptr);
+    auto data = generate_compressible_data(1024 * 1024);
+
+    // Content size in the header over the limit: not allocated
+    auto compressed = create_compressor(CompressorType::LZ4, 0)->compress(data);
+    EXPECT_TRUE(decompressor->decompress(compressed).empty());
+
+    // No content size: output grows up to the limit, then fails
+    LZ4F_preferences_t prefs{};
+    std::vector<uint8_t> frame(LZ4F_compressFrameBound(data.size(), &prefs));
+    size_t size = LZ4F_compressFrame(frame.data(), frame.size(), data.data(), data.size(), &prefs);
+    ASSERT_FALSE(LZ4F_isError(size));
+    frame.resize(size);
+    EXPECT_TRUE(decompressor->decompress(frame).empty());
+    EXPECT_EQ(decompressor->stats().errors, 2u);
+
+    // Within the limit
+    auto small = generate_compressible_data(60 * 1024);
+    EXPECT_EQ(decompressor->decompress(create_compressor(CompressorType::LZ4, 0)->compress(small)),
+              small);
+}
+
+TEST_F(CompressorTest, ZstdDecompressor_OutputOverLimitIsRejected) {
+    auto decompressor = create_decompressor(CompressorType::ZSTD, {}, 64 * 1024);
+    ASSERT_NE(decompressor, nullptr);
+    auto data = generate_compressible_data(1024 * 1024);
+
+    auto compressed = create_compressor(CompressorType::ZSTD, 3)->compress(data);
+    EXPECT_TRUE(decompressor->decompress(compressed).empty());
+
+    // No content size: the estimate is capped, the frame does not fit
+    ZSTD_CCtx* ctx = ZSTD_createCCtx();
+    ZSTD_CCtx_setParameter(ctx, ZSTD_c_contentSizeFlag, 0);
+    std::vector<uint8_t> frame(ZSTD_compressBound(data.size()));
+    size_t size = ZSTD_compress2(ctx, frame.data(), frame.size(), data.data(), data.size());
+    ZSTD_freeCCtx(ctx);
+    ASSERT_FALSE(ZSTD_isError(size));
+    frame.resize(size);
+    EXPECT_TRUE(decompressor->decompress(frame).empty());
+    EXPECT_EQ(decompressor->stats().errors, 2u);
+
+    // AUTO applies the limit to every codec
+    auto automatic = create_decompressor(CompressorType::AUTO, {}, 64 * 1024);
+    EXPECT_TRUE(automatic->decompress(compressed).empty());
+    EXPECT_TRUE(automatic->decompress(
+        create_compressor(CompressorType::LZ4, 0)->compress(data)).empty());
+    EXPECT_EQ(automatic->stats().errors, 2u);
+    EXPECT_EQ(create_decompressor(CompressorType::AUTO)->decompress(compressed), data);
+}
+
+TEST_F(CompressorTest, ZstdCompressor_NegativeLevelRoundTrip) {
+    auto samples = generate_batch_samples(50);
+    std::vector<uint8_t> data;
+    for (const auto& sample : samples) {
+        data.insert(data.end(), sample.begin(), sample.end());
+    }
+    auto fast = create_compressor(CompressorType::ZSTD, -5);
+    ASSERT_NE(fast, nullptr);
+    auto compressed = fast->compress(data);
+    EXPECT_LT(compressed.size(), data.size());
+    EXPECT_EQ(create_decompressor(CompressorType::ZSTD)->decompress(compressed), data);
+}
+
+TEST_F(CompressorTest, DetectCompressorType_FromFrameMagic) {
+    auto data = generate_compressible_data(1000);
+    auto zstd = create_compressor(CompressorType::ZSTD, 3)->compress(data);
+    auto lz4 = create_compressor(CompressorType::LZ4, 0)->compress(data);
+    EXPECT_EQ(detect_compressor_type(zstd.data(), zstd.size()), CompressorType::ZSTD);
+    EXPECT_EQ(detect_compressor_type(lz4.data(), lz4.size()), CompressorType::LZ4);
+    EXPECT_EQ(detect_compressor_type(data.data(), data.size()), CompressorType::NONE);
+    EXPECT_EQ(detect_compressor_type(lz4.data(), 3), CompressorType::NONE);
+}
+
+TEST_F(CompressorTest, AutoDecompressor_DecodesAnyCodec) {
+    auto dictionary = train_zstd_dictionary(generate_batch_samples(500), 4096);
+    ASSERT_TRUE(dictionary.has_value());
+    auto decompressor = create_decompressor(CompressorType::AUTO, *dictionary);
+    ASSERT_NE(decompressor, nullptr);
+
+    auto data = generate_batch_samples(1)[0];
+    EXPECT_EQ(decompressor->decompress(create_compressor(CompressorType::ZSTD, 3)->compress(data)), data);
+    EXPECT_EQ(decompressor->decompress(create_compressor(CompressorType::ZSTD, 3, *dictionary)->compress(data)),
+              data);
+    EXPECT_EQ(decompressor->decompress(create_compressor(CompressorType::LZ4, 0)->compress(data)), data);
+    EXPECT_EQ(decompressor->decompress(data), data);  // Uncompressed
+    EXPECT_EQ(decompressor->stats().operations, 4u);
+    EXPECT_EQ(decompressor->stats().errors, 0u);
+}
+
+TEST_F(CompressorTest, AutoCompressor_StartsAtMaxLevel) {
+    AutoCompressionConfig config;
+    config.max_ns_per_byte = 1e9;  // Unlimited
+    config.max_level = 5;
+    AutoCompressor compressor(config);
+    ASSERT_TRUE(compressor.init());
+    EXPECT_EQ(compressor.current_type(), CompressorType::ZSTD);
+    EXPECT_EQ(compressor.current_level(), 5);
+
+    auto data = generate_compressible_data(50000);
+    for (int i = 0; i < 10; ++i) {
+        compressor.compress(data);
+    }
+    EXPECT_EQ(compressor.current_type(), CompressorType::ZSTD);
+    EXPECT_EQ(compressor.current_level(), 5);
+    EXPECT_STREQ(compressor.name(), "auto");
+}
+
+TEST_F(CompressorTest, AutoCompressor_OverBudgetStepsDownToLz4) {
+    AutoCompressionConfig config;
+    config.max_ns_per_byte = 0.0;  // Nothing fits: fastest codec
+    auto compressor = create_auto_compressor(config);
+    ASSERT_NE(compressor, nullptr);
+    auto decompressor = create_decompressor(CompressorType::AUTO);
+
+    std::vector<CompressorType> codecs;
+    auto data = generate_compressible_data(50000);
+    for (int i = 0; i < 10; ++i) {
+        auto compressed = compressor->compress(data);
+        EXPECT_LE(compressed.size(), compressor->max_compressed_size(data.size()));
+        codecs.push_back(detect_compressor_type(compressed.data(), compressed.size()));
+        EXPECT_EQ(decompressor->decompress(compressed), data);
+    }
+    auto& automatic = static_cast<AutoCompressor&>(*compressor);
+    EXPECT_EQ(automatic.current_type(), CompressorType::LZ4);
+    EXPECT_EQ(codecs.front(), CompressorType::ZSTD);
+    EXPECT_EQ(codecs.back(), CompressorType::LZ4);
+    EXPECT_EQ(decompressor->stats().errors, 0u);
+}
+
+TEST_F(CompressorTest, AutoCompressor_ProbesStrongerLevelWhenBudgetAllows) {
+    AutoCompressionConfig config;
+    config.max_ns_per_byte = 0.0;
+    config.probe_interval = 2;
+    AutoCompressor compressor(config);
+    ASSERT_TRUE(compressor.init());
+
+    std::vector<uint8_t> data;
+    for (const auto& sample : generate_batch_samples(200)) {
+        data.insert(data.end(), sample.begin(), sample.end());
+    }
+    for (int i = 0; i < 10; ++i) {
+        compressor.compress(data);
+    }
+    ASSERT_EQ(compressor.current_type(), CompressorType::LZ4);
+
+    // Budget raised: probes zstd, which shrinks text well beyond lz4
+    compressor.set_max_ns_per_byte(1e9);
+    for (int i = 0; i < 10; ++i) {
+        compressor.compress(data);
+    }
+    EXPECT_EQ(compressor.current_type(), CompressorType::ZSTD);
+
+    // Clones continue from the current level
+    auto clone = compressor.clone();
+    ASSERT_NE(clone, nullptr);
+    auto& cloned = static_cast<AutoCompressor&>(*clone);
+    EXPECT_EQ(cloned.current_type(), CompressorType::ZSTD);
+    EXPECT_EQ(cloned.current_level(), compressor.current_level());
+}
+
+TEST_F(CompressorTest, AutoCompressor_MaxCompressedSizeCoversAllCodecs) {
+    auto compressor = create_compressor(CompressorType::AUTO, 3);
+    auto lz4 = create_compressor(CompressorType::LZ4, 0);
+    auto zstd = create_compressor(CompressorType::ZSTD, 3);
+    for (size_t size : {0u, 100u, 65536u, 1000000u}) {
+        EXPECT_GE(compressor->max_compressed_size(size), lz4->max_compressed_size(size));
+        EXPECT_GE(compressor->max_compressed_size(size), zstd->max_compressed_size(size));
+    }
+}
+
 }  // namespace vep::exporter::test
@@ -0,0 +1,143 @@
+// Copyright 2025 Vehicle Edge Platform Contributors
+// SPDX-License-Identifier: Apache-2.0
+
+#include "dds_reactor.hpp"
+#include "common/qos_profiles.hpp"
+#include "events.h"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace bridge::test {
+
+namespace {
+
+/// Poll until condition holds or timeout
+template<typename Condition>
+bool wait_until(Condition condition,
+                std::chrono::milliseconds timeout = std::chrono::milliseconds(2000)) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+vep_Event make_event() {
+    vep_Event event = {};
+    event.header.source_id = const_cast<char*>("test");
+    event.header.timestamp_ns = 1000000000;
+    event.header.correlation_id = const_cast<char*>("");
+    event.event_id = const_cast<char*>("evt-1");
+    event.category = const_cast<char*>("ADAS");
+    event.event_type = const_cast<char*>("harsh_brake");
+    event.severity = vep_SEVERITY_WARNING;
+    return event;
+}
+
+}  // namespace
+
+// =============================================================================
+// DdsReactor Tests
+// =============================================================================
+
+/// Writer and reader of one topic, unique per test, in one participant
+class DdsReactorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        auto qos = dds::qos_profiles::reliable_standard(100);
+        std::string name = std::string("test/dds_reactor/") +
+            ::testing::UnitTest::GetInstance()->current_test_info()->name();
+        topic_ = std::make_unique<dds::Topic>(participant_, &vep_Event_desc, name, qos.get());
+        reader_ = std::make_unique<dds::Reader>(participant_, *topic_, qos.get());
+        writer_ = std::make_unique<dds::Writer>(participant_, *topic_, qos.get());
+    }
+
+    void write(int count = 1) {
+        for (int i = 0; i < count; ++i) {
+            writer_->write(make_event());
+        }
+    }
+
+    dds::Participant participant_;
+    std::unique_ptr<dds::Topic> topic_;
+    std::unique_ptr<dds::Reader> reader_;
+    std::unique_ptr<dds::Writer> writer_;
+};
+
+TEST_F(DdsReactorTest, StopWakesIdleReactor) {
+    DdsReactor reactor("test");
+    ASSERT_TRUE(reactor.add_reader<vep_Event>("events", *reader_, [](const vep_Event&) {}));
+    ASSERT_TRUE(reactor.start());
+    EXPECT_TRUE(reactor.running());
+
+    // Nothing to read: the thread is blocked in the waitset until the
+    // guard condition fires
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    auto start = std::chrono::steady_clock::now();
+    reactor.stop();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(500));
+    EXPECT_FALSE(reactor.running());
+
+    // Stopping twice is harmless
+    reactor.stop();
+}
+
+TEST_F(DdsReactorTest, RestartDispatchesSamplesQueuedWhileStopped) {
+    DdsReactor reactor("test");
+    std::atomic<int> received{0};
+    ASSERT_TRUE(reactor.add_reader<vep_Event>("events", *reader_,
+                                              [&received](const vep_Event&) { received++; }));
+    ASSERT_TRUE(reactor.start());
+    write();
+    ASSERT_TRUE(wait_until([&] { return received == 1; }));
+
+    reactor.stop();
+    write(2);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(received.load(), 1);
+
+    // The guard condition is reset: the thread waits for samples again
+    ASSERT_TRUE(reactor.start());
+    ASSERT_TRUE(wait_until([&] { return received == 3; }));
+    write();
+    ASSERT_TRUE(wait_until([&] { return received == 4; }));
+    reactor.stop();
+}
+
+TEST_F(DdsReactorTest, AddReaderWhileRunningFails) {
+    DdsReactor reactor("test");
+    ASSERT_TRUE(reactor.start());
+    EXPECT_FALSE(reactor.add_reader<vep_Event>("events", *reader_, [](const vep_Event&) {}));
+    EXPECT_EQ(reactor.readers(), 0u);
+    reactor.stop();
+}
+
+TEST_F(DdsReactorTest, BatchReaderDeliversEverySampleOnce) {
+    DdsReactor reactor("test");
+    std::atomic<size_t> received{0};
+    ASSERT_TRUE(reactor.add_batch_reader<vep_Event>(
+        "events", *reader_, [&received](const vep_Event* events, size_t count) {
+            for (size_t i = 0; i < count; ++i) {
+                EXPECT_EQ(events[i].severity, vep_SEVERITY_WARNING);
+            }
+            received += count;
+        }, 10));
+    ASSERT_TRUE(reactor.start());
+
+    // More than one take's worth: the condition stays triggered
+    write(25);
+    ASSERT_TRUE(wait_until([&] { return received == 25; }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(received.load(), 25u);
+    reactor.stop();
+}
+
+}  // namespace bridge::test
@@ -0,0 +1,563 @@
+// Copyright 2025 Vehicle Edge Platform Contributors
+// SPDX-License-Identifier: Apache-2.0
+
+#include "export_policy.hpp"
+#include "unified_pipeline.hpp"
+#include "transfer.pb.h"
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace vep::exporter::test {
+
+namespace {
+
+vep_VssSignal make_signal(const char* path, double value, int64_t timestamp_ms,
+                          vep_VssQuality quality = vep_VSS_QUALITY_VALID) {
+    vep_VssSignal signal = {};
+    signal.path = const_cast<char*>(path);
+    signal.header.source_id = const_cast<char*>("test");
+    signal.header.timestamp_ns = timestamp_ms * 1000000;
+    signal.header.correlation_id = const_cast<char*>("");
+    signal.quality = quality;
+    signal.value.type = vep_VSS_VALUE_TYPE_DOUBLE;
+    signal.value.double_value = value;
+    return signal;
+}
+
+ExportRule make_rule(const std::string& match, PolicyAction action) {
+    ExportRule rule;
+    rule.match = match;
+    rule.action = action;
+    return rule;
+}
+
+/// Aggregate gauge as seen by the sink
+struct EmittedGauge {
+    std::string name;
+    std::string aggregation;
+    std::string window_ms;
+    double value;
+    int64_t timestamp_ms;
+};
+
+class GaugeCollector {
+public:
+    ExportPolicy::AggregateSink sink() {
+        return [this](const vep_OtelGauge& gauge) {
+            EmittedGauge out{gauge.name, "", "", gauge.value,
+                             gauge.header.timestamp_ns / 1000000};
+            for (uint32_t i = 0; i < gauge.labels._length; ++i) {
+                std::string key = gauge.labels._buffer[i].key;
+                if (key == "aggregation") out.aggregation = gauge.labels._buffer[i].value;
+                if (key == "window_ms") out.window_ms = gauge.labels._buffer[i].value;
+            }
+            gauges.push_back(out);
+        };
+    }
+
+    /// Values of the last emitted window by statistic
+    std::map<std::string, double> by_stat() const {
+        std::map<std::string, double> out;
+        for (const auto& g : gauges) {
+            out[g.aggregation] = g.value;
+        }
+        return out;
+    }
+
+    std::vector<EmittedGauge> gauges;
+};
+
+/// Temporary YAML file removed on destruction
+class TempYaml {
+public:
+    explicit TempYaml(const std::string& content) {
+        char name[] = "/tmp/export_policy_test_XXXXXX";
+        int fd = mkstemp(name);
+        close(fd);
+        path_ = name;
+        std::ofstream(path_) << content;
+    }
+    ~TempYaml() { std::remove(path_.c_str()); }
+
+    const std::string& path() const { return path_; }
+
+private:
+    std::string path_;
+};
+
+}  // namespace
+
+// =============================================================================
+// Rule matching
+// =============================================================================
+
+TEST(ExportPolicyMatchTest, ExactWildcardAndRestGlobs) {
+    ExportPolicyConfig config;
+    config.rules.push_back(make_rule("Vehicle.Speed", PolicyAction::Drop));
+    config.rules.push_back(make_rule("Vehicle.Chassis.Axle.*.Wheel.*.Speed", PolicyAction::Downsample));
+    config.rules.push_back(make_rule("Vehicle.Powertrain.**", PolicyAction::Deadband));
+
+    ExportPolicy policy(config, nullptr);
+
+    ASSERT_NE(policy.match("Vehicle.Speed"), nullptr);
+    EXPECT_EQ(policy.match("Vehicle.Speed")->match, "Vehicle.Speed");
+    EXPECT_EQ(policy.match("Vehicle.SpeedLimit"), nullptr);
+    EXPECT_EQ(policy.match("Vehicle"), nullptr);
+
+    ASSERT_NE(policy.match("Vehicle.Chassis.Axle.Row1.Wheel.Left.Speed"), nullptr);
+    EXPECT_EQ(policy.match("Vehicle.Chassis.Axle.Row1.Wheel.Left.Speed")->action,
+              PolicyAction::Downsample);
+    EXPECT_EQ(policy.match("Vehicle.Chassis.Axle.Row1.Wheel.Speed"), nullptr);
+
+    ASSERT_NE(policy.match("Vehicle.Powertrain.TractionBattery.StateOfCharge.Current"), nullptr);
+    EXPECT_EQ(policy.match("Vehicle.Powertrain.TractionBattery.StateOfCharge.Current")->action,
+              PolicyAction::Deadband);
+    EXPECT_NE(policy.match("Vehicle.Powertrain"), nullptr);
+}
+
+TEST(ExportPolicyMatchTest, MostSpecificRuleWins) {
+    ExportPolicyConfig config;
+    config.rules.push_back(make_rule("Vehicle.**", PolicyAction::Drop));
+    config.rules.push_back(make_rule("Vehicle.*.Temperature", PolicyAction::Deadband));
+    config.rules.push_back(make_rule("Vehicle.Cabin.Temperature", PolicyAction::Forward));
+
+    ExportPolicy policy(config, nullptr);
+
+    EXPECT_EQ(policy.match("Vehicle.Cabin.Temperature")->action, PolicyAction::Forward);
+    EXPECT_EQ(policy.match("Vehicle.Exterior.Temperature")->action, PolicyAction::Deadband);
+    EXPECT_EQ(policy.match("Vehicle.Exterior.Humidity")->action, PolicyAction::Drop);
+
+    // A literal branch that dead-ends falls back to the wildcard
+    EXPECT_EQ(policy.match("Vehicle.Cabin.Humidity")->action, PolicyAction::Drop);
+}
+
+TEST(ExportPolicyMatchTest, InvalidGlobsAreIgnored) {
+    ExportPolicyConfig config;
+    config.rules.push_back(make_rule("Vehicle.**.Speed", PolicyAction::Drop));
+    config.rules.push_back(make_rule("Vehicle..Speed", PolicyAction::Drop));
+    config.rules.push_back(make_rule("", PolicyAction::Drop));
+
+    ExportPolicy policy(config, nullptr);
+
+    EXPECT_EQ(policy.match("Vehicle.Chassis.Speed"), nullptr);
+    EXPECT_EQ(policy.match("Vehicle.Speed"), nullptr);
+
+    auto signal = make_signal("Vehicle.Speed", 1.0, 1000);
+    EXPECT_TRUE(policy.filter(signal));
+}
+
+TEST(ExportPolicyMatchTest, DefaultActionAppliesToUnmatchedPaths) {
+    ExportPolicyConfig config;
+    config.default_action = PolicyAction::Drop;
+    config.rules.push_back(make_rule("Vehicle.Speed", PolicyAction::Forward));
+
+    ExportPolicy policy(config, nullptr);
+
+    auto speed = make_signal("Vehicle.Speed", 1.0, 1000);
+    auto soc = make_signal("Vehicle.Powertrain.TractionBattery.StateOfCharge.Current", 80.0, 1000);
+    EXPECT_TRUE(policy.filter(speed));
+    EXPECT_FALSE(policy.filter(soc));
+
+    auto stats = policy.stats();
+    EXPECT_EQ(stats.samples_forwarded, 1u);
+    EXPECT_EQ(stats.samples_dropped, 1u);
+}
+
+// =============================================================================
+// Downsample / deadband
+// =============================================================================
+
+TEST(ExportPolicyFilterTest, DownsampleKeepsOneSamplePerInterval) {
+    ExportPolicyConfig config;
+    auto rule = make_rule("Vehicle.Speed", PolicyAction::Downsample);
+    rule.min_interval_ms = 100;
+    config.rules.push_back(rule);
+
+    ExportPolicy policy(config, nullptr);
+
+    // 100 Hz for one second
+    int exported = 0;
+    for (int i = 0; i < 100; ++i) {
+        auto signal = make_signal("Vehicle.Speed", i, 1000 + i * 10);
+        exported += policy.filter(signal) ? 1 : 0;
+    }
+    EXPECT_EQ(exported, 10);
+    EXPECT_EQ(policy.stats().samples_dropped, 90u);
+}
+
+TEST(ExportPolicyFilterTest, DeadbandSuppressesSmallChanges) {
+    ExportPolicyConfig config;
+    auto rule = make_rule("Vehicle.Speed", PolicyAction::Deadband);
+    rule.change_threshold = 0.5;
+    config.rules.push_back(rule);
+
+    ExportPolicy policy(config, nullptr);
+
+    auto s1 = make_signal("Vehicle.Speed", 50.0, 1000);
+    auto s2 = make_signal("Vehicle.Speed", 50.3, 1010);
+    auto s3 = make_signal("Vehicle.Speed", 50.4, 1020);   // Compared to 50.0, not 50.3
+    auto s4 = make_signal("Vehicle.Speed", 50.5, 1030);
+    auto s5 = make_signal("Vehicle.Speed", 50.1, 1040);
+    EXPECT_TRUE(policy.filter(s1));
+    EXPECT_FALSE(policy.filter(s2));
+    EXPECT_FALSE(policy.filter(s3));
+    EXPECT_TRUE(policy.filter(s4));
+    EXPECT_FALSE(policy.filter(s5));
+}
+
+TEST(ExportPolicyFilterTest, DeadbandWithoutThresholdDropsRepeats) {
+    ExportPolicyConfig config;
+    config.rules.push_back(make_rule("Vehicle.Cabin.Door.Row1.DriverSide.IsOpen",
+                                     PolicyAction::Deadband));
+
+    ExportPolicy policy(config, nullptr);
+
+    auto closed = make_signal("Vehicle.Cabin.Door.Row1.DriverSide.IsOpen", 0.0, 1000);
+    closed.value.type = vep_VSS_VALUE_TYPE_BOOL;
+    closed.value.bool_value = false;
+    auto open = closed;
+    open.value.bool_value = true;
+
+    EXPECT_TRUE(policy.filter(closed));
+    EXPECT_FALSE(policy.filter(closed));
+    EXPECT_TRUE(policy.filter(open));
+    EXPECT_FALSE(policy.filter(open));
+    EXPECT_TRUE(policy.filter(closed));
+}
+
+TEST(ExportPolicyFilterTest, DeadbandHeartbeatAndMinInterval) {
+    ExportPolicyConfig config;
+    auto rule = make_rule("Vehicle.Speed", PolicyAction::Deadband);
+    rule.change_threshold = 5.0;
+    rule.min_interval_ms = 50;
+    rule.max_interval_ms = 1000;
+    config.rules.push_back(rule);
+
+    ExportPolicy policy(config, nullptr);
+
+    auto first = make_signal("Vehicle.Speed", 10.0, 1000);
+    auto jump_too_soon = make_signal("Vehicle.Speed", 30.0, 1020);
+    auto jump = make_signal("Vehicle.Speed", 30.0, 1060);
+    auto steady = make_signal("Vehicle.Speed", 30.0, 1500);
+    auto heartbeat = make_signal("Vehicle.Speed", 30.0, 2060);
+
+    EXPECT_TRUE(policy.filter(first));
+    EXPECT_FALSE(policy.filter(jump_too_soon));
+    EXPECT_TRUE(policy.filter(jump));
+    EXPECT_FALSE(policy.filter(steady));
+    EXPECT_TRUE(policy.filter(heartbeat));
+}
+
+TEST(ExportPolicyFilterTest, QualityChangeIsAlwaysExported) {
+    ExportPolicyConfig config;
+    auto rule = make_rule("Vehicle.Speed", PolicyAction::Deadband);
+    rule.change_threshold = 100.0;
+    rule.min_interval_ms = 1000;
+    config.rules.push_back(rule);
+
+    ExportPolicy policy(config, nullptr);
+
+    auto valid = make_signal("Vehicle.Speed", 10.0, 1000);
+    auto invalid = make_signal("Vehicle.Speed", 10.0, 1010, vep_VSS_QUALITY_INVALID);
+    auto valid_again = make_signal("Vehicle.Speed", 10.0, 1020);
+
+    EXPECT_TRUE(policy.filter(valid));
+    EXPECT_TRUE(policy.filter(invalid));
+    EXPECT_FALSE(policy.filter(invalid));
+    EXPECT_TRUE(policy.filter(valid_again));
+}
+
+TEST(ExportPolicyFilterTest, NonNumericDeadbandFallsBackToInterval) {
+    ExportPolicyConfig config;
+    auto rule = make_rule("Vehicle.Cabin.Infotainment.Media.Played.Track", PolicyAction::Deadband);
+    rule.change_threshold = 1.0;
+    rule.min_interval_ms = 100;
+    config.rules.push_back(rule);
+
+    ExportPolicy policy(config, nullptr);
+
+    auto track = make_signal("Vehicle.Cabin.Infotainment.Media.Played.Track", 0.0, 1000);
+    track.value.type = vep_VSS_VALUE_TYPE_STRING;
+    track.value.string_value = const_cast<char*>("Song");
+
+    EXPECT_TRUE(policy.filter(track));
+    track.header.timestamp_ns = 1050 * 1000000LL;
+    EXPECT_FALSE(policy.filter(track));
+    track.header.timestamp_ns = 1100 * 1000000LL;
+    EXPECT_TRUE(policy.filter(track));
+}
+
+TEST(ExportPolicyFilterTest, DropAndForward) {
+    ExportPolicyConfig config;
+    config.rules.push_back(make_rule("Vehicle.Cabin.**", PolicyAction::Drop));
+
+    ExportPolicy policy(config, nullptr);
+
+    auto cabin = make_signal("Vehicle.Cabin.Temperature", 21.0, 1000);
+    auto speed = make_signal("Vehicle.Speed", 50.0, 1000);
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_FALSE(policy.filter(cabin));
+        EXPECT_TRUE(policy.filter(speed));
+    }
+    EXPECT_EQ(policy.stats().samples_dropped, 5u);
+    EXPECT_EQ(policy.stats().samples_forwarded, 5u);
+}
+
+// =============================================================================
+// Aggregation
+// =============================================================================
+
+TEST(ExportPolicyAggregateTest, WindowRolloverEmitsStatistics) {
+    ExportPolicyConfig config;
+    auto rule = make_rule("Vehicle.Powertrain.TractionBattery.**", PolicyAction::Aggregate);
+    rule.window_ms = 1000;
+    config.rules.push_back(rule);
+
+    GaugeCollector collector;
+    ExportPolicy policy(config, collector.sink());
+
+    const char* path = "Vehicle.Powertrain.TractionBattery.CurrentVoltage";
+    int64_t ts = 5000;
+    for (double v : {400.0, 396.0, 404.0, 398.0}) {
+        auto signal = make_signal(path, v, ts);
+        EXPECT_FALSE(policy.filter(signal));
+        ts += 200;
+    }
+    EXPECT_TRUE(collector.gauges.empty());
+
+    // First sample of the next window closes [5000, 6000)
+    auto next = make_signal(path, 401.0, 6000);
+    EXPECT_FALSE(policy.filter(next));
+
+    ASSERT_EQ(collector.gauges.size(), 4u);
+    auto stats = collector.by_stat();
+    EXPECT_DOUBLE_EQ(stats["min"], 396.0);
+    EXPECT_DOUBLE_EQ(stats["max"], 404.0);
+    EXPECT_DOUBLE_EQ(stats["mean"], 399.5);
+    EXPECT_DOUBLE_EQ(stats["last"], 398.0);
+    for (const auto& g : collector.gauges) {
+        EXPECT_EQ(g.name, path);
+        EXPECT_EQ(g.window_ms, "1000");
+        EXPECT_EQ(g.timestamp_ms, 5600);
+    }
+
+    auto stats_after = policy.stats();
+    EXPECT_EQ(stats_after.samples_aggregated, 5u);
+    EXPECT_EQ(stats_after.aggregates_emitted, 4u);
+    EXPECT_EQ(stats_after.samples_forwarded, 0u);
+}
+
+TEST(ExportPolicyAggregateTest, FlushExpiredAndFlushAll) {
+    ExportPolicyConfig config;
+    auto rule = make_rule("Vehicle.Speed", PolicyAction::Aggregate);
+    rule.window_ms = 1000;
+    rule.stats = {AggregateStat::Mean};
+    config.rules.push_back(rule);
+
+    GaugeCollector collector;
+    ExportPolicy policy(config, collector.sink());
+
+    auto a = make_signal("Vehicle.Speed", 10.0, 1100);
+    auto b = make_signal("Vehicle.Speed", 20.0, 1900);
+    policy.filter(a);
+    policy.filter(b);
+
+    policy.flush_expired(1999);
+    EXPECT_TRUE(collector.gauges.empty());
+
+    policy.flush_expired(2000);
+    ASSERT_EQ(collector.gauges.size(), 1u);
+    EXPECT_EQ(collector.gauges[0].aggregation, "mean");
+    EXPECT_DOUBLE_EQ(collector.gauges[0].value, 15.0);
+
+    // Nothing open any more
+    policy.flush_all();
+    EXPECT_EQ(collector.gauges.size(), 1u);
+
+    auto c = make_signal("Vehicle.Speed", 30.0, 2500);
+    policy.filter(c);
+    policy.flush_all();
+    ASSERT_EQ(collector.gauges.size(), 2u);
+    EXPECT_DOUBLE_EQ(collector.gauges[1].value, 30.0);
+}
+
+TEST(ExportPolicyAggregateTest, InvalidAndNonNumericSamplesAreForwarded) {
+    ExportPolicyConfig config;
+    config.rules.push_back(make_rule("Vehicle.**", PolicyAction::Aggregate));
+
+    GaugeCollector collector;
+    ExportPolicy policy(config, collector.sink());
+
+    auto invalid = make_signal("Vehicle.Speed", 0.0, 1000, vep_VSS_QUALITY_INVALID);
+    EXPECT_TRUE(policy.filter(invalid));
+
+    auto vin = make_signal("Vehicle.VehicleIdentification.VIN", 0.0, 1000);
+    vin.value.type = vep_VSS_VALUE_TYPE_STRING;
+    vin.value.string_value = const_cast<char*>("5YJ3E1EA7KF000001");
+    EXPECT_TRUE(policy.filter(vin));
+
+    policy.flush_all();
+    EXPECT_TRUE(collector.gauges.empty());
+}
+
+// =============================================================================
+// Policy file
+// =============================================================================
+
+TEST(ExportPolicyLoadTest, LoadsRules) {
+    TempYaml file(R"(
+export_policy:
+  default: drop
+  rules:
+    - match: "Vehicle.Speed"
+      action: deadband
+      change_threshold: 0.5
+      max_interval_ms: 1000
+    - match: "Vehicle.Chassis.Axle.*.Wheel.*.Speed"
+      action: downsample
+      min_interval_ms: 100
+    - match: "Vehicle.Powertrain.TractionBattery.**"
+      action: aggregate
+      window_ms: 5000
+      stats: [min, max]
+)");
+
+    auto config = load_export_policy(file.path());
+    ASSERT_TRUE(config.has_value());
+    EXPECT_EQ(config->default_action, PolicyAction::Drop);
+    ASSERT_EQ(config->rules.size(), 3u);
+
+    EXPECT_EQ(config->rules[0].action, PolicyAction::Deadband);
+    EXPECT_DOUBLE_EQ(config->rules[0].change_threshold, 0.5);
+    EXPECT_EQ(config->rules[0].max_interval_ms, 1000u);
+
+    EXPECT_EQ(config->rules[1].action, PolicyAction::Downsample);
+    EXPECT_EQ(config->rules[1].min_interval_ms, 100u);
+
+    EXPECT_EQ(config->rules[2].action, PolicyAction::Aggregate);
+    EXPECT_EQ(config->rules[2].window_ms, 5000u);
+    EXPECT_EQ(config->rules[2].stats,
+              (std::vector<AggregateStat>{AggregateStat::Min, AggregateStat::Max}));
+}
+
+TEST(ExportPolicyLoadTest, RejectsInvalidFiles) {
+    EXPECT_FALSE(load_export_policy("/nonexistent/export_policy.yaml").has_value());
+
+    TempYaml no_section("signals: []\n");
+    EXPECT_FALSE(load_export_policy(no_section.path()).has_value());
+
+    TempYaml bad_action(R"(
+export_policy:
+  rules:
+    - match: "Vehicle.Speed"
+      action: compress
+)");
+    EXPECT_FALSE(load_export_policy(bad_action.path()).has_value());
+
+    TempYaml bad_glob(R"(
+export_policy:
+  rules:
+    - match: "Vehicle.**.Speed"
+      action: drop
+)");
+    EXPECT_FALSE(load_export_policy(bad_glob.path()).has_value());
+
+    TempYaml bad_default(R"(
+export_policy:
+  default: deadband
+)");
+    EXPECT_FALSE(load_export_policy(bad_default.path()).has_value());
+
+    TempYaml bad_stat(R"(
+export_policy:
+  rules:
+    - match: "Vehicle.Speed"
+      action: aggregate
+      stats: [median]
+)");
+    EXPECT_FALSE(load_export_policy(bad_stat.path()).has_value());
+}
+
+// =============================================================================
+// Pipeline integration
+// =============================================================================
+
+namespace {
+
+/// Transport that keeps published payloads (shared so the test can read
+/// them after the pipeline takes ownership)
+class CapturingTransport : public vep::BackendTransport {
+public:
+    explicit CapturingTransport(std::shared_ptr<std::vector<std::vector<uint8_t>>> payloads)
+        : payloads_(std::move(payloads)) {}
+
+    bool start() override { return true; }
+    void stop() override {}
+    uint32_t content_id() const override { return 1; }
+    bool publish(const std::vector<uint8_t>& data, vep::Persistence) override {
+        payloads_->push_back(data);
+        return true;
+    }
+    bool healthy() const override { return true; }
+    vep::BackendTransportStats stats() const override { return {}; }
+    std::string name() const override { return "capture"; }
+
+private:
+    std::shared_ptr<std::vector<std::vector<uint8_t>>> payloads_;
+};
+
+}  // namespace
+
+TEST(ExportPolicyPipelineTest, PolicyReducesExportedItems) {
+    UnifiedPipelineConfig config;
+    config.batch_max_items = 10000;
+    config.batch_timeout = std::chrono::milliseconds(60000);
+
+    auto rule = make_rule("Vehicle.Speed", PolicyAction::Downsample);
+    rule.min_interval_ms = 100;
+    config.policy.rules.push_back(rule);
+    auto aggregate = make_rule("Vehicle.Powertrain.**", PolicyAction::Aggregate);
+    aggregate.stats = {AggregateStat::Mean};
+    config.policy.rules.push_back(aggregate);
+
+    auto payloads = std::make_shared<std::vector<std::vector<uint8_t>>>();
+    UnifiedExporterPipeline pipeline(std::make_unique<CapturingTransport>(payloads),
+                                     create_compressor(CompressorType::NONE), config);
+    ASSERT_TRUE(pipeline.start());
+
+    for (int i = 0; i < 100; ++i) {
+        pipeline.send(make_signal("Vehicle.Speed", i, 1000 + i * 10));
+        pipeline.send(make_signal("Vehicle.Powertrain.Range", 300.0 - i, 1000 + i * 10));
+    }
+    pipeline.stop();
+
+    auto stats = pipeline.stats();
+    EXPECT_EQ(stats.signals_processed, 200u);
+    EXPECT_EQ(stats.signals_suppressed, 190u);
+    EXPECT_EQ(stats.aggregates_emitted, 1u);
+
+    size_t signals = 0;
+    size_t metrics = 0;
+    for (const auto& payload : *payloads) {
+        vep::transfer::TransferBatch batch;
+        ASSERT_TRUE(batch.ParseFromArray(payload.data(), static_cast<int>(payload.size())));
+        for (const auto& item : batch.items()) {
+            if (item.has_signal()) signals++;
+            if (item.has_metric()) {
+                metrics++;
+                EXPECT_DOUBLE_EQ(item.metric().gauge(), 250.5);
+            }
+        }
+    }
+    EXPECT_EQ(signals, 10u);
+    EXPECT_EQ(metrics, 1u);
+}
+
+}  // namespace vep::exporter::test
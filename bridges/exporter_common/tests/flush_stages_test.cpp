@@ -0,0 +1,249 @@
+// Copyright 2025 Vehicle Edge Platform Contributors
+// SPDX-License-Identifier: Apache-2.0
+
+/// @file flush_stages_test.cpp
+/// @brief Tests for FlushStages and the payload buffers it recycles
+///
+/// Stages run with their own compressor and a publish callback in place
+/// of a transport; the pipeline level ordering is in unified_pipeline_test.
+
+#include "flush_stages.hpp"
+#include "pipeline_test_support.hpp"
+#include "vep/payload_buffer.hpp"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vep::exporter::test {
+
+namespace {
+
+vep::PayloadBuffer payload(std::vector<uint8_t> bytes) {
+    return vep::PayloadBuffer(std::move(bytes));
+}
+
+/// Passthrough compressor that takes longer for lower first bytes, so
+/// later batches finish compressing first
+class SlowCompressor : public Compressor {
+public:
+    bool init() override { return true; }
+
+    std::vector<uint8_t> compress(const std::vector<uint8_t>& data) override {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2 * (16 - data[0])));
+        return data;
+    }
+
+    CompressionStats stats() const override { return {}; }
+    std::unique_ptr<Compressor> clone() const override { return std::make_unique<SlowCompressor>(); }
+    CompressorType type() const override { return CompressorType::NONE; }
+};
+
+}  // namespace
+
+TEST(FlushStagesTest, PublishesInSubmissionOrder) {
+    SlowCompressor compressor;
+    std::vector<uint8_t> published;
+    FlushStagesConfig config;
+    config.compress_workers = 4;
+    config.queue_depth = 8;
+    FlushStages stages(config, compressor,
+                       [&](vep::PayloadBuffer compressed, size_t raw_size) {
+                           EXPECT_EQ(raw_size, 1u);
+                           published.push_back(compressed.data()[0]);
+                       });
+    stages.start();
+    EXPECT_EQ(stages.workers(), 4u);
+
+    for (uint8_t i = 0; i < 16; ++i) {
+        auto buffer = stages.acquire_buffer();
+        buffer.bytes().assign(1, i);
+        stages.submit(std::move(buffer));
+    }
+    stages.stop();
+
+    ASSERT_EQ(published.size(), 16u);
+    for (uint8_t i = 0; i < 16; ++i) {
+        EXPECT_EQ(published[i], i);
+    }
+}
+
+TEST(FlushStagesTest, SubmitBlocksWhileQueueIsFull) {
+    auto compressor = create_compressor(CompressorType::NONE);
+    std::mutex gate;
+    std::unique_lock<std::mutex> closed(gate);
+    FlushStagesConfig config;
+    config.compress_workers = 1;
+    config.queue_depth = 2;
+    FlushStages stages(config, *compressor,
+                       [&](vep::PayloadBuffer, size_t) {
+                           std::lock_guard<std::mutex> wait(gate);  // Slow transport
+                       });
+    stages.start();
+
+    stages.submit(payload({1}));
+    stages.submit(payload({2}));
+    std::atomic<bool> third_submitted{false};
+    std::thread producer([&] {
+        stages.submit(payload({3}));
+        third_submitted = true;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(third_submitted);
+    EXPECT_EQ(stages.in_flight(), 2u);
+
+    closed.unlock();
+    producer.join();
+    EXPECT_TRUE(third_submitted);
+    stages.stop();
+    EXPECT_EQ(stages.in_flight(), 0u);
+}
+
+TEST(FlushStagesTest, OverflowDropsOldestQueuedBatch) {
+    auto compressor = create_compressor(CompressorType::NONE);
+    std::mutex gate;
+    std::unique_lock<std::mutex> closed(gate);
+    std::atomic<bool> publishing{false};
+    std::atomic<bool> overflow{false};
+    std::vector<size_t> published;
+    std::vector<size_t> dropped;
+    FlushStagesConfig config;
+    config.compress_workers = 1;
+    config.queue_depth = 2;
+    FlushStages stages(
+        config, *compressor,
+        [&](vep::PayloadBuffer compressed, size_t) {
+            publishing = true;
+            std::lock_guard<std::mutex> wait(gate);  // Slow transport
+            published.push_back(compressed.size());
+        },
+        [&] { return overflow.load(); },
+        [&](size_t raw_size) { dropped.push_back(raw_size); });
+    stages.start();
+
+    stages.submit(payload({1}));
+    ASSERT_TRUE(wait_until([&] { return publishing.load(); }));
+    stages.submit(payload({2, 2}));
+    EXPECT_EQ(stages.in_flight(), 2u);
+
+    // Window full, over budget: the queued batch makes room, not the one
+    // being published
+    overflow = true;
+    stages.submit(payload({3, 3, 3}));
+    EXPECT_EQ(stages.in_flight(), 2u);
+    overflow = false;
+
+    closed.unlock();
+    stages.stop();
+    EXPECT_EQ(published, (std::vector<size_t>{1, 3}));
+    EXPECT_EQ(dropped, (std::vector<size_t>{2}));
+    EXPECT_EQ(stages.bytes_in_flight(), 0u);
+}
+
+TEST(FlushStagesTest, NoWorkersPublishesInline) {
+    auto compressor = create_compressor(CompressorType::NONE);
+    std::thread::id publisher;
+    FlushStagesConfig config;
+    config.compress_workers = 0;
+    FlushStages stages(config, *compressor,
+                       [&](vep::PayloadBuffer, size_t) {
+                           publisher = std::this_thread::get_id();
+                       });
+    stages.start();
+    stages.submit(payload({1, 2, 3}));
+
+    EXPECT_EQ(publisher, std::this_thread::get_id());
+    EXPECT_EQ(stages.workers(), 0u);
+    stages.stop();
+}
+
+TEST(FlushStagesTest, PassthroughPublishesSerializedBuffer) {
+    auto compressor = create_compressor(CompressorType::NONE);
+    const uint8_t* published = nullptr;
+    FlushStagesConfig config;
+    config.compress_workers = 1;
+    FlushStages stages(config, *compressor,
+                       [&](vep::PayloadBuffer compressed, size_t raw_size) {
+                           EXPECT_EQ(compressed.size(), raw_size);
+                           published = compressed.data();
+                       });
+    stages.start();
+
+    auto buffer = stages.acquire_buffer();
+    buffer.bytes().assign(4096, 0x5A);
+    const uint8_t* serialized = buffer.data();
+    stages.submit(std::move(buffer));
+    stages.drain();
+
+    EXPECT_EQ(published, serialized);  // Not copied
+    stages.stop();
+}
+
+TEST(FlushStagesTest, RecyclesBuffers) {
+    auto compressor = create_compressor(CompressorType::ZSTD);
+    FlushStagesConfig config;
+    config.compress_workers = 1;
+    FlushStages stages(config, *compressor, [](vep::PayloadBuffer, size_t) {});
+    stages.start();
+
+    auto buffer = stages.acquire_buffer();
+    buffer.bytes().assign(10000, 0x11);
+    stages.submit(std::move(buffer));
+    stages.drain();
+
+    // Serialized and compressed storage both came back, capacity kept
+    auto first = stages.acquire_buffer();
+    auto second = stages.acquire_buffer();
+    EXPECT_TRUE(first.empty());
+    EXPECT_GE(std::max(first.bytes().capacity(), second.bytes().capacity()), 10000u);
+    EXPECT_GT(std::min(first.bytes().capacity(), second.bytes().capacity()), 0u);
+    stages.stop();
+}
+
+// =============================================================================
+// Payload Buffer Tests
+// =============================================================================
+
+TEST(PayloadBufferTest, ReturnsStorageToPool) {
+    auto pool = vep::BufferPool::create(1);
+    {
+        auto a = pool->acquire();
+        auto b = pool->acquire();
+        a.bytes().resize(100);
+        b.bytes().resize(200);
+        EXPECT_EQ(pool->available(), 0u);
+    }
+    EXPECT_EQ(pool->available(), 1u);  // Bounded: one freed
+
+    auto reused = pool->acquire();
+    EXPECT_TRUE(reused.empty());
+    EXPECT_GE(reused.bytes().capacity(), 100u);
+    EXPECT_EQ(pool->available(), 0u);
+
+    // Moving transfers ownership; release() hands back early
+    vep::PayloadBuffer moved = std::move(reused);
+    moved.release();
+    EXPECT_EQ(pool->available(), 1u);
+    EXPECT_TRUE(moved.empty());
+}
+
+TEST(PayloadBufferTest, OutlivesPoolHandle) {
+    auto pool = vep::BufferPool::create();
+    auto buffer = pool->acquire();
+    buffer.bytes().assign(10, 1);
+    std::weak_ptr<vep::BufferPool> weak = pool;
+    pool.reset();
+
+    EXPECT_FALSE(weak.expired());  // Kept alive by the buffer
+    buffer.release();
+    EXPECT_TRUE(weak.expired());
+}
+
+}  // namespace vep::exporter::test
@@ -0,0 +1,62 @@
+// Copyright 2025 Vehicle Edge Platform Contributors
+// SPDX-License-Identifier: Apache-2.0
+
+/// @file latency_histogram_test.cpp
+/// @brief Tests for LatencyHistogram percentiles and bucket counts
+
+#include "latency_histogram.hpp"
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <limits>
+
+namespace vep::exporter::test {
+
+TEST(LatencyHistogramTest, PercentilesWithinBucketResolution) {
+    LatencyHistogram histogram;
+    for (int64_t us = 1; us <= 10000; ++us) {
+        histogram.record(us);
+    }
+
+    auto summary = histogram.summary();
+    EXPECT_EQ(summary.count, 10000u);
+    EXPECT_DOUBLE_EQ(summary.mean_us, 5000.5);
+    EXPECT_EQ(summary.max_us, 10000);
+    EXPECT_GE(summary.p50_us, 5000);
+    EXPECT_LE(summary.p50_us, 5000 * 1.0625);
+    EXPECT_GE(summary.p99_us, 9900);
+    EXPECT_LE(summary.p99_us, 10000);
+    EXPECT_EQ(summary.p999_us, 10000);  // Capped at the maximum
+}
+
+TEST(LatencyHistogramTest, SmallValuesAreExact) {
+    LatencyHistogram histogram;
+    for (int64_t us = 0; us < 16; ++us) {
+        histogram.record(us);
+    }
+    histogram.record(-5);  // Clock step: counts as 0
+
+    EXPECT_EQ(histogram.count(), 17u);
+    EXPECT_EQ(histogram.percentile(0.0), 0);
+    EXPECT_EQ(histogram.percentile(0.5), 7);
+    EXPECT_EQ(histogram.percentile(1.0), 15);
+    EXPECT_EQ(histogram.count_at_most(3), 5u);
+}
+
+TEST(LatencyHistogramTest, CountAtMostIncludesTheBoundsBucket) {
+    LatencyHistogram histogram;
+    histogram.record(900);
+    histogram.record(1000);
+    histogram.record(1100);
+    histogram.record(100000000000);  // Clamped, still counted
+
+    EXPECT_EQ(histogram.count_at_most(0), 0u);
+    EXPECT_EQ(histogram.count_at_most(1000), 2u);
+    EXPECT_EQ(histogram.count_at_most(std::numeric_limits<int64_t>::max()), 4u);
+
+    histogram.reset();
+    EXPECT_EQ(histogram.count(), 0u);
+    EXPECT_EQ(histogram.summary().p99_us, 0);
+}
+
+}  // namespace vep::exporter::test
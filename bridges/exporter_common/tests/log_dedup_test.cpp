@@ -0,0 +1,297 @@
+// Copyright 2025 Vehicle Edge Platform Contributors
+// SPDX-License-Identifier: Apache-2.0
+
+#include "log_dedup.hpp"
+#include "log_template.hpp"
+#include "unified_pipeline.hpp"
+#include "wire_decoder.hpp"
+#include "transfer.pb.h"
+
+#include <gtest/gtest.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace vep::exporter::test {
+
+namespace {
+
+vep_OtelLogEntry make_log(const char* message, int64_t timestamp_ms,
+                          vep_OtelLogLevel level = vep_LOG_LEVEL_ERROR,
+                          const char* component = "mqtt_client") {
+    vep_OtelLogEntry log = {};
+    log.header.source_id = const_cast<char*>("test");
+    log.header.timestamp_ns = timestamp_ms * 1000000;
+    log.header.correlation_id = const_cast<char*>("");
+    log.level = level;
+    log.component = const_cast<char*>(component);
+    log.message = const_cast<char*>(message);
+    log.trace_id = const_cast<char*>("");
+    log.span_id = const_cast<char*>("");
+    return log;
+}
+
+/// Summary entry as seen by the sink
+struct Summary {
+    std::string component;
+    std::string message;
+    int64_t timestamp_ms;
+    LogRepeat repeat;
+    std::map<std::string, std::string> attributes;
+};
+
+class SummaryCollector {
+public:
+    LogDedup::SummarySink sink() {
+        return [this](const vep_OtelLogEntry& entry, const LogRepeat& repeat) {
+            Summary out{entry.component, entry.message, entry.header.timestamp_ns / 1000000,
+                        repeat, {}};
+            for (uint32_t i = 0; i < entry.attributes._length; ++i) {
+                out.attributes[entry.attributes._buffer[i].key] = entry.attributes._buffer[i].value;
+            }
+            summaries.push_back(out);
+        };
+    }
+
+    std::vector<Summary> summaries;
+};
+
+LogDedupConfig dedup_config(uint32_t window_ms = 1000) {
+    LogDedupConfig config;
+    config.enabled = true;
+    config.window_ms = window_ms;
+    return config;
+}
+
+}  // namespace
+
+// =============================================================================
+// Log templates
+// =============================================================================
+
+TEST(LogTemplateTest, NumericTokensBecomeParameters) {
+    std::string templ;
+    std::vector<std::string> params;
+    ASSERT_TRUE(extract_log_template("connect to 10.0.0.5:1883 failed (rc=7), retry in 500 ms",
+                                     templ, params));
+    EXPECT_EQ(templ, "connect to <*>:<*> failed (rc=<*>), retry in <*> ms");
+    EXPECT_EQ(params, (std::vector<std::string>{"10.0.0.5", "1883", "7", "500"}));
+}
+
+TEST(LogTemplateTest, MessageWithoutNumbersIsItsOwnTemplate) {
+    std::string templ;
+    std::vector<std::string> params;
+    ASSERT_TRUE(extract_log_template("Broker connection lost", templ, params));
+    EXPECT_EQ(templ, "Broker connection lost");
+    EXPECT_TRUE(params.empty());
+}
+
+TEST(LogTemplateTest, ExpansionIsLossless) {
+    const char* messages[] = {
+        "",
+        "42",
+        "  leading and trailing  ",
+        "frame 0x1A3 on vcan0: dlc=8 data=[de ad be ef 00 11 22 33]",
+        "sensor{id=\"wheel_fl\"} value=-3.5e-2; ts=1717000000123",
+        "<5*> <1 *> <<2>> a<b>c",
+        "tabs\tand\nnewlines 12\r\n",
+        "utf-8 temperature 21.5 \xc2\xb0" "C",
+    };
+    std::string templ;
+    std::vector<std::string> params;
+    for (const char* message : messages) {
+        ASSERT_TRUE(extract_log_template(message, templ, params)) << message;
+        EXPECT_EQ(expand_log_template(templ, params), message);
+    }
+}
+
+TEST(LogTemplateTest, MessageContainingPlaceholderIsNotTemplated) {
+    std::string templ;
+    std::vector<std::string> params;
+    EXPECT_FALSE(extract_log_template("pattern <*> matched 3 times", templ, params));
+}
+
+// =============================================================================
+// LogDedup
+// =============================================================================
+
+TEST(LogDedupTest, RepeatsInsideWindowAreCollapsed) {
+    SummaryCollector collector;
+    LogDedup dedup(dedup_config(), collector.sink());
+
+    EXPECT_TRUE(dedup.filter(make_log("connection refused", 1000)));
+    for (int i = 1; i <= 50; ++i) {
+        EXPECT_FALSE(dedup.filter(make_log("connection refused", 1000 + i * 10)));
+    }
+    EXPECT_TRUE(collector.summaries.empty());
+
+    dedup.flush_expired(2000);
+    ASSERT_EQ(collector.summaries.size(), 1u);
+    const auto& summary = collector.summaries[0];
+    EXPECT_EQ(summary.message, "connection refused");
+    EXPECT_EQ(summary.component, "mqtt_client");
+    EXPECT_EQ(summary.repeat.count, 50u);
+    EXPECT_EQ(summary.timestamp_ms, 1010);
+    EXPECT_EQ(summary.repeat.last_timestamp_ms, 1500);
+    EXPECT_EQ(dedup.size(), 0u);
+
+    auto stats = dedup.stats();
+    EXPECT_EQ(stats.entries_forwarded, 1u);
+    EXPECT_EQ(stats.entries_collapsed, 50u);
+    EXPECT_EQ(stats.summaries_emitted, 1u);
+}
+
+TEST(LogDedupTest, OccurrenceAfterWindowEmitsSummaryAndOpensNextWindow) {
+    SummaryCollector collector;
+    LogDedup dedup(dedup_config(), collector.sink());
+
+    EXPECT_TRUE(dedup.filter(make_log("timeout", 0)));
+    EXPECT_FALSE(dedup.filter(make_log("timeout", 400)));
+    EXPECT_FALSE(dedup.filter(make_log("timeout", 999)));
+
+    EXPECT_TRUE(dedup.filter(make_log("timeout", 1000)));
+    ASSERT_EQ(collector.summaries.size(), 1u);
+    EXPECT_EQ(collector.summaries[0].repeat.count, 2u);
+    EXPECT_EQ(collector.summaries[0].repeat.last_timestamp_ms, 999);
+
+    EXPECT_FALSE(dedup.filter(make_log("timeout", 1500)));
+    dedup.flush_all();
+    ASSERT_EQ(collector.summaries.size(), 2u);
+    EXPECT_EQ(collector.summaries[1].repeat.count, 1u);
+}
+
+TEST(LogDedupTest, LevelComponentAndMessageFormTheKey) {
+    SummaryCollector collector;
+    LogDedup dedup(dedup_config(), collector.sink());
+
+    EXPECT_TRUE(dedup.filter(make_log("retry", 0, vep_LOG_LEVEL_WARN)));
+    EXPECT_TRUE(dedup.filter(make_log("retry", 1, vep_LOG_LEVEL_ERROR)));
+    EXPECT_TRUE(dedup.filter(make_log("retry", 2, vep_LOG_LEVEL_WARN, "can_probe")));
+    EXPECT_TRUE(dedup.filter(make_log("retry 2", 3, vep_LOG_LEVEL_WARN)));
+    EXPECT_FALSE(dedup.filter(make_log("retry", 4, vep_LOG_LEVEL_WARN)));
+    EXPECT_EQ(dedup.size(), 4u);
+}
+
+TEST(LogDedupTest, WindowWithoutRepeatsEmitsNothing) {
+    SummaryCollector collector;
+    LogDedup dedup(dedup_config(), collector.sink());
+
+    EXPECT_TRUE(dedup.filter(make_log("started", 0, vep_LOG_LEVEL_INFO)));
+    dedup.flush_all();
+    EXPECT_TRUE(collector.summaries.empty());
+    EXPECT_EQ(dedup.size(), 0u);
+}
+
+TEST(LogDedupTest, SummaryCarriesAttributesOfFirstRepeat) {
+    SummaryCollector collector;
+    LogDedup dedup(dedup_config(), collector.sink());
+
+    vep_KeyValue first[] = {{const_cast<char*>("attempt"), const_cast<char*>("1")}};
+    vep_KeyValue second[] = {{const_cast<char*>("attempt"), const_cast<char*>("2")}};
+    vep_KeyValue third[] = {{const_cast<char*>("attempt"), const_cast<char*>("3")}};
+    for (auto* attributes : {first, second, third}) {
+        auto log = make_log("publish failed", attributes == first ? 0 : attributes == second ? 10 : 20);
+        log.attributes._buffer = attributes;
+        log.attributes._length = 1;
+        log.attributes._maximum = 1;
+        dedup.filter(log);
+    }
+    dedup.flush_all();
+    ASSERT_EQ(collector.summaries.size(), 1u);
+    EXPECT_EQ(collector.summaries[0].attributes["attempt"], "2");
+}
+
+TEST(LogDedupTest, EntriesBeyondLimitPassThrough) {
+    SummaryCollector collector;
+    auto config = dedup_config();
+    config.max_entries = 2;
+    LogDedup dedup(config, collector.sink());
+
+    EXPECT_TRUE(dedup.filter(make_log("a", 0)));
+    EXPECT_TRUE(dedup.filter(make_log("b", 0)));
+    EXPECT_TRUE(dedup.filter(make_log("c", 0)));
+    EXPECT_TRUE(dedup.filter(make_log("c", 1)));  // Not tracked
+    EXPECT_FALSE(dedup.filter(make_log("a", 1)));
+    EXPECT_EQ(dedup.size(), 2u);
+}
+
+// =============================================================================
+// Pipeline integration
+// =============================================================================
+
+namespace {
+
+/// Transport that keeps published payloads (shared so the test can read
+/// them after the pipeline takes ownership)
+class CapturingTransport : public vep::BackendTransport {
+public:
+    explicit CapturingTransport(std::shared_ptr<std::vector<std::vector<uint8_t>>> payloads)
+        : payloads_(std::move(payloads)) {}
+
+    bool start() override { return true; }
+    void stop() override {}
+    uint32_t content_id() const override { return 1; }
+    bool publish(const std::vector<uint8_t>& data, vep::Persistence) override {
+        payloads_->push_back(data);
+        return true;
+    }
+    bool healthy() const override { return true; }
+    vep::BackendTransportStats stats() const override { return {}; }
+    std::string name() const override { return "capture"; }
+
+private:
+    std::shared_ptr<std::vector<std::vector<uint8_t>>> payloads_;
+};
+
+}  // namespace
+
+TEST(LogDedupPipelineTest, StormBecomesEntryAndSummaryWithTemplates) {
+    UnifiedPipelineConfig config;
+    config.batch_max_items = 10000;
+    config.batch_timeout = std::chrono::milliseconds(60000);
+    config.log_dedup = dedup_config(60000);
+    config.encoding.log_templates = true;
+
+    auto payloads = std::make_shared<std::vector<std::vector<uint8_t>>>();
+    UnifiedExporterPipeline pipeline(std::make_unique<CapturingTransport>(payloads),
+                                     create_compressor(CompressorType::NONE), config);
+    ASSERT_TRUE(pipeline.start());
+
+    for (int i = 0; i < 1000; ++i) {
+        pipeline.send(make_log("connect to 10.0.0.5:1883 failed (rc=7)", 1000 + i));
+    }
+    pipeline.send(make_log("link up after 1000 attempts", 3000, vep_LOG_LEVEL_INFO));
+    pipeline.stop();
+
+    auto stats = pipeline.stats();
+    EXPECT_EQ(stats.logs_processed, 1001u);
+    EXPECT_EQ(stats.logs_collapsed, 999u);
+
+    PathDictionaryCache dictionary;
+    std::vector<DecodedLogEntry> logs;
+    for (const auto& payload : *payloads) {
+        auto batch = decode_transfer_batch(payload, dictionary);
+        ASSERT_TRUE(batch.has_value());
+        for (const auto& item : batch->items) {
+            if (item.log) {
+                logs.push_back(*item.log);
+            }
+        }
+    }
+
+    ASSERT_EQ(logs.size(), 3u);
+    EXPECT_EQ(logs[0].message, "connect to 10.0.0.5:1883 failed (rc=7)");
+    EXPECT_EQ(logs[0].repeat_count, 1u);
+    EXPECT_NE(logs[0].template_id, 0u);
+    EXPECT_EQ(logs[1].message, "link up after 1000 attempts");
+
+    // Summary is flushed at stop
+    EXPECT_EQ(logs[2].message, "connect to 10.0.0.5:1883 failed (rc=7)");
+    EXPECT_EQ(logs[2].template_id, logs[0].template_id);
+    EXPECT_EQ(logs[2].repeat_count, 999u);
+    EXPECT_EQ(logs[2].timestamp_ms, 1001);
+    EXPECT_EQ(logs[2].last_timestamp_ms, 1999);
+}
+
+}  // namespace vep::exporter::test
@@ -0,0 +1,143 @@
+// Copyright 2025 Vehicle Edge Platform Contributors
+// SPDX-License-Identifier: Apache-2.0
+
+/// @file pipeline_router_test.cpp
+/// @brief Tests for PipelineRouter lanes and routes
+///
+/// Every lane publishes to its own BackpressureTransport and batches
+/// until stop(), so each test sees which lane took which items.
+
+#include "pipeline_router.hpp"
+#include "pipeline_test_support.hpp"
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace vep::exporter::test {
+
+class PipelineRouterTest : public ::testing::Test {
+protected:
+    /// Add a lane with a fresh transport, batching until stop()
+    BackpressureTransport* add_lane(const std::string& name, LaneRoute route) {
+        LaneConfig config;
+        config.name = name;
+        config.route = std::move(route);
+        config.pipeline = test_pipeline_config();
+        config.pipeline.source_id = "vep_exporter/" + name;
+        auto transport = std::make_unique<BackpressureTransport>();
+        auto* transport_ptr = transport.get();
+        EXPECT_TRUE(router_.add_lane(config, std::move(transport),
+                                     create_compressor(CompressorType::NONE)));
+        return transport_ptr;
+    }
+
+    PipelineRouter router_;
+};
+
+TEST_F(PipelineRouterTest, FirstMatchingLaneTakesItem) {
+    auto* fast = add_lane("fast", {{ItemType::Signal}, {"Vehicle.Speed"}});
+    auto* logs = add_lane("logs", {{ItemType::Log}, {}});
+    auto* rest = add_lane("default", {});
+    ASSERT_TRUE(router_.start());
+
+    auto speed = make_signal(1.0, 1000);
+    auto steering = make_signal(2.0, 1000);
+    steering.path = const_cast<char*>("Vehicle.Chassis.SteeringWheel.Angle");
+    router_.send(speed);
+    router_.send(steering);
+    router_.send(make_log(vep_LOG_LEVEL_INFO));
+    router_.send(make_event());
+    router_.send(make_gauge());
+    router_.stop();
+
+    ASSERT_EQ(fast->batches().size(), 1u);
+    EXPECT_EQ(fast->batches()[0].source_id(), "vep_exporter/fast");
+    EXPECT_EQ(fast->items().size(), 1u);
+    EXPECT_EQ(logs->items().size(), 1u);
+    EXPECT_TRUE(logs->items()[0].has_log());
+    EXPECT_EQ(rest->items().size(), 3u);  // Other signal, event, gauge
+
+    auto stats = router_.stats();
+    ASSERT_EQ(stats.lanes.size(), 3u);
+    EXPECT_EQ(stats.lanes[0].name, "fast");
+    EXPECT_EQ(stats.lanes[0].pipeline.signals_processed, 1u);
+    EXPECT_EQ(stats.lanes[2].pipeline.items_total, 3u);
+    EXPECT_EQ(stats.items_unrouted, 0u);
+}
+
+TEST_F(PipelineRouterTest, UnmatchedItemsAreCounted) {
+    auto* adas = add_lane("adas", {{ItemType::Event}, {"ADAS"}});
+    ASSERT_TRUE(router_.start());
+
+    auto other = make_event();
+    other.category = const_cast<char*>("Body");
+    router_.send(make_event());
+    router_.send(other);
+    router_.send(make_log(vep_LOG_LEVEL_ERROR));
+    router_.stop();
+
+    EXPECT_EQ(adas->items().size(), 1u);
+    EXPECT_EQ(router_.stats().items_unrouted, 2u);
+}
+
+TEST_F(PipelineRouterTest, SendBatchSplitsSpanByLane) {
+    auto* fast = add_lane("fast", {{ItemType::Signal}, {"Vehicle.Speed"}});
+    auto* rest = add_lane("default", {{ItemType::Signal}, {"Vehicle.Chassis."}});
+    ASSERT_TRUE(router_.start());
+
+    std::vector<vep_VssSignal> signals;
+    const char* paths[] = {"Vehicle.Speed", "Vehicle.Speed", "Vehicle.Chassis.Axle",
+                           "Vehicle.Cabin.Temp", "Vehicle.Speed"};
+    for (int i = 0; i < 5; ++i) {
+        signals.push_back(make_signal(i, 1000 + i));
+        signals.back().path = const_cast<char*>(paths[i]);
+    }
+    router_.send_batch(signals.data(), signals.size());
+    router_.stop();
+
+    ASSERT_EQ(fast->items().size(), 3u);
+    EXPECT_EQ(fast->items()[0].signal().double_val(), 0.0);
+    EXPECT_EQ(fast->items()[1].signal().double_val(), 1.0);
+    EXPECT_EQ(fast->items()[2].signal().double_val(), 4.0);
+    EXPECT_EQ(rest->items().size(), 1u);
+    EXPECT_EQ(router_.stats().items_unrouted, 1u);
+}
+
+TEST_F(PipelineRouterTest, RejectsDuplicateLanes) {
+    add_lane("signals", {{ItemType::Signal}, {}});
+
+    LaneConfig same_name;
+    same_name.name = "signals";
+    same_name.pipeline.source_id = "vep_exporter/other";
+    EXPECT_FALSE(router_.add_lane(same_name, std::make_unique<BackpressureTransport>(),
+                                  create_compressor(CompressorType::NONE)));
+
+    LaneConfig same_source;
+    same_source.name = "other";
+    same_source.pipeline.source_id = "vep_exporter/signals";
+    EXPECT_FALSE(router_.add_lane(same_source, std::make_unique<BackpressureTransport>(),
+                                  create_compressor(CompressorType::NONE)));
+    EXPECT_EQ(router_.lanes(), 1u);
+}
+
+TEST_F(PipelineRouterTest, StuckLaneDoesNotHoldOthers) {
+    auto* logs = add_lane("logs", {{ItemType::Log}, {}});
+    auto* signals = add_lane("signals", {{ItemType::Signal}, {}});
+    ASSERT_TRUE(router_.start());
+    logs->set_stalled(true);
+
+    router_.send(make_log(vep_LOG_LEVEL_INFO));
+    router_.lane(0).flush();  // Publish blocks in the logs lane
+    router_.send(make_signal(1.0, 1000));
+    router_.lane(1).flush();
+    EXPECT_TRUE(wait_until([&] { return signals->published() == 1; }));
+    EXPECT_EQ(logs->published(), 0u);
+
+    logs->set_stalled(false);
+    router_.stop();
+    EXPECT_EQ(logs->published(), 1u);
+}
+
+}  // namespace vep::exporter::test
@@ -0,0 +1,251 @@
+// Copyright 2025 Vehicle Edge Platform Contributors
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+/// @file pipeline_test_support.hpp
+/// @brief Transport, items and pipeline factory shared by the pipeline tests
+///
+/// Pipelines are started on a BackpressureTransport the test drives: its
+/// queue level, connection, stalls and failed publishes are set by hand,
+/// and what it published is parsed back into batches and items.
+
+#include "unified_pipeline.hpp"
+#include "transfer.pb.h"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace vep::exporter::test {
+
+/// Transport whose queue level and connection are set by the test
+class BackpressureTransport : public vep::BackendTransport {
+public:
+    bool start() override { return true; }
+    void stop() override {}
+    uint32_t content_id() const override { return 1; }
+
+    bool publish(const std::vector<uint8_t>& data, vep::Persistence persistence) override {
+        if (reject_) {
+            return false;
+        }
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (reject_next_ > 0) {
+            --reject_next_;
+            return false;
+        }
+        ++waiting_;
+        stall_cv_.wait(lock, [this] { return !stalled_; });
+        --waiting_;
+        payloads_.push_back(data);
+        persistence_.push_back(persistence);
+        return true;
+    }
+
+    bool healthy() const override { return true; }
+    bool queue_full() const override { return full_; }
+    vep::BackendTransportStats stats() const override { return {}; }
+    std::string name() const override { return "backpressure"; }
+
+    void report(vep::QueueLevel level) {
+        vep::QueueStatus status;
+        status.level = level;
+        on_queue_status_(status);
+    }
+
+    void set_full(bool full) { full_ = full; }
+
+    /// Fail every publish
+    void set_reject(bool reject) { reject_ = reject; }
+
+    /// Fail the next count publishes (not one already stalled)
+    void reject_next(int count) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        reject_next_ = count;
+    }
+
+    /// Hold publish() calls until unstalled (a stuck transport)
+    void set_stalled(bool stalled) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stalled_ = stalled;
+        }
+        stall_cv_.notify_all();
+    }
+
+    void set_connected(bool connected) {
+        vep::ConnectionStatus status;
+        status.state = connected ? vep::ConnectionState::Connected
+                                 : vep::ConnectionState::Disconnected;
+        on_connection_status_(status);
+    }
+
+    size_t published() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return payloads_.size();
+    }
+
+    /// publish() calls held by the stall
+    int waiting() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return waiting_;
+    }
+
+    /// Sequence numbers of published zstd batches, in publish order
+    std::vector<uint32_t> sequences() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<uint32_t> sequences;
+        ZstdDecompressor decompressor;
+        EXPECT_TRUE(decompressor.init());
+        for (const auto& payload : payloads_) {
+            vep::transfer::TransferBatch batch;
+            auto data = decompressor.decompress(payload);
+            EXPECT_TRUE(batch.ParseFromArray(data.data(), static_cast<int>(data.size())));
+            sequences.push_back(batch.sequence());
+        }
+        return sequences;
+    }
+
+    /// Published payloads, in publish order
+    std::vector<std::vector<uint8_t>> payloads() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return payloads_;
+    }
+
+    /// Published uncompressed batches, in publish order
+    std::vector<vep::transfer::TransferBatch> batches() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<vep::transfer::TransferBatch> batches(payloads_.size());
+        for (size_t i = 0; i < payloads_.size(); ++i) {
+            EXPECT_TRUE(batches[i].ParseFromArray(payloads_[i].data(),
+                                                  static_cast<int>(payloads_[i].size())));
+        }
+        return batches;
+    }
+
+    /// Persistence requested for each published batch
+    std::vector<vep::Persistence> persistence() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return persistence_;
+    }
+
+    /// Items of all published batches
+    std::vector<vep::transfer::TransferItem> items() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<vep::transfer::TransferItem> items;
+        for (const auto& payload : payloads_) {
+            vep::transfer::TransferBatch batch;
+            EXPECT_TRUE(batch.ParseFromArray(payload.data(), static_cast<int>(payload.size())));
+            items.insert(items.end(), batch.items().begin(), batch.items().end());
+        }
+        return items;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::condition_variable stall_cv_;
+    bool stalled_ = false;
+    int reject_next_ = 0;
+    int waiting_ = 0;
+    std::vector<std::vector<uint8_t>> payloads_;
+    std::vector<vep::Persistence> persistence_;
+    std::atomic<bool> full_{false};
+    std::atomic<bool> reject_{false};
+};
+
+/// Poll until done() holds (up to 2 s)
+template <typename Predicate>
+bool wait_until(Predicate done) {
+    for (int i = 0; i < 400 && !done(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return done();
+}
+
+inline vep_VssSignal make_signal(double value, int64_t timestamp_ms) {
+    vep_VssSignal signal = {};
+    signal.path = const_cast<char*>("Vehicle.Speed");
+    signal.header.source_id = const_cast<char*>("test");
+    signal.header.timestamp_ns = timestamp_ms * 1000000;
+    signal.header.correlation_id = const_cast<char*>("");
+    signal.quality = vep_VSS_QUALITY_VALID;
+    signal.value.type = vep_VSS_VALUE_TYPE_DOUBLE;
+    signal.value.double_value = value;
+    return signal;
+}
+
+inline vep_Event make_event(vep_Severity severity = vep_SEVERITY_WARNING) {
+    vep_Event event = {};
+    event.header.source_id = const_cast<char*>("test");
+    event.header.timestamp_ns = 1000000000;
+    event.header.correlation_id = const_cast<char*>("");
+    event.event_id = const_cast<char*>("evt-1");
+    event.category = const_cast<char*>("ADAS");
+    event.event_type = const_cast<char*>("harsh_brake");
+    event.severity = severity;
+    return event;
+}
+
+inline vep_OtelGauge make_gauge() {
+    vep_OtelGauge gauge = {};
+    gauge.header.source_id = const_cast<char*>("test");
+    gauge.header.timestamp_ns = 1000000000;
+    gauge.header.correlation_id = const_cast<char*>("");
+    gauge.name = const_cast<char*>("cpu_usage");
+    gauge.value = 42.0;
+    return gauge;
+}
+
+inline vep_OtelCounter make_counter(double value) {
+    vep_OtelCounter counter = {};
+    counter.header.source_id = const_cast<char*>("test");
+    counter.header.timestamp_ns = 1000000000;
+    counter.header.correlation_id = const_cast<char*>("");
+    counter.name = const_cast<char*>("requests");
+    counter.value = value;
+    return counter;
+}
+
+inline vep_OtelLogEntry make_log(vep_OtelLogLevel level) {
+    vep_OtelLogEntry log = {};
+    log.header.source_id = const_cast<char*>("test");
+    log.header.timestamp_ns = 1000000000;
+    log.header.correlation_id = const_cast<char*>("");
+    log.level = level;
+    log.component = const_cast<char*>("exporter");
+    log.message = const_cast<char*>("message");
+    log.trace_id = const_cast<char*>("");
+    log.span_id = const_cast<char*>("");
+    return log;
+}
+
+/// Config the pipeline tests start from: batches are built only on
+/// flush() or stop(), never on their own
+inline UnifiedPipelineConfig test_pipeline_config() {
+    UnifiedPipelineConfig config;
+    config.batch_max_items = 10000;
+    config.batch_timeout = std::chrono::milliseconds(60000);
+    return config;
+}
+
+/// Started pipeline publishing to a new BackpressureTransport, which is
+/// returned in transport
+inline std::unique_ptr<UnifiedExporterPipeline> start_pipeline(
+    const UnifiedPipelineConfig& config, BackpressureTransport*& transport,
+    CompressorType compressor = CompressorType::NONE) {
+    auto owned = std::make_unique<BackpressureTransport>();
+    transport = owned.get();
+    auto pipeline = std::make_unique<UnifiedExporterPipeline>(
+        std::move(owned), create_compressor(compressor), config);
+    EXPECT_TRUE(pipeline->start());
+    return pipeline;
+}
+
+}  // namespace vep::exporter::test
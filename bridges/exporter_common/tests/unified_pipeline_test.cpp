@@ -0,0 +1,952 @@
+// Copyright 2025 Vehicle Edge Platform Contributors
+// SPDX-License-Identifier: Apache-2.0
+
+#include "pipeline_test_support.hpp"
+#include "unified_pipeline.hpp"
+#include "wire_decoder.hpp"
+#include "transfer.pb.h"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace vep::exporter::test {
+
+// =============================================================================
+// Load Shedding Tests
+// =============================================================================
+
+class LoadSheddingTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        auto config = test_pipeline_config();
+        config.shedding.enabled = true;
+        pipeline_ = start_pipeline(config, transport_);
+    }
+
+    /// One of each type; 10 signal samples 10 ms apart
+    void send_mix() {
+        for (int i = 0; i < 10; ++i) {
+            pipeline_->send(make_signal(i, 1000 + i * 10));
+        }
+        pipeline_->send(make_event());
+        pipeline_->send(make_gauge());
+        pipeline_->send(make_log(vep_LOG_LEVEL_DEBUG));
+        pipeline_->send(make_log(vep_LOG_LEVEL_INFO));
+        pipeline_->send(make_log(vep_LOG_LEVEL_WARN));
+        pipeline_->send(make_log(vep_LOG_LEVEL_ERROR));
+    }
+
+    struct Counts {
+        size_t signals = 0;
+        size_t events = 0;
+        size_t metrics = 0;
+        size_t logs = 0;
+    };
+
+    Counts exported() {
+        pipeline_->stop();
+        Counts counts;
+        for (const auto& item : transport_->items()) {
+            counts.signals += item.has_signal() ? 1 : 0;
+            counts.events += item.has_event() ? 1 : 0;
+            counts.metrics += item.has_metric() ? 1 : 0;
+            counts.logs += item.has_log() ? 1 : 0;
+        }
+        return counts;
+    }
+
+    BackpressureTransport* transport_ = nullptr;
+    std::unique_ptr<UnifiedExporterPipeline> pipeline_;
+};
+
+TEST_F(LoadSheddingTest, NothingShedBelowHigh) {
+    transport_->report(vep::QueueLevel::Normal);
+    send_mix();
+
+    auto counts = exported();
+    EXPECT_EQ(counts.signals, 10u);
+    EXPECT_EQ(counts.events, 1u);
+    EXPECT_EQ(counts.metrics, 1u);
+    EXPECT_EQ(counts.logs, 4u);
+}
+
+TEST_F(LoadSheddingTest, HighShedsDebugAndInfoLogs) {
+    transport_->report(vep::QueueLevel::High);
+    send_mix();
+
+    auto counts = exported();
+    EXPECT_EQ(counts.signals, 10u);
+    EXPECT_EQ(counts.events, 1u);
+    EXPECT_EQ(counts.metrics, 1u);
+    EXPECT_EQ(counts.logs, 2u);
+    EXPECT_EQ(pipeline_->stats().logs_shed, 2u);
+}
+
+TEST_F(LoadSheddingTest, CriticalAlsoShedsMetricsAndWarnings) {
+    transport_->report(vep::QueueLevel::Critical);
+    send_mix();
+
+    auto counts = exported();
+    EXPECT_EQ(counts.signals, 10u);
+    EXPECT_EQ(counts.events, 1u);
+    EXPECT_EQ(counts.metrics, 0u);
+    EXPECT_EQ(counts.logs, 1u);
+
+    auto stats = pipeline_->stats();
+    EXPECT_EQ(stats.metrics_shed, 1u);
+    EXPECT_EQ(stats.logs_shed, 3u);
+    EXPECT_EQ(stats.queue_level, vep::QueueLevel::Critical);
+}
+
+TEST_F(LoadSheddingTest, FullDownsamplesSignalsButKeepsEvents) {
+    transport_->report(vep::QueueLevel::Full);
+    send_mix();
+
+    auto counts = exported();
+    EXPECT_EQ(counts.signals, 1u);
+    EXPECT_EQ(counts.events, 1u);
+    EXPECT_EQ(counts.metrics, 0u);
+    EXPECT_EQ(counts.logs, 0u);
+
+    auto stats = pipeline_->stats();
+    EXPECT_EQ(stats.signals_shed, 9u);
+    EXPECT_EQ(stats.signals_processed, 10u);
+}
+
+TEST_F(LoadSheddingTest, RecoversWhenQueueDrains) {
+    transport_->report(vep::QueueLevel::Full);
+    pipeline_->send(make_gauge());
+    transport_->report(vep::QueueLevel::Low);
+    pipeline_->send(make_gauge());
+
+    auto counts = exported();
+    EXPECT_EQ(counts.metrics, 1u);
+    EXPECT_EQ(pipeline_->stats().metrics_shed, 1u);
+    EXPECT_EQ(pipeline_->stats().queue_level, vep::QueueLevel::Low);
+}
+
+TEST_F(LoadSheddingTest, PolledQueueFullShedsAfterPublish) {
+    transport_->set_full(true);
+    pipeline_->send(make_event());
+    pipeline_->flush();
+    for (int i = 0; i < 200 && pipeline_->stats().queue_level != vep::QueueLevel::Full; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    ASSERT_EQ(transport_->published(), 1u);
+
+    pipeline_->send(make_log(vep_LOG_LEVEL_ERROR));
+    EXPECT_EQ(pipeline_->stats().logs_shed, 1u);
+    EXPECT_EQ(pipeline_->stats().queue_level, vep::QueueLevel::Full);
+}
+
+TEST_F(LoadSheddingTest, SendBatchShedsLikeSend) {
+    transport_->report(vep::QueueLevel::Critical);
+    std::vector<vep_VssSignal> signals;
+    for (int i = 0; i < 10; ++i) {
+        signals.push_back(make_signal(i, 1000 + i * 10));
+    }
+    std::vector<vep_OtelLogEntry> logs = {
+        make_log(vep_LOG_LEVEL_DEBUG), make_log(vep_LOG_LEVEL_ERROR),
+        make_log(vep_LOG_LEVEL_INFO), make_log(vep_LOG_LEVEL_WARN)};
+    std::vector<vep_OtelGauge> gauges = {make_gauge(), make_gauge()};
+    pipeline_->send_batch(signals.data(), signals.size());
+    pipeline_->send_batch(logs.data(), logs.size());
+    pipeline_->send_batch(gauges.data(), gauges.size());
+
+    auto counts = exported();
+    EXPECT_EQ(counts.signals, 10u);
+    EXPECT_EQ(counts.metrics, 0u);
+    EXPECT_EQ(counts.logs, 1u);
+
+    auto stats = pipeline_->stats();
+    EXPECT_EQ(stats.signals_processed, 10u);
+    EXPECT_EQ(stats.metrics_processed, 2u);
+    EXPECT_EQ(stats.metrics_shed, 2u);
+    EXPECT_EQ(stats.logs_processed, 4u);
+    EXPECT_EQ(stats.logs_shed, 3u);
+}
+
+TEST(LoadSheddingDisabledTest, KeepsEmbedderQueueStatusCallback) {
+    auto transport = std::make_unique<BackpressureTransport>();
+    auto* raw = transport.get();
+    std::atomic<int> reports{0};
+    raw->on_queue_status([&reports](const vep::QueueStatus&) { reports++; });
+    UnifiedExporterPipeline pipeline(std::move(transport),
+                                     create_compressor(CompressorType::NONE));
+    ASSERT_TRUE(pipeline.start());
+
+    raw->report(vep::QueueLevel::Full);
+    pipeline.send(make_log(vep_LOG_LEVEL_DEBUG));
+    pipeline.flush();
+    pipeline.stop();
+
+    EXPECT_EQ(reports.load(), 1);
+    EXPECT_EQ(pipeline.stats().logs_shed, 0u);
+}
+
+TEST(LoadSheddingPolicyTest, ShedSamplesDoNotMoveTheDeadband) {
+    auto config = test_pipeline_config();
+    config.shedding.enabled = true;
+    ExportRule rule;
+    rule.match = "**";
+    rule.action = PolicyAction::Deadband;
+    rule.change_threshold = 1.0;
+    config.policy.rules.push_back(rule);
+    BackpressureTransport* transport = nullptr;
+    auto pipeline = start_pipeline(config, transport);
+
+    transport->report(vep::QueueLevel::Full);
+    pipeline->send(make_signal(0.0, 1000));
+    pipeline->send(make_signal(5.0, 1010));  // Shed: the receiver still has 0
+    transport->report(vep::QueueLevel::Low);
+    pipeline->send(make_signal(5.5, 2000));
+    pipeline->stop();
+
+    auto items = transport->items();
+    ASSERT_EQ(items.size(), 2u);
+    EXPECT_EQ(items[1].signal().double_val(), 5.5);
+    EXPECT_EQ(pipeline->stats().signals_shed, 1u);
+}
+
+// =============================================================================
+// Adaptive Batching Tests (BatchSizeController in batch_controller_test)
+// =============================================================================
+
+TEST(AdaptiveBatchingPipelineTest, LimitsFollowObservedFlushes) {
+    auto config = test_pipeline_config();
+    config.batch_max_items = 1000;
+    config.adaptive.enabled = true;
+    config.adaptive.target_latency_ms = 250;
+    BackpressureTransport* transport = nullptr;
+    auto pipeline = start_pipeline(config, transport);
+    EXPECT_EQ(pipeline->stats().batch_limits.timeout.count(), 60000);
+
+    for (int i = 0; i < 20; ++i) {
+        pipeline->send(make_signal(i, 1000 + i));
+    }
+    pipeline->flush();
+    for (int i = 0; i < 200 && transport->published() == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    ASSERT_EQ(transport->published(), 1u);
+    pipeline->stop();
+
+    auto limits = pipeline->stats().batch_limits;
+    EXPECT_LE(limits.timeout.count(), 250);
+    EXPECT_GE(limits.max_items, config.adaptive.min_items);
+    EXPECT_LE(limits.max_bytes, config.batch_max_bytes);
+}
+
+// =============================================================================
+// Flush Stages Tests (FlushStages alone in flush_stages_test)
+// =============================================================================
+
+TEST(FlushStagesTest, PipelineKeepsBatchSequence) {
+    UnifiedPipelineConfig config;
+    config.batch_max_bytes = 512;  // Split into many batches
+    config.stages.compress_workers = 3;
+    BackpressureTransport* transport = nullptr;
+    auto pipeline = start_pipeline(config, transport, CompressorType::ZSTD);
+
+    for (int i = 0; i < 200; ++i) {
+        pipeline->send(make_event());
+    }
+    pipeline->stop();
+
+    auto sequences = transport->sequences();
+    ASSERT_GT(sequences.size(), 1u);
+    for (size_t i = 1; i < sequences.size(); ++i) {
+        EXPECT_EQ(sequences[i], sequences[i - 1] + 1);
+    }
+    EXPECT_EQ(pipeline->stats().batches_in_flight, 0u);
+}
+
+// =============================================================================
+// Store-and-Forward Tests
+// =============================================================================
+
+class StoreAndForwardTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        char dir[] = "/tmp/vep_spool_XXXXXX";
+        ASSERT_NE(mkdtemp(dir), nullptr);
+        config_ = test_pipeline_config();
+        config_.spool.enabled = true;
+        config_.spool.directory = dir;
+        config_.spool.segment_bytes = 64 * 1024;
+        config_.spool.segments = 4;
+        config_.spool.replay_bytes_per_sec = 0;  // Unlimited
+        config_.spool.retry_interval = std::chrono::milliseconds(20);
+        start();
+    }
+
+    void TearDown() override {
+        pipeline_.reset();
+        std::filesystem::remove_all(config_.spool.directory);
+    }
+
+    void start() {
+        pipeline_ = start_pipeline(config_, transport_, CompressorType::ZSTD);
+    }
+
+    /// One batch per call
+    void send_batch() {
+        uint64_t spooled = pipeline_->stats().spool.batches_spooled;
+        pipeline_->send(make_event());
+        pipeline_->flush();
+        ASSERT_TRUE(wait_until([&] { return pipeline_->stats().spool.batches_spooled > spooled; }));
+    }
+
+    UnifiedPipelineConfig config_;
+    BackpressureTransport* transport_ = nullptr;
+    std::unique_ptr<UnifiedExporterPipeline> pipeline_;
+};
+
+TEST_F(StoreAndForwardTest, DisconnectedBatchesReplayInOrderOnReconnect) {
+    transport_->set_connected(false);
+    for (int i = 0; i < 3; ++i) {
+        send_batch();
+    }
+    EXPECT_EQ(transport_->published(), 0u);
+    EXPECT_EQ(pipeline_->stats().spool.batches_pending, 3u);
+    EXPECT_EQ(pipeline_->stats().batches_sent, 0u);
+
+    transport_->set_connected(true);
+    ASSERT_TRUE(wait_until([&] { return transport_->published() == 3; }));
+    EXPECT_EQ(transport_->sequences(), (std::vector<uint32_t>{0, 1, 2}));
+
+    auto stats = pipeline_->stats();
+    EXPECT_EQ(stats.spool.batches_spooled, 3u);
+    EXPECT_EQ(stats.spool.batches_replayed, 3u);
+    EXPECT_EQ(stats.spool.batches_pending, 0u);
+    EXPECT_EQ(stats.batches_failed, 0u);
+    EXPECT_EQ(stats.batches_sent, 0u);  // Replayed, not sent live
+}
+
+TEST_F(StoreAndForwardTest, FailedPublishIsSpooledAndRetried) {
+    transport_->set_reject(true);
+    send_batch();
+    EXPECT_EQ(pipeline_->stats().batches_failed, 1u);
+    EXPECT_EQ(pipeline_->stats().batches_sent, 0u);
+
+    // Replay retries until the transport accepts it
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(pipeline_->stats().spool.batches_pending, 1u);
+    transport_->set_reject(false);
+    ASSERT_TRUE(wait_until([&] { return transport_->published() == 1; }));
+    EXPECT_EQ(pipeline_->stats().spool.batches_replayed, 1u);
+}
+
+TEST_F(StoreAndForwardTest, SpooledBatchesSurviveRestart) {
+    transport_->set_connected(false);
+    send_batch();
+    send_batch();
+    pipeline_->stop();
+
+    start();
+    EXPECT_EQ(pipeline_->stats().spool.batches_recovered, 2u);
+    ASSERT_TRUE(wait_until([&] { return transport_->published() == 2; }));
+    EXPECT_EQ(transport_->sequences(), (std::vector<uint32_t>{0, 1}));
+}
+
+TEST_F(StoreAndForwardTest, ReplayAfterRestartDecodesOnItsOwn) {
+    pipeline_.reset();
+    config_.encoding.intern_paths = true;
+    config_.encoding.metric_series = true;
+    start();
+    auto send = [&](std::vector<const char*> paths, double requests) {
+        for (const char* path : paths) {
+            auto signal = make_signal(1.0, 1000);
+            signal.path = const_cast<char*>(path);
+            pipeline_->send(signal);
+        }
+        pipeline_->send(make_counter(requests));
+        pipeline_->flush();
+    };
+
+    // First run: one batch live, the next spooled as changes to it
+    send({"Vehicle.A"}, 10);
+    ASSERT_TRUE(wait_until([&] { return transport_->published() == 1; }));
+    transport_->set_connected(false);
+    send({"Vehicle.B", "Vehicle.A"}, 15);
+    ASSERT_TRUE(wait_until([&] { return pipeline_->stats().spool.batches_spooled == 1; }));
+    auto first_run = transport_->payloads();
+    pipeline_->stop();
+
+    // Second run: ids, versions and sequences start over
+    start();
+    ASSERT_TRUE(wait_until([&] { return transport_->published() == 1; }));
+    send({"Vehicle.C"}, 100);
+    ASSERT_TRUE(wait_until([&] { return transport_->published() == 2; }));
+    send({"Vehicle.C", "Vehicle.D"}, 107);
+    ASSERT_TRUE(wait_until([&] { return transport_->published() == 3; }));
+    auto second_run = transport_->payloads();
+
+    // The replayed batch reaches the receiver between live ones
+    ZstdDecompressor decompressor;
+    ASSERT_TRUE(decompressor.init());
+    std::vector<std::vector<uint8_t>> live;
+    std::vector<std::vector<uint8_t>> replayed;
+    for (const auto& payload : second_run) {
+        auto data = decompressor.decompress(payload);
+        vep::transfer::TransferBatch batch;
+        ASSERT_TRUE(batch.ParseFromArray(data.data(), static_cast<int>(data.size())));
+        (batch.replayed() ? replayed : live).push_back(std::move(data));
+    }
+    ASSERT_EQ(live.size(), 2u);
+    ASSERT_EQ(replayed.size(), 1u);
+    std::vector<std::vector<uint8_t>> received = {decompressor.decompress(first_run[0]),
+                                                  live[0], replayed[0], live[1]};
+
+    PathDictionaryCache cache;
+    std::vector<std::string> decoded;
+    for (const auto& data : received) {
+        auto batch = decode_transfer_batch(data, cache);
+        ASSERT_TRUE(batch);
+        for (const auto& item : batch->items) {
+            if (item.signal) {
+                decoded.push_back(item.signal->path);
+            } else if (item.metric) {
+                decoded.push_back(item.metric->name + " " +
+                                  std::to_string(static_cast<int>(item.metric->value)));
+            } else {
+                decoded.push_back(item_type_to_string(item.type));
+            }
+        }
+    }
+    EXPECT_EQ(decoded, (std::vector<std::string>{"Vehicle.A", "requests 10",
+                                                 "Vehicle.C", "requests 100",
+                                                 "Vehicle.B", "Vehicle.A", "requests 15",
+                                                 "Vehicle.C", "Vehicle.D", "requests 107"}));
+}
+
+TEST_F(StoreAndForwardTest, ReplayIsRateLimited) {
+    pipeline_.reset();
+    config_.spool.replay_bytes_per_sec = 1;  // Minutes per batch
+    start();
+
+    transport_->set_connected(false);
+    for (int i = 0; i < 3; ++i) {
+        send_batch();
+    }
+    transport_->set_connected(true);
+    ASSERT_TRUE(wait_until([&] { return transport_->published() == 1; }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(transport_->published(), 1u);
+
+    // Stop does not wait out the pause; the rest stays spooled
+    auto begin = std::chrono::steady_clock::now();
+    pipeline_->stop();
+    EXPECT_LT(std::chrono::steady_clock::now() - begin, std::chrono::seconds(2));
+    EXPECT_EQ(pipeline_->stats().spool.batches_pending, 2u);
+}
+
+// =============================================================================
+// Latency Tests (LatencyHistogram alone in latency_histogram_test)
+// =============================================================================
+
+TEST(LatencyPipelineTest, StatsAndPublishedHistograms) {
+
+    std::mutex mutex;
+    std::map<std::string, vep_OtelHistogram> published;  // By label value
+    std::vector<vep_OtelHistogramBucket> signal_buckets;
+
+    auto config = test_pipeline_config();
+    config.batch_timeout = std::chrono::milliseconds(20);
+    config.latency.enabled = true;
+    config.latency.interval = std::chrono::seconds(0);  // After every flush
+    config.latency.publish = [&](const vep_OtelHistogram& msg) {
+        std::lock_guard<std::mutex> lock(mutex);
+        ASSERT_EQ(msg.labels._length, 1u);
+        std::string value = msg.labels._buffer[0].value;
+        published[value] = msg;
+        if (value == "signal") {
+            signal_buckets.assign(msg.buckets._buffer, msg.buckets._buffer + msg.buckets._length);
+        }
+    };
+    BackpressureTransport* transport = nullptr;
+    auto pipeline = start_pipeline(config, transport, CompressorType::ZSTD);
+
+    // Signals sampled 50 ms ago
+    int64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    for (int i = 0; i < 10; ++i) {
+        pipeline->send(make_signal(i, now_ms - 50));
+    }
+    pipeline->send(make_event());
+    pipeline->flush();
+    ASSERT_TRUE(wait_until([&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        return !signal_buckets.empty() && signal_buckets.back().cumulative_count == 10;
+    }));
+    pipeline->stop();
+
+    auto latency = pipeline->stats().latency;
+    EXPECT_EQ(latency.signal.count, 10u);
+    EXPECT_GE(latency.signal.p50_us, 50000);
+    EXPECT_LT(latency.signal.max_us, 10000000);
+    EXPECT_EQ(latency.event.count, 1u);  // Sampled at 1 s after the epoch
+    EXPECT_EQ(latency.metric.count, 0u);
+    EXPECT_GE(latency.build.count, 1u);
+    EXPECT_EQ(latency.compress.count, latency.build.count);
+    EXPECT_EQ(latency.batch.count, transport->published());
+    EXPECT_LE(latency.publish.max_us, latency.batch.max_us);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(std::string(published["build"].name), "vep_exporter.stage_latency_ms");
+    EXPECT_EQ(std::string(published["signal"].name), "vep_exporter.item_latency_ms");
+    EXPECT_EQ(published.count("metric"), 0u);  // Nothing recorded
+    ASSERT_FALSE(signal_buckets.empty());
+    EXPECT_TRUE(std::isinf(signal_buckets.back().upper_bound));
+    EXPECT_EQ(signal_buckets.back().cumulative_count, 10u);
+    EXPECT_EQ(signal_buckets.front().cumulative_count, 0u);  // None within 0.1 ms
+}
+
+// =============================================================================
+// Urgent Lane Tests
+// =============================================================================
+
+class UrgentLaneTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        config_.urgent.enabled = true;
+        config_.urgent.min_severity = vep_SEVERITY_ERROR;
+        pipeline_ = start_pipeline(config_, transport_);
+    }
+
+    UnifiedPipelineConfig config_ = test_pipeline_config();  // Bulk waits
+    BackpressureTransport* transport_ = nullptr;
+    std::unique_ptr<UnifiedExporterPipeline> pipeline_;
+};
+
+TEST_F(UrgentLaneTest, CriticalEventOvertakesBulkBatch) {
+    for (int i = 0; i < 100; ++i) {
+        pipeline_->send(make_signal(i, 1000 + i));
+    }
+    pipeline_->send(make_event(vep_SEVERITY_WARNING));  // Below the threshold: bulk
+
+    auto begin = std::chrono::steady_clock::now();
+    pipeline_->send(make_event(vep_SEVERITY_CRITICAL));
+    ASSERT_TRUE(wait_until([&] { return transport_->published() == 1; }));
+    EXPECT_LT(std::chrono::steady_clock::now() - begin, std::chrono::milliseconds(100));
+
+    auto batches = transport_->batches();
+    EXPECT_EQ(batches[0].source_id(), "vep_exporter/urgent");
+    EXPECT_EQ(batches[0].sequence(), 0u);
+    ASSERT_EQ(batches[0].items_size(), 1);
+    EXPECT_EQ(batches[0].items(0).event().severity(), vep::transfer::SEVERITY_CRITICAL);
+    EXPECT_EQ(transport_->persistence()[0], vep::Persistence::Volatile);
+
+    // The bulk batch is still filling
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(transport_->published(), 1u);
+
+    pipeline_->stop();
+    batches = transport_->batches();
+    ASSERT_EQ(batches.size(), 2u);
+    EXPECT_EQ(batches[1].source_id(), "vep_exporter");
+    EXPECT_EQ(batches[1].sequence(), 0u);  // Numbered on its own
+    EXPECT_EQ(batches[1].items_size(), 101);
+    EXPECT_EQ(transport_->persistence()[1], vep::Persistence::BestEffort);
+
+    auto stats = pipeline_->stats();
+    EXPECT_EQ(stats.events_processed, 2u);
+    EXPECT_EQ(stats.events_urgent, 1u);
+    EXPECT_EQ(stats.urgent_batches_sent, 1u);
+    EXPECT_EQ(stats.batches_sent, 2u);
+}
+
+TEST_F(UrgentLaneTest, BurstSharesOneExpressBatch) {
+    pipeline_.reset();
+    config_.urgent.linger = std::chrono::milliseconds(50);
+    SetUp();
+
+    for (int i = 0; i < 5; ++i) {
+        pipeline_->send(make_event(vep_SEVERITY_ERROR));
+    }
+    ASSERT_TRUE(wait_until([&] { return transport_->published() == 1; }));
+    EXPECT_EQ(transport_->batches()[0].items_size(), 5);
+    EXPECT_EQ(pipeline_->stats().events_urgent, 5u);
+}
+
+TEST_F(UrgentLaneTest, SendBatchSplitsOffUrgentEvents) {
+    std::vector<vep_Event> events = {make_event(vep_SEVERITY_WARNING),
+                                     make_event(vep_SEVERITY_CRITICAL),
+                                     make_event(vep_SEVERITY_INFO)};
+    pipeline_->send_batch(events.data(), events.size());
+    ASSERT_TRUE(wait_until([&] { return transport_->published() == 1; }));
+    EXPECT_EQ(transport_->batches()[0].source_id(), "vep_exporter/urgent");
+
+    pipeline_->stop();
+    auto batches = transport_->batches();
+    ASSERT_EQ(batches.size(), 2u);
+    ASSERT_EQ(batches[1].items_size(), 2);
+    EXPECT_EQ(batches[1].items(0).event().severity(), vep::transfer::SEVERITY_WARNING);
+    EXPECT_EQ(batches[1].items(1).event().severity(), vep::transfer::SEVERITY_INFO);
+    EXPECT_EQ(pipeline_->stats().events_processed, 3u);
+    EXPECT_EQ(pipeline_->stats().events_urgent, 1u);
+}
+
+// =============================================================================
+// Memory Budget Tests
+// =============================================================================
+
+class MemoryBudgetTest : public ::testing::Test {
+protected:
+    /// Pipeline with a stuck transport and a budget of kBudget bytes
+    void start(OverflowPolicy policy) {
+        UnifiedPipelineConfig config;
+        config.batch_max_items = 10;
+        config.stages.compress_workers = 1;
+        config.stages.queue_depth = 2;
+        config.memory.max_bytes = kBudget;
+        config.memory.policy = policy;
+        config.memory.block_timeout = std::chrono::milliseconds(20);
+        pipeline_ = start_pipeline(config, transport_);
+        transport_->set_stalled(true);
+    }
+
+    void TearDown() override {
+        if (transport_) {
+            transport_->set_stalled(false);
+        }
+    }
+
+    static constexpr size_t kBudget = 4096;
+
+    BackpressureTransport* transport_ = nullptr;
+    std::unique_ptr<UnifiedExporterPipeline> pipeline_;
+};
+
+TEST_F(MemoryBudgetTest, DropNewestBoundsMemoryWhilePublishIsStuck) {
+    start(OverflowPolicy::DropNewest);
+    for (int i = 0; i < 1000; ++i) {
+        pipeline_->send(make_signal(i, 1000 + i));
+    }
+
+    auto stats = pipeline_->stats();
+    EXPECT_GT(stats.overflow_items_dropped, 0u);
+    EXPECT_LT(stats.memory_bytes, kBudget + 200);  // At most one item over
+    EXPECT_GT(stats.memory_bytes, 0u);
+    EXPECT_EQ(stats.overflow_batches_dropped, 0u);
+
+    transport_->set_stalled(false);
+    pipeline_->stop();
+    EXPECT_EQ(transport_->items().size(), 1000 - stats.overflow_items_dropped);
+    EXPECT_EQ(pipeline_->stats().memory_bytes, 0u);
+}
+
+TEST_F(MemoryBudgetTest, BlockWaitsForRoomThenDrops) {
+    start(OverflowPolicy::Block);
+    int sent = 0;
+    while (pipeline_->stats().overflow_items_dropped == 0 && sent < 1000) {
+        pipeline_->send(make_signal(sent, 1000 + sent));
+        ++sent;
+    }
+    auto stats = pipeline_->stats();
+    EXPECT_EQ(stats.overflow_items_dropped, 1u);
+    EXPECT_GE(stats.overflow_blocked, 1u);
+
+    // Room comes back once the transport moves again
+    transport_->set_stalled(false);
+    auto blocked = stats.overflow_blocked;
+    for (int i = 0; i < 200; ++i) {
+        pipeline_->send(make_signal(i, 5000 + i));
+    }
+    pipeline_->stop();
+    stats = pipeline_->stats();
+    EXPECT_GE(stats.overflow_blocked, blocked);
+    EXPECT_EQ(transport_->items().size(), sent + 200 - stats.overflow_items_dropped);
+}
+
+TEST_F(MemoryBudgetTest, DropOldestDropsQueuedBatches) {
+    start(OverflowPolicy::DropOldest);
+    for (int i = 0; i < 1000; ++i) {
+        pipeline_->send(make_signal(i, 1000 + i));
+        if (i % 10 == 9) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));  // Let batches fill
+        }
+    }
+    auto stats = pipeline_->stats();
+    EXPECT_GT(stats.overflow_batches_dropped, 0u);
+    EXPECT_LT(stats.memory_bytes, kBudget + 2048);  // Plus the batches being built
+
+    transport_->set_stalled(false);
+    pipeline_->stop();
+    stats = pipeline_->stats();
+
+    // Newest data survives; receivers see the drops as sequence gaps
+    auto batches = transport_->batches();
+    ASSERT_GT(batches.size(), 1u);
+    EXPECT_GT(batches.back().sequence() + 1u, batches.size());
+    for (size_t i = 1; i < batches.size(); ++i) {
+        EXPECT_GT(batches[i].sequence(), batches[i - 1].sequence());
+    }
+    EXPECT_EQ(stats.batches_sent, batches.size());
+}
+
+TEST_F(MemoryBudgetTest, WindowSummariesAreAdmitted) {
+    auto config = test_pipeline_config();
+    config.memory.max_bytes = kBudget;
+    config.log_dedup.enabled = true;
+    pipeline_ = start_pipeline(config, transport_);
+
+    for (int i = 0; i < 5; ++i) {
+        pipeline_->send(make_log(vep_LOG_LEVEL_ERROR));
+    }
+    size_t gauges = 0;
+    while (pipeline_->stats().overflow_items_dropped == 0 && gauges < 1000) {
+        pipeline_->send(make_gauge());
+        ++gauges;
+    }
+    pipeline_->stop();  // Closes the window: its summary is over the budget
+
+    auto stats = pipeline_->stats();
+    EXPECT_EQ(stats.logs_collapsed, 4u);
+    EXPECT_EQ(stats.overflow_items_dropped, 2u);
+    EXPECT_EQ(transport_->items().size(), gauges);  // The first entry, not the last gauge
+}
+
+TEST_F(MemoryBudgetTest, DroppedEntriesLeaveDedupWindowsAlone) {
+    auto config = test_pipeline_config();
+    config.memory.max_bytes = 1;  // Over once the first entry is held
+    config.log_dedup.enabled = true;
+    pipeline_ = start_pipeline(config, transport_);
+
+    pipeline_->send(make_log(vep_LOG_LEVEL_ERROR));
+    for (int i = 0; i < 3; ++i) {
+        pipeline_->send(make_log(vep_LOG_LEVEL_WARN));
+    }
+    std::vector<vep_OtelLogEntry> logs(3, make_log(vep_LOG_LEVEL_INFO));
+    pipeline_->send_batch(logs.data(), logs.size());
+    pipeline_->stop();
+
+    // Dropped entries open no window, so none are counted into a summary
+    auto stats = pipeline_->stats();
+    EXPECT_EQ(stats.overflow_items_dropped, 6u);
+    EXPECT_EQ(stats.logs_collapsed, 0u);
+    EXPECT_EQ(transport_->items().size(), 1u);
+}
+
+TEST_F(MemoryBudgetTest, UrgentEventsAreNeverDropped) {
+    UnifiedPipelineConfig config;
+    config.batch_max_items = 10;
+    config.memory.max_bytes = 1;  // Always over
+    config.urgent.enabled = true;
+    config.urgent.linger = std::chrono::milliseconds(0);
+    pipeline_ = start_pipeline(config, transport_);
+
+    pipeline_->send(make_event(vep_SEVERITY_CRITICAL));
+    pipeline_->send(make_event(vep_SEVERITY_CRITICAL));
+    ASSERT_TRUE(wait_until([&] { return pipeline_->stats().urgent_batches_sent >= 1; }));
+    pipeline_->stop();
+
+    auto stats = pipeline_->stats();
+    EXPECT_EQ(stats.events_urgent, 2u);
+    EXPECT_EQ(stats.overflow_items_dropped, 0u);
+    EXPECT_EQ(transport_->items().size(), 2u);
+}
+
+// =============================================================================
+// Batch Recovery Tests
+// =============================================================================
+
+/// Pipeline interning paths, its batches held in the stages by a stuck
+/// transport
+class BatchRecoveryPipelineTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        config_.batch_max_items = 10;
+        config_.batch_timeout = std::chrono::milliseconds(60000);
+        config_.encoding.intern_paths = true;
+        config_.stages.compress_workers = 1;
+        config_.stages.queue_depth = 4;
+    }
+
+    void start(CompressorType compressor) {
+        compressor_ = compressor;
+        pipeline_ = start_pipeline(config_, transport_, compressor);
+        transport_->set_stalled(true);
+    }
+
+    void TearDown() override {
+        if (transport_) {
+            transport_->set_stalled(false);
+        }
+    }
+
+    /// Flush the items sent into a batch held in the stages
+    void flush_batch() {
+        uint64_t in_flight = pipeline_->stats().batches_in_flight;
+        pipeline_->flush();
+        ASSERT_TRUE(wait_until([&] {
+            return pipeline_->stats().batches_in_flight > in_flight;
+        }));
+    }
+
+    /// One batch of a signal per path
+    void send_batch(const std::vector<const char*>& paths) {
+        for (const char* path : paths) {
+            auto signal = make_signal(1.0, 1000);
+            signal.path = const_cast<char*>(path);
+            pipeline_->send(signal);
+        }
+        flush_batch();
+    }
+
+    /// Items of every published batch, decoded in order by one receiver
+    /// that checks each dictionary delta applies to its version
+    std::vector<DecodedItem> receive() {
+        ZstdDecompressor decompressor;
+        EXPECT_TRUE(decompressor.init());
+        PathDictionaryCache cache;
+        std::vector<DecodedItem> items;
+        for (const auto& payload : transport_->payloads()) {
+            auto data = compressor_ == CompressorType::ZSTD ? decompressor.decompress(payload)
+                                                            : payload;
+            vep::transfer::TransferBatch batch;
+            EXPECT_TRUE(batch.ParseFromArray(data.data(), static_cast<int>(data.size())));
+            if (batch.has_path_dictionary() && batch.path_dictionary().base_version() != 0) {
+                EXPECT_EQ(batch.path_dictionary().base_version(), cache.version())
+                    << "batch " << batch.sequence();
+            }
+            auto decoded = decode_transfer_batch(data, cache);
+            EXPECT_TRUE(decoded);
+            if (decoded) {
+                items.insert(items.end(), decoded->items.begin(), decoded->items.end());
+            }
+        }
+        return items;
+    }
+
+    /// Signal paths of every published batch
+    std::vector<std::string> receive_paths() {
+        std::vector<std::string> paths;
+        for (const auto& item : receive()) {
+            if (item.signal) {
+                paths.push_back(item.signal->path);
+            }
+        }
+        return paths;
+    }
+
+    UnifiedPipelineConfig config_;
+    CompressorType compressor_ = CompressorType::NONE;
+    BackpressureTransport* transport_ = nullptr;
+    std::unique_ptr<UnifiedExporterPipeline> pipeline_;
+};
+
+TEST_F(BatchRecoveryPipelineTest, FailedPublishEntriesReachTheNextBatch) {
+    start(CompressorType::ZSTD);
+    send_batch({"Vehicle.A"});
+    ASSERT_TRUE(wait_until([&] { return transport_->waiting() == 1; }));
+
+    // Built on the failed batch's entry (B) before it fails
+    send_batch({"Vehicle.B", "Vehicle.A"});
+    send_batch({"Vehicle.B", "Vehicle.C"});
+    send_batch({"Vehicle.A", "Vehicle.B", "Vehicle.C", "Vehicle.D"});
+    transport_->reject_next(1);
+    transport_->set_stalled(false);
+    pipeline_->stop();
+
+    auto stats = pipeline_->stats();
+    EXPECT_EQ(stats.batches_failed, 1u);
+    EXPECT_EQ(stats.batches_sent, 3u);
+    EXPECT_EQ(stats.batches_rewritten, 1u);
+    EXPECT_EQ(receive_paths(), (std::vector<std::string>{"Vehicle.A", "Vehicle.B", "Vehicle.C",
+                                                         "Vehicle.A", "Vehicle.B", "Vehicle.C",
+                                                         "Vehicle.D"}));
+}
+
+TEST_F(BatchRecoveryPipelineTest, DroppedBatchesEntriesReachTheNextBatch) {
+    config_.memory.max_bytes = 4096;
+    config_.memory.policy = OverflowPolicy::DropOldest;
+    start(CompressorType::NONE);
+
+    // Each batch introduces paths the later ones reuse
+    std::vector<std::string> names;
+    for (int i = 0; i < 100; ++i) {
+        names.push_back("Vehicle.Path" + std::to_string(i));
+    }
+    for (int i = 0; i < 1000; ++i) {
+        auto signal = make_signal(i, 1000 + i);
+        signal.path = const_cast<char*>(names[static_cast<size_t>(i) % names.size()].c_str());
+        pipeline_->send(signal);
+        if (i % 10 == 9) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));  // Let batches fill
+        }
+    }
+    ASSERT_GT(pipeline_->stats().overflow_batches_dropped, 0u);
+    transport_->set_stalled(false);
+    pipeline_->stop();
+
+    EXPECT_GE(pipeline_->stats().batches_rewritten, 1u);
+    auto paths = receive_paths();
+    EXPECT_EQ(paths.size(), transport_->items().size());
+    for (const auto& path : paths) {
+        EXPECT_EQ(path.rfind("Vehicle.Path", 0), 0u) << path;
+    }
+}
+
+TEST_F(BatchRecoveryPipelineTest, SeriesValuesSurviveAFailedPublish) {
+    for (bool direct : {false, true}) {
+        SCOPED_TRACE(direct ? "direct" : "staged");
+        config_.encoding.metric_series = true;
+        config_.encoding.direct_encoding = direct;
+        start(CompressorType::NONE);
+
+        // A counter and a histogram, sent as changes after the first batch
+        vep_OtelHistogramBucket buckets[2];
+        for (uint64_t i = 1; i <= 4; ++i) {
+            pipeline_->send(make_counter(static_cast<double>(10 * i)));
+
+            buckets[0] = {1.0, i};
+            buckets[1] = {2.0, 3 * i};
+            vep_OtelHistogram hist = {};
+            hist.header.source_id = const_cast<char*>("test");
+            hist.header.timestamp_ns = 1000000000;
+            hist.header.correlation_id = const_cast<char*>("");
+            hist.name = const_cast<char*>("latency");
+            hist.sample_count = 3 * i;
+            hist.sample_sum = 1.5 * static_cast<double>(i);
+            hist.buckets._length = hist.buckets._maximum = 2;
+            hist.buckets._buffer = buckets;
+            pipeline_->send(hist);
+            flush_batch();
+            if (i == 1) {
+                ASSERT_TRUE(wait_until([&] { return transport_->waiting() == 1; }));
+            }
+        }
+        transport_->reject_next(1);
+        transport_->set_stalled(false);
+        pipeline_->stop();
+        EXPECT_EQ(pipeline_->stats().batches_rewritten, 1u);
+
+        // The third batch's changes apply to the lost second batch's values
+        std::vector<std::string> metrics;
+        for (const auto& item : receive()) {
+            ASSERT_TRUE(item.metric);
+            std::string line = item.metric->name + " " +
+                               std::to_string(static_cast<int>(item.metric->value));
+            for (uint64_t count : item.metric->bucket_counts) {
+                line += " " + std::to_string(count);
+            }
+            metrics.push_back(line);
+        }
+        EXPECT_EQ(metrics, (std::vector<std::string>{"requests 10", "latency 0 1 3",
+                                                     "requests 30", "latency 0 3 9",
+                                                     "requests 40", "latency 0 4 12"}));
+    }
+}
+
+}  // namespace vep::exporter::test
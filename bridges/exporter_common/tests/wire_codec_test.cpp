@@ -10,11 +10,20 @@
 /// 3. The decoded values match the original input
 
 #include "batch_builder.hpp"
+#include "compressor.hpp"
+#include "direct_encoder.hpp"
 #include "wire_decoder.hpp"
 #include "wire_encoder.hpp"
 
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <cstring>
+#include <functional>
+#include <limits>
+#include <map>
+#include <tuple>
+#include <string>
+#include <vector>
 
 namespace vep::exporter::test {
 
@@ -444,6 +453,1548 @@ TEST_F(MixedTypesRoundTripTest, InterleavedItems) {
     EXPECT_EQ(decoded->items[4].type, DecodedItemType::SIGNAL);
 }
 
+// =============================================================================
+// Path Interning Round-Trip Tests
+// =============================================================================
+
+class PathInterningRoundTripTest : public ::testing::Test {
+protected:
+    static BatchBuilderConfig interning_config(uint32_t refresh_batches = 100) {
+        BatchBuilderConfig config;
+        config.intern_paths = true;
+        config.path_dictionary_refresh_batches = refresh_batches;
+        return config;
+    }
+};
+
+TEST_F(PathInterningRoundTripTest, PathsReplacedByIds) {
+    UnifiedBatchBuilder builder("test_source", 100, interning_config());
+    builder.add(create_double_signal("Vehicle.Speed", 1.0, 1000000000));
+    builder.add(create_double_signal("Vehicle.Speed", 2.0, 1001000000));
+    builder.add(create_double_signal("Vehicle.Chassis.SteeringWheel.Angle", 3.0, 1002000000));
+
+    auto data = builder.build();
+    vep::transfer::TransferBatch batch;
+    ASSERT_TRUE(batch.ParseFromArray(data.data(), static_cast<int>(data.size())));
+
+    ASSERT_EQ(batch.items_size(), 3);
+    EXPECT_FALSE(batch.items(0).signal().has_path());
+    EXPECT_EQ(batch.items(0).signal().path_id(), batch.items(1).signal().path_id());
+    EXPECT_NE(batch.items(0).signal().path_id(), batch.items(2).signal().path_id());
+
+    ASSERT_TRUE(batch.has_path_dictionary());
+    EXPECT_EQ(batch.path_dictionary().entries_size(), 2);
+    EXPECT_EQ(builder.path_dictionary_size(), 2);
+}
+
+TEST_F(PathInterningRoundTripTest, DecodeResolvesIdsAcrossBatches) {
+    UnifiedBatchBuilder builder("test_source", 100, interning_config());
+    PathDictionaryCache paths;
+
+    builder.add(create_double_signal("Vehicle.Speed", 1.0, 1000000000));
+    auto first = decode_transfer_batch(builder.build(), paths);
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(first->items[0].signal->path, "Vehicle.Speed");
+
+    // Second batch only carries the new path in its delta
+    builder.add(create_double_signal("Vehicle.Speed", 2.0, 1001000000));
+    builder.add(create_int32_signal("Vehicle.Cabin.Door.Row1.Left.IsOpen", 1, 1001000000));
+    auto data = builder.build();
+
+    vep::transfer::TransferBatch batch;
+    ASSERT_TRUE(batch.ParseFromArray(data.data(), static_cast<int>(data.size())));
+    ASSERT_TRUE(batch.has_path_dictionary());
+    EXPECT_EQ(batch.path_dictionary().entries_size(), 1);
+    EXPECT_EQ(batch.path_dictionary().base_version(), 1);
+
+    auto second = decode_transfer_batch(data, paths);
+    ASSERT_TRUE(second.has_value());
+    ASSERT_EQ(second->signal_count(), 2);
+    EXPECT_EQ(second->items[0].signal->path, "Vehicle.Speed");
+    EXPECT_EQ(second->items[1].signal->path, "Vehicle.Cabin.Door.Row1.Left.IsOpen");
+    EXPECT_EQ(paths.size(), 2);
+}
+
+TEST_F(PathInterningRoundTripTest, NoDictionaryWhenNothingNew) {
+    UnifiedBatchBuilder builder("test_source", 100, interning_config());
+
+    builder.add(create_double_signal("Vehicle.Speed", 1.0, 1000000000));
+    builder.build();
+
+    builder.add(create_double_signal("Vehicle.Speed", 2.0, 1001000000));
+    auto data = builder.build();
+
+    vep::transfer::TransferBatch batch;
+    ASSERT_TRUE(batch.ParseFromArray(data.data(), static_cast<int>(data.size())));
+    EXPECT_FALSE(batch.has_path_dictionary());
+}
+
+TEST_F(PathInterningRoundTripTest, PeriodicSnapshotRecoversLateReceiver) {
+    UnifiedBatchBuilder builder("test_source", 100, interning_config(2));
+
+    builder.add(create_double_signal("Vehicle.Speed", 1.0, 1000000000));
+    builder.build();  // Receiver never sees this batch
+    builder.add(create_double_signal("Vehicle.Speed", 2.0, 1001000000));
+    builder.build();
+    builder.add(create_double_signal("Vehicle.Speed", 3.0, 1002000000));
+    auto data = builder.build();
+
+    PathDictionaryCache paths;
+    auto decoded = decode_transfer_batch(data, paths);
+    ASSERT_TRUE(decoded.has_value());
+    EXPECT_EQ(decoded->items[0].signal->path, "Vehicle.Speed");
+}
+
+TEST_F(PathInterningRoundTripTest, ResendAfterLostBatch) {
+    UnifiedBatchBuilder builder("test_source", 100, interning_config(0));
+
+    builder.add(create_double_signal("Vehicle.Speed", 1.0, 1000000000));
+    builder.build();  // Lost
+    builder.resend_path_dictionary();
+
+    builder.add(create_double_signal("Vehicle.Speed", 2.0, 1001000000));
+    PathDictionaryCache paths;
+    auto decoded = decode_transfer_batch(builder.build(), paths);
+    ASSERT_TRUE(decoded.has_value());
+    EXPECT_EQ(decoded->items[0].signal->path, "Vehicle.Speed");
+}
+
+TEST_F(PathInterningRoundTripTest, UnknownIdWithoutDictionary) {
+    UnifiedBatchBuilder builder("test_source", 100, interning_config(0));
+
+    builder.add(create_double_signal("Vehicle.Speed", 1.0, 1000000000));
+    builder.build();
+    builder.add(create_double_signal("Vehicle.Speed", 2.0, 1001000000));
+
+    auto decoded = decode_transfer_batch(builder.build());
+    ASSERT_TRUE(decoded.has_value());
+    EXPECT_EQ(decoded->items[0].signal->path, "<path_id:1>");
+}
+
+TEST_F(PathInterningRoundTripTest, DictionaryLimitFallsBackToStrings) {
+    BatchBuilderConfig config = interning_config();
+    config.path_dictionary_max_entries = 1;
+    UnifiedBatchBuilder builder("test_source", 100, config);
+
+    builder.add(create_double_signal("Vehicle.Speed", 1.0, 1000000000));
+    builder.add(create_double_signal("Vehicle.Cabin.Temperature", 21.0, 1000000000));
+
+    auto decoded = decode_transfer_batch(builder.build());
+    ASSERT_TRUE(decoded.has_value());
+    EXPECT_EQ(decoded->items[0].signal->path, "Vehicle.Speed");
+    EXPECT_EQ(decoded->items[1].signal->path, "Vehicle.Cabin.Temperature");
+    EXPECT_EQ(builder.path_dictionary_size(), 1);
+}
+
+TEST(PathDictionaryCacheTest, DetectsMissedDelta) {
+    PathDictionaryCache paths;
+
+    vep::transfer::PathDictionary snapshot;
+    snapshot.set_version(1);
+    auto* entry = snapshot.add_entries();
+    entry->set_id(1);
+    entry->set_path("Vehicle.Speed");
+    EXPECT_TRUE(paths.apply(snapshot));
+
+    vep::transfer::PathDictionary delta;
+    delta.set_base_version(2);  // Version 2 was never received
+    delta.set_version(3);
+    entry = delta.add_entries();
+    entry->set_id(3);
+    entry->set_path("Vehicle.Cabin.Temperature");
+    EXPECT_FALSE(paths.apply(delta));
+
+    EXPECT_EQ(paths.version(), 3);
+    ASSERT_NE(paths.find(3), nullptr);
+    EXPECT_EQ(*paths.find(3), "Vehicle.Cabin.Temperature");
+    EXPECT_EQ(paths.find(2), nullptr);
+}
+
+TEST(PathDictionaryCacheTest, IgnoresStaleSnapshotWithinSession) {
+    PathDictionaryCache paths;
+    paths.begin_batch(7, 42);
+
+    vep::transfer::PathDictionary snapshot;
+    snapshot.set_version(5);
+    auto* entry = snapshot.add_entries();
+    entry->set_id(1);
+    entry->set_path("Vehicle.Speed");
+    EXPECT_TRUE(paths.apply(snapshot));
+
+    // A late batch's snapshot neither clears entries nor goes back
+    vep::transfer::PathDictionary stale;
+    stale.set_version(2);
+    EXPECT_FALSE(paths.apply(stale));
+    EXPECT_EQ(paths.version(), 5);
+    ASSERT_NE(paths.find(1), nullptr);
+
+    // Another run of the sender starts over
+    paths.begin_batch(0, 43);
+    EXPECT_EQ(paths.find(1), nullptr);
+    EXPECT_TRUE(paths.apply(stale));
+    EXPECT_EQ(paths.version(), 2);
+}
+
+// =============================================================================
+// Direct Encoding Tests (byte-compatible with the generated encoder)
+// =============================================================================
+
+class DirectEncodingTest : public ::testing::Test {
+protected:
+    template<typename Seq>
+    static void set_sequence(Seq& seq, decltype(Seq::_buffer) buffer, uint32_t length) {
+        seq._maximum = length;
+        seq._length = length;
+        seq._buffer = buffer;
+        seq._release = false;
+    }
+
+    static BatchBuilderConfig direct_config(bool intern_paths = false) {
+        BatchBuilderConfig config;
+        config.direct_encoding = true;
+        config.intern_paths = intern_paths;
+        return config;
+    }
+
+    /// Feed the same items to a generated-encoder builder and a direct
+    /// builder and require identical bytes
+    static void expect_same_bytes(const std::function<void(UnifiedBatchBuilder&)>& add) {
+        UnifiedBatchBuilder generated("test_source", 100);
+        UnifiedBatchBuilder direct("test_source", 100, direct_config());
+        add(generated);
+        add(direct);
+        EXPECT_EQ(direct.size(), generated.size());
+        EXPECT_EQ(direct.build(), generated.build());
+    }
+};
+
+TEST_F(DirectEncodingTest, ScalarValues) {
+    expect_same_bytes([](UnifiedBatchBuilder& builder) {
+        builder.add(create_double_signal("Vehicle.Speed", 100.5, 1000000000));
+        builder.add(create_double_signal("Vehicle.Speed", 0.0, 1001000000));
+        builder.add(create_int32_signal("Vehicle.Temp", -40, 1002000000));
+        builder.add(create_int32_signal("Vehicle.Temp", 0, 1002000000));
+        builder.add(create_string_signal("Vehicle.VIN", "WVWZZZ1JZXW000001", 1003000000));
+        builder.add(create_string_signal("Vehicle.VIN", "", 1003000000));
+        builder.add(create_bool_signal("Vehicle.IsMoving", false, 1004000000));
+
+        auto signal = create_double_signal("", 0.0, 1005000000);
+        signal.quality = vep_VSS_QUALITY_NOT_AVAILABLE;
+        signal.value.type = vep_VSS_VALUE_TYPE_INT8;
+        signal.value.int8_value = 200;
+        builder.add(signal);
+        signal.value.type = vep_VSS_VALUE_TYPE_INT64;
+        signal.value.int64_value = -1234567890123LL;
+        builder.add(signal);
+        signal.value.type = vep_VSS_VALUE_TYPE_UINT16;
+        signal.value.uint16_value = 65535;
+        builder.add(signal);
+        signal.value.type = vep_VSS_VALUE_TYPE_UINT64;
+        signal.value.uint64_value = UINT64_MAX;
+        builder.add(signal);
+        signal.value.type = vep_VSS_VALUE_TYPE_FLOAT;
+        signal.value.float_value = -1.5f;
+        builder.add(signal);
+        signal.value.type = vep_VSS_VALUE_TYPE_EMPTY;
+        builder.add(signal);
+        signal.path = nullptr;
+        builder.add(signal);
+    });
+}
+
+TEST_F(DirectEncodingTest, ArrayValues) {
+    bool bools[] = {true, false, true};
+    int8_t int8s[] = {-1, 0, 127};
+    int32_t int32s[] = {-100000, 0, 100000};
+    uint16_t uint16s[] = {1, 300, 65535};
+    uint64_t uint64s[] = {0, 1ULL << 40};
+    float floats[] = {1.5f, -2.25f};
+    double doubles[] = {3.14159, -0.0};
+    char* strings[] = {const_cast<char*>("a"), nullptr, const_cast<char*>("")};
+
+    expect_same_bytes([&](UnifiedBatchBuilder& builder) {
+        auto signal = create_double_signal("Vehicle.Array", 0.0, 1000000000);
+
+        signal.value.type = vep_VSS_VALUE_TYPE_BOOL_ARRAY;
+        set_sequence(signal.value.bool_array, bools, 3);
+        builder.add(signal);
+        signal.value.type = vep_VSS_VALUE_TYPE_INT8_ARRAY;
+        set_sequence(signal.value.int8_array, int8s, 3);
+        builder.add(signal);
+        signal.value.type = vep_VSS_VALUE_TYPE_INT32_ARRAY;
+        set_sequence(signal.value.int32_array, int32s, 3);
+        builder.add(signal);
+        signal.value.type = vep_VSS_VALUE_TYPE_UINT16_ARRAY;
+        set_sequence(signal.value.uint16_array, uint16s, 3);
+        builder.add(signal);
+        signal.value.type = vep_VSS_VALUE_TYPE_UINT64_ARRAY;
+        set_sequence(signal.value.uint64_array, uint64s, 2);
+        builder.add(signal);
+        signal.value.type = vep_VSS_VALUE_TYPE_FLOAT_ARRAY;
+        set_sequence(signal.value.float_array, floats, 2);
+        builder.add(signal);
+        signal.value.type = vep_VSS_VALUE_TYPE_DOUBLE_ARRAY;
+        set_sequence(signal.value.double_array, doubles, 2);
+        builder.add(signal);
+        signal.value.type = vep_VSS_VALUE_TYPE_STRING_ARRAY;
+        set_sequence(signal.value.string_array, strings, 3);
+        builder.add(signal);
+
+        // Empty and unset arrays still set the oneof
+        signal.value.type = vep_VSS_VALUE_TYPE_INT64_ARRAY;
+        set_sequence(signal.value.int64_array, nullptr, 0);
+        builder.add(signal);
+        signal.value.type = vep_VSS_VALUE_TYPE_UINT32_ARRAY;
+        set_sequence(signal.value.uint32_array, nullptr, 0);
+        builder.add(signal);
+    });
+}
+
+TEST_F(DirectEncodingTest, StructValues) {
+    int32_t int32s[] = {1, -2};
+    vep_VssStructField fields[3] = {};
+    fields[0].name = const_cast<char*>("lat");
+    fields[0].type = vep_VSS_VALUE_TYPE_DOUBLE;
+    fields[0].double_value = 48.1374;
+    fields[1].name = const_cast<char*>("");
+    fields[1].type = vep_VSS_VALUE_TYPE_INT32_ARRAY;
+    set_sequence(fields[1].int32_array, int32s, 2);
+    fields[2].name = const_cast<char*>("label");
+    fields[2].type = vep_VSS_VALUE_TYPE_UINT8_ARRAY;  // Not supported in struct fields
+
+    vep_VssStructValue structs[2] = {};
+    structs[0].type_name = const_cast<char*>("Types.Location");
+    set_sequence(structs[0].fields, fields, 3);
+    structs[1].type_name = nullptr;
+
+    expect_same_bytes([&](UnifiedBatchBuilder& builder) {
+        auto signal = create_double_signal("Vehicle.CurrentLocation", 0.0, 1000000000);
+        signal.value.type = vep_VSS_VALUE_TYPE_STRUCT;
+        signal.value.struct_value = structs[0];
+        builder.add(signal);
+
+        signal.value.type = vep_VSS_VALUE_TYPE_STRUCT_ARRAY;
+        set_sequence(signal.value.struct_array, structs, 2);
+        builder.add(signal);
+    });
+}
+
+TEST_F(DirectEncodingTest, MultiByteLengthPrefixes) {
+    std::string medium(200, 'x');
+    std::string large(20000, 'y');
+
+    expect_same_bytes([&](UnifiedBatchBuilder& builder) {
+        builder.add(create_string_signal("Vehicle.Medium", medium.c_str(), 1000000000));
+        builder.add(create_string_signal("Vehicle.Large", large.c_str(), 1000000000));
+    });
+}
+
+TEST_F(DirectEncodingTest, EventsMetricsAndLogs) {
+    vep_KeyValue labels[] = {
+        {const_cast<char*>("cpu"), const_cast<char*>("0")},
+        {nullptr, const_cast<char*>("skipped")},
+        {const_cast<char*>("mode"), nullptr},
+    };
+    vep_OtelHistogramBucket buckets[] = {{0.5, 3}, {1.0, 200}, {1e9, 100000}};
+
+    expect_same_bytes([&](UnifiedBatchBuilder& builder) {
+        builder.add(create_event("evt_1", "ADAS", vep_SEVERITY_CRITICAL));
+        builder.add(create_event("", "", vep_SEVERITY_INFO));
+
+        auto gauge = create_gauge("cpu_usage", 0.0);
+        set_sequence(gauge.labels, labels, 3);
+        builder.add(gauge);
+
+        auto counter = create_counter("", 42.0);
+        counter.header.source_id = nullptr;
+        builder.add(counter);
+
+        vep_OtelHistogram hist = {};
+        hist.header.source_id = const_cast<char*>("test");
+        hist.header.timestamp_ns = 1002000000;
+        hist.name = const_cast<char*>("latency");
+        hist.sample_count = 100203;
+        hist.sample_sum = 1234.5;
+        set_sequence(hist.buckets, buckets, 3);
+        set_sequence(hist.labels, labels, 1);
+        builder.add(hist);
+        hist.sample_count = 0;
+        hist.sample_sum = -0.0;
+        set_sequence(hist.buckets, nullptr, 0);
+        builder.add(hist);
+
+        auto log = create_log("exporter", "Connection established", vep_LOG_LEVEL_DEBUG);
+        set_sequence(log.attributes, labels, 3);
+        builder.add(log);
+        builder.add(create_log("", "", vep_LOG_LEVEL_ERROR));
+    });
+}
+
+TEST_F(DirectEncodingTest, InternedPathsMatchAndDecode) {
+    BatchBuilderConfig interning;
+    interning.intern_paths = true;
+    UnifiedBatchBuilder generated("test_source", 100, interning);
+    UnifiedBatchBuilder direct("test_source", 100, direct_config(true));
+    PathDictionaryCache paths;
+
+    for (auto* builder : {&generated, &direct}) {
+        builder->add(create_double_signal("Vehicle.Speed", 1.0, 1000000000));
+        builder->add(create_double_signal("Vehicle.Speed", 2.0, 1001000000));
+    }
+    auto first = direct.build();
+    EXPECT_EQ(first, generated.build());
+
+    for (auto* builder : {&generated, &direct}) {
+        builder->add(create_int32_signal("Vehicle.Cabin.Door.Row1.Left.IsOpen", 1, 1002000000));
+        builder->add(create_double_signal("Vehicle.Speed", 3.0, 1002000000));
+    }
+    auto second = direct.build();
+    EXPECT_EQ(second, generated.build());
+
+    ASSERT_TRUE(decode_transfer_batch(first, paths).has_value());
+    auto decoded = decode_transfer_batch(second, paths);
+    ASSERT_TRUE(decoded.has_value());
+    ASSERT_EQ(decoded->signal_count(), 2);
+    EXPECT_EQ(decoded->items[0].signal->path, "Vehicle.Cabin.Door.Row1.Left.IsOpen");
+    EXPECT_EQ(decoded->items[1].signal->path, "Vehicle.Speed");
+}
+
+TEST_F(DirectEncodingTest, BatchIsWireCompatibleNotByteIdentical) {
+    auto config = direct_config(true);
+    config.string_table = true;
+    UnifiedBatchBuilder direct("test_source", 100, config);
+    direct.add(create_double_signal("Vehicle.Speed", 1.0, 1000000000));
+    direct.add(create_gauge("cpu_usage_percent", 45.5));
+    auto data = direct.build();
+
+    vep::transfer::TransferBatch batch;
+    ASSERT_TRUE(batch.ParseFromArray(data.data(), static_cast<int>(data.size())));
+    ASSERT_TRUE(batch.has_path_dictionary());
+    ASSERT_GT(batch.strings_size(), 0);
+
+    // Same fields, but the string table precedes the dictionary
+    std::string serialized = batch.SerializeAsString();
+    std::string bytes(data.begin(), data.end());
+    EXPECT_EQ(bytes.size(), serialized.size());
+    EXPECT_NE(bytes, serialized);
+
+    // Items follow in the bytes generated code writes
+    vep::transfer::TransferBatch head = batch;
+    head.clear_items();
+    size_t items = serialized.size() - head.SerializeAsString().size();
+    EXPECT_EQ(bytes.substr(bytes.size() - items), serialized.substr(serialized.size() - items));
+}
+
+TEST_F(DirectEncodingTest, LogTemplatesAndRepeatsMatchAndDecode) {
+    BatchBuilderConfig templates;
+    templates.log_templates = true;
+    templates.intern_paths = true;
+    auto direct_templates = direct_config(true);
+    direct_templates.log_templates = true;
+    UnifiedBatchBuilder generated("test_source", 100, templates);
+    UnifiedBatchBuilder direct("test_source", 100, direct_templates);
+    PathDictionaryCache paths;
+
+    LogRepeat repeat;
+    repeat.count = 12;
+    repeat.last_timestamp_ms = 1000 + 4500;
+    for (auto* builder : {&generated, &direct}) {
+        builder->add(create_log("mqtt", "connect to 10.0.0.5:1883 failed (rc=7)", vep_LOG_LEVEL_ERROR));
+        builder->add(create_double_signal("Vehicle.Speed", 1.0, 1000000000));
+        builder->add(create_log("mqtt", "connect to 10.0.0.6:1883 failed (rc=5)", vep_LOG_LEVEL_ERROR),
+                     repeat);
+        builder->add(create_log("mqtt", "pattern <*> in 3 topics", vep_LOG_LEVEL_WARN));
+        builder->add(create_log("mqtt", "", vep_LOG_LEVEL_INFO));
+    }
+    auto data = direct.build();
+    EXPECT_EQ(data, generated.build());
+    EXPECT_EQ(direct.log_template_count(), 1u);
+    EXPECT_EQ(direct.path_dictionary_size(), 2u);
+
+    auto decoded = decode_transfer_batch(data, paths);
+    ASSERT_TRUE(decoded.has_value());
+    ASSERT_EQ(decoded->log_count(), 4);
+    const auto& first = *decoded->items[0].log;
+    EXPECT_EQ(first.message, "connect to 10.0.0.5:1883 failed (rc=7)");
+    EXPECT_NE(first.template_id, 0u);
+    EXPECT_EQ(first.repeat_count, 1u);
+    EXPECT_EQ(decoded->items[1].signal->path, "Vehicle.Speed");
+
+    const auto& repeated = *decoded->items[2].log;
+    EXPECT_EQ(repeated.message, "connect to 10.0.0.6:1883 failed (rc=5)");
+    EXPECT_EQ(repeated.template_id, first.template_id);
+    EXPECT_EQ(repeated.repeat_count, 12u);
+    EXPECT_EQ(repeated.last_timestamp_ms, repeated.timestamp_ms + 4500);
+
+    // Not templatable: sent verbatim
+    EXPECT_EQ(decoded->items[3].log->message, "pattern <*> in 3 topics");
+    EXPECT_EQ(decoded->items[3].log->template_id, 0u);
+    EXPECT_EQ(decoded->items[4].log->message, "");
+
+    // Without the dictionary the template id and parameters still show
+    vep::transfer::TransferBatch batch;
+    ASSERT_TRUE(batch.ParseFromArray(data.data(), static_cast<int>(data.size())));
+    batch.clear_path_dictionary();
+    std::vector<uint8_t> stripped(batch.ByteSizeLong());
+    batch.SerializeToArray(stripped.data(), static_cast<int>(stripped.size()));
+    auto unresolved = decode_transfer_batch(stripped);
+    ASSERT_TRUE(unresolved.has_value());
+    EXPECT_EQ(unresolved->items[0].log->message,
+              "<template_id:" + std::to_string(first.template_id) + "> 10.0.0.5 1883 7");
+}
+
+TEST_F(DirectEncodingTest, LogTemplatesShrinkRepeatedMessages) {
+    BatchBuilderConfig templates;
+    templates.log_templates = true;
+    UnifiedBatchBuilder plain("test_source", 1000);
+    UnifiedBatchBuilder templated("test_source", 1000, templates);
+
+    std::vector<std::string> messages;
+    for (int i = 0; i < 200; ++i) {
+        messages.push_back("sensor read timeout on bus " + std::to_string(i % 4) +
+                           " after " + std::to_string(100 + i) + " ms, retrying");
+    }
+    for (auto* builder : {&plain, &templated}) {
+        for (const auto& message : messages) {
+            builder->add(create_log("can_probe", message.c_str(), vep_LOG_LEVEL_WARN));
+        }
+    }
+    auto plain_size = plain.build().size();
+    auto templated_size = templated.build().size();
+    EXPECT_LT(templated_size * 2, plain_size);
+}
+
+TEST_F(DirectEncodingTest, EstimatedSizeIsExactItemBytes) {
+    UnifiedBatchBuilder builder("test_source", 100, direct_config());
+    builder.add(create_double_signal("Vehicle.Speed", 100.5, 1000000000));
+    builder.add(create_gauge("memory_usage", 8192.0));
+
+    std::vector<uint8_t> items;
+    encode_signal_item(items, create_double_signal("Vehicle.Speed", 100.5, 1000000000), 0);
+    encode_gauge_item(items, create_gauge("memory_usage", 8192.0), 0);
+    EXPECT_EQ(builder.estimated_size(), items.size());
+
+    std::vector<uint8_t> header;
+    encode_batch_header(header, 1000, "test_source", 0);
+    auto data = builder.build();
+    EXPECT_EQ(data.size(), header.size() + items.size());
+    EXPECT_EQ(builder.estimated_size(), 0);
+    EXPECT_FALSE(builder.ready());
+}
+
+// =============================================================================
+// Signal Block Tests (columnar encoding of same-path samples)
+// =============================================================================
+
+class SignalBlockTest : public ::testing::Test {
+protected:
+    static BatchBuilderConfig block_config(bool direct = false, bool arena = false) {
+        BatchBuilderConfig config;
+        config.signal_blocks = true;
+        config.direct_encoding = direct;
+        config.use_arena = arena;
+        return config;
+    }
+
+    /// Periodic CAN-derived signals: wheel speeds and steering angle scaled
+    /// from raw integers, pack current as float, gear as uint32
+    static void add_can_frames(UnifiedBatchBuilder& builder, int samples) {
+        static const char* const kWheels[] = {
+            "Vehicle.Chassis.Axle.Row1.Wheel.Left.Speed",
+            "Vehicle.Chassis.Axle.Row1.Wheel.Right.Speed",
+            "Vehicle.Chassis.Axle.Row2.Wheel.Left.Speed",
+            "Vehicle.Chassis.Axle.Row2.Wheel.Right.Speed",
+        };
+        for (int i = 0; i < samples; ++i) {
+            int64_t ts = 1700000000000000000LL + i * 10000000LL;  // 100 Hz
+            for (int w = 0; w < 4; ++w) {
+                builder.add(create_double_signal(kWheels[w], (8000 + i / 3 + w) * 0.01, ts));
+            }
+            builder.add(create_double_signal("Vehicle.Chassis.SteeringWheel.Angle",
+                                             (i % 40 - 20) * 0.1, ts));
+
+            auto current = create_double_signal(
+                "Vehicle.Powertrain.TractionBattery.CurrentCurrent", 0.0, ts);
+            current.value.type = vep_VSS_VALUE_TYPE_FLOAT;
+            current.value.float_value = -120.5f + static_cast<float>(i % 7) * 0.5f;
+            builder.add(current);
+        }
+    }
+
+    static std::vector<DecodedSignal> sorted_signals(const DecodedTransferBatch& batch) {
+        std::vector<DecodedSignal> signals;
+        for (const auto& item : batch.items) {
+            if (item.signal) {
+                signals.push_back(*item.signal);
+            }
+        }
+        std::stable_sort(signals.begin(), signals.end(),
+                         [](const DecodedSignal& a, const DecodedSignal& b) {
+                             return std::tie(a.path, a.timestamp_ms) <
+                                    std::tie(b.path, b.timestamp_ms);
+                         });
+        return signals;
+    }
+
+    static bool same_scalar(const DecodedValue& a, const DecodedValue& b) {
+        if (a.index() != b.index()) {
+            return false;
+        }
+        return std::visit([&b](const auto& value) {
+            using T = std::decay_t<decltype(value)>;
+            if constexpr (std::is_arithmetic_v<T>) {
+                return value == std::get<T>(b);
+            } else {
+                return false;
+            }
+        }, a);
+    }
+
+    static void expect_same_signals(const std::vector<uint8_t>& blocks,
+                                    const std::vector<uint8_t>& rows) {
+        auto decoded_blocks = decode_transfer_batch(blocks);
+        auto decoded_rows = decode_transfer_batch(rows);
+        ASSERT_TRUE(decoded_blocks.has_value());
+        ASSERT_TRUE(decoded_rows.has_value());
+        EXPECT_EQ(decoded_blocks->base_timestamp_ms, decoded_rows->base_timestamp_ms);
+
+        auto a = sorted_signals(*decoded_blocks);
+        auto b = sorted_signals(*decoded_rows);
+        ASSERT_EQ(a.size(), b.size());
+        for (size_t i = 0; i < a.size(); ++i) {
+            EXPECT_EQ(a[i].path, b[i].path);
+            EXPECT_EQ(a[i].timestamp_ms, b[i].timestamp_ms) << a[i].path << " #" << i;
+            EXPECT_EQ(a[i].quality, b[i].quality);
+            EXPECT_TRUE(same_scalar(a[i].value, b[i].value))
+                << a[i].path << " #" << i << ": " << value_to_string(a[i].value)
+                << " vs " << value_to_string(b[i].value);
+        }
+    }
+};
+
+TEST_F(SignalBlockTest, XorRoundTripsEdgeValues) {
+    std::vector<double> doubles = {
+        0.0, -0.0, 1.0, 1.0, 1.0000000001, -3.5e300, 5e-324,
+        std::numeric_limits<double>::infinity(), std::numeric_limits<double>::quiet_NaN(),
+        42.0, 42.0, 42.25, 1e-10, 0.0,
+    };
+    std::vector<uint64_t> bits;
+    for (double d : doubles) {
+        uint64_t b;
+        std::memcpy(&b, &d, sizeof(b));
+        bits.push_back(b);
+    }
+    std::string stream;
+    xor_encode(bits.data(), bits.size(), 64, &stream);
+    std::vector<uint64_t> decoded;
+    ASSERT_TRUE(xor_decode(stream, bits.size(), 64, &decoded));
+    EXPECT_EQ(decoded, bits);
+
+    std::vector<uint64_t> floats = {0x3f800000, 0x3f800000, 0x80000000, 0x7fc00000,
+                                    0x00000001, 0xffffffff, 0x3f800001};
+    xor_encode(floats.data(), floats.size(), 32, &stream);
+    ASSERT_TRUE(xor_decode(stream, floats.size(), 32, &decoded));
+    EXPECT_EQ(decoded, floats);
+
+    // Truncated stream is rejected, not read past the end
+    stream.pop_back();
+    EXPECT_FALSE(xor_decode(stream, floats.size(), 32, &decoded));
+}
+
+TEST_F(SignalBlockTest, AllScalarTypesExpandToOriginalSignals) {
+    for (bool direct : {false, true}) {
+        UnifiedBatchBuilder blocks("test_source", 1000, block_config(direct));
+        UnifiedBatchBuilder rows("test_source", 1000);
+
+        for (int i = 0; i < 6; ++i) {
+            int64_t ts = 1000000000LL + i * 10000000LL + (i == 3 ? 4000000LL : 0);
+            auto signal = create_int32_signal("Vehicle.Temp", -40 + i * (i % 2 ? -1 : 1), ts);
+            std::vector<vep_VssSignal> samples = {signal, signal, signal, signal, signal};
+            samples[1].path = const_cast<char*>("Vehicle.Odometer");
+            samples[1].value.type = vep_VSS_VALUE_TYPE_UINT64;
+            samples[1].value.uint64_value = (i % 2) ? ~0ULL - i : i;
+            samples[2].path = const_cast<char*>("Vehicle.Gear");
+            samples[2].value.type = vep_VSS_VALUE_TYPE_UINT8;
+            samples[2].value.uint8_value = static_cast<uint8_t>(250 + i);
+            samples[3] = create_bool_signal("Vehicle.IsMoving", i % 3 == 0, ts);
+            samples[4] = create_double_signal("Vehicle.Speed", i * 0.1, ts);
+            samples[4].quality = vep_VSS_QUALITY_INVALID;
+            for (const auto& sample : samples) {
+                blocks.add(sample);
+                rows.add(sample);
+            }
+        }
+
+        auto data = blocks.build();
+        vep::transfer::TransferBatch batch;
+        ASSERT_TRUE(batch.ParseFromArray(data.data(), static_cast<int>(data.size())));
+        ASSERT_EQ(batch.items_size(), 5) << "direct=" << direct;
+        for (const auto& item : batch.items()) {
+            EXPECT_TRUE(item.has_signal_block());
+            EXPECT_EQ(item.signal_block().count(), 6);
+        }
+        expect_same_signals(data, rows.build());
+    }
+}
+
+TEST_F(SignalBlockTest, BlockTakesPositionOfFirstSample) {
+    for (const auto& config : {block_config(), block_config(false, true), block_config(true)}) {
+        UnifiedBatchBuilder builder("test_source", 100, config);
+        builder.add(create_event("evt-1", "system", vep_SEVERITY_INFO));
+        for (int i = 0; i < 4; ++i) {
+            builder.add(create_double_signal("Vehicle.Speed", 50.0 + i, 1000000000 + i * 1000000));
+            builder.add(create_string_signal("Vehicle.VIN", "WVWZZZ1JZXW000001", 1000000000));
+        }
+
+        auto decoded = decode_transfer_batch(builder.build());
+        ASSERT_TRUE(decoded.has_value());
+        ASSERT_EQ(decoded->items.size(), 9);
+        EXPECT_EQ(decoded->items[0].type, DecodedItemType::EVENT);
+        for (int i = 0; i < 4; ++i) {
+            EXPECT_EQ(decoded->items[1 + i].signal->path, "Vehicle.Speed");
+            EXPECT_EQ(std::get<double>(decoded->items[1 + i].signal->value), 50.0 + i);
+            EXPECT_EQ(decoded->items[1 + i].timestamp_ms, 1000 + i);
+            EXPECT_EQ(decoded->items[5 + i].signal->path, "Vehicle.VIN");
+        }
+    }
+}
+
+TEST_F(SignalBlockTest, DirectModeKeepsStagedItemOrder) {
+    auto add = [](UnifiedBatchBuilder& builder) {
+        for (int i = 0; i < 6; ++i) {
+            int64_t ts = 1000000000 + i * 1000000;
+            builder.add(create_double_signal("Vehicle.Speed", i, ts));
+            if (i % 2 == 0) {
+                builder.add(create_gauge("cpu_usage", i));
+            }
+            if (i == 1 || i == 4) {
+                builder.add(create_double_signal("Vehicle.Angle", i, ts));  // Short: rows
+            }
+            if (i == 3) {
+                builder.add(create_string_signal("Vehicle.VIN", "WVWZZZ1JZXW000001", ts));
+            }
+        }
+    };
+    auto order = [](const std::vector<uint8_t>& data) {
+        std::vector<std::tuple<DecodedItemType, std::string, int64_t>> items;
+        auto decoded = decode_transfer_batch(data);
+        EXPECT_TRUE(decoded.has_value());
+        for (const auto& item : decoded->items) {
+            items.emplace_back(item.type, item.signal ? item.signal->path : "",
+                               item.timestamp_ms);
+        }
+        return items;
+    };
+
+    UnifiedBatchBuilder staged("test_source", 100, block_config());
+    UnifiedBatchBuilder direct("test_source", 100, block_config(true));
+    add(staged);
+    add(direct);
+    auto expected = order(staged.build());
+    ASSERT_EQ(expected.size(), 6u + 3u + 2u + 1u);
+    EXPECT_EQ(order(direct.build()), expected);
+}
+
+TEST_F(SignalBlockTest, ShortOrMixedColumnsStayRows) {
+    auto add = [](UnifiedBatchBuilder& builder) {
+        for (int i = 0; i < 3; ++i) {
+            builder.add(create_double_signal("Vehicle.Speed", i, 1000000000 + i * 1000000));
+        }
+        for (int i = 0; i < 4; ++i) {
+            auto signal = create_double_signal("Vehicle.Angle", i, 1000000000 + i * 1000000);
+            if (i == 2) {
+                signal.quality = vep_VSS_QUALITY_INVALID;
+            }
+            builder.add(signal);
+        }
+    };
+
+    // Staged mode output is unchanged when no column reaches the minimum
+    UnifiedBatchBuilder blocks("test_source", 100, block_config());
+    UnifiedBatchBuilder rows("test_source", 100);
+    add(blocks);
+    add(rows);
+    EXPECT_EQ(blocks.build(), rows.build());
+
+    // Direct mode re-creates rows from short columns
+    UnifiedBatchBuilder direct("test_source", 100, block_config(true));
+    add(direct);
+    add(rows);
+    EXPECT_EQ(direct.size(), 7);
+    expect_same_signals(direct.build(), rows.build());
+}
+
+TEST_F(SignalBlockTest, InternedBlockPathsResolveAcrossBatches) {
+    for (bool direct : {false, true}) {
+        auto config = block_config(direct);
+        config.intern_paths = true;
+        UnifiedBatchBuilder builder("test_source", 1000, config);
+        PathDictionaryCache paths;
+
+        add_can_frames(builder, 10);
+        ASSERT_TRUE(decode_transfer_batch(builder.build(), paths).has_value());
+
+        add_can_frames(builder, 10);
+        auto data = builder.build();
+        vep::transfer::TransferBatch batch;
+        ASSERT_TRUE(batch.ParseFromArray(data.data(), static_cast<int>(data.size())));
+        EXPECT_FALSE(batch.has_path_dictionary());
+        ASSERT_EQ(batch.items_size(), 6);
+        EXPECT_FALSE(batch.items(0).signal_block().has_path());
+
+        auto decoded = decode_transfer_batch(data, paths);
+        ASSERT_TRUE(decoded.has_value());
+        ASSERT_EQ(decoded->signal_count(), 60);
+        EXPECT_EQ(decoded->items[0].signal->path, "Vehicle.Chassis.Axle.Row1.Wheel.Left.Speed");
+    }
+}
+
+TEST_F(SignalBlockTest, MalformedBlockDecodesAsUnknown) {
+    vep::transfer::TransferBatch batch;
+    auto* block = batch.add_items()->mutable_signal_block();
+    block->set_path("Vehicle.Speed");
+    block->set_count(3);
+    block->add_timestamp_dod_ms(10);  // count - 1 entries required
+    block->mutable_int32_delta()->add_values(1);
+
+    std::vector<uint8_t> data(batch.ByteSizeLong());
+    batch.SerializeToArray(data.data(), static_cast<int>(data.size()));
+    auto decoded = decode_transfer_batch(data);
+    ASSERT_TRUE(decoded.has_value());
+    ASSERT_EQ(decoded->items.size(), 1);
+    EXPECT_EQ(decoded->items[0].type, DecodedItemType::UNKNOWN);
+}
+
+TEST_F(SignalBlockTest, PeriodicCanSignalsAreDenserThanRowsAfterZstd) {
+    UnifiedBatchBuilder blocks("test_source", 1000, block_config());
+    UnifiedBatchBuilder rows("test_source", 1000);
+    add_can_frames(blocks, 100);
+    add_can_frames(rows, 100);
+
+    auto block_data = blocks.build();
+    auto row_data = rows.build();
+    expect_same_signals(block_data, row_data);
+
+    ZstdCompressor compressor;
+    ASSERT_TRUE(compressor.init());
+    size_t block_bytes = compressor.compress(block_data).size();
+    size_t row_bytes = compressor.compress(row_data).size();
+    EXPECT_LT(block_data.size() * 10, row_data.size());
+    EXPECT_LT(block_bytes * 2, row_bytes)
+        << "blocks " << block_data.size() << " -> " << block_bytes
+        << ", rows " << row_data.size() << " -> " << row_bytes;
+}
+
+// =============================================================================
+// Batch Size Limit Tests (max_batch_bytes splitting)
+// =============================================================================
+
+class BatchSizeLimitTest : public ::testing::Test {
+protected:
+    enum class Mode { Staged, Arena, Direct };
+    static constexpr Mode kModes[] = {Mode::Staged, Mode::Arena, Mode::Direct};
+
+    static BatchBuilderConfig limit_config(Mode mode, size_t max_bytes, bool intern = false) {
+        BatchBuilderConfig config;
+        config.max_batch_bytes = max_bytes;
+        config.use_arena = mode == Mode::Arena;
+        config.direct_encoding = mode == Mode::Direct;
+        config.intern_paths = intern;
+        return config;
+    }
+
+    /// Build until nothing is left; every batch must fit and sequences
+    /// must be consecutive
+    static std::vector<std::vector<uint8_t>> drain(UnifiedBatchBuilder& builder,
+                                                   size_t max_bytes) {
+        std::vector<std::vector<uint8_t>> batches;
+        std::vector<uint8_t> buffer;
+        while (builder.build_into(buffer) > 0) {
+            EXPECT_LE(buffer.size(), max_bytes);
+            batches.push_back(buffer);
+        }
+        for (size_t i = 1; i < batches.size(); ++i) {
+            vep::transfer::TransferBatch prev;
+            vep::transfer::TransferBatch next;
+            EXPECT_TRUE(prev.ParseFromArray(batches[i - 1].data(),
+                                            static_cast<int>(batches[i - 1].size())));
+            EXPECT_TRUE(next.ParseFromArray(batches[i].data(),
+                                            static_cast<int>(batches[i].size())));
+            EXPECT_EQ(next.sequence(), prev.sequence() + 1);
+        }
+        return batches;
+    }
+
+    /// Signals of all batches in order, paths resolved
+    static std::vector<DecodedSignal> decode_signals(
+            const std::vector<std::vector<uint8_t>>& batches) {
+        PathDictionaryCache paths;
+        std::vector<DecodedSignal> signals;
+        for (const auto& data : batches) {
+            auto decoded = decode_transfer_batch(data, paths);
+            EXPECT_TRUE(decoded.has_value());
+            if (!decoded) {
+                continue;
+            }
+            for (const auto& item : decoded->items) {
+                if (item.signal) {
+                    signals.push_back(*item.signal);
+                }
+            }
+        }
+        return signals;
+    }
+};
+
+TEST_F(BatchSizeLimitTest, SplitsIntoConsecutiveBatchesInEveryMode) {
+    constexpr size_t kMaxBytes = 1024;
+    for (Mode mode : kModes) {
+        SCOPED_TRACE(static_cast<int>(mode));
+        UnifiedBatchBuilder builder("test_source", 1000, limit_config(mode, kMaxBytes));
+        for (int i = 0; i < 300; ++i) {
+            builder.add(create_double_signal("Vehicle.Chassis.SteeringWheel.Angle", i,
+                                             1000000000LL + i * 1000000LL));
+        }
+
+        std::vector<uint8_t> first;
+        ASSERT_GT(builder.build_into(first), 0u);
+        EXPECT_GT(builder.pending_batches(), 0u);
+        EXPECT_TRUE(builder.ready());
+
+        auto batches = drain(builder, kMaxBytes);
+        batches.insert(batches.begin(), first);
+        EXPECT_GT(batches.size(), 10u);
+        EXPECT_FALSE(builder.ready());
+
+        auto signals = decode_signals(batches);
+        ASSERT_EQ(signals.size(), 300u);
+        for (int i = 0; i < 300; ++i) {
+            EXPECT_EQ(std::get<double>(signals[i].value), i);
+            EXPECT_EQ(signals[i].timestamp_ms, 1000 + i);
+        }
+        EXPECT_EQ(builder.oversized_items(), 0u);
+    }
+}
+
+TEST_F(BatchSizeLimitTest, EstimatedSizeIsExactItemBytes) {
+    for (Mode mode : kModes) {
+        SCOPED_TRACE(static_cast<int>(mode));
+        UnifiedBatchBuilder builder("test_source", 1000, limit_config(mode, 0));
+        for (int i = 0; i < 50; ++i) {
+            builder.add(create_double_signal("Vehicle.Speed", i, 1000000000LL + i * 7000000LL));
+            builder.add(create_gauge("cpu_usage", i));
+            builder.add(create_log("exporter", "batch flushed", vep_LOG_LEVEL_INFO));
+        }
+        size_t estimate = builder.estimated_size();
+
+        std::vector<uint8_t> header;
+        encode_batch_header(header, 1000, "test_source", 0);
+        EXPECT_EQ(builder.build().size(), header.size() + estimate);
+    }
+}
+
+TEST_F(BatchSizeLimitTest, LargeDictionaryIsSpreadOverLeadingBatches) {
+    constexpr size_t kMaxBytes = 512;
+    std::vector<std::string> names;
+    for (int i = 0; i < 200; ++i) {
+        names.push_back("Vehicle.Body.Lights.Zone" + std::to_string(i) + ".IsOn");
+    }
+
+    for (Mode mode : kModes) {
+        SCOPED_TRACE(static_cast<int>(mode));
+        UnifiedBatchBuilder builder("test_source", 1000, limit_config(mode, kMaxBytes, true));
+        for (int i = 0; i < 200; ++i) {
+            builder.add(create_bool_signal(names[i].c_str(), i % 2, 1000000000));
+        }
+        auto batches = drain(builder, kMaxBytes);
+
+        // Another batch with one new path continues the version chain
+        builder.add(create_bool_signal("Vehicle.Body.Horn.IsActive", true, 2000000000));
+        auto more = drain(builder, kMaxBytes);
+        batches.insert(batches.end(), more.begin(), more.end());
+
+        PathDictionaryCache chain;
+        size_t dictionaries = 0;
+        for (const auto& data : batches) {
+            vep::transfer::TransferBatch batch;
+            ASSERT_TRUE(batch.ParseFromArray(data.data(), static_cast<int>(data.size())));
+            if (batch.has_path_dictionary()) {
+                EXPECT_TRUE(chain.apply(batch.path_dictionary()));
+                dictionaries++;
+            }
+        }
+        EXPECT_GT(dictionaries, 2u);
+        EXPECT_EQ(chain.size(), 201u);
+
+        auto signals = decode_signals(batches);
+        ASSERT_EQ(signals.size(), 201u);
+        for (int i = 0; i < 200; ++i) {
+            EXPECT_EQ(signals[i].path, names[i]);
+        }
+        EXPECT_EQ(signals[200].path, "Vehicle.Body.Horn.IsActive");
+    }
+}
+
+TEST_F(BatchSizeLimitTest, OversizedItemIsDroppedAndCounted) {
+    constexpr size_t kMaxBytes = 256;
+    std::string long_message(1000, 'x');
+
+    for (Mode mode : kModes) {
+        SCOPED_TRACE(static_cast<int>(mode));
+        UnifiedBatchBuilder builder("test_source", 100, limit_config(mode, kMaxBytes));
+        builder.add(create_double_signal("Vehicle.Speed", 1.0, 1000000000));
+        builder.add(create_log("exporter", long_message.c_str(), vep_LOG_LEVEL_ERROR));
+        builder.add(create_double_signal("Vehicle.Speed", 2.0, 1001000000));
+
+        auto batches = drain(builder, kMaxBytes);
+        auto signals = decode_signals(batches);
+        ASSERT_EQ(signals.size(), 2u);
+        EXPECT_EQ(std::get<double>(signals[1].value), 2.0);
+        EXPECT_EQ(builder.oversized_items(), 1u);
+    }
+}
+
+// =============================================================================
+// String Table Tests (TransferBatch.strings)
+// =============================================================================
+
+class StringTableTest : public DirectEncodingTest {
+protected:
+    enum class Mode { Staged, Arena, Direct };
+    static constexpr Mode kModes[] = {Mode::Staged, Mode::Arena, Mode::Direct};
+
+    static BatchBuilderConfig table_config(Mode mode, size_t max_bytes = 0) {
+        BatchBuilderConfig config;
+        config.string_table = true;
+        config.use_arena = mode == Mode::Arena;
+        config.direct_encoding = mode == Mode::Direct;
+        config.max_batch_bytes = max_bytes;
+        return config;
+    }
+
+    struct HostMetric {
+        std::string name;
+        std::vector<std::pair<std::string, std::string>> labels;
+        bool counter;
+    };
+
+    /// One collection cycle of vep_host_metrics: CPU, memory, two disks,
+    /// two network interfaces and two filesystems
+    static std::vector<HostMetric> host_metrics_scrape() {
+        std::vector<HostMetric> scrape;
+        scrape.push_back({"system.cpu.utilization", {}, false});
+        for (const char* state : {"user", "system", "idle", "iowait"}) {
+            scrape.push_back({"system.cpu.time", {{"state", state}}, true});
+        }
+        scrape.push_back({"system.cpu.count", {}, false});
+        for (const char* state : {"used", "free", "buffers", "cached"}) {
+            scrape.push_back({"system.memory.usage", {{"state", state}}, false});
+        }
+        scrape.push_back({"system.memory.limit", {}, false});
+        for (const char* state : {"used", "free"}) {
+            scrape.push_back({"system.paging.usage", {{"state", state}}, false});
+        }
+        for (const char* device : {"mmcblk0", "nvme0n1"}) {
+            for (const char* name : {"system.disk.operations", "system.disk.io"}) {
+                for (const char* direction : {"read", "write"}) {
+                    scrape.push_back({name, {{"device", device}, {"direction", direction}}, true});
+                }
+            }
+            scrape.push_back({"system.disk.io_time", {{"device", device}}, true});
+            scrape.push_back({"system.disk.pending_operations", {{"device", device}}, false});
+        }
+        for (const char* device : {"eth0", "can0"}) {
+            for (const char* name : {"system.network.io", "system.network.packets",
+                                     "system.network.errors", "system.network.dropped"}) {
+                for (const char* direction : {"receive", "transmit"}) {
+                    scrape.push_back({name, {{"device", device}, {"direction", direction}}, true});
+                }
+            }
+        }
+        for (auto [device, mountpoint] : {std::pair{"/dev/mmcblk0p2", "/"},
+                                          std::pair{"/dev/nvme0n1p1", "/var/lib/vep"}}) {
+            for (const char* name : {"system.filesystem.usage", "system.filesystem.inodes.usage"}) {
+                for (const char* state : {"used", "free"}) {
+                    scrape.push_back({name, {{"device", device}, {"mountpoint", mountpoint},
+                                             {"type", "ext4"}, {"state", state}}, false});
+                }
+            }
+            scrape.push_back({"system.filesystem.utilization",
+                              {{"device", device}, {"mountpoint", mountpoint}, {"type", "ext4"}},
+                              false});
+        }
+        return scrape;
+    }
+
+    /// Add `scrapes` collection cycles, one second apart, with changing values
+    static void add_host_metrics(UnifiedBatchBuilder& builder, int scrapes) {
+        auto scrape = host_metrics_scrape();
+        std::vector<vep_KeyValue> labels;
+        for (int cycle = 0; cycle < scrapes; ++cycle) {
+            int64_t timestamp_ns = 1000000000LL * (1000 + cycle);
+            for (size_t i = 0; i < scrape.size(); ++i) {
+                const auto& metric = scrape[i];
+                labels.clear();
+                for (const auto& [key, value] : metric.labels) {
+                    labels.push_back({const_cast<char*>(key.c_str()),
+                                      const_cast<char*>(value.c_str())});
+                }
+                double value = static_cast<double>((cycle + 1) * 4096 + i * 17);
+                auto add = [&](auto msg) {
+                    msg.header.source_id = const_cast<char*>("vep_host_metrics");
+                    msg.header.timestamp_ns = timestamp_ns;
+                    msg.labels._buffer = labels.data();
+                    msg.labels._length = static_cast<uint32_t>(labels.size());
+                    msg.labels._maximum = msg.labels._length;
+                    builder.add(msg);
+                };
+                if (metric.counter) {
+                    add(create_counter(metric.name.c_str(), value));
+                } else {
+                    add(create_gauge(metric.name.c_str(), value));
+                }
+            }
+        }
+    }
+
+    /// Metrics and logs of all batches, as "name{labels}=value" lines
+    static std::vector<std::string> decode_lines(const std::vector<std::vector<uint8_t>>& batches) {
+        std::vector<std::string> lines;
+        for (const auto& data : batches) {
+            auto decoded = decode_transfer_batch(data);
+            EXPECT_TRUE(decoded.has_value());
+            if (!decoded) {
+                continue;
+            }
+            for (const auto& item : decoded->items) {
+                std::string line;
+                const std::map<std::string, std::string>* labels = nullptr;
+                if (item.metric) {
+                    line = item.metric->name + "=" + std::to_string(item.metric->value) + " " +
+                           std::to_string(item.metric->sample_count);
+                    labels = &item.metric->labels;
+                } else if (item.log) {
+                    line = item.log->component + ": " + item.log->message;
+                    labels = &item.log->attributes;
+                } else {
+                    line = item_type_to_string(item.type);
+                }
+                if (labels) {
+                    for (const auto& [key, value] : *labels) {
+                        line += " " + key + "=" + value;
+                    }
+                }
+                lines.push_back(line);
+            }
+        }
+        return lines;
+    }
+
+    static std::vector<std::vector<uint8_t>> drain(UnifiedBatchBuilder& builder) {
+        std::vector<std::vector<uint8_t>> batches;
+        std::vector<uint8_t> buffer;
+        while (builder.build_into(buffer) > 0) {
+            batches.push_back(buffer);
+        }
+        return batches;
+    }
+};
+
+TEST_F(StringTableTest, AllModesMatchAndDecodeLikeInlineStrings) {
+    vep_KeyValue labels[] = {
+        {const_cast<char*>("cpu"), const_cast<char*>("0")},
+        {nullptr, const_cast<char*>("skipped")},
+        {const_cast<char*>("mode"), nullptr},
+        {const_cast<char*>("0"), const_cast<char*>("cpu")},
+    };
+    vep_OtelHistogramBucket buckets[] = {{0.5, 3}, {1.0, 200}, {1e9, 100000}};
+    auto add = [&](UnifiedBatchBuilder& builder) {
+        builder.add(create_event("evt_1", "ADAS", vep_SEVERITY_CRITICAL));
+        for (int i = 0; i < 3; ++i) {
+            auto gauge = create_gauge("cpu_usage", i);
+            set_sequence(gauge.labels, labels, 4);
+            builder.add(gauge);
+        }
+        auto counter = create_counter("", 42.0);
+        counter.header.source_id = nullptr;
+        builder.add(counter);
+        builder.add(create_counter("test", 1.0));  // Name equals a label value
+
+        vep_OtelHistogram hist = {};
+        hist.header.source_id = const_cast<char*>("test");
+        hist.header.timestamp_ns = 1002000000;
+        hist.name = const_cast<char*>("latency");
+        hist.sample_count = 100203;
+        hist.sample_sum = 1234.5;
+        set_sequence(hist.buckets, buckets, 3);
+        set_sequence(hist.labels, labels, 1);
+        builder.add(hist);
+
+        auto log = create_log("exporter", "Connection established", vep_LOG_LEVEL_DEBUG);
+        set_sequence(log.attributes, labels, 4);
+        builder.add(log);
+        builder.add(create_log("cpu_usage", "", vep_LOG_LEVEL_ERROR));
+        builder.add(create_log("", "no component", vep_LOG_LEVEL_INFO));
+    };
+
+    UnifiedBatchBuilder plain("test_source", 100);
+    add(plain);
+    auto expected = decode_lines(drain(plain));
+
+    std::vector<uint8_t> staged;
+    for (Mode mode : kModes) {
+        SCOPED_TRACE(static_cast<int>(mode));
+        UnifiedBatchBuilder builder("test_source", 100, table_config(mode));
+        add(builder);
+        auto batches = drain(builder);
+        ASSERT_EQ(batches.size(), 1u);
+        if (mode == Mode::Staged) {
+            staged = batches[0];
+        } else {
+            EXPECT_EQ(batches[0], staged);
+        }
+        EXPECT_EQ(decode_lines(batches), expected);
+    }
+
+    vep::transfer::TransferBatch batch;
+    ASSERT_TRUE(batch.ParseFromArray(staged.data(), static_cast<int>(staged.size())));
+    EXPECT_EQ(batch.strings(0), "cpu_usage");
+    EXPECT_EQ(batch.items(1).metric().name_ref(), 1u);
+    EXPECT_EQ(batch.items(1).metric().label_keys_size(), 0);
+    EXPECT_EQ(batch.items(1).metric().label_key_refs_size(), 4);
+
+    // A second batch starts its own table
+    UnifiedBatchBuilder builder("test_source", 100, table_config(Mode::Direct));
+    add(builder);
+    builder.build();
+    builder.add(create_gauge("memory_usage", 1.0));
+    auto second = builder.build();
+    ASSERT_TRUE(batch.ParseFromArray(second.data(), static_cast<int>(second.size())));
+    ASSERT_EQ(batch.strings_size(), 3);
+    EXPECT_EQ(batch.strings(0), "memory_usage");
+}
+
+TEST_F(StringTableTest, FullTableSpillsInlineAndSplitBatchesRepeatIt) {
+    constexpr size_t kMaxBytes = 600;  // Table limited to 150 bytes
+    std::vector<std::string> values;
+    for (int i = 0; i < 40; ++i) {
+        values.push_back("interface-with-a-long-name-" + std::to_string(i));
+    }
+    auto add = [&](UnifiedBatchBuilder& builder) {
+        for (const auto& value : values) {
+            vep_KeyValue label[] = {{const_cast<char*>("device"),
+                                     const_cast<char*>(value.c_str())}};
+            auto counter = create_counter("system.network.io", 1.0);
+            set_sequence(counter.labels, label, 1);
+            builder.add(counter);
+        }
+    };
+
+    UnifiedBatchBuilder plain("test_source", 1000);
+    add(plain);
+    auto expected = decode_lines(drain(plain));
+
+    std::vector<std::vector<uint8_t>> staged;
+    for (Mode mode : kModes) {
+        SCOPED_TRACE(static_cast<int>(mode));
+        UnifiedBatchBuilder builder("test_source", 1000, table_config(mode, kMaxBytes));
+        add(builder);
+        auto batches = drain(builder);
+        ASSERT_GT(batches.size(), 1u);
+        for (const auto& data : batches) {
+            EXPECT_LE(data.size(), kMaxBytes);
+        }
+        if (mode == Mode::Staged) {
+            staged = batches;
+        } else {
+            EXPECT_EQ(batches, staged);
+        }
+        EXPECT_EQ(decode_lines(batches), expected);
+        EXPECT_EQ(builder.oversized_items(), 0u);
+    }
+
+    vep::transfer::TransferBatch first;
+    vep::transfer::TransferBatch last;
+    ASSERT_TRUE(first.ParseFromArray(staged.front().data(),
+                                     static_cast<int>(staged.front().size())));
+    ASSERT_TRUE(last.ParseFromArray(staged.back().data(), static_cast<int>(staged.back().size())));
+    EXPECT_EQ(last.strings_size(), first.strings_size());
+    const auto& spilled = last.items(last.items_size() - 1).metric();
+    EXPECT_EQ(spilled.label_value_refs(1), 0u);
+    ASSERT_EQ(spilled.label_values_size(), 1);
+    EXPECT_EQ(spilled.label_values(0), values.back());
+}
+
+TEST_F(StringTableTest, UnknownRefDecodesAsPlaceholder) {
+    UnifiedBatchBuilder builder("test_source", 100, table_config(Mode::Staged));
+    builder.add(create_gauge("cpu_usage", 1.0));
+    auto data = builder.build();
+
+    vep::transfer::TransferBatch batch;
+    ASSERT_TRUE(batch.ParseFromArray(data.data(), static_cast<int>(data.size())));
+    batch.clear_strings();
+    std::vector<uint8_t> stripped(batch.ByteSizeLong());
+    batch.SerializeToArray(stripped.data(), static_cast<int>(stripped.size()));
+    auto decoded = decode_transfer_batch(stripped);
+    ASSERT_TRUE(decoded.has_value());
+    EXPECT_EQ(decoded->items[0].metric->name, "<string:1>");
+    EXPECT_EQ(decoded->items[0].metric->labels.at("<string:2>"), "<string:3>");
+}
+
+TEST_F(StringTableTest, HostMetricsShrinkRawAndCompressed) {
+    constexpr int kScrapes = 5;
+    UnifiedBatchBuilder plain("test_source", 1000);
+    UnifiedBatchBuilder table("test_source", 1000, table_config(Mode::Direct));
+    add_host_metrics(plain, kScrapes);
+    add_host_metrics(table, kScrapes);
+    auto plain_data = plain.build();
+    auto table_data = table.build();
+    EXPECT_EQ(decode_lines({table_data}), decode_lines({plain_data}));
+
+    ZstdCompressor compressor;
+    ASSERT_TRUE(compressor.init());
+    size_t plain_bytes = compressor.compress(plain_data).size();
+    size_t table_bytes = compressor.compress(table_data).size();
+    EXPECT_LT(table_data.size() * 2, plain_data.size());
+    EXPECT_LT(table_bytes, plain_bytes)
+        << "table " << table_data.size() << " -> " << table_bytes
+        << ", inline " << plain_data.size() << " -> " << plain_bytes;
+}
+
+// =============================================================================
+// Metric Series Tests
+// =============================================================================
+
+class MetricSeriesTest : public StringTableTest {
+protected:
+    static BatchBuilderConfig series_config(Mode mode, uint32_t keyframe_samples = 60) {
+        BatchBuilderConfig config = table_config(mode);
+        config.string_table = false;
+        config.metric_series = true;
+        config.metric_keyframe_samples = keyframe_samples;
+        return config;
+    }
+
+    /// Request latency histograms of two endpoints sharing bucket bounds
+    static void add_latency_histograms(UnifiedBatchBuilder& builder, int cycle) {
+        static vep_OtelHistogramBucket buckets[2][8];
+        static const double kBounds[] = {0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0};
+        for (int endpoint = 0; endpoint < 2; ++endpoint) {
+            vep_KeyValue label[] = {{const_cast<char*>("endpoint"),
+                                     const_cast<char*>(endpoint ? "/publish" : "/subscribe")}};
+            uint64_t cumulative = 0;
+            for (int i = 0; i < 8; ++i) {
+                cumulative += static_cast<uint64_t>((cycle + 1) * (10 + i * (endpoint + 1)));
+                buckets[endpoint][i] = {kBounds[i], cumulative};
+            }
+            vep_OtelHistogram hist = {};
+            hist.header.source_id = const_cast<char*>("vep_exporter");
+            hist.header.timestamp_ns = 1000000000LL * (1000 + cycle);
+            hist.name = const_cast<char*>("rpc.server.duration");
+            hist.sample_count = cumulative;
+            hist.sample_sum = 0.0125 * static_cast<double>(cumulative);
+            set_sequence(hist.buckets, buckets[endpoint], 8);
+            set_sequence(hist.labels, label, 1);
+            builder.add(hist);
+        }
+    }
+
+    /// Metrics of consecutive batches decoded with one cache, as
+    /// "name{labels}=value count [buckets]" lines
+    static std::vector<std::string> decode_series(const std::vector<std::vector<uint8_t>>& batches,
+                                                  PathDictionaryCache& paths) {
+        std::vector<std::string> lines;
+        for (const auto& data : batches) {
+            auto decoded = decode_transfer_batch(data, paths);
+            EXPECT_TRUE(decoded.has_value());
+            if (!decoded) {
+                continue;
+            }
+            for (const auto& item : decoded->items) {
+                if (!item.metric) {
+                    lines.push_back(item_type_to_string(item.type));
+                    continue;
+                }
+                const auto& metric = *item.metric;
+                std::string line = metric.name;
+                for (const auto& [key, value] : metric.labels) {
+                    line += " " + key + "=" + value;
+                }
+                line += " " + std::string(metric_type_to_string(metric.type)) + "=" +
+                        std::to_string(metric.value) + " " + std::to_string(metric.sample_count) +
+                        " " + std::to_string(metric.sample_sum);
+                for (size_t i = 0; i < metric.bucket_counts.size(); ++i) {
+                    line += " " + std::to_string(i < metric.bucket_bounds.size()
+                                                     ? metric.bucket_bounds[i] : 0.0) +
+                            ":" + std::to_string(metric.bucket_counts[i]);
+                }
+                lines.push_back(line);
+            }
+        }
+        return lines;
+    }
+
+    /// Host metrics and latency histograms, one batch per collection cycle
+    static std::vector<std::vector<uint8_t>> scrape_batches(UnifiedBatchBuilder& builder,
+                                                            int scrapes) {
+        std::vector<std::vector<uint8_t>> batches;
+        for (int cycle = 0; cycle < scrapes; ++cycle) {
+            add_latency_histograms(builder, cycle);
+            batches.push_back(builder.build());
+        }
+        return batches;
+    }
+};
+
+TEST_F(MetricSeriesTest, AllModesMatchAndDecodeLikePlainMetrics) {
+    constexpr int kScrapes = 7;
+    auto add = [](UnifiedBatchBuilder& builder, std::vector<std::vector<uint8_t>>& batches) {
+        for (int cycle = 0; cycle < kScrapes; ++cycle) {
+            add_host_metrics(builder, 1);
+            add_latency_histograms(builder, cycle);
+            builder.add(create_counter("exporter.bytes", 1.5 * cycle));  // Not integral
+            builder.add(create_counter("exporter.restarts", -1.0 * cycle));  // -0.0 first
+            batches.push_back(builder.build());
+        }
+    };
+
+    UnifiedBatchBuilder plain("test_source", 1000);
+    std::vector<std::vector<uint8_t>> plain_batches;
+    add(plain, plain_batches);
+    PathDictionaryCache plain_paths;
+    auto expected = decode_series(plain_batches, plain_paths);
+
+    std::vector<std::vector<uint8_t>> staged;
+    for (Mode mode : kModes) {
+        SCOPED_TRACE(static_cast<int>(mode));
+        UnifiedBatchBuilder builder("test_source", 1000, series_config(mode, 3));
+        std::vector<std::vector<uint8_t>> batches;
+        add(builder, batches);
+        if (mode == Mode::Staged) {
+            staged = batches;
+        } else {
+            EXPECT_EQ(batches, staged);
+        }
+        PathDictionaryCache paths;
+        EXPECT_EQ(decode_series(batches, paths), expected);
+    }
+
+    // Series and the one bucket schema are interned once
+    UnifiedBatchBuilder builder("test_source", 1000, series_config(Mode::Direct));
+    std::vector<std::vector<uint8_t>> batches;
+    add(builder, batches);
+    size_t series = host_metrics_scrape().size() + 2 + 2;
+    EXPECT_EQ(builder.metric_series_count(), series + 1);
+
+    vep::transfer::TransferBatch batch;
+    ASSERT_TRUE(batch.ParseFromArray(batches[1].data(), static_cast<int>(batches[1].size())));
+    EXPECT_FALSE(batch.has_path_dictionary());
+    int deltas = 0;
+    for (const auto& item : batch.items()) {
+        ASSERT_TRUE(item.has_metric_sample());
+        const auto& sample = item.metric_sample();
+        if (sample.has_counter_delta()) {
+            deltas++;
+        } else if (sample.has_histogram()) {
+            EXPECT_TRUE(sample.histogram().delta());
+            EXPECT_EQ(sample.histogram().bucket_counts(0), 10);
+        }
+    }
+    EXPECT_EQ(deltas, 30);  // Host counters; exporter.restarts follows -0.0
+}
+
+TEST_F(MetricSeriesTest, LostBatchLeavesChangesUnresolvedUntilAbsoluteValues) {
+    UnifiedBatchBuilder builder("test_source", 1000, series_config(Mode::Direct));
+    auto batches = scrape_batches(builder, 3);
+
+    // Batch 2 never arrives: its successor's changes cannot be applied
+    PathDictionaryCache paths;
+    auto lines = decode_series({batches[0], batches[2]}, paths);
+    ASSERT_EQ(lines.size(), 4u);
+    EXPECT_EQ(lines[2], "unknown");
+    EXPECT_EQ(lines[3], "unknown");
+
+    // The sender learns of the loss and sends absolute values again
+    builder.resend_path_dictionary();
+    auto recovered = scrape_batches(builder, 2);
+    PathDictionaryCache reference;
+    decode_series(batches, reference);
+    auto expected = decode_series(recovered, reference);
+    EXPECT_EQ(decode_series(recovered, paths), expected);
+    EXPECT_NE(expected[0], "unknown");
+
+    vep::transfer::TransferBatch batch;
+    ASSERT_TRUE(batch.ParseFromArray(recovered[0].data(), static_cast<int>(recovered[0].size())));
+    EXPECT_EQ(batch.path_dictionary().base_version(), 0u);
+    EXPECT_FALSE(batch.items(0).metric_sample().histogram().delta());
+}
+
+TEST_F(MetricSeriesTest, LateBatchLeavesSeriesValuesAlone) {
+    auto config = series_config(Mode::Direct);
+    config.session = 7;
+    UnifiedBatchBuilder builder("test_source", 1000, config);
+    std::vector<std::vector<uint8_t>> batches;
+    for (int total = 10; total <= 25; total += 5) {
+        builder.add(create_counter("exporter.items", total));
+        batches.push_back(builder.build());
+    }
+
+    // Batch 1 arrives again after batch 2: its change was applied already
+    PathDictionaryCache paths;
+    auto lines = decode_series({batches[0], batches[1], batches[2], batches[1], batches[3]},
+                               paths);
+    ASSERT_EQ(lines.size(), 5u);
+    EXPECT_NE(lines[2].find("counter=20.000000"), std::string::npos) << lines[2];
+    EXPECT_EQ(lines[3], "unknown");
+    EXPECT_NE(lines[4].find("counter=25.000000"), std::string::npos) << lines[4];
+}
+
+TEST_F(MetricSeriesTest, SeriesLimitFallsBackToMetrics) {
+    auto config = series_config(Mode::Direct);
+    config.metric_series_max_entries = 2;  // One series and its bucket schema
+    UnifiedBatchBuilder builder("test_source", 1000, config);
+    auto data = scrape_batches(builder, 1)[0];
+
+    vep::transfer::TransferBatch batch;
+    ASSERT_TRUE(batch.ParseFromArray(data.data(), static_cast<int>(data.size())));
+    ASSERT_EQ(batch.items_size(), 2);
+    EXPECT_TRUE(batch.items(0).has_metric_sample());
+    EXPECT_TRUE(batch.items(1).has_metric());
+    EXPECT_EQ(builder.metric_series_count(), 2u);
+
+    auto decoded = decode_transfer_batch(data);
+    ASSERT_TRUE(decoded.has_value());
+    EXPECT_EQ(decoded->items[0].metric->labels.at("endpoint"), "/subscribe");
+    EXPECT_EQ(decoded->items[0].metric->bucket_bounds,
+              decoded->items[1].metric->bucket_bounds);
+}
+
+TEST_F(MetricSeriesTest, HistogramsShrinkRawAndCompressed) {
+    constexpr int kScrapes = 20;
+    UnifiedBatchBuilder plain("test_source", 1000);
+    UnifiedBatchBuilder series("test_source", 1000, series_config(Mode::Direct));
+    auto plain_batches = scrape_batches(plain, kScrapes);
+    auto series_batches = scrape_batches(series, kScrapes);
+    PathDictionaryCache plain_paths;
+    PathDictionaryCache series_paths;
+    EXPECT_EQ(decode_series(series_batches, series_paths),
+              decode_series(plain_batches, plain_paths));
+
+    ZstdCompressor compressor;
+    ASSERT_TRUE(compressor.init());
+    size_t plain_raw = 0, plain_bytes = 0, series_raw = 0, series_bytes = 0;
+    for (int i = 0; i < kScrapes; ++i) {
+        plain_raw += plain_batches[i].size();
+        series_raw += series_batches[i].size();
+        plain_bytes += compressor.compress(plain_batches[i]).size();
+        series_bytes += compressor.compress(series_batches[i]).size();
+    }
+    EXPECT_LT(series_raw * 2, plain_raw);
+    EXPECT_LT(series_bytes, plain_bytes)
+        << "series " << series_raw << " -> " << series_bytes
+        << ", metrics " << plain_raw << " -> " << plain_bytes;
+}
+
 // =============================================================================
 // Utility Function Tests
 // =============================================================================
@@ -333,9 +333,27 @@ bool KuksaDdsBridge::start() {
         return false;
     }
 
-    // Start DDS polling thread
+    // Dispatch DDS samples as they arrive; resetting the reactor detaches
+    // the readers already added
+    dds_reactor_ = std::make_unique<DdsReactor>("KuksaDdsBridge");
+    if (!dds_reactor_->add_reader<vep_VssSignal>(
+            config_.dds_signals_topic, *dds_signals_reader_,
+            [this](const vep_VssSignal& signal) { on_dds_signal(signal); }) ||
+        !dds_reactor_->add_reader<vep_VssSignal>(
+            config_.dds_actuator_actual_topic, *dds_actuator_actual_reader_,
+            [this](const vep_VssSignal& signal) { on_dds_actuator_actual(signal); })) {
+        LOG(ERROR) << "Failed to add DDS readers for " << config_.dds_signals_topic << " and "
+                   << config_.dds_actuator_actual_topic;
+        dds_reactor_.reset();
+        kuksa_client_->stop();
+        return false;
+    }
+    if (!dds_reactor_->start()) {
+        dds_reactor_.reset();
+        kuksa_client_->stop();
+        return false;
+    }
     running_ = true;
-    dds_poll_thread_ = std::thread(&KuksaDdsBridge::dds_poll_loop, this);
 
     LOG(INFO) << "Kuksa-DDS Bridge started";
     return true;
@@ -350,8 +368,9 @@ void KuksaDdsBridge::stop() {
 
     running_ = false;
 
-    if (dds_poll_thread_.joinable()) {
-        dds_poll_thread_.join();
+    if (dds_reactor_) {
+        dds_reactor_->stop();
+        dds_reactor_.reset();
     }
 
     if (kuksa_client_) {
@@ -361,41 +380,6 @@ void KuksaDdsBridge::stop() {
     LOG(INFO) << "Kuksa-DDS Bridge stopped";
 }
 
-void KuksaDdsBridge::dds_poll_loop() {
-    LOG(INFO) << "DDS poll loop started";
-
-    while (running_) {
-        // Poll signals topic (sensors from probes)
-        try {
-            dds_signals_reader_->take_each<vep_VssSignal>(
-                [this](const vep_VssSignal& signal) {
-                    on_dds_signal(signal);
-                },
-                100  // max samples per poll
-            );
-        } catch (const dds::Error& e) {
-            LOG(ERROR) << "Error reading DDS signals: " << e.what();
-        }
-
-        // Poll actuator actuals topic (feedback from RT bridge)
-        try {
-            dds_actuator_actual_reader_->take_each<vep_VssSignal>(
-                [this](const vep_VssSignal& signal) {
-                    on_dds_actuator_actual(signal);
-                },
-                100
-            );
-        } catch (const dds::Error& e) {
-            LOG(ERROR) << "Error reading DDS actuator actuals: " << e.what();
-        }
-
-        // Small sleep to avoid spinning
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
-    }
-
-    LOG(INFO) << "DDS poll loop stopped";
-}
-
 void KuksaDdsBridge::on_dds_signal(const vep_VssSignal& signal) {
     std::string path = signal.path ? signal.path : "";
     if (path.empty()) {
@@ -25,13 +25,13 @@
 
 #include <kuksa_cpp/kuksa.hpp>
 #include "common/dds_wrapper.hpp"
+#include "dds_reactor.hpp"
 #include "vss-signal.h"
 
 #include <atomic>
 #include <memory>
 #include <mutex>
 #include <string>
-#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -144,15 +144,13 @@ private:
     // Set of actuator paths (for quick lookup)
     std::unordered_set<std::string> actuator_paths_;
 
-    // DDS polling thread
-    std::thread dds_poll_thread_;
+    // DDS dispatch thread
+    std::unique_ptr<DdsReactor> dds_reactor_;
     std::atomic<bool> running_{false};
 
     // Stats
     mutable std::mutex stats_mutex_;
     Stats stats_;
-
-    void dds_poll_loop();
 };
 
 }  // namespace bridge
@@ -152,9 +152,22 @@ bool RtDdsBridge::start() {
         }
     );
 
-    // Start DDS polling thread
+    // Dispatch DDS targets as they arrive
+    dds_reactor_ = std::make_unique<bridge::DdsReactor>("RtDdsBridge");
+    if (!dds_reactor_->add_reader<vep_VssSignal>(
+            config_.dds_actuator_target_topic, *dds_target_reader_,
+            [this](const vep_VssSignal& signal) { on_dds_actuator_target(signal); })) {
+        LOG(ERROR) << "Failed to add DDS reader for " << config_.dds_actuator_target_topic;
+        dds_reactor_.reset();
+        rt_transport_->on_actual_value(nullptr);
+        return false;
+    }
+    if (!dds_reactor_->start()) {
+        dds_reactor_.reset();
+        rt_transport_->on_actual_value(nullptr);
+        return false;
+    }
     running_ = true;
-    dds_poll_thread_ = std::thread(&RtDdsBridge::dds_poll_loop, this);
 
     LOG(INFO) << "RT-DDS Bridge started";
     return true;
@@ -169,8 +182,9 @@ void RtDdsBridge::stop() {
 
     running_ = false;
 
-    if (dds_poll_thread_.joinable()) {
-        dds_poll_thread_.join();
+    if (dds_reactor_) {
+        dds_reactor_->stop();
+        dds_reactor_.reset();
     }
 
     if (rt_transport_) {
@@ -180,29 +194,6 @@ void RtDdsBridge::stop() {
     LOG(INFO) << "RT-DDS Bridge stopped";
 }
 
-void RtDdsBridge::dds_poll_loop() {
-    LOG(INFO) << "DDS poll loop started";
-
-    while (running_) {
-        // Poll actuator targets from DDS
-        try {
-            dds_target_reader_->take_each<vep_VssSignal>(
-                [this](const vep_VssSignal& signal) {
-                    on_dds_actuator_target(signal);
-                },
-                100  // max samples per poll
-            );
-        } catch (const dds::Error& e) {
-            LOG(ERROR) << "Error reading DDS targets: " << e.what();
-        }
-
-        // Small sleep to avoid spinning
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
-    }
-
-    LOG(INFO) << "DDS poll loop stopped";
-}
-
 void RtDdsBridge::on_dds_actuator_target(const vep_VssSignal& signal) {
     std::string path = signal.path ? signal.path : "";
     if (path.empty()) {
@@ -23,13 +23,13 @@
 #include "rt_transport.hpp"
 
 #include "common/dds_wrapper.hpp"
+#include "dds_reactor.hpp"
 #include "vss-signal.h"
 
 #include <atomic>
 #include <memory>
 #include <mutex>
 #include <string>
-#include <thread>
 #include <functional>
 
 namespace rt_bridge {
@@ -110,15 +110,13 @@ private:
     // RT transport
     std::shared_ptr<bridge::RtTransport> rt_transport_;
 
-    // DDS polling thread
-    std::thread dds_poll_thread_;
+    // DDS dispatch thread
+    std::unique_ptr<bridge::DdsReactor> dds_reactor_;
     std::atomic<bool> running_{false};
 
     // Stats
     mutable std::mutex stats_mutex_;
     Stats stats_;
-
-    void dds_poll_loop();
 };
 
 /// Factory function to create RT transport by type
@@ -6,9 +6,13 @@
 ///
 /// This application wires SubscriptionManager with UnifiedExporterPipeline
 /// to create a bandwidth-efficient vehicle-to-cloud data export pipeline.
+/// --lane adds pipelines (lanes) with their own transport, compressor and
+/// thread for selected items; the rest goes to the default lane.
 ///
 /// Architecture:
-///   DDS Topics → SubscriptionManager → UnifiedExporterPipeline → IfexBackendTransport
+///   DDS Topics → SubscriptionManager → PipelineRouter → UnifiedExporterPipeline (per lane)
+///                                                                      ↓
+///                                                             IfexBackendTransport
 ///                                                                      ↓
 ///                                                             gRPC BackendTransport
 ///                                                                      ↓
@@ -20,20 +24,29 @@
 ///   vep_exporter_ifex [options]
 
 #include "common/dds_wrapper.hpp"
+#include "common/qos_profiles.hpp"
+#include "batch_spool.hpp"
+#include "pipeline_router.hpp"
 #include "unified_pipeline.hpp"
 #include "ifex_backend_transport.hpp"
 #include "compressor.hpp"
+#include "export_policy.hpp"
 #include "subscriber.hpp"
 
 #include <glog/logging.h>
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <csignal>
 #include <cstdlib>
 #include <iomanip>
 #include <iostream>
+#include <memory>
+#include <optional>
+#include <sstream>
 #include <string>
+#include <vector>
 
 namespace {
 
@@ -44,6 +57,21 @@ void signal_handler(int sig) {
     g_running = false;
 }
 
+std::optional<vep_Severity> severity_from_string(const std::string& name) {
+    if (name == "info") return vep_SEVERITY_INFO;
+    if (name == "warning") return vep_SEVERITY_WARNING;
+    if (name == "error") return vep_SEVERITY_ERROR;
+    if (name == "critical") return vep_SEVERITY_CRITICAL;
+    return std::nullopt;
+}
+
+std::optional<vep::exporter::OverflowPolicy> overflow_from_string(const std::string& name) {
+    if (name == "drop-newest") return vep::exporter::OverflowPolicy::DropNewest;
+    if (name == "drop-oldest") return vep::exporter::OverflowPolicy::DropOldest;
+    if (name == "block") return vep::exporter::OverflowPolicy::Block;
+    return std::nullopt;
+}
+
 void print_usage(const char* prog) {
     std::cout << "Usage: " << prog << " [OPTIONS]\n"
               << "\n"
@@ -55,8 +83,46 @@ void print_usage(const char* prog) {
               << "  --content-id ID          Content ID for transport routing (default: 1)\n"
               << "  --batch-size N           Max items per batch (default: 100)\n"
               << "  --batch-timeout MS       Batch timeout in ms (default: 1000)\n"
-              << "  --compression N          Zstd compression level 1-19 (default: 3)\n"
+              << "  --target-latency MS      Adapt batch limits to an end-to-end latency target\n"
+              << "  --target-rate BYTES      Adapt batch limits to a compressed bytes/s budget\n"
+              << "  --compressor NAME        zstd, lz4, auto or none (default: zstd)\n"
+              << "  --compression N          Level: zstd 1-19 or negative fast levels (default: 3),\n"
+              << "                           lz4 0-12 (default: 0), auto: strongest zstd level\n"
+              << "  --cpu-budget NS          auto: compression CPU per input byte (default: 10)\n"
               << "  --no-compression         Disable compression\n"
+              << "  --zstd-dict FILE         Zstd dictionary (see vep_zstd_dict_trainer)\n"
+              << "  --compress-workers N     Compression threads, 0 = inline on flush thread (default: 2)\n"
+              << "  --intern-paths           Send signal paths as ids with in-band dictionary\n"
+              << "  --arena                  Build batch items in place on a protobuf arena\n"
+              << "  --direct-encoding        Serialize items straight from DDS to wire bytes\n"
+              << "  --signal-blocks          Group same-path signal samples into column blocks\n"
+              << "  --policy FILE            Per-path export policy (YAML, see config/export_policy.yaml)\n"
+              << "  --log-dedup MS           Collapse repeated log entries within MS into one\n"
+              << "  --log-templates          Send log messages as learned templates plus parameters\n"
+              << "  --string-table           Send metric/log names and labels once per batch\n"
+              << "  --metric-series          Send metrics as series ids with counter/histogram deltas\n"
+              << "  --spool DIR              Store batches on disk while offline, replay on reconnect\n"
+              << "  --spool-size BYTES       Spool size on disk, shared equally by the lanes\n"
+              << "                           (default: 33554432)\n"
+              << "  --replay-rate BYTES      Spool replay limit in bytes/s (default: 65536, 0 = none)\n"
+              << "  --spool-sync BYTES       Spooled bytes a power loss may lose (default: 0, every\n"
+              << "                           batch is on disk when spooled)\n"
+              << "  --urgent-events LEVEL    Send events of LEVEL (info|warning|error|critical) and\n"
+              << "                           above at once in express batches\n"
+              << "  --urgent-linger MS       Wait for more urgent events before sending (default: 5)\n"
+              << "  --shed-load              Drop low-value items while the transport queue fills\n"
+              << "  --latency SEC            Track stage and per-type item latency, log every SEC\n"
+              << "  --publish-latency        Also publish latency histograms on rt/telemetry/histograms\n"
+              << "  --memory-budget BYTES    Bound buffered batches and items, shared equally by\n"
+              << "                           the lanes (default: unlimited)\n"
+              << "  --overflow POLICY        Over budget: drop-newest|drop-oldest|block\n"
+              << "                           (default: drop-newest)\n"
+              << "  --block-timeout MS       Longest wait per item with --overflow block (default: 50)\n"
+              << "  --lane SPEC              Separate pipeline for matching items (repeatable), e.g.\n"
+              << "                           name=logs,types=log,content-id=3,compression=19\n"
+              << "                           keys: name, types (signal|event|metric|log),\n"
+              << "                           prefixes (A|B), content-id, compressor, compression,\n"
+              << "                           batch-size, batch-timeout; others as the default lane\n"
               << "  --help                   Show this help message\n"
               << "\n"
               << "Environment:\n"
@@ -73,9 +139,87 @@ struct Config {
     vep::exporter::UnifiedPipelineConfig pipeline;
     integration::SubscriptionConfig sub;
     std::string compressor_type = "zstd";
-    int compression_level = 3;
+    std::optional<int> compression_level;  // Default per codec
+    vep::exporter::AutoCompressionConfig auto_compression;
+    std::vector<uint8_t> zstd_dictionary;
+    bool publish_latency = false;
+    std::vector<std::string> lanes;  // --lane specs, resolved against the rest
 };
 
+/// A --lane: route, pipeline and transport settings
+struct LaneOptions {
+    vep::exporter::LaneConfig lane;
+    vep::IfexBackendTransportConfig transport;
+    std::string compressor_type;
+    std::optional<int> compression_level;
+};
+
+std::vector<std::string> split(const std::string& text, char separator) {
+    std::vector<std::string> parts;
+    std::istringstream in(text);
+    std::string part;
+    while (std::getline(in, part, separator)) {
+        if (!part.empty()) {
+            parts.push_back(part);
+        }
+    }
+    return parts;
+}
+
+/// Lane from "key=value,..." on top of the default lane's settings
+std::optional<LaneOptions> parse_lane(const std::string& spec, const Config& config) {
+    LaneOptions options;
+    options.lane.pipeline = config.pipeline;
+    options.transport = config.transport;
+    options.compressor_type = config.compressor_type;
+    options.compression_level = config.compression_level;
+
+    for (const auto& field : split(spec, ',')) {
+        size_t equals = field.find('=');
+        if (equals == std::string::npos) {
+            LOG(ERROR) << "Lane " << spec << ": expected key=value, got " << field;
+            return std::nullopt;
+        }
+        std::string key = field.substr(0, equals);
+        std::string value = field.substr(equals + 1);
+        if (key == "name") {
+            options.lane.name = value;
+        } else if (key == "types") {
+            for (const auto& name : split(value, '|')) {
+                auto type = vep::exporter::item_type_from_string(name);
+                if (!type) {
+                    LOG(ERROR) << "Lane " << spec << ": unknown item type " << name;
+                    return std::nullopt;
+                }
+                options.lane.route.types.push_back(*type);
+            }
+        } else if (key == "prefixes") {
+            options.lane.route.prefixes = split(value, '|');
+        } else if (key == "content-id") {
+            options.transport.content_id = static_cast<uint32_t>(std::stoul(value));
+        } else if (key == "compressor") {
+            options.compressor_type = value;
+        } else if (key == "compression") {
+            options.compression_level = std::stoi(value);
+        } else if (key == "batch-size") {
+            options.lane.pipeline.batch_max_items = std::stoul(value);
+        } else if (key == "batch-timeout") {
+            options.lane.pipeline.batch_timeout = std::chrono::milliseconds(std::stoi(value));
+        } else {
+            LOG(ERROR) << "Lane " << spec << ": unknown key " << key;
+            return std::nullopt;
+        }
+    }
+    if (options.lane.name.empty() || options.lane.name == "default") {
+        LOG(ERROR) << "Lane " << spec << ": needs a name other than \"default\"";
+        return std::nullopt;
+    }
+    // Own sequence numbers and spool per lane
+    options.lane.pipeline.source_id += "/" + options.lane.name;
+    options.lane.pipeline.spool.directory += "/" + options.lane.name;
+    return options;
+}
+
 Config parse_args(int argc, char* argv[]) {
     Config config;
 
@@ -101,10 +245,94 @@ Config parse_args(int argc, char* argv[]) {
             config.pipeline.batch_max_items = std::stoul(argv[++i]);
         } else if (arg == "--batch-timeout" && i + 1 < argc) {
             config.pipeline.batch_timeout = std::chrono::milliseconds(std::stoi(argv[++i]));
+        } else if (arg == "--target-latency" && i + 1 < argc) {
+            config.pipeline.adaptive.enabled = true;
+            config.pipeline.adaptive.target_latency_ms = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } else if (arg == "--target-rate" && i + 1 < argc) {
+            config.pipeline.adaptive.enabled = true;
+            config.pipeline.adaptive.target_bytes_per_sec = std::stoull(argv[++i]);
+        } else if (arg == "--compressor" && i + 1 < argc) {
+            config.compressor_type = argv[++i];
         } else if (arg == "--compression" && i + 1 < argc) {
             config.compression_level = std::stoi(argv[++i]);
+        } else if (arg == "--cpu-budget" && i + 1 < argc) {
+            config.auto_compression.max_ns_per_byte = std::stod(argv[++i]);
+        } else if (arg == "--compress-workers" && i + 1 < argc) {
+            config.pipeline.stages.compress_workers = std::stoul(argv[++i]);
+        } else if (arg == "--zstd-dict" && i + 1 < argc) {
+            auto dictionary = vep::exporter::load_zstd_dictionary(argv[++i]);
+            if (!dictionary) {
+                exit(1);
+            }
+            config.zstd_dictionary = std::move(*dictionary);
         } else if (arg == "--no-compression") {
             config.compressor_type = "none";
+        } else if (arg == "--intern-paths") {
+            config.pipeline.encoding.intern_paths = true;
+        } else if (arg == "--arena") {
+            config.pipeline.encoding.use_arena = true;
+        } else if (arg == "--direct-encoding") {
+            config.pipeline.encoding.direct_encoding = true;
+        } else if (arg == "--signal-blocks") {
+            config.pipeline.encoding.signal_blocks = true;
+        } else if (arg == "--log-dedup" && i + 1 < argc) {
+            config.pipeline.log_dedup.enabled = true;
+            config.pipeline.log_dedup.window_ms = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } else if (arg == "--log-templates") {
+            config.pipeline.encoding.log_templates = true;
+        } else if (arg == "--string-table") {
+            config.pipeline.encoding.string_table = true;
+        } else if (arg == "--metric-series") {
+            config.pipeline.encoding.metric_series = true;
+        } else if (arg == "--spool" && i + 1 < argc) {
+            config.pipeline.spool.enabled = true;
+            config.pipeline.spool.directory = argv[++i];
+        } else if (arg == "--spool-size" && i + 1 < argc) {
+            // Fixed segment count: the size sets the segment size
+            config.pipeline.spool.segment_bytes =
+                std::stoull(argv[++i]) / config.pipeline.spool.segments;
+        } else if (arg == "--replay-rate" && i + 1 < argc) {
+            config.pipeline.spool.replay_bytes_per_sec = std::stoull(argv[++i]);
+        } else if (arg == "--spool-sync" && i + 1 < argc) {
+            config.pipeline.spool.sync_bytes = std::stoull(argv[++i]);
+        } else if (arg == "--urgent-events" && i + 1 < argc) {
+            auto severity = severity_from_string(argv[++i]);
+            if (!severity) {
+                LOG(ERROR) << "Unknown event severity: " << argv[i];
+                exit(1);
+            }
+            config.pipeline.urgent.enabled = true;
+            config.pipeline.urgent.min_severity = *severity;
+        } else if (arg == "--urgent-linger" && i + 1 < argc) {
+            config.pipeline.urgent.linger = std::chrono::milliseconds(std::stoul(argv[++i]));
+        } else if (arg == "--shed-load") {
+            config.pipeline.shedding.enabled = true;
+        } else if (arg == "--latency" && i + 1 < argc) {
+            config.pipeline.latency.enabled = true;
+            config.pipeline.latency.interval = std::chrono::seconds(std::stoul(argv[++i]));
+        } else if (arg == "--publish-latency") {
+            config.pipeline.latency.enabled = true;
+            config.publish_latency = true;
+        } else if (arg == "--memory-budget" && i + 1 < argc) {
+            config.pipeline.memory.max_bytes = std::stoull(argv[++i]);
+        } else if (arg == "--overflow" && i + 1 < argc) {
+            auto policy = overflow_from_string(argv[++i]);
+            if (!policy) {
+                LOG(ERROR) << "Unknown overflow policy: " << argv[i];
+                exit(1);
+            }
+            config.pipeline.memory.policy = *policy;
+        } else if (arg == "--block-timeout" && i + 1 < argc) {
+            config.pipeline.memory.block_timeout = std::chrono::milliseconds(std::stoul(argv[++i]));
+        } else if (arg == "--lane" && i + 1 < argc) {
+            config.lanes.push_back(argv[++i]);
+        } else if (arg == "--policy" && i + 1 < argc) {
+            auto policy = vep::exporter::load_export_policy(argv[++i]);
+            if (!policy) {
+                LOG(ERROR) << "Invalid export policy: " << argv[i];
+                exit(1);
+            }
+            config.pipeline.policy = std::move(*policy);
         } else {
             LOG(WARNING) << "Unknown argument: " << arg;
         }
@@ -119,8 +347,53 @@ void log_config(const Config& config) {
     LOG(INFO) << "Content ID: " << config.transport.content_id;
     LOG(INFO) << "Batching: " << config.pipeline.batch_max_items << " items, "
               << config.pipeline.batch_timeout.count() << "ms timeout";
+    if (config.pipeline.adaptive.enabled) {
+        LOG(INFO) << "Adaptive batching: latency target "
+                  << config.pipeline.adaptive.target_latency_ms << "ms, rate target "
+                  << config.pipeline.adaptive.target_bytes_per_sec << " B/s (0 = none)";
+    }
     LOG(INFO) << "Compression: " << config.compressor_type
-              << (config.compressor_type == "zstd" ? " (level " + std::to_string(config.compression_level) + ")" : "");
+              << (config.compression_level ? " (level " + std::to_string(*config.compression_level) + ")" : "");
+    if (config.compressor_type == "auto") {
+        LOG(INFO) << "Compression CPU budget: " << config.auto_compression.max_ns_per_byte
+                  << " ns/byte";
+    }
+    if (!config.zstd_dictionary.empty()) {
+        LOG(INFO) << "Zstd dictionary: id " << vep::exporter::zstd_dictionary_id(config.zstd_dictionary)
+                  << ", " << config.zstd_dictionary.size() << " bytes";
+    }
+    LOG(INFO) << "Path interning: " << (config.pipeline.encoding.intern_paths ? "enabled" : "disabled");
+    LOG(INFO) << "Export policy: " << config.pipeline.policy.rules.size() << " rules, default "
+              << vep::exporter::to_string(config.pipeline.policy.default_action);
+    if (config.pipeline.log_dedup.enabled) {
+        LOG(INFO) << "Log dedup: " << config.pipeline.log_dedup.window_ms << "ms window";
+    }
+    LOG(INFO) << "Log templates: " << (config.pipeline.encoding.log_templates ? "enabled" : "disabled");
+    LOG(INFO) << "String table: " << (config.pipeline.encoding.string_table ? "enabled" : "disabled");
+    LOG(INFO) << "Metric series: " << (config.pipeline.encoding.metric_series ? "enabled" : "disabled");
+    if (config.pipeline.spool.enabled) {
+        LOG(INFO) << "Spool: " << config.pipeline.spool.directory << ", "
+                  << config.pipeline.spool.segments * config.pipeline.spool.segment_bytes
+                  << " bytes, replay " << config.pipeline.spool.replay_bytes_per_sec << " B/s"
+                  << ", sync every " << config.pipeline.spool.sync_bytes << " bytes";
+    }
+    if (config.pipeline.urgent.enabled) {
+        LOG(INFO) << "Urgent events: severity >= " << config.pipeline.urgent.min_severity
+                  << ", linger " << config.pipeline.urgent.linger.count() << "ms";
+    }
+    LOG(INFO) << "Load shedding: " << (config.pipeline.shedding.enabled ? "enabled" : "disabled");
+    if (config.pipeline.memory.max_bytes > 0) {
+        LOG(INFO) << "Memory budget: " << config.pipeline.memory.max_bytes << " bytes, "
+                  << vep::exporter::overflow_policy_name(config.pipeline.memory.policy)
+                  << " when over";
+    }
+    for (const auto& lane : config.lanes) {
+        LOG(INFO) << "Lane: " << lane;
+    }
+    if (config.pipeline.latency.enabled) {
+        LOG(INFO) << "Latency: every " << config.pipeline.latency.interval.count() << "s"
+                  << (config.publish_latency ? ", published on rt/telemetry/histograms" : "");
+    }
 }
 
 }  // namespace
@@ -145,31 +418,108 @@ int main(int argc, char* argv[]) {
     LOG(INFO) << "Creating DDS participant...";
     dds::Participant participant;
 
-    // Create transport (IFEX gRPC backend)
-    LOG(INFO) << "Creating IFEX backend transport...";
-    auto transport = std::make_unique<vep::IfexBackendTransport>(config.transport);
+    // Latency histograms go out as telemetry like any other: the exporter's
+    // own subscription picks them up again
+    auto qos_latency = dds::qos_profiles::best_effort(8);
+    std::unique_ptr<dds::Topic> latency_topic;
+    std::unique_ptr<dds::Writer> latency_writer;
+    if (config.publish_latency) {
+        latency_topic = std::make_unique<dds::Topic>(
+            participant, &vep_OtelHistogram_desc, "rt/telemetry/histograms", qos_latency.get());
+        latency_writer = std::make_unique<dds::Writer>(participant, *latency_topic, qos_latency.get());
+        config.pipeline.latency.publish = [&latency_writer](const vep_OtelHistogram& msg) {
+            latency_writer->write(msg);
+        };
+    }
 
-    // Create compressor
-    auto comp_type = vep::exporter::compressor_type_from_string(config.compressor_type);
-    if (!comp_type) {
-        LOG(ERROR) << "Unknown compressor type: " << config.compressor_type;
-        return 1;
+    // Lanes: --lane pipelines first (matched in order), then the default
+    // lane for everything else. Each has its own transport and compressor.
+    std::vector<LaneOptions> lanes;
+    for (const auto& spec : config.lanes) {
+        auto lane = parse_lane(spec, config);
+        if (!lane) {
+            return 1;
+        }
+        lanes.push_back(std::move(*lane));
     }
-    LOG(INFO) << "Creating compressor (" << vep::exporter::to_string(*comp_type) << ")...";
-    auto compressor = vep::exporter::create_compressor(*comp_type, config.compression_level);
-    if (!compressor) {
-        LOG(ERROR) << "Failed to create compressor";
-        return 1;
+    LaneOptions default_lane;
+    default_lane.lane.name = "default";
+    default_lane.lane.pipeline = config.pipeline;
+    default_lane.transport = config.transport;
+    default_lane.compressor_type = config.compressor_type;
+    default_lane.compression_level = config.compression_level;
+    lanes.push_back(std::move(default_lane));
+
+    // --memory-budget and --spool-size bound the whole process: each lane
+    // gets an equal share. The spool is split by segments, keeping each
+    // segment large enough for a batch.
+    for (auto& lane : lanes) {
+        auto& pipeline = lane.lane.pipeline;
+        auto& spool = pipeline.spool;
+        size_t spool_bytes = spool.segments * spool.segment_bytes / lanes.size();
+        if (lanes.size() > 1) {
+            if (pipeline.memory.max_bytes > 0) {
+                // At least 1: 0 would mean unlimited
+                pipeline.memory.max_bytes =
+                    std::max<size_t>(1, pipeline.memory.max_bytes / lanes.size());
+            }
+            spool.segments = std::max<size_t>(2, spool.segments / lanes.size());
+            spool.segment_bytes = spool_bytes / spool.segments;
+        }
+        size_t min_segment = vep::exporter::BatchSpool::segment_bytes_for(pipeline.batch_max_bytes);
+        if (spool.enabled && spool.segment_bytes < min_segment) {
+            LOG(WARNING) << "Lane " << lane.lane.name << ": spool of " << spool_bytes
+                         << " bytes is too small for " << spool.segments << " segments of "
+                         << pipeline.batch_max_bytes << "-byte batches, using "
+                         << spool.segments * min_segment << " bytes";
+            spool.segment_bytes = min_segment;
+        }
+        if (lanes.size() > 1 && pipeline.memory.max_bytes > 0) {
+            LOG(INFO) << "Lane " << lane.lane.name << ": memory budget "
+                      << pipeline.memory.max_bytes << " bytes";
+        }
+        if (lanes.size() > 1 && spool.enabled) {
+            LOG(INFO) << "Lane " << lane.lane.name << ": spool " << spool.segments << " x "
+                      << spool.segment_bytes << " bytes";
+        }
     }
 
-    // Create unified exporter pipeline (interleaved items in TransferBatch)
-    LOG(INFO) << "Creating unified exporter pipeline...";
-    vep::exporter::UnifiedExporterPipeline pipeline(
-        std::move(transport),
-        std::move(compressor),
-        config.pipeline);
+    // Create unified exporter pipelines (interleaved items in TransferBatch)
+    vep::exporter::PipelineRouter router;
+    for (const auto& lane : lanes) {
+        // Create compressor
+        auto comp_type = vep::exporter::compressor_type_from_string(lane.compressor_type);
+        if (!comp_type) {
+            LOG(ERROR) << "Unknown compressor type: " << lane.compressor_type;
+            return 1;
+        }
+        LOG(INFO) << "Creating " << lane.lane.name << " lane (IFEX backend transport, content id "
+                  << lane.transport.content_id << ", " << vep::exporter::to_string(*comp_type)
+                  << " compressor)...";
+        int level = lane.compression_level.value_or(
+            vep::exporter::default_compression_level(*comp_type));
+        std::unique_ptr<vep::exporter::Compressor> compressor;
+        if (*comp_type == vep::exporter::CompressorType::AUTO) {
+            auto auto_compression = config.auto_compression;
+            auto_compression.max_level = level;
+            compressor = vep::exporter::create_auto_compressor(auto_compression,
+                                                               config.zstd_dictionary);
+        } else {
+            compressor = vep::exporter::create_compressor(*comp_type, level, config.zstd_dictionary);
+        }
+        if (!compressor) {
+            LOG(ERROR) << "Failed to create compressor";
+            return 1;
+        }
+
+        // Create transport (IFEX gRPC backend)
+        auto transport = std::make_unique<vep::IfexBackendTransport>(lane.transport);
+        if (!router.add_lane(lane.lane, std::move(transport), std::move(compressor))) {
+            return 1;
+        }
+    }
 
-    if (!pipeline.start()) {
+    if (!router.start()) {
         LOG(ERROR) << "Failed to start exporter pipeline";
         return 1;
     }
@@ -178,30 +528,8 @@ int main(int argc, char* argv[]) {
     LOG(INFO) << "Creating subscription manager...";
     integration::SubscriptionManager sub_manager(participant, config.sub);
 
-    // Wire callbacks to pipeline
-    sub_manager.on_vss_signal([&pipeline](const vep_VssSignal& msg) {
-        pipeline.send(msg);
-    });
-
-    sub_manager.on_event([&pipeline](const vep_Event& msg) {
-        pipeline.send(msg);
-    });
-
-    sub_manager.on_gauge([&pipeline](const vep_OtelGauge& msg) {
-        pipeline.send(msg);
-    });
-
-    sub_manager.on_counter([&pipeline](const vep_OtelCounter& msg) {
-        pipeline.send(msg);
-    });
-
-    sub_manager.on_histogram([&pipeline](const vep_OtelHistogram& msg) {
-        pipeline.send(msg);
-    });
-
-    sub_manager.on_log_entry([&pipeline](const vep_OtelLogEntry& msg) {
-        pipeline.send(msg);
-    });
+    // Each take from a reader goes to the router as one span
+    sub_manager.send_batches_to(router);
 
     // Start receiving
     sub_manager.start();
@@ -218,33 +546,48 @@ int main(int argc, char* argv[]) {
         if (now - last_stats_time >= stats_interval) {
             last_stats_time = now;
 
-            auto stats = pipeline.stats();
-            LOG(INFO) << "Stats: items=" << stats.items_total
-                      << " (signals=" << stats.signals_processed
-                      << " events=" << stats.events_processed
-                      << " metrics=" << stats.metrics_processed
-                      << " logs=" << stats.logs_processed << ")"
-                      << " batches=" << stats.batches_sent
-                      << " compression=" << std::fixed << std::setprecision(1)
-                      << (stats.compression_ratio() * 100.0) << "%";
+            for (const auto& lane : router.stats().lanes) {
+                const auto& stats = lane.pipeline;
+                LOG(INFO) << "Stats" << (router.lanes() > 1 ? "[" + lane.name + "]" : "")
+                          << ": items=" << stats.items_total
+                          << " (signals=" << stats.signals_processed
+                          << " events=" << stats.events_processed
+                          << " metrics=" << stats.metrics_processed
+                          << " logs=" << stats.logs_processed << ")"
+                          << " suppressed=" << stats.signals_suppressed
+                          << " logs_collapsed=" << stats.logs_collapsed
+                          << " shed=" << (stats.signals_shed + stats.metrics_shed + stats.logs_shed)
+                          << " batches=" << stats.batches_sent
+                          << " spool_pending=" << stats.spool.batches_pending
+                          << " memory=" << stats.memory_bytes
+                          << " overflow=" << (stats.overflow_items_dropped +
+                                              stats.overflow_batches_dropped)
+                          << " limits=" << stats.batch_limits.max_items << "/"
+                          << stats.batch_limits.timeout.count() << "ms"
+                          << " compression=" << std::fixed << std::setprecision(1)
+                          << (stats.compression_ratio() * 100.0) << "%";
+            }
         }
     }
 
     // Shutdown
     LOG(INFO) << "Shutting down...";
     sub_manager.stop();
-    pipeline.stop();
+    router.stop();
 
     // Final stats
-    auto stats = pipeline.stats();
-    LOG(INFO) << "Final stats: items=" << stats.items_total
-              << " (signals=" << stats.signals_processed
-              << " events=" << stats.events_processed
-              << " metrics=" << stats.metrics_processed
-              << " logs=" << stats.logs_processed << ")"
-              << " batches=" << stats.batches_sent
-              << " compression=" << std::fixed << std::setprecision(1)
-              << (stats.compression_ratio() * 100.0) << "%";
+    for (const auto& lane : router.stats().lanes) {
+        const auto& stats = lane.pipeline;
+        LOG(INFO) << "Final stats" << (router.lanes() > 1 ? "[" + lane.name + "]" : "")
+                  << ": items=" << stats.items_total
+                  << " (signals=" << stats.signals_processed
+                  << " events=" << stats.events_processed
+                  << " metrics=" << stats.metrics_processed
+                  << " logs=" << stats.logs_processed << ")"
+                  << " batches=" << stats.batches_sent
+                  << " compression=" << std::fixed << std::setprecision(1)
+                  << (stats.compression_ratio() * 100.0) << "%";
+    }
 
     LOG(INFO) << "VEP Exporter IFEX stopped.";
     return 0;
@@ -67,9 +67,10 @@ $SUDO apt-get install -y \
     protobuf-compiler
 
 echo ""
-echo "Installing zstd compression library..."
+echo "Installing zstd and lz4 compression libraries..."
 $SUDO apt-get install -y \
-    libzstd-dev
+    libzstd-dev \
+    liblz4-dev
 
 echo ""
 echo "Installing Lua (for libvssdag)..."
@@ -19,6 +19,8 @@
 /// - SomeipBackendTransport: content_id -> SOME/IP method via BE Message Proxy
 /// - IfexBackendTransport: content_id -> gRPC channel metadata
 
+#include "vep/payload_buffer.hpp"
+
 #include <cstdint>
 #include <functional>
 #include <string>
@@ -158,6 +160,18 @@ public:
     virtual bool publish(const std::vector<uint8_t>& data,
                          Persistence persistence = Persistence::BestEffort) = 0;
 
+    /// Publish a pooled buffer without copying it
+    ///
+    /// The transport owns the buffer and drops it once it no longer needs
+    /// the bytes (on return, or on completion for asynchronous transports),
+    /// which returns the storage to its pool.
+    /// Default: publish(buffer.bytes(), persistence).
+    /// @return true if publish succeeded
+    virtual bool publish_buffer(PayloadBuffer buffer,
+                                Persistence persistence = Persistence::BestEffort) {
+        return publish(buffer.bytes(), persistence);
+    }
+
     // =========================================================================
     // c2v: Cloud-to-Vehicle (receive)
     // =========================================================================
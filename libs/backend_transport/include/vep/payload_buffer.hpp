@@ -0,0 +1,137 @@
+// Copyright 2025 Vehicle Edge Platform Contributors
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+/// @file payload_buffer.hpp
+/// @brief Pooled payload buffers passed to BackendTransport without copying
+///
+/// A PayloadBuffer owns the bytes of one outgoing message. It is moved,
+/// never copied, from the producer (e.g. the exporter's compressor) into
+/// BackendTransport::publish_buffer(). When the last owner drops it, its
+/// storage goes back to the BufferPool it came from, capacity intact, so
+/// steady-state publishing does not allocate.
+///
+/// Example:
+/// @code
+///   auto pool = vep::BufferPool::create();
+///   vep::PayloadBuffer buffer = pool->acquire();
+///   buffer.bytes().assign(payload.begin(), payload.end());
+///   transport.publish_buffer(std::move(buffer));  // Storage back in pool when done
+/// @endcode
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace vep {
+
+class BufferPool;
+
+/// Move-only payload; returns its storage to its pool on destruction
+class PayloadBuffer {
+public:
+    PayloadBuffer() = default;
+
+    /// Wrap bytes; with a pool, the storage is recycled into it on release
+    explicit PayloadBuffer(std::vector<uint8_t> bytes, std::shared_ptr<BufferPool> pool = nullptr)
+        : bytes_(std::move(bytes))
+        , pool_(std::move(pool)) {}
+
+    ~PayloadBuffer() { release(); }
+
+    PayloadBuffer(PayloadBuffer&& other) noexcept
+        : bytes_(std::move(other.bytes_))
+        , pool_(std::move(other.pool_)) {}
+
+    PayloadBuffer& operator=(PayloadBuffer&& other) noexcept {
+        if (this != &other) {
+            release();
+            bytes_ = std::move(other.bytes_);
+            pool_ = std::move(other.pool_);
+        }
+        return *this;
+    }
+
+    PayloadBuffer(const PayloadBuffer&) = delete;
+    PayloadBuffer& operator=(const PayloadBuffer&) = delete;
+
+    /// Payload bytes; size() is the message size
+    std::vector<uint8_t>& bytes() { return bytes_; }
+    const std::vector<uint8_t>& bytes() const { return bytes_; }
+
+    const uint8_t* data() const { return bytes_.data(); }
+    size_t size() const { return bytes_.size(); }
+    bool empty() const { return bytes_.empty(); }
+
+    /// Give the storage back to the pool now (buffer becomes empty)
+    inline void release();
+
+private:
+    std::vector<uint8_t> bytes_;
+    std::shared_ptr<BufferPool> pool_;
+};
+
+/// Recycles PayloadBuffer storage
+///
+/// Thread-safe: buffers may be released on any thread (e.g. a transport's
+/// completion callback). Buffers keep the pool alive.
+class BufferPool : public std::enable_shared_from_this<BufferPool> {
+public:
+    /// @param max_buffers Free buffers kept for reuse; more are freed
+    static std::shared_ptr<BufferPool> create(size_t max_buffers = 8) {
+        return std::shared_ptr<BufferPool>(new BufferPool(max_buffers));
+    }
+
+    /// Empty buffer, with the capacity of a recycled one if available
+    PayloadBuffer acquire() {
+        std::vector<uint8_t> storage;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!free_.empty()) {
+                storage = std::move(free_.back());
+                free_.pop_back();
+            }
+        }
+        storage.clear();
+        return PayloadBuffer(std::move(storage), shared_from_this());
+    }
+
+    /// Buffers waiting for reuse
+    size_t available() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return free_.size();
+    }
+
+private:
+    friend class PayloadBuffer;
+
+    explicit BufferPool(size_t max_buffers) : max_buffers_(max_buffers) {}
+
+    void recycle(std::vector<uint8_t>&& storage) {
+        if (storage.capacity() == 0) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (free_.size() < max_buffers_) {
+            free_.push_back(std::move(storage));
+        }
+    }
+
+    size_t max_buffers_;
+    mutable std::mutex mutex_;
+    std::vector<std::vector<uint8_t>> free_;
+};
+
+inline void PayloadBuffer::release() {
+    if (pool_) {
+        pool_->recycle(std::move(bytes_));
+        pool_.reset();
+    }
+    bytes_ = {};
+}
+
+}  // namespace vep
@@ -4,29 +4,35 @@
 /// @file main.cpp
 /// @brief VEP MQTT Logger - Receives and decodes compressed MQTT messages
 ///
-/// Subscribes to MQTT topics, decompresses with zstd, decodes TransferBatch
-/// protobuf, and logs data. This is the public/open-source version that
-/// does not use CCPMainMessage envelope.
+/// Subscribes to MQTT topics, decompresses (zstd or LZ4, told apart by
+/// frame magic), decodes TransferBatch protobuf, and logs data. This is
+/// the public/open-source version that does not use CCPMainMessage envelope.
 ///
 /// Message format:
-///   MQTT payload -> zstd compressed -> TransferBatch (interleaved items)
+///   MQTT payload -> zstd / lz4 frame or uncompressed -> TransferBatch (interleaved items)
 ///
 /// This tool serves as a template for cloud-side ingestion (e.g., MQTT-to-Kafka).
 ///
 /// Usage:
 ///   vep_mqtt_logger --broker localhost --port 1883 --topic "telemetry/#"
 ///   vep_mqtt_logger --json  # Output JSON format
+///   vep_mqtt_logger --capture captures/  # Save batches for vep_zstd_dict_trainer
 
 #include "transfer.pb.h"
 
 #include <glog/logging.h>
+#include <lz4frame.h>
 #include <zstd.h>
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <iterator>
 #include <map>
 #include <mosquitto.h>
 #include <signal.h>
@@ -44,11 +50,21 @@ struct Config {
     std::string topic_pattern = "telemetry/#";
     bool json_output = false;
     bool verbose = false;
+    std::string zstd_dict;    // Dictionary file for tagged frames
+    std::string capture_dir;  // Save decompressed batches here
 };
 
+// Largest decompressed batch accepted: 64 times the exporter's default
+// batch_max_bytes; frame headers claiming more are not allocated
+constexpr size_t kMaxDecompressedSize = 64 * 64 * 1024;
+
 Config g_config;
 std::atomic<bool> g_running{true};
 ZSTD_DCtx* g_zstd_ctx = nullptr;
+ZSTD_DDict* g_zstd_ddict = nullptr;
+LZ4F_dctx* g_lz4_ctx = nullptr;
+unsigned g_zstd_dict_id = 0;
+uint64_t g_captured = 0;
 
 // Statistics per source
 struct SourceStats {
@@ -65,28 +81,45 @@ struct SourceStats {
 
 std::map<std::string, SourceStats> g_source_stats;
 
+// Interned signal paths per source (from in-band PathDictionary)
+std::map<std::string, std::map<uint32_t, std::string>> g_source_paths;
+
 void signal_handler(int sig) {
     LOG(INFO) << "Received signal " << sig << ", shutting down...";
     g_running = false;
 }
 
-std::vector<uint8_t> decompress(const uint8_t* data, size_t size) {
+std::vector<uint8_t> decompress_zstd(const uint8_t* data, size_t size) {
     if (!g_zstd_ctx) {
         g_zstd_ctx = ZSTD_createDCtx();
     }
 
     unsigned long long decompressed_size = ZSTD_getFrameContentSize(data, size);
     if (decompressed_size == ZSTD_CONTENTSIZE_UNKNOWN) {
-        decompressed_size = size * 10;
+        decompressed_size = std::min<unsigned long long>(size * 10, kMaxDecompressedSize);
     } else if (decompressed_size == ZSTD_CONTENTSIZE_ERROR) {
         LOG(ERROR) << "Invalid zstd frame";
         return {};
+    } else if (decompressed_size > kMaxDecompressedSize) {
+        LOG(ERROR) << "Zstd frame of " << decompressed_size << " bytes exceeds limit";
+        return {};
+    }
+
+    // Frames compressed with a dictionary carry its id
+    unsigned dict_id = ZSTD_getDictID_fromFrame(data, size);
+    if (dict_id != 0 && dict_id != g_zstd_dict_id) {
+        LOG(ERROR) << "Frame needs zstd dictionary " << dict_id << " (--zstd-dict)";
+        return {};
     }
 
     std::vector<uint8_t> decompressed(decompressed_size);
-    size_t result = ZSTD_decompressDCtx(g_zstd_ctx,
-                                         decompressed.data(), decompressed.size(),
-                                         data, size);
+    size_t result = dict_id != 0
+        ? ZSTD_decompress_usingDDict(g_zstd_ctx,
+                                     decompressed.data(), decompressed.size(),
+                                     data, size, g_zstd_ddict)
+        : ZSTD_decompressDCtx(g_zstd_ctx,
+                              decompressed.data(), decompressed.size(),
+                              data, size);
 
     if (ZSTD_isError(result)) {
         LOG(ERROR) << "Decompression failed: " << ZSTD_getErrorName(result);
@@ -97,6 +130,76 @@ std::vector<uint8_t> decompress(const uint8_t* data, size_t size) {
     return decompressed;
 }
 
+std::vector<uint8_t> decompress_lz4(const uint8_t* data, size_t size) {
+    if (!g_lz4_ctx) {
+        LZ4F_createDecompressionContext(&g_lz4_ctx, LZ4F_VERSION);
+    }
+
+    LZ4F_frameInfo_t info{};
+    size_t pos = size;
+    size_t result = LZ4F_getFrameInfo(g_lz4_ctx, &info, data, &pos);
+    if (!LZ4F_isError(result) && info.contentSize > kMaxDecompressedSize) {
+        LOG(ERROR) << "LZ4 frame of " << info.contentSize << " bytes exceeds limit";
+        LZ4F_resetDecompressionContext(g_lz4_ctx);
+        return {};
+    }
+    std::vector<uint8_t> decompressed(
+        info.contentSize > 0 ? info.contentSize : std::min(size * 10, kMaxDecompressedSize));
+    size_t written = 0;
+
+    // result is 0 once the frame is complete
+    while (!LZ4F_isError(result) && result != 0) {
+        if (written == decompressed.size()) {
+            if (written >= kMaxDecompressedSize) {
+                LOG(ERROR) << "LZ4 frame exceeds limit of " << kMaxDecompressedSize << " bytes";
+                LZ4F_resetDecompressionContext(g_lz4_ctx);
+                return {};
+            }
+            decompressed.resize(std::min(decompressed.size() * 2, kMaxDecompressedSize));
+        }
+        size_t out_size = decompressed.size() - written;
+        size_t in_size = size - pos;
+        result = LZ4F_decompress(g_lz4_ctx, decompressed.data() + written, &out_size,
+                                 data + pos, &in_size, nullptr);
+        pos += in_size;
+        written += out_size;
+        if (!LZ4F_isError(result) && result != 0 && pos == size && written < decompressed.size()) {
+            LOG(ERROR) << "Truncated lz4 frame";
+            LZ4F_resetDecompressionContext(g_lz4_ctx);
+            return {};
+        }
+    }
+
+    if (LZ4F_isError(result)) {
+        LOG(ERROR) << "Decompression failed: " << LZ4F_getErrorName(result);
+        LZ4F_resetDecompressionContext(g_lz4_ctx);
+        return {};
+    }
+
+    decompressed.resize(written);
+    return decompressed;
+}
+
+// Codec from the frame magic (little-endian); a TransferBatch starts
+// with a field tag, never with either magic
+std::vector<uint8_t> decompress(const uint8_t* data, size_t size, const char*& codec) {
+    uint32_t magic = 0;
+    if (size >= 4) {
+        magic = static_cast<uint32_t>(data[0]) | static_cast<uint32_t>(data[1]) << 8 |
+                static_cast<uint32_t>(data[2]) << 16 | static_cast<uint32_t>(data[3]) << 24;
+    }
+    if (magic == ZSTD_MAGICNUMBER) {
+        codec = "zstd";
+        return decompress_zstd(data, size);
+    }
+    if (magic == LZ4F_MAGICNUMBER) {
+        codec = "lz4";
+        return decompress_lz4(data, size);
+    }
+    codec = "none";
+    return std::vector<uint8_t>(data, data + size);
+}
+
 // Quality/Severity to string
 const char* quality_str(vep::transfer::Quality q) {
     switch (q) {
@@ -127,6 +230,66 @@ const char* log_level_str(vep::transfer::LogLevel l) {
     }
 }
 
+// Log message, expanded from its template ("<*>" = next parameter)
+std::string log_message_str(const vep::transfer::LogEntry& log,
+                            const std::map<uint32_t, std::string>& paths) {
+    if (log.template_id() == 0) {
+        return log.message();
+    }
+    auto it = paths.find(log.template_id());
+    if (it == paths.end()) {
+        std::string message = "template:" + std::to_string(log.template_id());
+        for (const auto& param : log.params()) {
+            message += " " + param;
+        }
+        return message;
+    }
+    const std::string& templ = it->second;
+    std::string message;
+    int param = 0;
+    size_t pos = 0;
+    for (size_t next; (next = templ.find("<*>", pos)) != std::string::npos; pos = next + 3) {
+        message.append(templ, pos, next - pos);
+        if (param < log.params_size()) {
+            message += log.params(param++);
+        }
+    }
+    message.append(templ, pos, std::string::npos);
+    return message;
+}
+
+// String table entry, or the inline value if ref is 0
+std::string batch_str(const vep::transfer::TransferBatch& batch, uint32_t ref,
+                      const std::string& value) {
+    if (ref == 0) {
+        return value;
+    }
+    if (ref <= static_cast<uint32_t>(batch.strings_size())) {
+        return batch.strings(static_cast<int>(ref - 1));
+    }
+    return "string:" + std::to_string(ref);
+}
+
+// Strings of a ref array; a ref of 0 (or no refs at all) takes the next
+// inline value
+std::vector<std::string> batch_strs(const vep::transfer::TransferBatch& batch,
+                                    const google::protobuf::RepeatedField<uint32_t>& refs,
+                                    const google::protobuf::RepeatedPtrField<std::string>& values) {
+    if (refs.empty()) {
+        return {values.begin(), values.end()};
+    }
+    std::vector<std::string> out;
+    int next = 0;
+    for (uint32_t ref : refs) {
+        if (ref != 0) {
+            out.push_back(batch_str(batch, ref, ""));
+        } else {
+            out.push_back(next < values.size() ? values.Get(next++) : "");
+        }
+    }
+    return out;
+}
+
 // Get signal value as string
 std::string signal_value_str(const vep::transfer::Signal& sig) {
     std::ostringstream oss;
@@ -172,13 +335,32 @@ void process_transfer_batch(const std::string& topic, const std::vector<uint8_t>
     const std::string& source_id = batch.source_id();
     auto& stats = g_source_stats[source_id];
 
+    auto& paths = g_source_paths[source_id];
+    if (batch.has_path_dictionary()) {
+        if (batch.path_dictionary().base_version() == 0) {
+            paths.clear();  // Full snapshot
+        }
+        for (const auto& entry : batch.path_dictionary().entries()) {
+            // Metric series are shown with their labels
+            std::string path = entry.path();
+            for (int i = 0; i < entry.label_keys_size() && i < entry.label_values_size(); ++i) {
+                path += (i == 0 ? " {" : ",") + entry.label_keys(i) + "=" + entry.label_values(i);
+            }
+            paths[entry.id()] = entry.label_keys_size() > 0 ? path + "}" : path;
+        }
+    }
+
     // Count items by type
     int signal_count = 0, event_count = 0, metric_count = 0, log_count = 0;
     for (const auto& item : batch.items()) {
         switch (item.item_case()) {
             case vep::transfer::TransferItem::kSignal: signal_count++; break;
+            case vep::transfer::TransferItem::kSignalBlock:
+                signal_count += static_cast<int>(item.signal_block().count());
+                break;
             case vep::transfer::TransferItem::kEvent: event_count++; break;
             case vep::transfer::TransferItem::kMetric: metric_count++; break;
+            case vep::transfer::TransferItem::kMetricSample: metric_count++; break;
             case vep::transfer::TransferItem::kLog: log_count++; break;
             default: break;
         }
@@ -215,7 +397,13 @@ void process_transfer_batch(const std::string& topic, const std::vector<uint8_t>
             switch (item.item_case()) {
                 case vep::transfer::TransferItem::kSignal: {
                     const auto& sig = item.signal();
-                    std::string path = sig.has_path() ? sig.path() : ("id:" + std::to_string(sig.path_id()));
+                    std::string path;
+                    if (sig.has_path()) {
+                        path = sig.path();
+                    } else {
+                        auto it = paths.find(sig.path_id());
+                        path = it != paths.end() ? it->second : ("id:" + std::to_string(sig.path_id()));
+                    }
                     std::cout << "  [SIG] " << path << " = " << signal_value_str(sig);
                     if (sig.quality() != vep::transfer::QUALITY_VALID) {
                         std::cout << " [" << quality_str(sig.quality()) << "]";
@@ -226,6 +414,25 @@ void process_transfer_batch(const std::string& topic, const std::vector<uint8_t>
                     std::cout << "\n";
                     break;
                 }
+                case vep::transfer::TransferItem::kSignalBlock: {
+                    const auto& block = item.signal_block();
+                    std::string path;
+                    if (block.has_path()) {
+                        path = block.path();
+                    } else {
+                        auto it = paths.find(block.path_id());
+                        path = it != paths.end() ? it->second : ("id:" + std::to_string(block.path_id()));
+                    }
+                    std::cout << "  [BLK] " << path << " x" << block.count() << " samples";
+                    if (block.quality() != vep::transfer::QUALITY_VALID) {
+                        std::cout << " [" << quality_str(block.quality()) << "]";
+                    }
+                    if (g_config.verbose) {
+                        std::cout << " (delay=" << delay_ms << "ms)";
+                    }
+                    std::cout << "\n";
+                    break;
+                }
                 case vep::transfer::TransferItem::kEvent: {
                     const auto& evt = item.event();
                     std::cout << "  [EVT] [" << severity_str(evt.severity()) << "] "
@@ -235,31 +442,63 @@ void process_transfer_batch(const std::string& topic, const std::vector<uint8_t>
                 }
                 case vep::transfer::TransferItem::kMetric: {
                     const auto& m = item.metric();
+                    std::string name = batch_str(batch, m.name_ref(), m.name());
                     std::cout << "  [MET] ";
                     if (m.has_gauge()) {
-                        std::cout << "[GAUGE] " << m.name() << " = " << m.gauge();
+                        std::cout << "[GAUGE] " << name << " = " << m.gauge();
                     } else if (m.has_counter()) {
-                        std::cout << "[COUNTER] " << m.name() << " = " << m.counter();
+                        std::cout << "[COUNTER] " << name << " = " << m.counter();
                     } else if (m.has_histogram()) {
-                        std::cout << "[HISTO] " << m.name()
+                        std::cout << "[HISTO] " << name
                                   << " count=" << m.histogram().sample_count()
                                   << " sum=" << m.histogram().sample_sum();
                     }
-                    if (m.label_keys_size() > 0) {
+                    auto keys = batch_strs(batch, m.label_key_refs(), m.label_keys());
+                    auto values = batch_strs(batch, m.label_value_refs(), m.label_values());
+                    if (!keys.empty()) {
                         std::cout << " {";
-                        for (int i = 0; i < m.label_keys_size() && i < m.label_values_size(); ++i) {
+                        for (size_t i = 0; i < keys.size() && i < values.size(); ++i) {
                             if (i > 0) std::cout << ",";
-                            std::cout << m.label_keys(i) << "=" << m.label_values(i);
+                            std::cout << keys[i] << "=" << values[i];
                         }
                         std::cout << "}";
                     }
                     std::cout << "\n";
                     break;
                 }
+                case vep::transfer::TransferItem::kMetricSample: {
+                    // Changes are shown as such: absolute values need the
+                    // series' earlier samples
+                    const auto& m = item.metric_sample();
+                    auto it = paths.find(m.series_id());
+                    std::string name = it != paths.end() ? it->second
+                                                         : ("series:" + std::to_string(m.series_id()));
+                    std::cout << "  [MET] ";
+                    if (m.has_gauge()) {
+                        std::cout << "[GAUGE] " << name << " = " << m.gauge();
+                    } else if (m.has_counter()) {
+                        std::cout << "[COUNTER] " << name << " = " << m.counter();
+                    } else if (m.has_counter_delta()) {
+                        std::cout << "[COUNTER] " << name << " +" << m.counter_delta();
+                    } else if (m.has_histogram()) {
+                        std::cout << "[HISTO] " << name
+                                  << (m.histogram().delta() ? " count+" : " count=")
+                                  << m.histogram().sample_count()
+                                  << " sum=" << m.histogram().sample_sum();
+                    }
+                    std::cout << "\n";
+                    break;
+                }
                 case vep::transfer::TransferItem::kLog: {
                     const auto& log = item.log();
                     std::cout << "  [LOG] [" << log_level_str(log.level()) << "] "
-                              << log.component() << ": " << log.message() << "\n";
+                              << batch_str(batch, log.component_ref(), log.component())
+                              << ": " << log_message_str(log, paths);
+                    if (log.repeat_count() > 1) {
+                        std::cout << " (x" << log.repeat_count() << " over "
+                                  << log.last_occurrence_delta_ms() << "ms)";
+                    }
+                    std::cout << "\n";
                     break;
                 }
                 default:
@@ -275,7 +514,8 @@ void on_message(struct mosquitto* /*mosq*/, void* /*obj*/,
     std::string topic(msg->topic);
 
     // Decompress payload directly (no CCPMainMessage envelope)
-    auto decompressed = decompress(static_cast<uint8_t*>(msg->payload), msg->payloadlen);
+    const char* codec = "";
+    auto decompressed = decompress(static_cast<uint8_t*>(msg->payload), msg->payloadlen, codec);
     if (decompressed.empty() && msg->payloadlen > 0) {
         return;
     }
@@ -292,6 +532,14 @@ void on_message(struct mosquitto* /*mosq*/, void* /*obj*/,
         stats.messages_received++;
         stats.bytes_compressed += msg->payloadlen;
         stats.bytes_decompressed += decompressed.size();
+
+        if (!g_config.capture_dir.empty()) {
+            auto path = std::filesystem::path(g_config.capture_dir) /
+                        ("batch_" + std::to_string(g_captured++) + ".pb");
+            std::ofstream file(path, std::ios::binary);
+            file.write(reinterpret_cast<const char*>(decompressed.data()),
+                       static_cast<std::streamsize>(decompressed.size()));
+        }
     }
 
     double ratio = 100.0 * msg->payloadlen / std::max(decompressed.size(), size_t(1));
@@ -299,7 +547,7 @@ void on_message(struct mosquitto* /*mosq*/, void* /*obj*/,
     if (g_config.verbose) {
         LOG(INFO) << topic
                   << " (" << msg->payloadlen << " -> " << decompressed.size()
-                  << " bytes, " << std::fixed << std::setprecision(1) << ratio << "% zstd)";
+                  << " bytes, " << std::fixed << std::setprecision(1) << ratio << "% " << codec << ")";
     }
 
     // Process as TransferBatch (unified format)
@@ -343,7 +591,7 @@ void print_usage(const char* prog) {
               << "VEP MQTT Logger - Receives and decodes vehicle telemetry\n"
               << "\n"
               << "Message format:\n"
-              << "  zstd compressed -> TransferBatch (interleaved items)\n"
+              << "  zstd / lz4 frame or uncompressed -> TransferBatch (interleaved items)\n"
               << "\n"
               << "Options:\n"
               << "  --broker HOST     MQTT broker host (default: localhost)\n"
@@ -351,6 +599,9 @@ void print_usage(const char* prog) {
               << "  --topic PATTERN   Topic pattern (default: telemetry/#)\n"
               << "  --json            Output JSON format\n"
               << "  --verbose         Verbose output with delay info\n"
+              << "  --zstd-dict FILE  Zstd dictionary for frames compressed with one\n"
+              << "  --capture DIR     Save each decompressed TransferBatch to DIR\n"
+              << "                    (samples for vep_zstd_dict_trainer)\n"
               << "  --help            Show this help\n"
               << "\n"
               << "Examples:\n"
@@ -378,6 +629,10 @@ Config parse_args(int argc, char* argv[]) {
             config.json_output = true;
         } else if (arg == "--verbose" || arg == "-v") {
             config.verbose = true;
+        } else if (arg == "--zstd-dict" && i + 1 < argc) {
+            config.zstd_dict = argv[++i];
+        } else if (arg == "--capture" && i + 1 < argc) {
+            config.capture_dir = argv[++i];
         } else {
             LOG(WARNING) << "Unknown argument: " << arg;
         }
@@ -401,6 +656,27 @@ int main(int argc, char* argv[]) {
     std::cout << "MQTT Broker: " << g_config.broker_host << ":" << g_config.broker_port << "\n";
     std::cout << "Topic:       " << g_config.topic_pattern << "\n\n";
 
+    if (!g_config.zstd_dict.empty()) {
+        std::ifstream file(g_config.zstd_dict, std::ios::binary);
+        std::vector<char> dictionary((std::istreambuf_iterator<char>(file)),
+                                     std::istreambuf_iterator<char>());
+        g_zstd_ddict = ZSTD_createDDict(dictionary.data(), dictionary.size());
+        g_zstd_dict_id = g_zstd_ddict ? ZSTD_getDictID_fromDDict(g_zstd_ddict) : 0;
+        if (g_zstd_dict_id == 0) {
+            LOG(ERROR) << "Not a zstd dictionary: " << g_config.zstd_dict;
+            return 1;
+        }
+        std::cout << "Dictionary:  " << g_config.zstd_dict << " (id " << g_zstd_dict_id << ")\n\n";
+    }
+    if (!g_config.capture_dir.empty()) {
+        std::error_code ec;
+        std::filesystem::create_directories(g_config.capture_dir, ec);
+        if (ec) {
+            LOG(ERROR) << "Cannot create " << g_config.capture_dir << ": " << ec.message();
+            return 1;
+        }
+    }
+
     signal(SIGINT, signal_handler);
     signal(SIGTERM, signal_handler);
 
@@ -449,6 +725,12 @@ int main(int argc, char* argv[]) {
     if (g_zstd_ctx) {
         ZSTD_freeDCtx(g_zstd_ctx);
     }
+    if (g_zstd_ddict) {
+        ZSTD_freeDDict(g_zstd_ddict);
+    }
+    if (g_lz4_ctx) {
+        LZ4F_freeDecompressionContext(g_lz4_ctx);
+    }
 
     LOG(INFO) << "Stopped.";
     return 0;
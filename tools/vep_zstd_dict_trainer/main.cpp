@@ -0,0 +1,222 @@
+// Copyright 2025 Vehicle Edge Platform Contributors
+// SPDX-License-Identifier: Apache-2.0
+
+/// @file main.cpp
+/// @brief VEP ZSTD Dictionary Trainer - Builds a zstd dictionary for TransferBatch
+///
+/// Reads captured batches (one per file, raw TransferBatch or zstd/lz4
+/// compressed, e.g. from `vep_mqtt_logger --capture DIR`), trains a zstd
+/// dictionary and reports the ratio it gains on held-out batches.
+///
+/// The dictionary goes to both ends: the exporter compresses with it
+/// (`vep_exporter_ifex --zstd-dict FILE`) and the cloud decompresses
+/// frames tagged with its id (`vep_mqtt_logger --zstd-dict FILE`).
+///
+/// Usage:
+///   vep_zstd_dict_trainer --output transfer.zdict captures/
+
+#include "compressor.hpp"
+#include "transfer.pb.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace {
+
+namespace fs = std::filesystem;
+using vep::exporter::CompressorType;
+
+struct Config {
+    std::string output = "transfer.zdict";
+    size_t dict_size = 16 * 1024;
+    int level = 3;
+    std::vector<std::string> inputs;
+};
+
+// Every n-th sample is held out to measure the gain
+constexpr size_t kHoldOutEvery = 10;
+
+void print_usage(const char* prog) {
+    std::cout << "Usage: " << prog << " [OPTIONS] SAMPLE...\n"
+              << "\n"
+              << "VEP ZSTD Dictionary Trainer - Builds a zstd dictionary from captured batches\n"
+              << "\n"
+              << "SAMPLE is a file holding one TransferBatch (raw or zstd/lz4 compressed),\n"
+              << "or a directory of such files.\n"
+              << "\n"
+              << "Options:\n"
+              << "  --output FILE     Dictionary file (default: transfer.zdict)\n"
+              << "  --size BYTES      Dictionary size (default: 16384)\n"
+              << "  --level N         Zstd level for the evaluation (default: 3)\n"
+              << "  --help            Show this help\n"
+              << "\n"
+              << "Example:\n"
+              << "  vep_mqtt_logger --capture captures/\n"
+              << "  " << prog << " --output transfer.zdict captures/\n"
+              << "\n";
+}
+
+Config parse_args(int argc, char* argv[]) {
+    Config config;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+
+        if (arg == "--help" || arg == "-h") {
+            print_usage(argv[0]);
+            exit(0);
+        } else if (arg == "--output" && i + 1 < argc) {
+            config.output = argv[++i];
+        } else if (arg == "--size" && i + 1 < argc) {
+            config.dict_size = std::stoul(argv[++i]);
+        } else if (arg == "--level" && i + 1 < argc) {
+            config.level = std::stoi(argv[++i]);
+        } else if (!arg.empty() && arg[0] == '-') {
+            LOG(WARNING) << "Unknown argument: " << arg;
+        } else {
+            config.inputs.push_back(arg);
+        }
+    }
+
+    return config;
+}
+
+/// Sample files, directories expanded recursively, in a stable order
+std::vector<fs::path> collect_files(const std::vector<std::string>& inputs) {
+    std::vector<fs::path> files;
+    for (const auto& input : inputs) {
+        std::error_code ec;
+        if (fs::is_directory(input, ec)) {
+            for (const auto& entry : fs::recursive_directory_iterator(input, ec)) {
+                if (entry.is_regular_file()) {
+                    files.push_back(entry.path());
+                }
+            }
+        } else if (fs::is_regular_file(input, ec)) {
+            files.emplace_back(input);
+        } else {
+            LOG(WARNING) << "Skipping " << input << ": not a file or directory";
+        }
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+/// Serialized TransferBatches from the sample files
+std::vector<std::vector<uint8_t>> load_samples(const std::vector<fs::path>& files) {
+    // Raw, zstd or lz4, told apart by frame magic
+    auto decompressor = vep::exporter::create_decompressor(CompressorType::AUTO);
+    std::vector<std::vector<uint8_t>> samples;
+    size_t skipped = 0;
+
+    for (const auto& path : files) {
+        std::ifstream file(path, std::ios::binary);
+        std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)),
+                                  std::istreambuf_iterator<char>());
+        data = decompressor->decompress(data);
+
+        vep::transfer::TransferBatch batch;
+        if (data.empty() || !batch.ParseFromArray(data.data(), static_cast<int>(data.size()))) {
+            ++skipped;
+            continue;
+        }
+        samples.push_back(std::move(data));
+    }
+
+    if (skipped > 0) {
+        LOG(WARNING) << "Skipped " << skipped << " files that are not TransferBatches";
+    }
+    return samples;
+}
+
+/// Total compressed size of samples
+size_t compressed_size(vep::exporter::Compressor& compressor,
+                       const std::vector<std::vector<uint8_t>>& samples) {
+    size_t total = 0;
+    for (const auto& sample : samples) {
+        total += compressor.compress(sample).size();
+    }
+    return total;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    google::InitGoogleLogging(argv[0]);
+    FLAGS_logtostderr = true;
+
+    Config config = parse_args(argc, argv);
+    if (config.inputs.empty()) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    auto samples = load_samples(collect_files(config.inputs));
+    if (samples.empty()) {
+        LOG(ERROR) << "No TransferBatch samples found";
+        return 1;
+    }
+
+    // Hold out samples for evaluation when there are enough
+    std::vector<std::vector<uint8_t>> training;
+    std::vector<std::vector<uint8_t>> evaluation;
+    for (size_t i = 0; i < samples.size(); ++i) {
+        bool hold_out = samples.size() >= 2 * kHoldOutEvery && i % kHoldOutEvery == 0;
+        (hold_out ? evaluation : training).push_back(std::move(samples[i]));
+    }
+    if (evaluation.empty()) {
+        LOG(WARNING) << "Few samples: evaluating on the training set";
+        evaluation = training;
+    }
+
+    size_t training_bytes = 0;
+    for (const auto& sample : training) {
+        training_bytes += sample.size();
+    }
+    std::cout << "Training on " << training.size() << " batches (" << training_bytes
+              << " bytes), dictionary size " << config.dict_size << "\n";
+
+    auto dictionary = vep::exporter::train_zstd_dictionary(training, config.dict_size);
+    if (!dictionary) {
+        return 1;
+    }
+
+    std::ofstream out(config.output, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(dictionary->data()),
+              static_cast<std::streamsize>(dictionary->size()));
+    if (!out) {
+        LOG(ERROR) << "Failed to write " << config.output;
+        return 1;
+    }
+
+    auto plain = vep::exporter::create_compressor(CompressorType::ZSTD, config.level);
+    auto with_dict = vep::exporter::create_compressor(CompressorType::ZSTD, config.level, *dictionary);
+    if (!plain || !with_dict) {
+        return 1;
+    }
+
+    size_t raw_bytes = 0;
+    for (const auto& sample : evaluation) {
+        raw_bytes += sample.size();
+    }
+    size_t plain_bytes = compressed_size(*plain, evaluation);
+    size_t dict_bytes = compressed_size(*with_dict, evaluation);
+
+    std::cout << "Dictionary id " << vep::exporter::zstd_dictionary_id(*dictionary) << ", "
+              << dictionary->size() << " bytes -> " << config.output << "\n"
+              << std::fixed << std::setprecision(1)
+              << "Evaluation on " << evaluation.size() << " batches (" << raw_bytes << " bytes):\n"
+              << "  zstd -" << config.level << ":              " << plain_bytes << " bytes ("
+              << 100.0 * plain_bytes / std::max<size_t>(raw_bytes, 1) << "%)\n"
+              << "  zstd -" << config.level << " + dictionary: " << dict_bytes << " bytes ("
+              << 100.0 * dict_bytes / std::max<size_t>(raw_bytes, 1) << "%)\n";
+    return 0;
+}